@@ -110,6 +110,7 @@ if(THIRDPARTY_DIRECTORY)
     VorbisFile
     VRPN
     ZLIB
+    Zstd
   )
 
     string(TOLOWER "${_Package}" _package)
@@ -487,6 +488,15 @@ package_option(ZLIB
 
 package_status(ZLIB "zlib")
 
+# Zstandard
+find_package(Zstd QUIET MODULE)
+
+package_option(ZSTD
+  "Enables support for fast Zstandard compression of Multifiles and cache files."
+  FOUND_AS Zstd)
+
+package_status(ZSTD "Zstandard")
+
 
 #
 # ------------ Image formats ------------
@@ -86,6 +86,7 @@ PkgListSet(["PYTHON", "DIRECT",                        # Python support
   "ODE", "BULLET", "PANDAPHYSICS",                     # Physics
   "SPEEDTREE",                                         # SpeedTree
   "ZLIB", "PNG", "JPEG", "TIFF", "OPENEXR", "SQUISH",  # 2D Formats support
+  "ZSTD",                                              # Compression
   "FCOLLADA", "ASSIMP", "EGG",                         # 3D Formats support
   "FREETYPE", "HARFBUZZ",                              # Text rendering
   "VRPN", "OPENSSL",                                   # Transport
@@ -716,6 +717,7 @@ if (COMPILER == "MSVC"):
         IncDirectory("OPENEXR", GetThirdpartyDir() + "openexr/include/Imath")
     if (PkgSkip("JPEG")==0):     LibName("JPEG",     GetThirdpartyDir() + "jpeg/lib/jpeg-static.lib")
     if (PkgSkip("ZLIB")==0):     LibName("ZLIB",     GetThirdpartyDir() + "zlib/lib/zlibstatic.lib")
+    if (PkgSkip("ZSTD")==0):     LibName("ZSTD",     GetThirdpartyDir() + "zstd/lib/zstd_static.lib")
     if (PkgSkip("VRPN")==0):     LibName("VRPN",     GetThirdpartyDir() + "vrpn/lib/vrpn.lib")
     if (PkgSkip("VRPN")==0):     LibName("VRPN",     GetThirdpartyDir() + "vrpn/lib/quat.lib")
     if (PkgSkip("NVIDIACG")==0): LibName("CGGL",     GetThirdpartyDir() + "nvidiacg/lib/cgGL.lib")
@@ -1059,6 +1061,7 @@ if (COMPILER=="GCC"):
     SmartPkgEnable("GTK3",      "gtk+-3.0")
     if GetTarget() != 'emscripten':
        SmartPkgEnable("ZLIB",      "zlib",      ("z"), "zlib.h")
+       SmartPkgEnable("ZSTD",      "libzstd",   ("zstd"), "zstd.h")
 
     if not PkgSkip("OPENSSL") and GetTarget() not in ("darwin", "emscripten"):
         LibName("OPENSSL", "-Wl,--exclude-libs,libssl.a")
@@ -2434,6 +2437,7 @@ DTOOL_CONFIG=[
     ("HAVE_EIGEN",                     'UNDEF',                  'UNDEF'),
     ("LINMATH_ALIGN",                  '1',                      '1'),
     ("HAVE_ZLIB",                      'UNDEF',                  'UNDEF'),
+    ("HAVE_ZSTD",                      'UNDEF',                  'UNDEF'),
     ("HAVE_PNG",                       'UNDEF',                  'UNDEF'),
     ("HAVE_JPEG",                      'UNDEF',                  'UNDEF'),
     ("HAVE_VIDEO4LINUX",               'UNDEF',                  '1'),
@@ -3623,11 +3627,11 @@ TargetAdd('p3pandabase_pandabase.obj', opts=OPTS, input='pandabase.cxx')
 # DIRECTORY: panda/src/express/
 #
 
-OPTS=['DIR:panda/src/express', 'BUILDING:PANDAEXPRESS', 'OPENSSL', 'ZLIB']
+OPTS=['DIR:panda/src/express', 'BUILDING:PANDAEXPRESS', 'OPENSSL', 'ZLIB', 'ZSTD']
 TargetAdd('p3express_composite1.obj', opts=OPTS, input='p3express_composite1.cxx')
 TargetAdd('p3express_composite2.obj', opts=OPTS, input='p3express_composite2.cxx')
 
-OPTS=['DIR:panda/src/express', 'OPENSSL', 'ZLIB']
+OPTS=['DIR:panda/src/express', 'OPENSSL', 'ZLIB', 'ZSTD']
 IGATEFILES=GetDirectoryContents('panda/src/express', ["*.h", "*_composite*.cxx"])
 TargetAdd('libp3express.in', opts=OPTS, input=IGATEFILES)
 TargetAdd('libp3express.in', opts=['IMOD:panda3d.core', 'ILIB:libp3express', 'SRCDIR:panda/src/express'])
@@ -5061,6 +5065,8 @@ if not PkgSkip("TINYDISPLAY"):
     TargetAdd('p3tinydisplay_ztriangle_3.obj', opts=OPTS, input='ztriangle_3.cxx')
     TargetAdd('p3tinydisplay_ztriangle_4.obj', opts=OPTS, input='ztriangle_4.cxx')
     TargetAdd('p3tinydisplay_ztriangle_table.obj', opts=OPTS, input='ztriangle_table.cxx')
+    TargetAdd('p3tinydisplay_ztriangle_sse2.obj', opts=OPTS+['SSE2'], input='ztriangle_sse2.cxx')
+    TargetAdd('p3tinydisplay_zbuffer_sse2.obj', opts=OPTS+['SSE2'], input='zbuffer_sse2.cxx')
     if GetTarget() == 'windows':
         TargetAdd('libp3tinydisplay.dll', input='libp3windisplay.dll')
         TargetAdd('libp3tinydisplay.dll', opts=['WINIMM', 'WINGDI', 'WINKERNEL', 'WINOLDNAMES', 'WINUSER', 'WINMM'])
@@ -5080,6 +5086,8 @@ if not PkgSkip("TINYDISPLAY"):
     TargetAdd('libp3tinydisplay.dll', input='p3tinydisplay_ztriangle_3.obj')
     TargetAdd('libp3tinydisplay.dll', input='p3tinydisplay_ztriangle_4.obj')
     TargetAdd('libp3tinydisplay.dll', input='p3tinydisplay_ztriangle_table.obj')
+    TargetAdd('libp3tinydisplay.dll', input='p3tinydisplay_ztriangle_sse2.obj')
+    TargetAdd('libp3tinydisplay.dll', input='p3tinydisplay_zbuffer_sse2.obj')
     TargetAdd('libp3tinydisplay.dll', input=COMMON_PANDA_LIBS)
 
 #
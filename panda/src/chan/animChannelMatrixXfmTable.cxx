@@ -23,6 +23,7 @@
 #include "bamWriter.h"
 #include "fftCompressor.h"
 #include "config_linmath.h"
+#include "cmath.h"
 
 TypeHandle AnimChannelMatrixXfmTable::_type_handle;
 
@@ -33,6 +34,8 @@ AnimChannelMatrixXfmTable::
 AnimChannelMatrixXfmTable() {
   for (int i = 0; i < num_matrix_components; i++) {
     _tables[i] = CPTA_stdfloat(get_class_type());
+    _quantize_base[i] = 0.0f;
+    _quantize_scale[i] = 0.0f;
   }
 }
 
@@ -47,6 +50,9 @@ AnimChannelMatrixXfmTable(AnimGroup *parent, const AnimChannelMatrixXfmTable &co
 {
   for (int i = 0; i < num_matrix_components; i++) {
     _tables[i] = copy._tables[i];
+    _quantized[i] = copy._quantized[i];
+    _quantize_base[i] = copy._quantize_base[i];
+    _quantize_scale[i] = copy._quantize_scale[i];
   }
 }
 
@@ -59,6 +65,8 @@ AnimChannelMatrixXfmTable(AnimGroup *parent, const std::string &name)
 {
   for (int i = 0; i < num_matrix_components; i++) {
     _tables[i] = CPTA_stdfloat(get_class_type());
+    _quantize_base[i] = 0.0f;
+    _quantize_scale[i] = 0.0f;
   }
 }
 
@@ -80,9 +88,8 @@ has_changed(int last_frame, double last_frac,
             int this_frame, double this_frac) {
   if (last_frame != this_frame) {
     for (int i = 0; i < num_matrix_components; i++) {
-      if (_tables[i].size() > 1) {
-        if (_tables[i][last_frame % _tables[i].size()] !=
-            _tables[i][this_frame % _tables[i].size()]) {
+      if (get_table_size(i) > 1) {
+        if (get_table_value(i, last_frame) != get_table_value(i, this_frame)) {
           return true;
         }
       }
@@ -93,9 +100,8 @@ has_changed(int last_frame, double last_frac,
     // If we have some fractional changes, also check the next subsequent
     // frame (since we'll be blending with that).
     for (int i = 0; i < num_matrix_components; i++) {
-      if (_tables[i].size() > 1) {
-        if (_tables[i][last_frame % _tables[i].size()] !=
-            _tables[i][(this_frame + 1) % _tables[i].size()]) {
+      if (get_table_size(i) > 1) {
+        if (get_table_value(i, last_frame) != get_table_value(i, this_frame + 1)) {
           return true;
         }
       }
@@ -113,11 +119,7 @@ get_value(int frame, LMatrix4 &mat) {
   PN_stdfloat components[num_matrix_components];
 
   for (int i = 0; i < num_matrix_components; i++) {
-    if (_tables[i].empty()) {
-      components[i] = get_default_value(i);
-    } else {
-      components[i] = _tables[i][frame % _tables[i].size()];
-    }
+    components[i] = get_table_value(i, frame);
   }
 
   compose_matrix(mat, components);
@@ -138,11 +140,7 @@ get_value_no_scale_shear(int frame, LMatrix4 &mat) {
   components[5] = 0.0f;
 
   for (int i = 6; i < num_matrix_components; i++) {
-    if (_tables[i].empty()) {
-      components[i] = get_default_value(i);
-    } else {
-      components[i] = _tables[i][frame % _tables[i].size()];
-    }
+    components[i] = get_table_value(i, frame);
   }
 
   compose_matrix(mat, components);
@@ -154,11 +152,7 @@ get_value_no_scale_shear(int frame, LMatrix4 &mat) {
 void AnimChannelMatrixXfmTable::
 get_scale(int frame, LVecBase3 &scale) {
   for (int i = 0; i < 3; i++) {
-    if (_tables[i].empty()) {
-      scale[i] = 1.0f;
-    } else {
-      scale[i] = _tables[i][frame % _tables[i].size()];
-    }
+    scale[i] = get_table_value(i, frame);
   }
 }
 
@@ -169,11 +163,7 @@ get_scale(int frame, LVecBase3 &scale) {
 void AnimChannelMatrixXfmTable::
 get_hpr(int frame, LVecBase3 &hpr) {
   for (int i = 0; i < 3; i++) {
-    if (_tables[i + 6].empty()) {
-      hpr[i] = 0.0f;
-    } else {
-      hpr[i] = _tables[i + 6][frame % _tables[i + 6].size()];
-    }
+    hpr[i] = get_table_value(i + 6, frame);
   }
 }
 
@@ -186,11 +176,7 @@ void AnimChannelMatrixXfmTable::
 get_quat(int frame, LQuaternion &quat) {
   LVecBase3 hpr;
   for (int i = 0; i < 3; i++) {
-    if (_tables[i + 6].empty()) {
-      hpr[i] = 0.0f;
-    } else {
-      hpr[i] = _tables[i + 6][frame % _tables[i + 6].size()];
-    }
+    hpr[i] = get_table_value(i + 6, frame);
   }
 
   quat.set_hpr(hpr);
@@ -203,11 +189,7 @@ get_quat(int frame, LQuaternion &quat) {
 void AnimChannelMatrixXfmTable::
 get_pos(int frame, LVecBase3 &pos) {
   for (int i = 0; i < 3; i++) {
-    if (_tables[i + 9].empty()) {
-      pos[i] = 0.0f;
-    } else {
-      pos[i] = _tables[i + 9][frame % _tables[i + 9].size()];
-    }
+    pos[i] = get_table_value(i + 9, frame);
   }
 }
 
@@ -218,11 +200,7 @@ get_pos(int frame, LVecBase3 &pos) {
 void AnimChannelMatrixXfmTable::
 get_shear(int frame, LVecBase3 &shear) {
   for (int i = 0; i < 3; i++) {
-    if (_tables[i + 3].empty()) {
-      shear[i] = 0.0f;
-    } else {
-      shear[i] = _tables[i + 3][frame % _tables[i + 3].size()];
-    }
+    shear[i] = get_table_value(i + 3, frame);
   }
 }
 
@@ -231,6 +209,9 @@ get_shear(int frame, LVecBase3 &shear) {
  * 'a', 'b', 'c' for shear, 'h', 'p', 'r', for rotation, and 'x', 'y', 'z',
  * for translation.  The new table must have either zero, one, or
  * get_num_frames() frames.
+ *
+ * The table should not be modified after it has been assigned, since it may
+ * be shared with other channels; see share-anim-tables.
  */
 void AnimChannelMatrixXfmTable::
 set_table(char table_id, const CPTA_stdfloat &table) {
@@ -248,7 +229,7 @@ set_table(char table_id, const CPTA_stdfloat &table) {
     return;
   }
 
-  _tables[i] = table;
+  store_table(i, table);
 }
 
 
@@ -260,6 +241,7 @@ void AnimChannelMatrixXfmTable::
 clear_all_tables() {
   for (int i = 0; i < num_matrix_components; i++) {
     _tables[i] = CPTA_stdfloat(get_class_type());
+    _quantized[i] = nullptr;
   }
 }
 
@@ -274,8 +256,8 @@ write(std::ostream &out, int indent_level) const {
   // Write a list of all the sub-tables that have data.
   bool found_any = false;
   for (int i = 0; i < num_matrix_components; i++) {
-    if (!_tables[i].empty()) {
-      out << get_table_id(i) << _tables[i].size();
+    if (get_table_size(i) != 0) {
+      out << get_table_id(i) << get_table_size(i);
       found_any = true;
     }
   }
@@ -319,6 +301,76 @@ get_table_index(char table_id) {
   return -1;
 }
 
+/**
+ * Stores the indicated table as the data for the indicated component.  If
+ * share-anim-tables is true, an identical table already loaded for another
+ * channel is used instead, and if quantize-anim-tables is true, the table is
+ * converted to 16-bit values.
+ */
+void AnimChannelMatrixXfmTable::
+store_table(int table_index, const CPTA_stdfloat &table) {
+  _quantized[table_index] = nullptr;
+
+  if (quantize_anim_tables && table.size() > 1) {
+    PN_stdfloat min_value = table[0];
+    PN_stdfloat max_value = table[0];
+    for (size_t fi = 1; fi < table.size(); ++fi) {
+      min_value = std::min(min_value, table[fi]);
+      max_value = std::max(max_value, table[fi]);
+    }
+
+    if (min_value == max_value) {
+      // The component is constant; a single value will do.
+      PTA_stdfloat single(get_class_type());
+      single.push_back(min_value);
+      _tables[table_index] = single;
+
+    } else {
+      PN_stdfloat scale = (max_value - min_value) / 65535.0f;
+      PointerToArray<uint16_t> quantized =
+        PointerToArray<uint16_t>::empty_array(table.size(), get_class_type());
+      for (size_t fi = 0; fi < table.size(); ++fi) {
+        int value = (int)cfloor((table[fi] - min_value) / scale + 0.5f);
+        quantized[fi] = (uint16_t)std::max(std::min(value, 65535), 0);
+      }
+
+      _tables[table_index] = CPTA_stdfloat(get_class_type());
+      _quantized[table_index] = quantized;
+      _quantize_base[table_index] = min_value;
+      _quantize_scale[table_index] = scale;
+      if (share_anim_tables) {
+        _quantized[table_index] = AnimTablePool::share_table(_quantized[table_index]);
+      }
+      return;
+    }
+
+  } else {
+    _tables[table_index] = table;
+  }
+
+  if (share_anim_tables) {
+    _tables[table_index] = AnimTablePool::share_table(_tables[table_index]);
+  }
+}
+
+/**
+ * Returns the indicated table as floating-point values, decoding it if it has
+ * been quantized.
+ */
+CPTA_stdfloat AnimChannelMatrixXfmTable::
+decode_table(int table_index) const {
+  const AnimTablePool::CPTA_uint16 &quantized = _quantized[table_index];
+  if (quantized.empty()) {
+    return _tables[table_index];
+  }
+
+  PTA_stdfloat table = PTA_stdfloat::empty_array(quantized.size(), get_class_type());
+  for (size_t fi = 0; fi < quantized.size(); ++fi) {
+    table[fi] = get_table_value(table_index, (int)fi);
+  }
+  return table;
+}
+
 /**
  * Function to write the important information in the particular object to a
  * Datagram
@@ -344,12 +396,17 @@ write_datagram(BamWriter *manager, Datagram &me) {
   // We now always use the new HPR conventions.
   me.add_bool(true);
 
+  CPTA_stdfloat tables[num_matrix_components];
+  for (int i = 0; i < num_matrix_components; i++) {
+    tables[i] = decode_table(i);
+  }
+
   if (!compress_channels) {
     // Write out everything uncompressed, as a stream of floats.
     for (int i = 0; i < num_matrix_components; i++) {
-      me.add_uint16(_tables[i].size());
-      for(int j = 0; j < (int)_tables[i].size(); j++) {
-        me.add_stdfloat(_tables[i][j]);
+      me.add_uint16(tables[i].size());
+      for(int j = 0; j < (int)tables[i].size(); j++) {
+        me.add_stdfloat(tables[i][j]);
       }
     }
 
@@ -363,18 +420,18 @@ write_datagram(BamWriter *manager, Datagram &me) {
     // First, write out the scales and shears.
     int i;
     for (i = 0; i < 6; i++) {
-      compressor.write_reals(me, _tables[i], _tables[i].size());
+      compressor.write_reals(me, tables[i], tables[i].size());
     }
 
     // Now, write out the joint angles.  For these we need to build up a HPR
     // array.
     pvector<LVecBase3> hprs;
-    int hprs_length = std::max(std::max(_tables[6].size(), _tables[7].size()), _tables[8].size());
+    int hprs_length = std::max(std::max(tables[6].size(), tables[7].size()), tables[8].size());
     hprs.reserve(hprs_length);
     for (i = 0; i < hprs_length; i++) {
-      PN_stdfloat h = _tables[6].empty() ? 0.0f : _tables[6][i % _tables[6].size()];
-      PN_stdfloat p = _tables[7].empty() ? 0.0f : _tables[7][i % _tables[7].size()];
-      PN_stdfloat r = _tables[8].empty() ? 0.0f : _tables[8][i % _tables[8].size()];
+      PN_stdfloat h = tables[6].empty() ? 0.0f : tables[6][i % tables[6].size()];
+      PN_stdfloat p = tables[7].empty() ? 0.0f : tables[7][i % tables[7].size()];
+      PN_stdfloat r = tables[8].empty() ? 0.0f : tables[8][i % tables[8].size()];
       hprs.push_back(LVecBase3(h, p, r));
     }
     const LVecBase3 *hprs_array = nullptr;
@@ -385,7 +442,7 @@ write_datagram(BamWriter *manager, Datagram &me) {
 
     // And now the translations.
     for(i = 9; i < num_matrix_components; i++) {
-      compressor.write_reals(me, _tables[i], _tables[i].size());
+      compressor.write_reals(me, tables[i], tables[i].size());
     }
   }
 }
@@ -505,6 +562,14 @@ fillin(DatagramIterator &scan, BamReader *manager) {
       _tables[i] = ind_table;
     }
   }
+
+  // Now that we have the final values, share or quantize the tables as
+  // requested.
+  if (share_anim_tables || quantize_anim_tables) {
+    for (int i = 0; i < num_matrix_components; i++) {
+      store_table(i, _tables[i]);
+    }
+  }
 }
 
 /**
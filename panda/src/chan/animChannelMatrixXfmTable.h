@@ -21,12 +21,17 @@
 #include "pointerToArray.h"
 #include "pta_stdfloat.h"
 #include "compose_matrix.h"
+#include "animTablePool.h"
 
 /**
  * An animation channel that issues a matrix each frame, read from a table
  * such as might have been read from an egg file.  The table actually consists
  * of nine sub-tables, each representing one component of the transform:
  * scale, rotate, translate.
+ *
+ * If quantize-anim-tables is true, the sub-tables are stored in memory as
+ * 16-bit values scaled to the range of each sub-table, and decoded as they
+ * are needed.
  */
 class EXPCL_PANDA_CHAN AnimChannelMatrixXfmTable : public AnimChannelMatrix {
 protected:
@@ -58,6 +63,7 @@ PUBLISHED:
   void clear_all_tables();
   INLINE bool has_table(char table_id) const;
   INLINE void clear_table(char table_id);
+  INLINE bool is_table_quantized(char table_id) const;
 
   MAKE_MAP_PROPERTY(tables, has_table, get_table, set_table, clear_table);
 
@@ -71,8 +77,19 @@ protected:
   static int get_table_index(char table_id);
   INLINE static PN_stdfloat get_default_value(int table_index);
 
+  INLINE size_t get_table_size(int table_index) const;
+  INLINE PN_stdfloat get_table_value(int table_index, int frame) const;
+  void store_table(int table_index, const CPTA_stdfloat &table);
+  CPTA_stdfloat decode_table(int table_index) const;
+
   CPTA_stdfloat _tables[num_matrix_components];
 
+  // If a table has been quantized, it is stored here instead of in _tables;
+  // each value is _quantize_base + value * _quantize_scale.
+  AnimTablePool::CPTA_uint16 _quantized[num_matrix_components];
+  PN_stdfloat _quantize_base[num_matrix_components];
+  PN_stdfloat _quantize_scale[num_matrix_components];
+
 public:
   static void register_with_read_factory();
   virtual void write_datagram(BamWriter* manager, Datagram &me);
@@ -14,6 +14,7 @@
 #include "animChannelScalarTable.h"
 #include "animBundle.h"
 #include "config_chan.h"
+#include "animTablePool.h"
 
 #include "indent.h"
 #include "datagram.h"
@@ -95,7 +96,9 @@ get_value(int frame, PN_stdfloat &value) {
 
 
 /**
- * Assigns the data table.
+ * Assigns the data table.  The table should not be modified after it has been
+ * assigned, since it may be shared with other channels; see
+ * share-anim-tables.
  */
 void AnimChannelScalarTable::
 set_table(const CPTA_stdfloat &table) {
@@ -108,7 +111,11 @@ set_table(const CPTA_stdfloat &table) {
     return;
   }
 
-  _table = table;
+  if (share_anim_tables) {
+    _table = AnimTablePool::share_table(table);
+  } else {
+    _table = table;
+  }
 }
 
 /**
@@ -318,7 +325,11 @@ fillin(DatagramIterator& scan, BamReader* manager) {
     }
   }
 
-  _table = temp_table;
+  if (share_anim_tables) {
+    _table = AnimTablePool::share_table(temp_table);
+  } else {
+    _table = temp_table;
+  }
 }
 
 /**
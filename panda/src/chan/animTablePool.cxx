@@ -0,0 +1,160 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file animTablePool.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "animTablePool.h"
+#include "config_chan.h"
+#include "lightMutexHolder.h"
+
+AnimTablePool *AnimTablePool::_global_ptr = nullptr;
+
+/**
+ * The implementation of share_table() for both kinds of tables.  Assumes the
+ * lock is held.
+ */
+template<class Tables>
+typename Tables::key_type AnimTablePool::
+do_share_table(Tables &tables, const typename Tables::key_type &table) {
+  typedef typename Tables::key_type Table;
+
+  typename Tables::const_iterator ti = tables.find(table);
+  if (ti != tables.end()) {
+    // We already had an identical table.
+    ++_num_shared;
+    return *ti;
+  }
+
+  // The pool is keyed on the contents of the table, so it keeps its own copy;
+  // the caller might still be holding a PointerToArray to the one it passed
+  // in, and could modify it at any time.
+  Table copy(table.p(), table.p() + table.size());
+  tables.insert(copy);
+
+  if (tables.size() >= _next_gc_size) {
+    // Every so often, clean out the tables that nobody is using any more, so
+    // that the pool doesn't grow without bound as animations are unloaded.
+    size_t num_bytes;
+    do_garbage_collect(tables, num_bytes);
+    _next_gc_size = std::max(tables.size() * 2, (size_t)1024);
+  }
+  return copy;
+}
+
+/**
+ * Removes the tables that are referenced only by the pool itself.  Returns
+ * the number of tables released, and fills num_bytes with the number of bytes
+ * used by the remaining tables.  Assumes the lock is held.
+ */
+template<class Tables>
+int AnimTablePool::
+do_garbage_collect(Tables &tables, size_t &num_bytes) {
+  int num_released = 0;
+  num_bytes = 0;
+
+  typename Tables::iterator ti = tables.begin();
+  while (ti != tables.end()) {
+    if ((*ti).get_ref_count() == 1) {
+      tables.erase(ti++);
+      ++num_released;
+    } else {
+      num_bytes += (*ti).size() * sizeof((*ti)[0]);
+      ++ti;
+    }
+  }
+
+  return num_released;
+}
+
+/**
+ * The nonstatic implementation of share_table().
+ */
+CPTA_stdfloat AnimTablePool::
+ns_share_table(const CPTA_stdfloat &table) {
+  if (table.is_null()) {
+    return table;
+  }
+  LightMutexHolder holder(_lock);
+  return do_share_table(_float_tables, table);
+}
+
+/**
+ * The nonstatic implementation of share_table().
+ */
+AnimTablePool::CPTA_uint16 AnimTablePool::
+ns_share_table(const CPTA_uint16 &table) {
+  if (table.is_null()) {
+    return table;
+  }
+  LightMutexHolder holder(_lock);
+  return do_share_table(_uint16_tables, table);
+}
+
+/**
+ * The nonstatic implementation of get_num_tables().
+ */
+int AnimTablePool::
+ns_get_num_tables() {
+  LightMutexHolder holder(_lock);
+  return (int)(_float_tables.size() + _uint16_tables.size());
+}
+
+/**
+ * The nonstatic implementation of garbage_collect().
+ */
+int AnimTablePool::
+ns_garbage_collect() {
+  LightMutexHolder holder(_lock);
+
+  size_t num_bytes;
+  int num_released = do_garbage_collect(_float_tables, num_bytes);
+  num_released += do_garbage_collect(_uint16_tables, num_bytes);
+
+  if (chan_cat.is_debug()) {
+    chan_cat.debug()
+      << "Released " << num_released << " animation tables.\n";
+  }
+  return num_released;
+}
+
+/**
+ * The nonstatic implementation of list_contents().
+ */
+void AnimTablePool::
+ns_list_contents(std::ostream &out) {
+  LightMutexHolder holder(_lock);
+
+  size_t float_bytes = 0;
+  for (const CPTA_stdfloat &table : _float_tables) {
+    float_bytes += table.size() * sizeof(PN_stdfloat);
+  }
+  size_t uint16_bytes = 0;
+  for (const CPTA_uint16 &table : _uint16_tables) {
+    uint16_bytes += table.size() * sizeof(uint16_t);
+  }
+
+  out << "AnimTablePool contains " << _float_tables.size()
+      << " float tables (" << float_bytes << " bytes) and "
+      << _uint16_tables.size() << " quantized tables (" << uint16_bytes
+      << " bytes); " << _num_shared << " tables have been shared.\n";
+}
+
+/**
+ * Initializes and/or returns the global pointer to the one AnimTablePool
+ * object in the system.
+ */
+AnimTablePool *AnimTablePool::
+get_ptr() {
+  if (_global_ptr == nullptr) {
+    _global_ptr = new AnimTablePool;
+  }
+  return _global_ptr;
+}
@@ -0,0 +1,86 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file animTablePool.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef ANIMTABLEPOOL_H
+#define ANIMTABLEPOOL_H
+
+#include "pandabase.h"
+#include "pointerToArray.h"
+#include "pta_stdfloat.h"
+#include "lightMutex.h"
+#include "pset.h"
+
+/**
+ * This class unifies the tables of animation data that are identical, so that
+ * the many animations loaded for a family of characters, which often have
+ * the same values for many joints, need to keep only one copy of each table
+ * in memory.
+ *
+ * Tables are added to the pool by AnimChannelMatrixXfmTable and
+ * AnimChannelScalarTable as they are loaded, when share-anim-tables is true.
+ * Tables that are no longer referenced by any channel are periodically
+ * removed from the pool, or explicitly by garbage_collect().
+ */
+class EXPCL_PANDA_CHAN AnimTablePool {
+public:
+  typedef ConstPointerToArray<uint16_t> CPTA_uint16;
+
+  INLINE static CPTA_stdfloat share_table(const CPTA_stdfloat &table);
+  INLINE static CPTA_uint16 share_table(const CPTA_uint16 &table);
+
+PUBLISHED:
+  INLINE static int get_num_tables();
+  INLINE static int garbage_collect();
+
+  INLINE static void list_contents(std::ostream &out);
+  INLINE static void list_contents();
+
+private:
+  INLINE AnimTablePool();
+
+  template<class Element>
+  class TableCompare {
+  public:
+    INLINE bool operator () (const ConstPointerToArray<Element> &a,
+                             const ConstPointerToArray<Element> &b) const;
+  };
+
+  typedef pset<CPTA_stdfloat, TableCompare<PN_stdfloat> > FloatTables;
+  typedef pset<CPTA_uint16, TableCompare<uint16_t> > Uint16Tables;
+
+  template<class Tables>
+  typename Tables::key_type do_share_table(Tables &tables,
+                                           const typename Tables::key_type &table);
+  template<class Tables>
+  static int do_garbage_collect(Tables &tables, size_t &num_bytes);
+
+  CPTA_stdfloat ns_share_table(const CPTA_stdfloat &table);
+  CPTA_uint16 ns_share_table(const CPTA_uint16 &table);
+  int ns_get_num_tables();
+  int ns_garbage_collect();
+  void ns_list_contents(std::ostream &out);
+
+  static AnimTablePool *get_ptr();
+
+  static AnimTablePool *_global_ptr;
+
+  LightMutex _lock;
+  FloatTables _float_tables;
+  Uint16Tables _uint16_tables;
+  size_t _next_gc_size;
+  size_t _num_shared;
+};
+
+#include "animTablePool.I"
+
+#endif
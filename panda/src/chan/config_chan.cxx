@@ -78,6 +78,22 @@ PRC_DESC("Set this false to disable reading of compressed animation channels, "
          "might want to do this would be to speed load time when you don't "
          "care about what the animation looks like."));
 
+ConfigVariableBool share_anim_tables
+("share-anim-tables", true,
+PRC_DESC("Set this true to share the tables of identical animation data "
+         "between all of the animations that are loaded, so that each "
+         "distinct table is only stored in memory once.  See "
+         "AnimTablePool."));
+
+ConfigVariableBool quantize_anim_tables
+("quantize-anim-tables", false,
+PRC_DESC("Set this true to store the tables of joint animations in memory "
+         "as 16-bit values, scaled to the range of each table, rather than "
+         "as floats.  This reduces the memory used by animations by half "
+         "or more, at the cost of a small loss of precision and a little "
+         "more work to decode each value as it is used.  This does not "
+         "affect the format of bam files."));
+
 ConfigVariableBool interpolate_frames
 ("interpolate-frames", false,
 PRC_DESC("Set this true to interpolate character animations between frames, "
@@ -92,6 +108,14 @@ PRC_DESC("When this is true, setting all control effects on an Actor to 0 "
          "false, it retains whatever its last-computed pose was "
          "(which may or may not be the default pose)."));
 
+ConfigVariableBool lod_frame_blend
+("lod-frame-blend", true,
+ PRC_DESC("When this is true, a character whose updates have been delayed "
+          "by Character::set_lod_animation() interpolates between "
+          "successive animation frames on the frames that it is updated, "
+          "even if interpolate-frames is false.  See "
+          "PartBundle::set_lod_frame_blend_flag()."));
+
 ConfigVariableInt async_bind_priority
 ("async-bind-priority", 100,
 PRC_DESC("This specifies the priority assign to an asynchronous bind "
@@ -25,8 +25,11 @@ NotifyCategoryDecl(chan, EXPCL_PANDA_CHAN, EXPTP_PANDA_CHAN);
 EXPCL_PANDA_CHAN extern ConfigVariableBool compress_channels;
 EXPCL_PANDA_CHAN extern ConfigVariableInt compress_chan_quality;
 EXPCL_PANDA_CHAN extern ConfigVariableBool read_compressed_channels;
+EXPCL_PANDA_CHAN extern ConfigVariableBool share_anim_tables;
+EXPCL_PANDA_CHAN extern ConfigVariableBool quantize_anim_tables;
 EXPCL_PANDA_CHAN extern ConfigVariableBool interpolate_frames;
 EXPCL_PANDA_CHAN extern ConfigVariableBool restore_initial_pose;
+EXPCL_PANDA_CHAN extern ConfigVariableBool lod_frame_blend;
 EXPCL_PANDA_CHAN extern ConfigVariableInt async_bind_priority;
 
 #endif
@@ -103,18 +103,27 @@ write_with_value(std::ostream &out, int indent_level) const {
  * current frame.  This is not really public and is not intended to be called
  * directly; it is called from the top of the tree by PartBundle::update().
  *
+ * depth is the number of MovingParts above this one in the hierarchy; see
+ * PartBundle::set_lod_joint_depth().
+ *
  * The return value is true if any part has changed, false otherwise.
  */
 bool MovingPartBase::
 do_update(PartBundle *root, const CycleData *root_cdata, PartGroup *parent,
-          bool parent_changed, bool anim_changed,
+          int depth, bool parent_changed, bool anim_changed,
           Thread *current_thread) {
   bool any_changed = false;
   bool needs_update = anim_changed;
 
-  // See if any of the channel values have changed since last time.
+  // See if any of the channel values have changed since last time.  If this
+  // part is below the joint depth animated at the current level of detail,
+  // it holds its last value, unless it has been explicitly controlled.
+  int lod_joint_depth = ((const PartBundle::CData *)root_cdata)->_lod_joint_depth;
+  if (lod_joint_depth >= 0 && depth > lod_joint_depth &&
+      _forced_channel == nullptr) {
+    needs_update = false;
 
-  if (!needs_update) {
+  } else if (!needs_update) {
     if (_forced_channel != nullptr) {
       needs_update = _forced_channel->has_changed(0, 0.0, 0, 0.0);
 
@@ -155,7 +164,7 @@ do_update(PartBundle *root, const CycleData *root_cdata, PartGroup *parent,
   // Now recurse.
   Children::iterator ci;
   for (ci = _children.begin(); ci != _children.end(); ++ci) {
-    if ((*ci)->do_update(root, root_cdata, this,
+    if ((*ci)->do_update(root, root_cdata, this, depth + 1,
                          parent_changed || needs_update,
                          anim_changed, current_thread)) {
       any_changed = true;
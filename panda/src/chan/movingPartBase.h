@@ -54,7 +54,7 @@ PUBLISHED:
 
 public:
   virtual bool do_update(PartBundle *root, const CycleData *root_cdata,
-                         PartGroup *parent, bool parent_changed,
+                         PartGroup *parent, int depth, bool parent_changed,
                          bool anim_changed, Thread *current_thread);
 
   virtual void get_blend_value(const PartBundle *root)=0;
@@ -91,8 +91,12 @@ get_blend_value(const PartBundle *root) {
           nassertv(effect != 0.0f);
 
           int channel_index = control->get_channel_index();
-          nassertv(channel_index >= 0 && channel_index < (int)_channels.size());
-          ChannelType *channel = DCAST(ChannelType, _channels[channel_index]);
+          ChannelType *channel = nullptr;
+          if (channel_index >= 0 && channel_index < (int)_channels.size()) {
+            // The channel may not be bound yet, if the control is still
+            // pending an asynchronous load.
+            channel = DCAST(ChannelType, _channels[channel_index]);
+          }
           if (channel != nullptr) {
             ValueType v;
             channel->get_value(control->get_frame(), v);
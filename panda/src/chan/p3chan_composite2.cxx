@@ -1,4 +1,5 @@
 #include "animPreloadTable.cxx"
+#include "animTablePool.cxx"
 #include "bindAnimRequest.cxx"
 #include "config_chan.cxx"
 #include "movingPartBase.cxx"
@@ -15,6 +15,7 @@
 #include "animBundle.h"
 #include "animBundleNode.h"
 #include "animControl.h"
+#include "animControlCollection.h"
 #include "loader.h"
 #include "animPreloadTable.h"
 #include "config_chan.h"
@@ -55,6 +56,7 @@ PartBundle(const PartBundle &copy) :
 {
   _anim_preload = copy._anim_preload;
   _update_delay = 0.0;
+  _lod_frame_blend_flag = copy._lod_frame_blend_flag;
 
   CDWriter cdata(_cycler, true);
   CDReader cdata_from(copy._cycler);
@@ -73,6 +75,7 @@ PartBundle(const string &name) :
   PartGroup(name)
 {
   _update_delay = 0.0;
+  _lod_frame_blend_flag = lod_frame_blend;
 }
 
 /**
@@ -106,6 +109,42 @@ merge_anim_preloads(const PartBundle *other) {
   anim_preload->add_anims_from(other->_anim_preload.get_read_pointer());
 }
 
+/**
+ * Limits the animation of the bundle to the joints in the top levels of the
+ * hierarchy.  Joints that are more than the indicated number of levels below
+ * the root joint keep their last animated value, relative to their parent,
+ * and are not evaluated again until the limit is raised; they still follow
+ * their parents.  This is useful for characters in the distance, whose
+ * fingers and faces are too small to see.
+ *
+ * A value of 0 animates only the root joints; -1, the default, animates all
+ * of the joints.  This is normally set by Character::set_lod_animation(); see
+ * Character::set_lod_joint_depth().  Like update(), it should be called from
+ * the thread that updates the bundle.
+ */
+void PartBundle::
+set_lod_joint_depth(int depth, Thread *current_thread) {
+  if (depth < 0) {
+    depth = -1;
+  }
+
+  {
+    CDReader cdata(_cycler, current_thread);
+    if (depth == cdata->_lod_joint_depth) {
+      return;
+    }
+  }
+
+  CDWriter cdata(_cycler, false, current_thread);
+  if (cdata->_lod_joint_depth >= 0 &&
+      (depth < 0 || depth > cdata->_lod_joint_depth)) {
+    // The joints that we had been skipping need to be brought up to date on
+    // the next update, even if their channels haven't changed since.
+    cdata->_anim_changed = true;
+  }
+  cdata->_lod_joint_depth = depth;
+}
+
 /**
  * Defines the way the character responds to multiple calls to
  * set_control_effect()).  By default, this flag is set false, which disallows
@@ -340,6 +379,50 @@ load_bind_anim(Loader *loader, const Filename &filename,
   return control;
 }
 
+/**
+ * Loads and binds all of the animations listed in the PartBundle's preload
+ * table (see get_anim_preload()), looking for each one in the indicated
+ * directory, and stores the resulting AnimControls in the given collection,
+ * named by the animation's basename.
+ *
+ * When threading is available, the animation files are all loaded and bound
+ * in a sub-thread, and this method returns immediately.  The PartBundle may
+ * be used right away; it will hold its bind pose until the animations become
+ * available, at which point the AnimControls that are playing will start to
+ * take effect.  See load_bind_anim() for more information.
+ *
+ * The return value is the number of AnimControls that were stored.
+ */
+int PartBundle::
+load_bind_anims(Loader *loader, const Filename &directory,
+                AnimControlCollection &controls,
+                int hierarchy_match_flags, const PartSubset &subset) {
+  nassertr(loader != nullptr, 0);
+
+  CPT(AnimPreloadTable) anim_preload = _anim_preload.get_read_pointer();
+  if (anim_preload == nullptr) {
+    return 0;
+  }
+
+  int num_stored = 0;
+  int num_anims = anim_preload->get_num_anims();
+  for (int i = 0; i < num_anims; ++i) {
+    std::string basename = anim_preload->get_basename(i);
+
+    // The filename is given without an extension, so that the loader may
+    // resolve it with default-model-extension.
+    Filename filename(directory, basename);
+    PT(AnimControl) control =
+      load_bind_anim(loader, filename, hierarchy_match_flags, subset, true);
+    if (control != nullptr) {
+      controls.store_anim(control, basename);
+      ++num_stored;
+    }
+  }
+
+  return num_stored;
+}
+
 /**
  * Blocks the current thread until all currently-pending AnimControls, with a
  * nonzero control effect, have been loaded and are properly bound.
@@ -483,9 +566,22 @@ update() {
     bool anim_changed = cdata->_anim_changed;
     bool frame_blend_flag = cdata->_frame_blend_flag;
 
-    any_changed = do_update(this, cdata, nullptr, false, anim_changed,
+    // If we are only updating occasionally, interpolate the pose at the exact
+    // time of this update, rather than snapping to the current frame.
+    bool blend_catch_up = (!frame_blend_flag && _update_delay > 0.0 &&
+                           _lod_frame_blend_flag);
+    if (blend_catch_up) {
+      cdata->_frame_blend_flag = true;
+      frame_blend_flag = true;
+    }
+
+    any_changed = do_update(this, cdata, nullptr, 0, false, anim_changed,
                             current_thread);
 
+    if (blend_catch_up) {
+      cdata->_frame_blend_flag = false;
+    }
+
     // Now update all the controls for next time.
     ChannelBlend::const_iterator cbi;
     for (cbi = cdata->_blend.begin(); cbi != cdata->_blend.end(); ++cbi) {
@@ -508,7 +604,7 @@ bool PartBundle::
 force_update() {
   Thread *current_thread = Thread::get_current_thread();
   CDWriter cdata(_cycler, false, current_thread);
-  bool any_changed = do_update(this, cdata, nullptr, true, true, current_thread);
+  bool any_changed = do_update(this, cdata, nullptr, 0, true, true, current_thread);
 
   // Now update all the controls for next time.
   ChannelBlend::const_iterator cbi;
@@ -620,7 +716,15 @@ do_bind_anim(AnimControl *control, AnimBundle *anim,
                  subset.is_include_empty(), bound_joints, subset);
   control->setup_anim(this, anim, channel_index, bound_joints);
 
-  determine_effective_channels(cdata);
+  if (cdata->_blend.find(control) != cdata->_blend.end()) {
+    // The control was already given an effect while it was pending; now that
+    // it has become live, the parts need to be recomputed.
+    CDWriter cdataw(_cycler, cdata, false);
+    cdataw->_anim_changed = true;
+    determine_effective_channels(cdataw);
+  } else {
+    determine_effective_channels(cdata);
+  }
 
   return true;
 }
@@ -740,7 +844,7 @@ void PartBundle::
 finalize(BamReader *) {
   Thread *current_thread = Thread::get_current_thread();
   CDWriter cdata(_cycler, true);
-  do_update(this, cdata, nullptr, true, true, current_thread);
+  do_update(this, cdata, nullptr, 0, true, true, current_thread);
 }
 
 /**
@@ -823,6 +927,7 @@ CData() {
   _last_control_set = nullptr;
   _anim_changed = false;
   _last_update = 0.0;
+  _lod_joint_depth = -1;
 }
 
 /**
@@ -837,7 +942,8 @@ CData(const PartBundle::CData &copy) :
   _last_control_set(copy._last_control_set),
   _blend(copy._blend),
   _anim_changed(copy._anim_changed),
-  _last_update(copy._last_update)
+  _last_update(copy._last_update),
+  _lod_joint_depth(copy._lod_joint_depth)
 {
   // Note that this copy constructor is not used by the PartBundle copy
   // constructor!  Any elements that must be copied between PartBundles should
@@ -34,6 +34,7 @@
 
 class Loader;
 class AnimBundle;
+class AnimControlCollection;
 class PartBundleNode;
 class PartBundleNode;
 class TransformState;
@@ -104,6 +105,13 @@ PUBLISHED:
   INLINE void set_frame_blend_flag(bool frame_blend_flag);
   INLINE bool get_frame_blend_flag() const;
 
+  void set_lod_joint_depth(int depth,
+                           Thread *current_thread = Thread::get_current_thread());
+  INLINE int get_lod_joint_depth() const;
+
+  INLINE void set_lod_frame_blend_flag(bool lod_frame_blend_flag);
+  INLINE bool get_lod_frame_blend_flag() const;
+
   INLINE void set_root_xform(const LMatrix4 &root_xform);
   INLINE void xform(const LMatrix4 &mat);
   INLINE const LMatrix4 &get_root_xform() const;
@@ -116,6 +124,9 @@ PUBLISHED:
   MAKE_PROPERTY(blend_type, get_blend_type, set_blend_type);
   MAKE_PROPERTY(anim_blend_flag, get_anim_blend_flag, set_anim_blend_flag);
   MAKE_PROPERTY(frame_blend_flag, get_frame_blend_flag, set_frame_blend_flag);
+  MAKE_PROPERTY(lod_joint_depth, get_lod_joint_depth, set_lod_joint_depth);
+  MAKE_PROPERTY(lod_frame_blend_flag, get_lod_frame_blend_flag,
+                set_lod_frame_blend_flag);
   MAKE_PROPERTY(root_xform, get_root_xform, set_root_xform);
   MAKE_SEQ_PROPERTY(nodes, get_num_nodes, get_node);
 
@@ -134,6 +145,10 @@ PUBLISHED:
                                  int hierarchy_match_flags,
                                  const PartSubset &subset,
                                  bool allow_async);
+  int load_bind_anims(Loader *loader, const Filename &directory,
+                      AnimControlCollection &controls,
+                      int hierarchy_match_flags = 0,
+                      const PartSubset &subset = PartSubset());
   void wait_pending();
 
   bool freeze_joint(const std::string &joint_name, const TransformState *transform);
@@ -175,6 +190,7 @@ private:
   AppliedTransforms _applied_transforms;
 
   double _update_delay;
+  bool _lod_frame_blend_flag;
 
   // This is the data that must be cycled between pipeline stages.
   class CData : public CycleData {
@@ -197,6 +213,7 @@ private:
     ChannelBlend _blend;
     bool _anim_changed;
     double _last_update;
+    int _lod_joint_depth;
   };
 
   PipelineCycler<CData> _cycler;
@@ -464,16 +464,20 @@ check_hierarchy(const AnimGroup *anim, const PartGroup *,
  * current frame.  This is not really public and is not intended to be called
  * directly; it is called from the top of the tree by PartBundle::update().
  *
+ * depth is the number of MovingParts above this one in the hierarchy; see
+ * PartBundle::set_lod_joint_depth().
+ *
  * The return value is true if any part has changed, false otherwise.
  */
 bool PartGroup::
 do_update(PartBundle *root, const CycleData *root_cdata, PartGroup *,
-          bool parent_changed, bool anim_changed, Thread *current_thread) {
+          int depth, bool parent_changed, bool anim_changed,
+          Thread *current_thread) {
   bool any_changed = false;
 
   Children::iterator ci;
   for (ci = _children.begin(); ci != _children.end(); ++ci) {
-    if ((*ci)->do_update(root, root_cdata, this, parent_changed,
+    if ((*ci)->do_update(root, root_cdata, this, depth, parent_changed,
                          anim_changed, current_thread)) {
       any_changed = true;
     }
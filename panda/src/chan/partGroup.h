@@ -94,7 +94,7 @@ public:
                        int hierarchy_match_flags = 0) const;
 
   virtual bool do_update(PartBundle *root, const CycleData *root_cdata,
-                         PartGroup *parent, bool parent_changed,
+                         PartGroup *parent, int depth, bool parent_changed,
                          bool anim_changed, Thread *current_thread);
   virtual void do_xform(const LMatrix4 &mat, const LMatrix4 &inv_mat);
   virtual void determine_effective_channels(const CycleData *root_cdata);
@@ -45,7 +45,10 @@ Character(const Character &copy, bool copy_bundles) :
   _lod_far_distance(copy._lod_far_distance),
   _lod_near_distance(copy._lod_near_distance),
   _lod_delay_factor(copy._lod_delay_factor),
+  _lod_joint_depth(copy._lod_joint_depth),
+  _lod_current_joint_depth(-1),
   _do_lod_animation(copy._do_lod_animation),
+  _batch_update(false),
   _joints_pcollector(copy._joints_pcollector),
   _skinning_pcollector(copy._skinning_pcollector)
 {
@@ -78,6 +81,8 @@ Character(const std::string &name) :
   _last_auto_update(-1.0),
   _view_frame(-1),
   _view_distance2(0.0f),
+  _lod_current_joint_depth(-1),
+  _batch_update(false),
   _joints_pcollector(PStatCollector(_animation_pcollector, name), "Joints"),
   _skinning_pcollector(PStatCollector(_animation_pcollector, name), "Vertices")
 {
@@ -182,12 +187,16 @@ cull_callback(CullTraverser *trav, CullTraverserData &data) {
       // Now compute the lod delay.
       PN_stdfloat dist = sqrt(dist2);
       double delay = 0.0;
-      if (dist > _lod_near_distance) {
+      if (dist > _lod_near_distance && _lod_delay_factor > 0.0) {
         delay = _lod_delay_factor * (dist - _lod_near_distance) / (_lod_far_distance - _lod_near_distance);
         nassertr(delay > 0.0, false);
       }
       set_lod_current_delay(delay);
 
+      if (_lod_joint_depth >= 0) {
+        set_lod_current_joint_depth(dist >= _lod_far_distance ? _lod_joint_depth : -1);
+      }
+
       if (char_cat.is_spam()) {
         char_cat.spam()
           << "Distance to " << NodePath::any_path(this) << " in frame "
@@ -288,6 +297,9 @@ merge_bundles(PartBundleHandle *old_bundle_handle,
  *
  * If multiple cameras are viewing the character in any given frame, the
  * closest one counts.
+ *
+ * See also set_lod_joint_depth(), to stop animating the smaller joints of a
+ * distant character altogether, and PartBundle::set_lod_frame_blend_flag().
  */
 void Character::
 set_lod_animation(const LPoint3 &center,
@@ -299,9 +311,11 @@ set_lod_animation(const LPoint3 &center,
   _lod_far_distance = far_distance;
   _lod_near_distance = near_distance;
   _lod_delay_factor = delay_factor;
-  _do_lod_animation = (_lod_far_distance > _lod_near_distance && _lod_delay_factor > 0.0);
+  _do_lod_animation = (_lod_far_distance > _lod_near_distance &&
+                       (_lod_delay_factor > 0.0 || _lod_joint_depth >= 0));
   if (!_do_lod_animation) {
     set_lod_current_delay(0.0);
+    set_lod_current_joint_depth(-1);
   }
 }
 
@@ -316,8 +330,30 @@ clear_lod_animation() {
   _lod_far_distance = 0.0f;
   _lod_near_distance = 0.0f;
   _lod_delay_factor = 0.0f;
+  _lod_joint_depth = -1;
   _do_lod_animation = false;
   set_lod_current_delay(0.0);
+  set_lod_current_joint_depth(-1);
+}
+
+/**
+ * Further reduces the cost of animating the character when it is at least as
+ * far away as the far_distance given to set_lod_animation(): beyond that
+ * distance, only the joints that are no more than far_depth levels below the
+ * root joint are animated.  The deeper joints, such as fingers and facial
+ * joints, hold their last pose until the character comes closer again.
+ *
+ * A value of -1 animates all of the joints at any distance.  This has no
+ * effect unless set_lod_animation() has also been called.
+ */
+void Character::
+set_lod_joint_depth(int far_depth) {
+  _lod_joint_depth = std::max(far_depth, -1);
+  _do_lod_animation = (_lod_far_distance > _lod_near_distance &&
+                       (_lod_delay_factor > 0.0 || _lod_joint_depth >= 0));
+  if (_lod_joint_depth < 0 || !_do_lod_animation) {
+    set_lod_current_joint_depth(-1);
+  }
 }
 
 /**
@@ -429,8 +465,11 @@ force_update() {
   PStatTimer timer(_joints_pcollector);
 
   // Update all the joints and sliders.
+  Thread *current_thread = Thread::get_current_thread();
   for (PartBundleHandle *handle : _bundles) {
-    handle->get_bundle()->force_update();
+    PartBundle *bundle = handle->get_bundle();
+    bundle->set_lod_joint_depth(_lod_current_joint_depth, current_thread);
+    bundle->force_update();
   }
 }
 
@@ -541,6 +580,14 @@ get_rel_transform(CullTraverser *trav, CullTraverserData &data) {
  */
 void Character::
 do_update() {
+  // The joint depth chosen by the cull traversal is applied here, in the
+  // same pipeline stage as the update itself.
+  Thread *current_thread = Thread::get_current_thread();
+  for (PartBundleHandle *handle : _bundles) {
+    handle->get_bundle()->set_lod_joint_depth(_lod_current_joint_depth,
+                                              current_thread);
+  }
+
   // Update all the joints and sliders.
   if (even_animation) {
     for (PartBundleHandle *handle : _bundles) {
@@ -565,6 +612,17 @@ set_lod_current_delay(double delay) {
   }
 }
 
+/**
+ * Changes the depth of the joint hierarchy that is animated, due to the LOD
+ * animation setting.  This may be called from the cull traversal; the new
+ * depth is passed on to the bundles by the next update().
+ */
+void Character::
+set_lod_current_joint_depth(int depth) {
+  LightMutexHolder holder(_lock);
+  _lod_current_joint_depth = depth;
+}
+
 /**
  * After the joint hierarchy has already been copied from the indicated
  * hierarchy, this recursively walks through the joints and builds up a
@@ -66,6 +66,8 @@ PUBLISHED:
                          PN_stdfloat far_distance, PN_stdfloat near_distance,
                          PN_stdfloat delay_factor);
   void clear_lod_animation();
+  void set_lod_joint_depth(int far_depth);
+  INLINE int get_lod_joint_depth() const;
 
   CharacterJoint *find_joint(const std::string &name) const;
   CharacterSlider *find_slider(const std::string &name) const;
@@ -87,6 +89,7 @@ protected:
 private:
   void do_update();
   void set_lod_current_delay(double delay);
+  void set_lod_current_joint_depth(int depth);
 
   typedef pmap<const PandaNode *, PandaNode *> NodeMap;
   typedef pmap<const PartGroup *, PartGroup *> JointMap;
@@ -138,8 +141,16 @@ private:
   PN_stdfloat _lod_far_distance;
   PN_stdfloat _lod_near_distance;
   PN_stdfloat _lod_delay_factor;
+  int _lod_joint_depth;
+
+  // The joint depth most recently chosen by the LOD animation setting, to be
+  // applied to the bundles at the next update.  Protected by _lock.
+  int _lod_current_joint_depth;
   bool _do_lod_animation;
 
+  // True while a CharacterPoseBatch is updating the character.
+  bool _batch_update;
+
   // Statistics
   PStatCollector _joints_pcollector;
   PStatCollector _skinning_pcollector;
@@ -174,6 +185,9 @@ public:
 
 private:
   static TypeHandle _type_handle;
+
+  friend class CharacterJoint;
+  friend class CharacterPoseBatch;
 };
 
 #include "character.I"
@@ -12,6 +12,7 @@
  */
 
 #include "characterJoint.h"
+#include "character.h"
 #include "config_char.h"
 #include "jointVertexTransform.h"
 #include "characterJointEffect.h"
@@ -27,7 +28,9 @@ TypeHandle CharacterJoint::_type_handle;
  */
 CharacterJoint::
 CharacterJoint() :
-  _character(nullptr)
+  _character(nullptr),
+  _batch_self_changed(false),
+  _batch_net_changed(false)
 {
 }
 
@@ -40,7 +43,9 @@ CharacterJoint(const CharacterJoint &copy) :
   _character(nullptr),
   _net_transform(copy._net_transform),
   _initial_net_transform_inverse(copy._initial_net_transform_inverse),
-  _skinning_matrix(copy._skinning_matrix)
+  _skinning_matrix(copy._skinning_matrix),
+  _batch_self_changed(false),
+  _batch_net_changed(false)
 {
   // We don't copy the sets of transform nodes.
 }
@@ -53,7 +58,9 @@ CharacterJoint(Character *character,
                PartBundle *root, PartGroup *parent, const std::string &name,
                const LMatrix4 &default_value) :
   MovingPartMatrix(parent, name, default_value),
-  _character(character)
+  _character(character),
+  _batch_self_changed(false),
+  _batch_net_changed(false)
 {
   Thread *current_thread = Thread::get_current_thread();
 
@@ -116,22 +123,45 @@ update_internals(PartBundle *root, PartGroup *parent, bool self_changed,
   if (parent->is_character_joint()) {
     // The joint is not a toplevel joint; its parent therefore affects its net
     // transform.
-    if (parent_changed || self_changed) {
-      CharacterJoint *parent_joint = DCAST(CharacterJoint, parent);
-
-      _net_transform = _value * parent_joint->_net_transform;
-      net_changed = true;
-    }
-
+    net_changed = (parent_changed || self_changed);
   } else {
     // The joint is a toplevel joint, so therefore it gets its root transform
     // from the bundle.
-    if (self_changed) {
+    net_changed = self_changed;
+  }
+
+  if (_character != nullptr && _character->_batch_update) {
+    // A CharacterPoseBatch is updating this character; it will compute the
+    // net transform along with those of the other characters, and then call
+    // apply_transforms().
+    _batch_self_changed = _batch_self_changed || self_changed;
+    _batch_net_changed = _batch_net_changed || net_changed;
+    return self_changed || net_changed;
+  }
+
+  if (net_changed) {
+    if (parent->is_character_joint()) {
+      CharacterJoint *parent_joint = DCAST(CharacterJoint, parent);
+      _net_transform = _value * parent_joint->_net_transform;
+    } else {
       _net_transform = _value * root->get_root_xform();
-      net_changed = true;
     }
+
+    // Recompute the transform used by any vertices animated by this joint.
+    _skinning_matrix = _initial_net_transform_inverse * _net_transform;
   }
 
+  apply_transforms(self_changed, net_changed, current_thread);
+  return self_changed || net_changed;
+}
+
+/**
+ * Passes the new transforms of the joint on to the nodes and vertices that
+ * are animated by it, after the net transform and skinning matrix have been
+ * recomputed.
+ */
+void CharacterJoint::
+apply_transforms(bool self_changed, bool net_changed, Thread *current_thread) {
   if (net_changed) {
     if (!_net_transform_nodes.empty()) {
       CPT(TransformState) t = TransformState::make_mat(_net_transform);
@@ -145,10 +175,7 @@ update_internals(PartBundle *root, PartGroup *parent, bool self_changed,
       }
     }
 
-    // Recompute the transform used by any vertices animated by this joint.
-    _skinning_matrix = _initial_net_transform_inverse * _net_transform;
-
-    // Also tell our related JointVertexTransforms that we've changed their
+    // Tell our related JointVertexTransforms that we've changed their
     // underlying matrix.
     VertexTransforms::iterator vti;
     for (vti = _vertex_transforms.begin(); vti != _vertex_transforms.end(); ++vti) {
@@ -167,8 +194,6 @@ update_internals(PartBundle *root, PartGroup *parent, bool self_changed,
       node->set_transform(t, current_thread);
     }
   }
-
-  return self_changed || net_changed;
 }
 
 /**
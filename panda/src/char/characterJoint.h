@@ -73,6 +73,8 @@ PUBLISHED:
 
 private:
   void set_character(Character *character);
+  void apply_transforms(bool self_changed, bool net_changed,
+                        Thread *current_thread);
 
 private:
   // Not a reference-counted pointer.
@@ -115,6 +117,11 @@ public:
   // animated position.
   LMatrix4 _skinning_matrix;
 
+  // These are set while a CharacterPoseBatch is updating the character, to
+  // record which joints need to have their net transforms recomputed.
+  bool _batch_self_changed;
+  bool _batch_net_changed;
+
 public:
   virtual TypeHandle get_type() const {
     return get_class_type();
@@ -135,6 +142,7 @@ private:
   friend class Character;
   friend class CharacterJointBundle;
   friend class JointVertexTransform;
+  friend class CharacterPoseBatch;
 };
 
 #include "characterJoint.I"
@@ -0,0 +1,270 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file characterPoseBatch.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "characterPoseBatch.h"
+#include "characterJointBundle.h"
+#include "config_char.h"
+#include "pStatTimer.h"
+#include "workerThreadPool.h"
+
+#if !defined(STDFLOAT_DOUBLE) && (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <xmmintrin.h>
+#define POSE_BATCH_SSE 1
+#endif
+
+PStatCollector CharacterPoseBatch::_batch_pcollector("*:Animation:Batch");
+
+/**
+ * Computes result = a * b.  result must not be the same matrix as a or b.
+ */
+static INLINE void
+mult_matrix(LMatrix4 &result, const LMatrix4 &a, const LMatrix4 &b) {
+#ifdef POSE_BATCH_SSE
+  const float *ap = a.get_data();
+  const float *bp = b.get_data();
+  float *rp = &result(0, 0);
+
+  __m128 b0 = _mm_loadu_ps(bp);
+  __m128 b1 = _mm_loadu_ps(bp + 4);
+  __m128 b2 = _mm_loadu_ps(bp + 8);
+  __m128 b3 = _mm_loadu_ps(bp + 12);
+
+  for (int i = 0; i < 16; i += 4) {
+    __m128 r01 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ap[i]), b0),
+                            _mm_mul_ps(_mm_set1_ps(ap[i + 1]), b1));
+    __m128 r23 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ap[i + 2]), b2),
+                            _mm_mul_ps(_mm_set1_ps(ap[i + 3]), b3));
+    _mm_storeu_ps(rp + i, _mm_add_ps(r01, r23));
+  }
+#else
+  result.multiply(a, b);
+#endif
+}
+
+/**
+ *
+ */
+CharacterPoseBatch::
+CharacterPoseBatch() {
+}
+
+/**
+ *
+ */
+CharacterPoseBatch::
+~CharacterPoseBatch() {
+}
+
+/**
+ * Adds the indicated character to the batch.  It has no effect if the
+ * character has already been added.
+ */
+void CharacterPoseBatch::
+add_character(Character *character) {
+  nassertv(character != nullptr);
+  for (Character *other : _characters) {
+    if (other == character) {
+      return;
+    }
+  }
+  _characters.push_back(character);
+  rebuild();
+}
+
+/**
+ * Removes the indicated character from the batch.  Returns true if it was
+ * removed, false if it was not part of the batch.
+ */
+bool CharacterPoseBatch::
+remove_character(Character *character) {
+  Characters::iterator ci;
+  for (ci = _characters.begin(); ci != _characters.end(); ++ci) {
+    if ((*ci) == character) {
+      _characters.erase(ci);
+      rebuild();
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Removes all of the characters from the batch.
+ */
+void CharacterPoseBatch::
+clear_characters() {
+  _characters.clear();
+  rebuild();
+}
+
+/**
+ * Flattens the joint hierarchies of all of the characters again.  This must
+ * be called if the set of joints or bundles of any of the characters changes
+ * after it has been added to the batch.
+ */
+void CharacterPoseBatch::
+rebuild() {
+  _joints.clear();
+  _parents.clear();
+  _bundles.clear();
+  _root_xforms.clear();
+  _bundle_ptrs.clear();
+  _char_ends.clear();
+
+  for (Character *character : _characters) {
+    int num_bundles = character->get_num_bundles();
+    for (int i = 0; i < num_bundles; ++i) {
+      PartBundle *bundle = character->get_bundle(i);
+      if (std::find(_bundle_ptrs.begin(), _bundle_ptrs.end(), bundle) != _bundle_ptrs.end()) {
+        // This bundle is shared with a character we have already added.  Its
+        // joints must only be computed once, or two threads would end up
+        // writing to them at the same time.
+        continue;
+      }
+      int bundle_index = (int)_bundle_ptrs.size();
+      _bundle_ptrs.push_back(bundle);
+      _root_xforms.push_back(LMatrix4::ident_mat());
+      r_flatten(bundle, -1, bundle_index);
+    }
+    _char_ends.push_back((int)_joints.size());
+  }
+}
+
+/**
+ * Updates the joints of all of the characters in the batch, if their
+ * animations have changed since the last time they were updated.  Like
+ * Character::update(), this does nothing for a character that has already
+ * been updated this frame.
+ */
+void CharacterPoseBatch::
+update() {
+  do_update(false);
+}
+
+/**
+ * Recomputes the joints of all of the characters in the batch, whether or not
+ * their animations have changed.
+ */
+void CharacterPoseBatch::
+force_update() {
+  do_update(true);
+}
+
+/**
+ * The implementation of update() and force_update().
+ */
+void CharacterPoseBatch::
+do_update(bool force) {
+  Thread *current_thread = Thread::get_current_thread();
+  PStatTimer timer(_batch_pcollector, current_thread);
+
+  // First, let each character evaluate its animation channels.  The joints
+  // note which of them have changed, but leave the computation of their net
+  // transforms to us.
+  for (Character *character : _characters) {
+    character->_batch_update = true;
+    if (force) {
+      character->force_update();
+    } else {
+      character->update();
+    }
+    character->_batch_update = false;
+  }
+
+  for (size_t bi = 0; bi < _bundle_ptrs.size(); ++bi) {
+    _root_xforms[bi] = _bundle_ptrs[bi]->get_root_xform();
+  }
+
+  // Now compute the net transforms of all the joints, one character per
+  // thread if we are running in parallel.
+  int num_characters = (int)_char_ends.size();
+  WorkerThreadPool *pool = nullptr;
+  if (parallel_pose_batch && num_characters > 1) {
+    pool = WorkerThreadPool::get_global_ptr();
+    if (pool->get_num_threads() == 0) {
+      pool = nullptr;
+    }
+  }
+
+  if (pool != nullptr) {
+    pool->parallel_for(num_characters, [this] (size_t i, Thread *) {
+      compute_joints(i == 0 ? 0 : _char_ends[i - 1], _char_ends[i]);
+    }, current_thread);
+  } else {
+    compute_joints(0, (int)_joints.size());
+  }
+
+  apply_joints(current_thread);
+}
+
+/**
+ * Recursively adds the joints below the indicated group to the flattened
+ * arrays.  parent is the index of the nearest joint above the group, if the
+ * group is itself a joint, or -1.
+ */
+void CharacterPoseBatch::
+r_flatten(PartGroup *group, int parent, int bundle) {
+  int num_children = group->get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    PartGroup *child = group->get_child(i);
+    if (child->is_character_joint()) {
+      int index = (int)_joints.size();
+      _joints.push_back(DCAST(CharacterJoint, child));
+      _parents.push_back(parent);
+      _bundles.push_back(bundle);
+      r_flatten(child, index, bundle);
+    } else {
+      // A joint whose immediate parent is not a joint is a toplevel joint.
+      r_flatten(child, -1, bundle);
+    }
+  }
+}
+
+/**
+ * Computes the net transform and skinning matrix of each of the joints in the
+ * indicated range whose transform has changed.  Since each joint appears after
+ * its parent, the parent's net transform is always up-to-date by the time the
+ * joint is reached.
+ */
+void CharacterPoseBatch::
+compute_joints(int begin, int end) {
+  for (int j = begin; j < end; ++j) {
+    CharacterJoint *joint = _joints[j];
+    if (!joint->_batch_net_changed) {
+      continue;
+    }
+
+    int parent = _parents[j];
+    const LMatrix4 &parent_net = (parent >= 0) ? _joints[parent]->_net_transform : _root_xforms[_bundles[j]];
+    mult_matrix(joint->_net_transform, joint->get_transform(), parent_net);
+    mult_matrix(joint->_skinning_matrix, joint->_initial_net_transform_inverse,
+                joint->_net_transform);
+  }
+}
+
+/**
+ * Passes the new joint transforms on to the nodes and vertices that they
+ * animate.  This is done in the calling thread, after all the transforms have
+ * been computed.
+ */
+void CharacterPoseBatch::
+apply_joints(Thread *current_thread) {
+  for (CharacterJoint *joint : _joints) {
+    if (joint->_batch_self_changed || joint->_batch_net_changed) {
+      joint->apply_transforms(joint->_batch_self_changed,
+                              joint->_batch_net_changed, current_thread);
+      joint->_batch_self_changed = false;
+      joint->_batch_net_changed = false;
+    }
+  }
+}
@@ -0,0 +1,93 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file characterPoseBatch.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef CHARACTERPOSEBATCH_H
+#define CHARACTERPOSEBATCH_H
+
+#include "pandabase.h"
+#include "character.h"
+#include "characterJoint.h"
+#include "referenceCount.h"
+#include "pointerTo.h"
+#include "pvector.h"
+#include "vector_int.h"
+#include "pStatCollector.h"
+
+/**
+ * Updates the joints of many characters at once.  This is an alternative to
+ * letting each Character update itself as it is culled, for scenes with large
+ * crowds of animated characters.
+ *
+ * The animation channels of each character are still evaluated by its
+ * PartBundle, but the net transforms and skinning matrices of all of the
+ * joints are then computed in a single pass over flat arrays, in which each
+ * joint refers to its parent by index.  If parallel-pose-batch is true, the
+ * characters are divided among the threads of the WorkerThreadPool for this
+ * pass.
+ *
+ * The joint hierarchies are flattened when the characters are added; call
+ * rebuild() if joints are added to or removed from a character after that.
+ * Characters that share their bundles, such as instanced copies of the same
+ * character, are only posed once.
+ */
+class EXPCL_PANDA_CHAR CharacterPoseBatch : public ReferenceCount {
+PUBLISHED:
+  CharacterPoseBatch();
+  ~CharacterPoseBatch();
+
+  void add_character(Character *character);
+  bool remove_character(Character *character);
+  void clear_characters();
+  INLINE int get_num_characters() const;
+  INLINE Character *get_character(int n) const;
+  MAKE_SEQ(get_characters, get_num_characters, get_character);
+
+  INLINE int get_num_joints() const;
+
+  void rebuild();
+
+  void update();
+  void force_update();
+
+  MAKE_SEQ_PROPERTY(characters, get_num_characters, get_character);
+  MAKE_PROPERTY(num_joints, get_num_joints);
+
+private:
+  void do_update(bool force);
+  void r_flatten(PartGroup *group, int parent, int bundle);
+  void compute_joints(int begin, int end);
+  void apply_joints(Thread *current_thread);
+
+  typedef pvector<PT(Character)> Characters;
+  Characters _characters;
+
+  // The joints of all of the characters, in an order in which each joint
+  // appears after its parent.  _parents holds the index of each joint's
+  // parent joint, or -1 if it is a toplevel joint, and _bundles the index
+  // into _root_xforms of the bundle the joint belongs to.  Each bundle
+  // appears only once, even if it is shared by several characters.
+  pvector<PT(CharacterJoint)> _joints;
+  vector_int _parents;
+  vector_int _bundles;
+  pvector<LMatrix4> _root_xforms;
+  pvector<PT(PartBundle)> _bundle_ptrs;
+
+  // The range of _joints that belongs to each character.
+  vector_int _char_ends;
+
+  static PStatCollector _batch_pcollector;
+};
+
+#include "characterPoseBatch.I"
+
+#endif
@@ -40,6 +40,12 @@ ConfigVariableBool even_animation
           "The default is to compute vertices only when they need to be "
           "computed, which can lead to an uneven frame rate."));
 
+ConfigVariableBool parallel_pose_batch
+("parallel-pose-batch", false,
+ PRC_DESC("When this is true, CharacterPoseBatch divides the computation of "
+          "the joint transforms of its characters among the threads of the "
+          "worker thread pool.  See worker-threads."));
+
 
 /**
  * Initializes the library.  This must be called at least once before any of
@@ -1,4 +1,5 @@
 #include "characterJointEffect.cxx"
+#include "characterPoseBatch.cxx"
 #include "characterSlider.cxx"
 #include "characterVertexSlider.cxx"
 #include "jointVertexTransform.cxx"
@@ -29,6 +29,14 @@
 ConfigureDef(config_cull);
 NotifyCategoryDef(cull, "");
 
+ConfigVariableInt cull_bin_radix_sort_threshold
+("cull-bin-radix-sort-threshold", 256,
+ PRC_DESC("The sorted cull bins (state-sorted, back-to-front and front-to-back) "
+          "will use a radix sort instead of a comparison sort when they "
+          "contain at least this many objects.  The radix sort is much faster "
+          "for large bins, but has a fixed overhead that makes it slower "
+          "for small ones.  Set this to -1 to disable the radix sort."));
+
 ConfigureFn(config_cull) {
   init_libcull();
 }
@@ -26,6 +26,8 @@ class DSearchPath;
 ConfigureDecl(config_cull, EXPCL_PANDA_CULL, EXPTP_PANDA_CULL);
 NotifyCategoryDecl(cull, EXPCL_PANDA_CULL, EXPTP_PANDA_CULL);
 
+extern ConfigVariableInt cull_bin_radix_sort_threshold;
+
 extern EXPCL_PANDA_CULL void init_libcull();
 
 #endif
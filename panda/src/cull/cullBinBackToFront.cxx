@@ -17,6 +17,7 @@
 #include "cullableObject.h"
 #include "cullHandler.h"
 #include "pStatTimer.h"
+#include "config_cull.h"
 
 #include <algorithm>
 
@@ -63,7 +64,13 @@ add_object(CullableObject *object, Thread *current_thread) {
 void CullBinBackToFront::
 finish_cull(SceneSetup *, Thread *current_thread) {
   PStatTimer timer(_cull_this_pcollector, current_thread);
-  sort(_objects.begin(), _objects.end());
+  if (cull_bin_radix_sort_threshold >= 0 &&
+      _objects.size() >= (size_t)cull_bin_radix_sort_threshold) {
+    Objects scratch(_objects.size());
+    radix_sort(_objects.data(), scratch.data(), _objects.size());
+  } else {
+    sort(_objects.begin(), _objects.end());
+  }
 }
 
 /**
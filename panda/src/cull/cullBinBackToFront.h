@@ -21,6 +21,7 @@
 #include "transformState.h"
 #include "renderState.h"
 #include "pointerTo.h"
+#include "radixSort.h"
 
 /**
  * A specific kind of CullBin that sorts geometry in order from furthest to
@@ -49,11 +50,13 @@ protected:
 private:
   class ObjectData {
   public:
+    ObjectData() = default;
     INLINE ObjectData(CullableObject *object, PN_stdfloat dist);
     INLINE bool operator < (const ObjectData &other) const;
 
     CullableObject *_object;
     PN_stdfloat _dist;
+    uint64_t _sort_key;
   };
 
   typedef pvector<ObjectData> Objects;
@@ -16,6 +16,9 @@
 #include "cullableObject.h"
 #include "cullHandler.h"
 #include "pStatTimer.h"
+#include "radixSort.h"
+#include "simpleHashMap.h"
+#include "config_cull.h"
 
 #include <algorithm>
 
@@ -47,9 +50,107 @@ add_object(CullableObject *object, Thread *current_thread) {
 void CullBinStateSorted::
 finish_cull(SceneSetup *, Thread *current_thread) {
   PStatTimer timer(_cull_this_pcollector, current_thread);
-  sort(_objects.begin(), _objects.end());
+  if (cull_bin_radix_sort_threshold >= 0 &&
+      _objects.size() >= (size_t)cull_bin_radix_sort_threshold &&
+      make_sort_keys()) {
+    Objects scratch(get_class_type());
+    scratch.resize(_objects.size());
+    radix_sort(_objects.data(), scratch.data(), _objects.size());
+  } else {
+    sort(_objects.begin(), _objects.end());
+  }
 }
 
+/**
+ * Fills in the _sort_key of each object, so that sorting the objects by key
+ * groups them in nearly the same way as sorting them with operator <.  The
+ * states are ordered by RenderState::compare_sort(), but the formats, vertex
+ * data and transforms are merely grouped together, in order of first
+ * appearance, rather than sorted by pointer.
+ *
+ * Returns false if there are too many distinct values of any of these to fit
+ * in the key, in which case the objects must be sorted with operator <.
+ */
+bool CullBinStateSorted::
+make_sort_keys() {
+  // The number of bits of the key given to each part.
+  static const int state_bits = 20;
+  static const int format_bits = 6;
+  static const int munged_data_bits = 20;
+  static const int transform_bits = 18;
+  static const int transform_shift = 0;
+  static const int munged_data_shift = transform_shift + transform_bits;
+  static const int format_shift = munged_data_shift + munged_data_bits;
+  static const int state_shift = format_shift + format_bits;
+
+  typedef SimpleHashMap<const void *, std::nullptr_t, pointer_hash> Ids;
+  Ids states, formats, munged_datas, transforms;
+
+  // The index of each value in the hash map is the order in which it was
+  // first seen, which is what we store in the key for now.
+  for (ObjectData &data : _objects) {
+    CullableObject *object = data._object;
+    uint64_t key = 0;
+
+    int index = states.find(object->_state);
+    if (index < 0) {
+      index = states.store(object->_state, nullptr);
+    }
+    key |= (uint64_t)index << state_shift;
+
+    index = formats.find(data._format);
+    if (index < 0) {
+      index = formats.store(data._format, nullptr);
+    }
+    key |= (uint64_t)index << format_shift;
+
+    index = munged_datas.find(object->_munged_data);
+    if (index < 0) {
+      index = munged_datas.store(object->_munged_data, nullptr);
+    }
+    key |= (uint64_t)index << munged_data_shift;
+
+    index = transforms.find(object->_internal_transform);
+    if (index < 0) {
+      index = transforms.store(object->_internal_transform, nullptr);
+    }
+    key |= (uint64_t)index << transform_shift;
+
+    data._sort_key = key;
+  }
+
+  size_t num_states = states.get_num_entries();
+  if (num_states > ((size_t)1 << state_bits) ||
+      formats.get_num_entries() > ((size_t)1 << format_bits) ||
+      munged_datas.get_num_entries() > ((size_t)1 << munged_data_bits) ||
+      transforms.get_num_entries() > ((size_t)1 << transform_bits)) {
+    return false;
+  }
+
+  // Now sort the distinct states, of which there are usually far fewer than
+  // there are objects, and replace each state's index with its rank.
+  pvector<int> order(num_states);
+  for (size_t i = 0; i < num_states; ++i) {
+    order[i] = (int)i;
+  }
+  std::sort(order.begin(), order.end(), [&](int a, int b) {
+    const RenderState *sa = (const RenderState *)states.get_key(a);
+    const RenderState *sb = (const RenderState *)states.get_key(b);
+    return sa->compare_sort(*sb) < 0;
+  });
+
+  pvector<uint64_t> ranks(num_states);
+  for (size_t i = 0; i < num_states; ++i) {
+    ranks[order[i]] = (uint64_t)i << state_shift;
+  }
+
+  static const uint64_t state_mask = ~(uint64_t)0 << state_shift;
+  for (ObjectData &data : _objects) {
+    uint64_t key = data._sort_key;
+    data._sort_key = ranks[key >> state_shift] | (key & ~state_mask);
+  }
+  return true;
+}
 
 /**
  * Draws all the geoms in the bin, in the appropriate order.
@@ -50,13 +50,17 @@ protected:
   virtual void fill_result_graph(ResultGraphBuilder &builder);
 
 private:
+  bool make_sort_keys();
+
   class ObjectData {
   public:
+    ObjectData() = default;
     INLINE ObjectData(CullableObject *object);
     INLINE bool operator < (const ObjectData &other) const;
 
     CullableObject *_object;
     const GeomVertexFormat *_format;
+    uint64_t _sort_key;
   };
 
   typedef pvector<ObjectData> Objects;
@@ -0,0 +1,37 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file radixSort.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef RADIXSORT_H
+#define RADIXSORT_H
+
+#include "pandabase.h"
+#include "numeric_types.h"
+
+/**
+ * Sorts the indicated array of elements in ascending order of their
+ * _sort_key member, which must be a uint64_t.  This is a stable least-
+ * significant-digit radix sort, which is considerably faster than
+ * std::sort() for large arrays, since it never needs to look at anything
+ * other than the key.  Digits that are the same for all elements are
+ * skipped.
+ *
+ * The scratch array must have room for at least size elements.
+ */
+template<class Element>
+void radix_sort(Element *data, Element *scratch, size_t size);
+
+INLINE uint64_t radix_sort_float_key(double value);
+
+#include "radixSort.I"
+
+#endif
@@ -859,6 +859,8 @@ render_frame() {
     CullTraverser::_geom_nodes_pcollector.clear_level();
     CullTraverser::_pgui_nodes_pcollector.clear_level();
     CullTraverser::_geoms_pcollector.clear_level();
+    CullTraverser::_nodes_reused_pcollector.clear_level();
+    CullTraverser::_nodes_recomputed_pcollector.clear_level();
     GeomCacheManager::_geom_cache_active_pcollector.clear_level();
     GeomCacheManager::_geom_cache_record_pcollector.clear_level();
     GeomCacheManager::_geom_cache_erase_pcollector.clear_level();
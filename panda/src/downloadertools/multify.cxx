@@ -47,6 +47,9 @@ bool got_header_prefix = false;
 Filename chdir_to;             // -C
 bool got_chdir_to = false;
 size_t scale_factor = 0;       // -F
+int num_threads = -1;          // -j
+CompressionCodec compression_codec = CC_zlib; // -Y
+bool got_compression_codec = false;
 pset<string> dont_compress;    // -Z
 pset<string> text_ext;         // -X
 vector_string sign_params;     // -S
@@ -199,6 +202,18 @@ help() {
     "      size of the Multifile will be limited to 4GB * scale_factor.  The size\n"
     "      of individual subfiles may not exceed 4GB in any case.\n\n"
 
+    "  -j <num_threads>\n"
+    "      Specify the number of threads used to compress and encrypt subfiles\n"
+    "      as they are written.  The resulting Multifile is the same regardless\n"
+    "      of the number of threads.  Specify 0 to use one thread per CPU.  The\n"
+    "      default is taken from the multifile-num-threads config variable.\n\n"
+
+    "  -Y <codec>\n"
+    "      Specify the compression codec used for subfiles compressed with -z;\n"
+    "      either zlib or zstd.  Multifiles containing zstd-compressed subfiles\n"
+    "      can only be read by a Panda3D that was built with zstd support.  The\n"
+    "      default is taken from the multifile-compression-codec config variable.\n\n"
+
     "  -C <extract_dir>\n"
 
     "      Change to the named directory before working on files;\n"
@@ -404,6 +419,14 @@ add_files(const vector_string &params) {
     multifile->set_header_prefix(header_prefix);
   }
 
+  if (num_threads >= 0) {
+    multifile->set_num_threads(num_threads);
+  }
+
+  if (got_compression_codec) {
+    multifile->set_compression_codec(compression_codec);
+  }
+
   if (scale_factor != 0 && scale_factor != multifile->get_scale_factor()) {
     cerr << "Setting scale factor to " << scale_factor << "\n";
     multifile->set_scale_factor(scale_factor);
@@ -808,7 +831,7 @@ main(int argc, char **argv) {
 
   extern char *optarg;
   extern int optind;
-  static const char *optflags = "crutxkvz123456789Z:T:X:S:f:OC:ep:P:F:h";
+  static const char *optflags = "crutxkvz123456789Z:T:X:S:f:OC:ep:P:F:j:Y:h";
   int flag = getopt(argc, argv, optflags);
   Filename rel_path;
   while (flag != EOF) {
@@ -934,6 +957,34 @@ main(int argc, char **argv) {
       }
       break;
 
+    case 'j':
+      if (!string_to_int(optarg, num_threads) || num_threads < 0) {
+        cerr << "Invalid number of threads: " << optarg << "\n";
+        usage();
+        return 1;
+      }
+      break;
+
+    case 'Y':
+      {
+        if (string(optarg) == "zlib") {
+          compression_codec = CC_zlib;
+        } else if (string(optarg) == "zstd") {
+          compression_codec = CC_zstd;
+        } else {
+          cerr << "Invalid compression codec: " << optarg << "\n";
+          usage();
+          return 1;
+        }
+        if (!is_compression_codec_available(compression_codec)) {
+          cerr << "This build does not support the " << compression_codec
+               << " compression codec.\n";
+          return 1;
+        }
+        got_compression_codec = true;
+      }
+      break;
+
     case 'h':
       help();
       return 1;
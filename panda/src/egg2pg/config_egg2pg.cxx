@@ -201,6 +201,13 @@ ConfigVariableBool egg_force_srgb_textures
           "their envtype is set to a non-color map.  Keep in mind that the "
           "model-cache must be cleared after changing this setting."));
 
+ConfigVariableBool egg_parallel_load
+("egg-parallel-load", true,
+ PRC_DESC("Set this true to divide the work of building the geometry of an "
+          "egg file between the threads of the worker thread pool (see "
+          "worker-threads).  The resulting scene graph is the same either "
+          "way; this only affects how long it takes to build."));
+
 ConfigureFn(config_egg2pg) {
   init_libegg2pg();
 }
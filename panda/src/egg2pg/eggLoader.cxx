@@ -78,6 +78,8 @@
 #include "collisionPlane.h"
 #include "collisionPolygon.h"
 #include "collisionFloorMesh.h"
+#include "workerThreadPool.h"
+#include "lightMutexHolder.h"
 #include "collisionBox.h"
 #include "parametricCurve.h"
 #include "nurbsCurve.h"
@@ -213,6 +215,9 @@ build_graph() {
     make_node(*ci, _root);
   }
 
+  // Now build the geometry for the polysets we encountered along the way.
+  build_pending_polysets();
+
   reparent_decals();
   start_sequences();
 
@@ -298,6 +303,12 @@ start_sequences() {
  * been grouped into a bin.  If transform is non-NULL, it represents the
  * transform to apply to the vertices (instead of the default transform based
  * on the bin's position within the hierarchy).
+ *
+ * Static polysets are not built right away, but are queued up to be built
+ * together, possibly in parallel, by build_pending_polysets().  The GeomNode
+ * that will receive them is created now, however, so that the order of the
+ * nodes in the scene graph does not depend on the order in which the polysets
+ * are finished.
  */
 void EggLoader::
 make_polyset(EggBin *egg_bin, PandaNode *parent, const LMatrix4d *transform,
@@ -323,11 +334,74 @@ make_polyset(EggBin *egg_bin, PandaNode *parent, const LMatrix4d *transform,
 
   // Generate an optimal vertex pool (or multiple vertex pools, if we have a
   // lot of vertex) for the polygons within just the bin.  Each EggVertexPool
-  // translates directly to an optimal GeomVertexData structure.
+  // translates directly to an optimal GeomVertexData structure.  This has to
+  // be done serially, since the vertices being copied may be shared with
+  // other bins.
   EggVertexPools vertex_pools;
   egg_bin->rebuild_vertex_pools(vertex_pools, (unsigned int)egg_max_vertices,
                                 false);
 
+  if (transform != nullptr || is_dynamic || character_maker != nullptr) {
+    // Polysets belonging to a character are built right away, since the
+    // CharacterMaker isn't prepared to be called from multiple threads.
+    PolysetGeoms geoms;
+    build_polyset(egg_bin, vertex_pools, render_state, transform, is_dynamic,
+                  character_maker, geoms);
+    add_polyset_geoms(egg_bin, parent, nullptr, render_state, vertex_pools,
+                      geoms);
+    return;
+  }
+
+  PendingPolyset pending;
+  pending._egg_bin = egg_bin;
+  pending._parent = parent;
+  pending._render_state = render_state;
+
+  // The vertices in the new pools are all our own now, except that a vertex
+  // with a group membership is also referenced by the group.  Those are rare
+  // outside of characters, but must not be touched by another thread.
+  pending._parallel = true;
+  EggVertexPools::const_iterator vpi;
+  for (vpi = vertex_pools.begin();
+       vpi != vertex_pools.end() && pending._parallel;
+       ++vpi) {
+    EggVertexPool::const_iterator vi;
+    for (vi = (*vpi)->begin(); vi != (*vpi)->end(); ++vi) {
+      if ((*vi)->gref_size() != 0) {
+        pending._parallel = false;
+        break;
+      }
+    }
+  }
+  pending._vertex_pools.swap(vertex_pools);
+
+  // Is our parent node a GeomNode, or just an ordinary PandaNode?  If it's a
+  // GeomNode, we can add the new Geoms directly to our parent; otherwise, we
+  // need to create a new node.  We create it now to hold its place among its
+  // siblings, and remove it again later if it ends up with no Geoms.
+  if (!parent->is_geom_node() || render_state->_hidden) {
+    pending._geom_node = new GeomNode(egg_bin->get_name());
+    if (render_state->_hidden) {
+      parent->add_stashed(pending._geom_node);
+    } else {
+      parent->add_child(pending._geom_node);
+    }
+  }
+
+  _pending_polysets.push_back(std::move(pending));
+}
+
+/**
+ * Does the work of make_polyset(), after the vertex pools have been rebuilt:
+ * fills geoms with the Geoms built from the primitives in the bin, along with
+ * the state each should be rendered with.  This may be called from a worker
+ * thread, as long as no other thread touches the bin or the vertex pools.
+ */
+void EggLoader::
+build_polyset(EggBin *egg_bin, EggVertexPools &vertex_pools,
+              const EggRenderState *render_state, const LMatrix4d *transform,
+              bool is_dynamic, CharacterMaker *character_maker,
+              PolysetGeoms &geoms) {
   if (egg_mesh) {
     // If we're using the mesher, mesh now.
     egg_bin->mesh_triangles(render_state->_flat_shaded ? EggGroupNode::T_flat_shaded : 0);
@@ -345,8 +419,6 @@ make_polyset(EggBin *egg_bin, PandaNode *parent, const LMatrix4d *transform,
 
   // egg_bin->write(cerr, 0);
 
-  PT(GeomNode) geom_node;
-
   // Now iterate through each EggVertexPool.  Normally, there's only one, but
   // if we have a really big mesh, it might have been split into multiple
   // vertex pools (to keep each one within the egg_max_vertices constraint).
@@ -384,6 +456,7 @@ make_polyset(EggBin *egg_bin, PandaNode *parent, const LMatrix4d *transform,
     // of primitives that reference this vertex pool.
     UniquePrimitives unique_primitives;
     Primitives primitives;
+    EggGroupNode::const_iterator ci;
     for (ci = egg_bin->begin(); ci != egg_bin->end(); ++ci) {
       EggPrimitive *egg_prim;
       DCAST_INTO_V(egg_prim, (*ci));
@@ -427,24 +500,6 @@ make_polyset(EggBin *egg_bin, PandaNode *parent, const LMatrix4d *transform,
         // vertex_data->write(cerr); geom->write(cerr);
         // render_state->_state->write(cerr, 0);
 
-      // Create a new GeomNode if we haven't already.
-      if (geom_node == nullptr) {
-        // Now, is our parent node a GeomNode, or just an ordinary PandaNode?
-        // If it's a GeomNode, we can add the new Geom directly to our parent;
-        // otherwise, we need to create a new node.
-        if (parent->is_geom_node() && !render_state->_hidden) {
-          geom_node = DCAST(GeomNode, parent);
-
-        } else {
-          geom_node = new GeomNode(egg_bin->get_name());
-          if (render_state->_hidden) {
-            parent->add_stashed(geom_node);
-          } else {
-            parent->add_child(geom_node);
-          }
-        }
-      }
-
       CPT(RenderState) geom_state = render_state->_state;
       if (has_overall_color) {
         if (!overall_color.almost_equal(LColor(1.0f, 1.0f, 1.0f, 1.0f))) {
@@ -454,12 +509,64 @@ make_polyset(EggBin *egg_bin, PandaNode *parent, const LMatrix4d *transform,
         geom_state = geom_state->add_attrib(ColorAttrib::make_vertex(), -1);
       }
 
-      geom_node->add_geom(geom, geom_state);
+      PolysetGeom polyset_geom;
+      polyset_geom._geom = std::move(geom);
+      polyset_geom._state = std::move(geom_state);
+      geoms.push_back(std::move(polyset_geom));
+    }
+  }
+}
+
+/**
+ * Adds the Geoms built by build_polyset() to the scene graph.  If geom_node
+ * is non-NULL, it is the GeomNode that make_polyset() already created for
+ * them; otherwise, one is created here if needed.
+ */
+void EggLoader::
+add_polyset_geoms(EggBin *egg_bin, PandaNode *parent, GeomNode *geom_node,
+                  const EggRenderState *render_state,
+                  EggVertexPools &vertex_pools, const PolysetGeoms &geoms) {
+  if (geoms.empty()) {
+    if (geom_node != nullptr) {
+      // We made a GeomNode for nothing.
+      if (!parent->remove_child(geom_node)) {
+        int stashed = parent->find_stashed(geom_node);
+        if (stashed >= 0) {
+          parent->remove_stashed(stashed);
+        }
+      }
+    }
+    return;
+  }
+
+  // Create a new GeomNode if we haven't already.
+  PT(GeomNode) new_geom_node;
+  if (geom_node == nullptr) {
+    // Now, is our parent node a GeomNode, or just an ordinary PandaNode?  If
+    // it's a GeomNode, we can add the new Geom directly to our parent;
+    // otherwise, we need to create a new node.
+    if (parent->is_geom_node() && !render_state->_hidden) {
+      geom_node = DCAST(GeomNode, parent);
+
+    } else {
+      new_geom_node = new GeomNode(egg_bin->get_name());
+      geom_node = new_geom_node;
+      if (render_state->_hidden) {
+        parent->add_stashed(geom_node);
+      } else {
+        parent->add_child(geom_node);
+      }
     }
   }
 
-  if (geom_node != nullptr && egg_show_normals) {
+  PolysetGeoms::const_iterator gi;
+  for (gi = geoms.begin(); gi != geoms.end(); ++gi) {
+    geom_node->add_geom((*gi)._geom, (*gi)._state);
+  }
+
+  if (egg_show_normals) {
     // Create some more geometry to visualize each normal.
+    EggVertexPools::iterator vpi;
     for (vpi = vertex_pools.begin(); vpi != vertex_pools.end(); ++vpi) {
       EggVertexPool *vertex_pool = (*vpi);
       show_normals(vertex_pool, geom_node);
@@ -467,6 +574,63 @@ make_polyset(EggBin *egg_bin, PandaNode *parent, const LMatrix4d *transform,
   }
 }
 
+/**
+ * Builds all of the polysets that were postponed by make_polyset(), dividing
+ * them between the threads of the worker thread pool if egg-parallel-load is
+ * set, and adds the results to the scene graph in the original order.
+ */
+void EggLoader::
+build_pending_polysets() {
+  if (_pending_polysets.empty()) {
+    return;
+  }
+
+  // Make a list of those that can be built in parallel.
+  pvector<PendingPolyset *> parallel;
+  PendingPolysets::iterator pi;
+  for (pi = _pending_polysets.begin(); pi != _pending_polysets.end(); ++pi) {
+    if ((*pi)._parallel) {
+      parallel.push_back(&(*pi));
+    }
+  }
+
+  WorkerThreadPool *pool = nullptr;
+  if (egg_parallel_load && parallel.size() > 1) {
+    pool = WorkerThreadPool::get_global_ptr();
+    if (pool->get_num_threads() == 0) {
+      pool = nullptr;
+    }
+  }
+
+  if (pool != nullptr) {
+    if (egg2pg_cat.is_debug()) {
+      egg2pg_cat.debug()
+        << "Building " << parallel.size() << " of " << _pending_polysets.size()
+        << " polysets on " << pool->get_num_threads() + 1 << " threads.\n";
+    }
+    pool->parallel_for(parallel.size(), [&] (size_t n, Thread *current_thread) {
+      PendingPolyset &pending = *parallel[n];
+      build_polyset(pending._egg_bin, pending._vertex_pools,
+                    pending._render_state, nullptr, false, nullptr,
+                    pending._geoms);
+    });
+  }
+
+  for (pi = _pending_polysets.begin(); pi != _pending_polysets.end(); ++pi) {
+    PendingPolyset &pending = (*pi);
+    if (pool == nullptr || !pending._parallel) {
+      build_polyset(pending._egg_bin, pending._vertex_pools,
+                    pending._render_state, nullptr, false, nullptr,
+                    pending._geoms);
+    }
+    add_polyset_geoms(pending._egg_bin, pending._parent, pending._geom_node,
+                      pending._render_state, pending._vertex_pools,
+                      pending._geoms);
+  }
+
+  _pending_polysets.clear();
+}
+
 /**
  * Creates a TransformState object corresponding to the indicated
  * EggTransform.
@@ -2270,10 +2434,13 @@ make_vertex_data(const EggRenderState *render_state,
   vpt._bake_in_uvs = render_state->_bake_in_uvs;
   vpt._transform = transform;
 
-  VertexPoolData::iterator di;
-  di = _vertex_pool_data.find(vpt);
-  if (di != _vertex_pool_data.end()) {
-    return (*di).second;
+  {
+    LightMutexHolder holder(_vertex_pool_data_lock);
+    VertexPoolData::iterator di;
+    di = _vertex_pool_data.find(vpt);
+    if (di != _vertex_pool_data.end()) {
+      return (*di).second;
+    }
   }
 
   PT(GeomVertexArrayFormat) array_format = new GeomVertexArrayFormat;
@@ -2564,9 +2731,12 @@ make_vertex_data(const EggRenderState *render_state,
     }
   }
 
-  bool inserted = _vertex_pool_data.insert
-    (VertexPoolData::value_type(vpt, vertex_data)).second;
-  nassertr(inserted, vertex_data);
+  {
+    LightMutexHolder holder(_vertex_pool_data_lock);
+    bool inserted = _vertex_pool_data.insert
+      (VertexPoolData::value_type(vpt, vertex_data)).second;
+    nassertr(inserted, vertex_data);
+  }
 
   Thread::consider_yield();
   return vertex_data;
@@ -21,11 +21,14 @@
 #include "eggTexture.h"
 #include "pt_EggTexture.h"
 #include "eggGroup.h"
+#include "eggBin.h"
 #include "eggMaterial.h"
 #include "pt_EggMaterial.h"
 #include "eggVertexPool.h"
 #include "texture.h"
 #include "pandaNode.h"
+#include "geomNode.h"
+#include "geom.h"
 #include "pointerTo.h"
 #include "lmatrix.h"
 #include "indirectCompareTo.h"
@@ -37,9 +40,9 @@
 #include "geomVertexData.h"
 #include "geomPrimitive.h"
 #include "bamCacheRecord.h"
+#include "lightMutex.h"
 
 class EggNode;
-class EggBin;
 class EggTable;
 class EggNurbsCurve;
 class EggNurbsSurface;
@@ -140,6 +143,40 @@ private:
   PandaNode *make_node(EggTable *egg_table, PandaNode *parent);
   PandaNode *make_node(EggGroupNode *egg_group, PandaNode *parent);
 
+  // This is used by make_polyset() to hold the Geoms built from a bin until
+  // they are added to the scene graph.
+  class PolysetGeom {
+  public:
+    PT(Geom) _geom;
+    CPT(RenderState) _state;
+  };
+  typedef pvector<PolysetGeom> PolysetGeoms;
+
+  // This records a polyset whose construction has been postponed until the
+  // end of build_graph(), so that it may be built in parallel with others.
+  class PendingPolyset {
+  public:
+    PT(EggBin) _egg_bin;
+    PT(PandaNode) _parent;
+    PT(GeomNode) _geom_node;
+    const EggRenderState *_render_state;
+    EggVertexPools _vertex_pools;
+    bool _parallel;
+    PolysetGeoms _geoms;
+  };
+  typedef pvector<PendingPolyset> PendingPolysets;
+
+  void build_polyset(EggBin *egg_bin, EggVertexPools &vertex_pools,
+                     const EggRenderState *render_state,
+                     const LMatrix4d *transform, bool is_dynamic,
+                     CharacterMaker *character_maker, PolysetGeoms &geoms);
+  void add_polyset_geoms(EggBin *egg_bin, PandaNode *parent,
+                         GeomNode *geom_node,
+                         const EggRenderState *render_state,
+                         EggVertexPools &vertex_pools,
+                         const PolysetGeoms &geoms);
+  void build_pending_polysets();
+
   void check_for_polysets(EggGroup *egg_group, bool &all_polysets,
                           bool &any_hidden);
   PT(GeomVertexData) make_vertex_data
@@ -253,6 +290,9 @@ private:
   };
   typedef pmap<VertexPoolTransform, PT(GeomVertexData) > VertexPoolData;
   VertexPoolData _vertex_pool_data;
+  LightMutex _vertex_pool_data_lock;
+
+  PendingPolysets _pending_polysets;
 
   typedef pmap<LMatrix4, CPT(TransformState) > TransformStates;
   TransformStates _transform_states;
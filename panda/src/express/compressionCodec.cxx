@@ -0,0 +1,203 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file compressionCodec.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "compressionCodec.h"
+#include "config_express.h"
+#include "zStream.h"
+#include "zstdStream.h"
+#include "string_utils.h"
+
+using std::istream;
+using std::ostream;
+using std::string;
+
+/**
+ * Returns true if the indicated codec has been compiled into Panda, and may
+ * therefore be used to compress and decompress data.
+ */
+bool
+is_compression_codec_available(CompressionCodec codec) {
+  switch (codec) {
+  case CC_none:
+    return true;
+
+  case CC_zlib:
+#ifdef HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+
+  case CC_zstd:
+#ifdef HAVE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  return false;
+}
+
+/**
+ * Returns a new istream that decompresses the data read from the indicated
+ * source stream with the given codec.  If owns_source is true, the source
+ * stream is deleted along with the returned stream, including if this
+ * function fails.  Returns NULL if the codec is not available.
+ *
+ * If codec is CC_none, this returns the source stream itself.
+ */
+istream *
+make_decompress_stream(istream *source, bool owns_source,
+                       CompressionCodec codec, std::streamsize source_length) {
+  switch (codec) {
+  case CC_none:
+    return source;
+
+  case CC_zlib:
+#ifdef HAVE_ZLIB
+    return new IDecompressStream(source, owns_source, source_length);
+#else
+    express_cat.error()
+      << "zlib not compiled in; cannot decompress data.\n";
+    break;
+#endif
+
+  case CC_zstd:
+#ifdef HAVE_ZSTD
+    return new IZstdDecompressStream(source, owns_source, source_length);
+#else
+    express_cat.error()
+      << "zstd not compiled in; cannot decompress data.\n";
+    break;
+#endif
+  }
+
+  if (owns_source) {
+    delete source;
+  }
+  return nullptr;
+}
+
+/**
+ * Returns a new ostream that compresses the data written to it with the
+ * given codec, and writes it to the indicated destination stream.  If
+ * owns_dest is true, the dest stream is deleted along with the returned
+ * stream, including if this function fails.  Returns NULL if the codec is
+ * not available.
+ *
+ * If codec is CC_none, this returns the dest stream itself.
+ */
+ostream *
+make_compress_stream(ostream *dest, bool owns_dest,
+                     CompressionCodec codec, int compression_level) {
+  switch (codec) {
+  case CC_none:
+    return dest;
+
+  case CC_zlib:
+#ifdef HAVE_ZLIB
+    return new OCompressStream(dest, owns_dest, compression_level);
+#else
+    express_cat.error()
+      << "zlib not compiled in; cannot compress data.\n";
+    break;
+#endif
+
+  case CC_zstd:
+#ifdef HAVE_ZSTD
+    return new OZstdCompressStream(dest, owns_dest, compression_level);
+#else
+    express_cat.error()
+      << "zstd not compiled in; cannot compress data.\n";
+    break;
+#endif
+  }
+
+  if (owns_dest) {
+    delete dest;
+  }
+  return nullptr;
+}
+
+/**
+ * Examines the first few bytes of the indicated stream to determine whether
+ * it contains zlib- or zstd-compressed data, and returns the corresponding
+ * codec, or CC_none if the data does not appear to be compressed.  The read
+ * position of the stream is left unchanged.
+ */
+CompressionCodec
+detect_compression_codec(istream &in) {
+  std::streampos start = in.tellg();
+  unsigned char header[4] = {0};
+  in.read((char *)header, 4);
+  size_t count = in.gcount();
+  in.clear();
+  in.seekg(start);
+
+  if (count == 4 && header[0] == 0x28 && header[1] == 0xb5 &&
+      header[2] == 0x2f && header[3] == 0xfd) {
+    // The zstd frame magic number.
+    return CC_zstd;
+  }
+  if (count >= 2 && (header[0] & 0x0f) == 8 &&
+      ((header[0] << 8) | header[1]) % 31 == 0) {
+    // A zlib header: deflate, with a valid header checksum.
+    return CC_zlib;
+  }
+  return CC_none;
+}
+
+/**
+ *
+ */
+ostream &
+operator << (ostream &out, CompressionCodec codec) {
+  switch (codec) {
+  case CC_none:
+    return out << "none";
+
+  case CC_zlib:
+    return out << "zlib";
+
+  case CC_zstd:
+    return out << "zstd";
+  }
+
+  return out << "**invalid CompressionCodec (" << (int)codec << ")**";
+}
+
+/**
+ *
+ */
+istream &
+operator >> (istream &in, CompressionCodec &codec) {
+  string word;
+  in >> word;
+
+  if (cmp_nocase(word, "none") == 0) {
+    codec = CC_none;
+
+  } else if (cmp_nocase(word, "zlib") == 0) {
+    codec = CC_zlib;
+
+  } else if (cmp_nocase(word, "zstd") == 0) {
+    codec = CC_zstd;
+
+  } else {
+    express_cat->error() << "Invalid CompressionCodec value: " << word << "\n";
+    codec = CC_zlib;
+  }
+
+  return in;
+}
@@ -0,0 +1,47 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file compressionCodec.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef COMPRESSIONCODEC_H
+#define COMPRESSIONCODEC_H
+
+#include "pandabase.h"
+
+BEGIN_PUBLISH
+/**
+ * Selects the compression algorithm used for Multifile subfiles and model
+ * cache files.  zlib is always the default, for compatibility; zstd is much
+ * faster to decompress, but is only available if Panda was built with it.
+ */
+enum CompressionCodec {
+  CC_none,
+  CC_zlib,
+  CC_zstd,
+};
+
+EXPCL_PANDA_EXPRESS bool is_compression_codec_available(CompressionCodec codec);
+END_PUBLISH
+
+EXPCL_PANDA_EXPRESS std::istream *
+make_decompress_stream(std::istream *source, bool owns_source,
+                       CompressionCodec codec,
+                       std::streamsize source_length = -1);
+EXPCL_PANDA_EXPRESS std::ostream *
+make_compress_stream(std::ostream *dest, bool owns_dest,
+                     CompressionCodec codec, int compression_level);
+EXPCL_PANDA_EXPRESS CompressionCodec
+detect_compression_codec(std::istream &in);
+
+EXPCL_PANDA_EXPRESS std::ostream &operator << (std::ostream &out, CompressionCodec codec);
+EXPCL_PANDA_EXPRESS std::istream &operator >> (std::istream &in, CompressionCodec &codec);
+
+#endif
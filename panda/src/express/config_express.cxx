@@ -77,6 +77,45 @@ ConfigVariableBool multifile_always_binary
           "or extracted in either binary or text mode, according to the "
           "set_binary() or set_text() flag on the Filename."));
 
+ConfigVariableBool multifile_mmap
+("multifile-mmap", false,
+ PRC_DESC("Set this true to map Multifiles that are opened for reading "
+          "from disk into memory.  Subfiles are then read directly out of "
+          "the mapped memory, and uncompressed, unencrypted subfiles may be "
+          "accessed without copying.  Concurrent reads of different "
+          "subfiles no longer need to contend for the lock on the "
+          "Multifile's stream.  This should not be enabled if Multifiles "
+          "may be modified on disk while they are open."));
+
+ConfigVariableInt multifile_num_threads
+("multifile-num-threads", 1,
+ PRC_DESC("The number of threads that a Multifile uses by default to "
+          "compress and encrypt newly added subfiles when it is flushed or "
+          "repacked.  The subfiles are always written in the same order, so "
+          "the resulting file is the same regardless of this setting.  Set "
+          "this to 0 to use one thread per CPU."));
+
+ConfigVariableEnum<CompressionCodec> multifile_compression_codec
+("multifile-compression-codec", CC_zlib,
+ PRC_DESC("The compression algorithm used by default for compressed subfiles "
+          "that are added to a Multifile: zlib or zstd.  zstd subfiles "
+          "decompress considerably faster, but can only be read by builds "
+          "of Panda that include zstd support.  The codec is recorded for "
+          "each subfile, so this does not affect reading."));
+
+ConfigVariableInt vfs_prefetch_threads
+("vfs-prefetch-threads", 2,
+ PRC_DESC("The number of background threads that read the files requested "
+          "by VirtualFileSystem::prefetch().  Set this to 0 to use one "
+          "thread per CPU."));
+
+ConfigVariableInt64 vfs_prefetch_cache_size
+("vfs-prefetch-cache-size", 64 * 1024 * 1024,
+ PRC_DESC("The maximum number of bytes of file data that may be held in "
+          "memory by VirtualFileSystem::prefetch(), waiting to be read.  "
+          "When this is exceeded, the files that were prefetched longest "
+          "ago are discarded."));
+
 ConfigVariableBool collect_tcp
 ("collect-tcp", false,
  PRC_DESC("Set this true to enable accumulation of several small consecutive "
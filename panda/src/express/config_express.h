@@ -20,9 +20,12 @@
 
 #include "configVariableBool.h"
 #include "configVariableInt.h"
+#include "configVariableInt64.h"
 #include "configVariableDouble.h"
 #include "configVariableList.h"
 #include "configVariableFilename.h"
+#include "configVariableEnum.h"
+#include "compressionCodec.h"
 
 // Include these so interrogate can find them.
 #include "executionEnvironment.h"
@@ -50,6 +53,11 @@ extern ConfigVariableInt patchfile_zone_size;
 
 extern EXPCL_PANDA_EXPRESS ConfigVariableBool keep_temporary_files;
 extern ConfigVariableBool multifile_always_binary;
+extern ConfigVariableBool multifile_mmap;
+extern ConfigVariableInt multifile_num_threads;
+extern ConfigVariableEnum<CompressionCodec> multifile_compression_codec;
+extern ConfigVariableInt vfs_prefetch_threads;
+extern ConfigVariableInt64 vfs_prefetch_cache_size;
 
 extern EXPCL_PANDA_EXPRESS ConfigVariableBool collect_tcp;
 extern EXPCL_PANDA_EXPRESS ConfigVariableDouble collect_tcp_interval;
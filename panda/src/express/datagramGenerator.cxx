@@ -15,6 +15,8 @@
 
 #include "datagramGenerator.h"
 #include "temporaryFile.h"
+#include "subfileInfo.h"
+#include "config_express.h"
 
 /**
  * Does nothing since this is class is just the definition of an interface
@@ -34,7 +36,34 @@ DatagramGenerator::
  */
 bool DatagramGenerator::
 save_datagram(SubfileInfo &info) {
-  return false;
+  // The default implementation just reads the datagram into memory and then
+  // writes it out to a temporary file.  Subclasses that are file-based can do
+  // much better than this.
+  Datagram dg;
+  if (!get_datagram(dg)) {
+    return false;
+  }
+
+  PT(TemporaryFile) tfile = new TemporaryFile(Filename::temporary("", ""));
+  pofstream out;
+  Filename filename = tfile->get_filename();
+  filename.set_binary();
+  if (!filename.open_write(out)) {
+    express_cat.error()
+      << "Couldn't write to " << tfile->get_filename() << "\n";
+    return false;
+  }
+
+  out.write((const char *)dg.get_data(), dg.get_length());
+  if (out.fail()) {
+    express_cat.error()
+      << "Couldn't write " << dg.get_length() << " bytes to "
+      << tfile->get_filename() << "\n";
+    return false;
+  }
+
+  info = SubfileInfo(tfile, 0, dg.get_length());
+  return true;
 }
 
 /**
@@ -0,0 +1,176 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file mappedFile.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "mappedFile.h"
+#include "config_express.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN 1
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/**
+ *
+ */
+MappedFile::
+MappedFile() :
+  _map_base(nullptr),
+  _map_size(0),
+  _data(nullptr),
+  _size(0)
+#ifdef _WIN32
+  , _handle(nullptr)
+#endif
+{
+}
+
+/**
+ *
+ */
+MappedFile::
+~MappedFile() {
+  close();
+}
+
+/**
+ * Maps the indicated region of the named file into memory.  If size is 0,
+ * the region extends to the end of the file.  Returns true on success, false
+ * on failure.
+ */
+bool MappedFile::
+open(const Filename &filename, std::streampos start, size_t size) {
+  close();
+
+  Filename fname = filename;
+  fname.set_binary();
+  uint64_t offset = (uint64_t)start;
+
+#ifdef _WIN32
+  std::wstring os_specific = fname.to_os_specific_w();
+  HANDLE file = CreateFileW(os_specific.c_str(), GENERIC_READ,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size) ||
+      offset > (uint64_t)file_size.QuadPart) {
+    CloseHandle(file);
+    return false;
+  }
+  if (size == 0) {
+    size = (size_t)((uint64_t)file_size.QuadPart - offset);
+  }
+  if (size == 0 || offset + size > (uint64_t)file_size.QuadPart) {
+    CloseHandle(file);
+    return false;
+  }
+
+  HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr) {
+    return false;
+  }
+
+  // The offset of a view must be a multiple of the allocation granularity.
+  SYSTEM_INFO sysinfo;
+  GetSystemInfo(&sysinfo);
+  uint64_t align = offset % sysinfo.dwAllocationGranularity;
+  uint64_t map_offset = offset - align;
+  size_t map_size = size + (size_t)align;
+
+  void *base = MapViewOfFile(mapping, FILE_MAP_READ, (DWORD)(map_offset >> 32),
+                             (DWORD)(map_offset & 0xffffffff), map_size);
+  if (base == nullptr) {
+    CloseHandle(mapping);
+    return false;
+  }
+  _handle = mapping;
+
+#else
+  std::string os_specific = fname.to_os_specific();
+  int fd = ::open(os_specific.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || offset > (uint64_t)st.st_size) {
+    ::close(fd);
+    return false;
+  }
+  if (size == 0) {
+    size = (size_t)((uint64_t)st.st_size - offset);
+  }
+  if (size == 0 || offset + size > (uint64_t)st.st_size) {
+    ::close(fd);
+    return false;
+  }
+
+  // The offset of a mapping must be a multiple of the page size.
+  uint64_t align = offset % (uint64_t)sysconf(_SC_PAGESIZE);
+  uint64_t map_offset = offset - align;
+  size_t map_size = size + (size_t)align;
+
+  void *base = mmap(nullptr, map_size, PROT_READ, MAP_SHARED, fd, (off_t)map_offset);
+  ::close(fd);
+  if (base == MAP_FAILED) {
+    return false;
+  }
+#endif
+
+  _filename = filename;
+  _map_base = (char *)base;
+  _map_size = map_size;
+  _data = _map_base + align;
+  _size = size;
+
+  if (express_cat.is_debug()) {
+    express_cat.debug()
+      << "Mapped " << _size << " bytes of " << _filename << " at offset "
+      << offset << "\n";
+  }
+  return true;
+}
+
+/**
+ * Unmaps the file, if it is mapped.  Any pointers into the mapped region
+ * become invalid.
+ */
+void MappedFile::
+close() {
+  if (_map_base != nullptr) {
+#ifdef _WIN32
+    UnmapViewOfFile(_map_base);
+    CloseHandle((HANDLE)_handle);
+    _handle = nullptr;
+#else
+    munmap(_map_base, _map_size);
+#endif
+  }
+
+  _filename = Filename();
+  _map_base = nullptr;
+  _map_size = 0;
+  _data = nullptr;
+  _size = 0;
+}
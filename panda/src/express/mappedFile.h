@@ -0,0 +1,62 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file mappedFile.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include "pandabase.h"
+#include "referenceCount.h"
+#include "filename.h"
+
+/**
+ * A read-only view of a region of a file on disk, mapped into the address
+ * space of the process.  The contents of the file may be accessed directly
+ * in memory, without first being copied through a stream buffer, and
+ * without any locking, from any number of threads at once.
+ *
+ * The mapping remains valid for as long as the MappedFile object exists, so
+ * objects that hand out pointers into it should hold a reference to it.
+ */
+class EXPCL_PANDA_EXPRESS MappedFile : public ReferenceCount {
+PUBLISHED:
+  MappedFile();
+  MappedFile(const MappedFile &copy) = delete;
+  ~MappedFile();
+
+  MappedFile &operator = (const MappedFile &copy) = delete;
+
+  bool open(const Filename &filename, std::streampos start = 0,
+            size_t size = 0);
+  void close();
+
+  INLINE bool is_valid() const;
+  INLINE const Filename &get_filename() const;
+  INLINE size_t get_size() const;
+
+public:
+  INLINE const char *get_data() const;
+
+private:
+  Filename _filename;
+  char *_map_base;
+  size_t _map_size;
+  const char *_data;
+  size_t _size;
+#ifdef _WIN32
+  void *_handle;
+#endif
+};
+
+#include "mappedFile.I"
+
+#endif
@@ -0,0 +1,47 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file mappedStream.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef MAPPEDSTREAM_H
+#define MAPPEDSTREAM_H
+
+#include "pandabase.h"
+#include "mappedStreamBuf.h"
+
+/**
+ * An istream object that reads from a region of a MappedFile.  This is
+ * similar to ISubStream, but since the data is read directly out of memory,
+ * it does not need to lock or seek a shared source stream, so any number of
+ * IMappedStreams on the same file may be read in parallel.
+ *
+ * The stream holds a reference to the MappedFile, so the mapping remains
+ * valid for as long as the stream is open.
+ */
+class EXPCL_PANDA_EXPRESS IMappedStream : public std::istream {
+PUBLISHED:
+  INLINE IMappedStream();
+  INLINE explicit IMappedStream(MappedFile *source, size_t start, size_t size);
+
+#if _MSC_VER >= 1800
+  INLINE IMappedStream(const IMappedStream &copy) = delete;
+#endif
+
+  INLINE IMappedStream &open(MappedFile *source, size_t start, size_t size);
+  INLINE IMappedStream &close();
+
+private:
+  MappedStreamBuf _buf;
+};
+
+#include "mappedStream.I"
+
+#endif
@@ -0,0 +1,124 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file mappedStreamBuf.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "mappedStreamBuf.h"
+
+/**
+ *
+ */
+MappedStreamBuf::
+MappedStreamBuf() {
+  setg(nullptr, nullptr, nullptr);
+  setp(nullptr, nullptr);
+}
+
+/**
+ *
+ */
+MappedStreamBuf::
+~MappedStreamBuf() {
+  close();
+}
+
+/**
+ * Attaches this streambuf to the indicated region of the mapped file, which
+ * must lie entirely within the mapped region.
+ */
+void MappedStreamBuf::
+open(MappedFile *source, size_t start, size_t size) {
+  nassertv(source != nullptr && source->is_valid());
+  nassertv(start + size <= source->get_size());
+
+  _source = source;
+  char *data = (char *)source->get_data() + start;
+  setg(data, data, data + size);
+}
+
+/**
+ * Detaches this streambuf from the mapped file.
+ */
+void MappedStreamBuf::
+close() {
+  setg(nullptr, nullptr, nullptr);
+  _source.clear();
+}
+
+/**
+ * Implements seeking within the stream.
+ */
+std::streampos MappedStreamBuf::
+seekoff(std::streamoff off, ios_seekdir dir, ios_openmode which) {
+  if ((which & std::ios::in) == 0) {
+    return -1;
+  }
+
+  std::streamoff size = egptr() - eback();
+  std::streamoff pos;
+  switch (dir) {
+  case std::ios::beg:
+    pos = off;
+    break;
+
+  case std::ios::cur:
+    pos = (gptr() - eback()) + off;
+    break;
+
+  case std::ios::end:
+    pos = size + off;
+    break;
+
+  default:
+    return -1;
+  }
+
+  if (pos < 0 || pos > size) {
+    return -1;
+  }
+
+  setg(eback(), eback() + pos, egptr());
+  return pos;
+}
+
+/**
+ * Implements seeking within the stream.  The default implementation of
+ * seekpos() is supposed to map to seekoff() exactly as we do here, but it
+ * appears that some STL implementations (gcc 3.2, for instance) do not do
+ * this, so we override it explicitly.
+ */
+std::streampos MappedStreamBuf::
+seekpos(std::streampos pos, ios_openmode which) {
+  std::streamoff off = pos;
+  return seekoff(off, std::ios::beg, which);
+}
+
+/**
+ * Returns the number of characters that may be read without blocking.
+ */
+std::streamsize MappedStreamBuf::
+showmanyc() {
+  std::streamsize avail = egptr() - gptr();
+  return (avail > 0) ? avail : -1;
+}
+
+/**
+ * Called by the system istream implementation when its internal buffer needs
+ * more characters.  Since the whole region is already in the buffer, this
+ * only happens at the end of the stream.
+ */
+int MappedStreamBuf::
+underflow() {
+  if (gptr() < egptr()) {
+    return (unsigned char)*gptr();
+  }
+  return EOF;
+}
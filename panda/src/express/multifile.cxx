@@ -18,6 +18,8 @@
 #include "streamReader.h"
 #include "datagram.h"
 #include "zStream.h"
+#include "mappedStream.h"
+#include "stringStream.h"
 #include "encryptStream.h"
 #include "virtualFileSystem.h"
 #include "virtualFile.h"
@@ -26,6 +28,11 @@
 #include <iterator>
 #include <time.h>
 
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+#include <atomic>
+#include <thread>
+#endif
+
 #include "openSSLWrapper.h"
 
 using std::ios;
@@ -122,6 +129,8 @@ Multifile() :
   _next_index = 0;
   _last_index = 0;
   _last_data_byte = 0;
+  _num_threads = multifile_num_threads;
+  _compression_codec = multifile_compression_codec;
   _needs_repack = false;
   _timestamp = 0;
   _timestamp_dirty = false;
@@ -179,7 +188,23 @@ open_read(const Filename &multifile_name, const streampos &offset) {
   _owns_stream = true;
   _multifile_name = multifile_name;
   _offset = offset;
-  return read_index();
+  if (!read_index()) {
+    return false;
+  }
+
+  if (multifile_mmap) {
+    // If the Multifile resides on disk (possibly as an uncompressed subfile
+    // of another Multifile), map it into memory, so that subfiles can be read
+    // without going through the stream.
+    SubfileInfo info;
+    if (vfile->get_system_info(info)) {
+      PT(MappedFile) mapped = new MappedFile;
+      if (mapped->open(info.get_filename(), info.get_start(), info.get_size())) {
+        _mapped = std::move(mapped);
+      }
+    }
+  }
+  return true;
 }
 
 /**
@@ -344,6 +369,7 @@ close() {
 
   _read = nullptr;
   _write = nullptr;
+  _mapped.clear();
   _offset = 0;
   _owns_stream = false;
   _next_index = 0;
@@ -1200,30 +1226,37 @@ flush() {
     nassertr(_next_index == _write->tellp(), false);
     _next_index = pad_to_streampos(_next_index);
 
-    // All right, now write out each subfile's data.
-    for (pi = _new_subfiles.begin(); pi != _new_subfiles.end(); ++pi) {
-      Subfile *subfile = (*pi);
+    // All right, now write out each subfile's data.  If we have several
+    // threads, we compress a batch of subfiles at a time in parallel, and
+    // then write out that batch in order.
+    size_t i = 0;
+    while (i < _new_subfiles.size()) {
+      size_t batch_end = encode_subfiles(_new_subfiles, i);
 
-      if (_read != nullptr) {
-        _read->acquire();
-        _next_index = subfile->write_data(*_write, _read->get_istream(),
-                                          _next_index, this);
-        _read->release();
+      for (; i < batch_end; ++i) {
+        Subfile *subfile = _new_subfiles[i];
 
-      } else {
-        _next_index = subfile->write_data(*_write, nullptr, _next_index, this);
-      }
+        if (_read != nullptr) {
+          _read->acquire();
+          _next_index = subfile->write_data(*_write, _read->get_istream(),
+                                            _next_index, this);
+          _read->release();
 
-      nassertr(_next_index == _write->tellp(), false);
-      _next_index = pad_to_streampos(_next_index);
-      if (subfile->is_data_invalid()) {
-        wrote_ok = false;
-      }
+        } else {
+          _next_index = subfile->write_data(*_write, nullptr, _next_index, this);
+        }
+
+        nassertr(_next_index == _write->tellp(), false);
+        _next_index = pad_to_streampos(_next_index);
+        if (subfile->is_data_invalid()) {
+          wrote_ok = false;
+        }
 
-      if (!subfile->is_cert_special()) {
-        _last_data_byte = max(_last_data_byte, subfile->get_last_byte_pos());
+        if (!subfile->is_cert_special()) {
+          _last_data_byte = max(_last_data_byte, subfile->get_last_byte_pos());
+        }
+        nassertr(_next_index == _write->tellp(), false);
       }
-      nassertr(_next_index == _write->tellp(), false);
     }
 
     // Now go back and fill in the proper addresses for the data start.  We
@@ -1262,6 +1295,10 @@ flush() {
     return false;
   }
 
+  if (_name_index.empty()) {
+    rebuild_name_index();
+  }
+
   return true;
 }
 
@@ -1367,6 +1404,21 @@ int Multifile::
 find_subfile(const string &subfile_name) const {
   Subfile find_subfile;
   find_subfile._name = standardize_subfile_name(subfile_name);
+
+  if (!_name_index.empty()) {
+    size_t mask = _name_index.size() - 1;
+    size_t i = string_hash::add_hash(0, find_subfile._name) & mask;
+    int index = _name_index[i];
+    while (index >= 0) {
+      if (_subfiles[index]->_name == find_subfile._name) {
+        return index;
+      }
+      i = (i + 1) & mask;
+      index = _name_index[i];
+    }
+    return -1;
+  }
+
   Subfiles::const_iterator fi;
   fi = _subfiles.find(&find_subfile);
   if (fi == _subfiles.end()) {
@@ -1463,6 +1515,7 @@ remove_subfile(int index) {
   subfile->_flags |= SF_deleted;
   _removed_subfiles.push_back(subfile);
   _subfiles.erase(_subfiles.begin() + index);
+  _name_index.clear();
 
   _timestamp = time(nullptr);
   _timestamp_dirty = true;
@@ -1519,6 +1572,16 @@ is_subfile_compressed(int index) const {
   return (_subfiles[index]->_flags & SF_compressed) != 0;
 }
 
+/**
+ * Returns the algorithm with which the indicated subfile has been compressed
+ * within the archive, or CC_none if it is not compressed.
+ */
+CompressionCodec Multifile::
+get_subfile_compression_codec(int index) const {
+  nassertr(index >= 0 && index < (int)_subfiles.size(), CC_none);
+  return _subfiles[index]->get_compression_codec();
+}
+
 /**
  * Returns true if the indicated subfile has been encrypted when stored within
  * the archive, false otherwise.
@@ -1928,6 +1991,13 @@ read_subfile(int index, vector_uchar &result) {
     success = VirtualFile::simple_read_file(in, result);
     close_read_subfile(in);
 
+  } else if (is_subfile_mapped(subfile)) {
+    // The subfile is a plain file within the mapped region, so we can just
+    // copy it out of memory.
+    const unsigned char *data = (const unsigned char *)_mapped->get_data() +
+      (size_t)(_offset + subfile->_data_start);
+    result.assign(data, data + subfile->_data_length);
+
   } else {
     // But if the subfile is just a plain file, we can just read the data
     // directly from the Multifile, without paying the cost of an ISubStream.
@@ -1966,6 +2036,26 @@ read_subfile(int index, vector_uchar &result) {
   return true;
 }
 
+/**
+ * Returns a pointer directly to the contents of the indicated subfile, in
+ * the memory-mapped Multifile, or NULL if this is not possible: the
+ * Multifile is not mapped (see is_mapped()), or the subfile is compressed or
+ * encrypted.  The data is get_subfile_length() bytes long.
+ *
+ * The pointer remains valid until the Multifile is closed.  This may be
+ * called from any thread.
+ */
+const char *Multifile::
+get_subfile_data(int index) const {
+  nassertr(index >= 0 && index < (int)_subfiles.size(), nullptr);
+  const Subfile *subfile = _subfiles[index];
+  if ((subfile->_flags & (SF_encrypted | SF_compressed)) != 0 ||
+      !is_subfile_mapped(subfile)) {
+    return nullptr;
+  }
+  return _mapped->get_data() + (size_t)(_offset + subfile->_data_start);
+}
+
 /**
  * Assumes the _write pointer is at the indicated fpos, rounds the fpos up to
  * the next legitimate address (using normalize_streampos()), and writes
@@ -1984,20 +2074,84 @@ pad_to_streampos(streampos fpos) {
   return fpos;
 }
 
+/**
+ * Compresses and/or encrypts, in parallel, the data for a batch of the
+ * indicated subfiles, beginning at the indicated index, in preparation for
+ * writing them out with write_data().  Returns the index of the end of the
+ * batch.
+ *
+ * If threading is not available or not enabled, this does nothing, and the
+ * data is compressed by write_data() as it is written.
+ */
+size_t Multifile::
+encode_subfiles(const pvector<Subfile *> &subfiles, size_t begin) {
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+  int num_threads = _num_threads;
+  if (num_threads == 0) {
+    num_threads = (int)std::thread::hardware_concurrency();
+  }
+  if (num_threads > 1) {
+    // Limit the number of subfiles in a batch, so that we don't hold too
+    // much compressed data in memory at once.
+    size_t end = min(subfiles.size(), begin + (size_t)num_threads * 8);
+
+    // Only subfiles with a source that need compression or encryption are
+    // worth sending to a thread; the rest are simply copied in by
+    // write_data().
+    pvector<Subfile *> work;
+    for (size_t i = begin; i < end; ++i) {
+      Subfile *subfile = subfiles[i];
+      if ((subfile->_source != nullptr || !subfile->_source_filename.empty()) &&
+          (subfile->_flags & (SF_compressed | SF_encrypted)) != 0 &&
+          (subfile->_flags & SF_signature) == 0) {
+        work.push_back(subfile);
+      }
+    }
+
+    if (work.size() > 1) {
+      std::atomic<size_t> next(0);
+      auto encode = [&]() {
+        size_t wi;
+        while ((wi = next.fetch_add(1)) < work.size()) {
+          work[wi]->encode_data(this);
+        }
+      };
+
+      num_threads = min(num_threads, (int)work.size());
+      pvector<std::thread> threads;
+      threads.reserve(num_threads - 1);
+      for (int ti = 1; ti < num_threads; ++ti) {
+        threads.push_back(std::thread(encode));
+      }
+      encode();
+      for (std::thread &thread : threads) {
+        thread.join();
+      }
+    }
+    return end;
+  }
+#endif  // HAVE_THREADS && !SIMPLE_THREADS
+
+  return subfiles.size();
+}
+
 /**
  * Adds a newly-allocated Subfile pointer to the Multifile.
  */
 void Multifile::
 add_new_subfile(Subfile *subfile, int compression_level) {
-  if (compression_level != 0) {
-#ifndef HAVE_ZLIB
-    express_cat.warning()
-      << "zlib not compiled in; cannot generated compressed multifiles.\n";
-    compression_level = 0;
-#else  // HAVE_ZLIB
-    subfile->_flags |= SF_compressed;
-    subfile->_compression_level = compression_level;
-#endif  // HAVE_ZLIB
+  if (compression_level != 0 && _compression_codec != CC_none) {
+    if (!is_compression_codec_available(_compression_codec)) {
+      express_cat.warning()
+        << _compression_codec << " not compiled in; cannot generate compressed multifiles.\n";
+      compression_level = 0;
+    } else {
+      subfile->_flags |= SF_compressed;
+      if (_compression_codec == CC_zstd) {
+        subfile->_flags |= SF_zstd;
+      }
+      subfile->_compression_level = compression_level;
+    }
   }
 
 #ifdef HAVE_OPENSSL
@@ -2012,6 +2166,7 @@ add_new_subfile(Subfile *subfile, int compression_level) {
     _needs_repack = true;
   }
 
+  _name_index.clear();
   std::pair<Subfiles::iterator, bool> insert_result = _subfiles.insert(subfile);
   if (!insert_result.second) {
     // Hmm, unable to insert.  There must already be a subfile by that name.
@@ -2047,12 +2202,21 @@ open_read_subfile(Subfile *subfile) {
   nassertr(subfile->_source == nullptr &&
            subfile->_source_filename.empty(), nullptr);
 
-  // Return an ISubStream object that references into the open Multifile
-  // istream.
   nassertr(subfile->_data_start != (streampos)0, nullptr);
-  istream *stream =
-    new ISubStream(_read, _offset + subfile->_data_start,
-                   _offset + subfile->_data_start + (streampos)subfile->_data_length);
+  istream *stream;
+  if (is_subfile_mapped(subfile)) {
+    // Read the subfile directly out of the mapped memory.  This doesn't need
+    // to hold the lock on the Multifile's stream, and it remains valid even
+    // after the Multifile is closed.
+    stream = new IMappedStream(_mapped, (size_t)(_offset + subfile->_data_start),
+                               subfile->_data_length);
+  } else {
+    // Return an ISubStream object that references into the open Multifile
+    // istream.
+    stream =
+      new ISubStream(_read, _offset + subfile->_data_start,
+                     _offset + subfile->_data_start + (streampos)subfile->_data_length);
+  }
 
   if ((subfile->_flags & SF_encrypted) != 0) {
 #ifndef HAVE_OPENSSL
@@ -2078,17 +2242,14 @@ open_read_subfile(Subfile *subfile) {
   }
 
   if ((subfile->_flags & SF_compressed) != 0) {
-#ifndef HAVE_ZLIB
-    express_cat.error()
-      << "zlib not compiled in; cannot read compressed multifiles.\n";
-    delete stream;
-    return nullptr;
-#else  // HAVE_ZLIB
-    // Oops, the subfile is compressed.  So actually, return an
-    // IDecompressStream that wraps around the ISubStream.
-    IDecompressStream *wrapper = new IDecompressStream(stream, true);
-    stream = wrapper;
-#endif  // HAVE_ZLIB
+    // Oops, the subfile is compressed.  So actually, return a decompression
+    // stream for the appropriate codec that wraps around the ISubStream.
+    stream = make_decompress_stream(stream, true, subfile->get_compression_codec());
+    if (stream == nullptr) {
+      express_cat.error()
+        << "Cannot read compressed subfile " << subfile->_name << ".\n";
+      return nullptr;
+    }
   }
 
   if (stream->fail()) {
@@ -2100,6 +2261,20 @@ open_read_subfile(Subfile *subfile) {
   return stream;
 }
 
+/**
+ * Returns true if the indicated subfile's data lies entirely within the
+ * mapped region of the Multifile, and may therefore be read from memory.
+ */
+bool Multifile::
+is_subfile_mapped(const Subfile *subfile) const {
+  if (_mapped == nullptr || subfile->_data_start == (streampos)0 ||
+      subfile->_source != nullptr || !subfile->_source_filename.empty()) {
+    return false;
+  }
+  streampos end = _offset + subfile->_data_start + (streampos)subfile->_data_length;
+  return end <= (streampos)_mapped->get_size();
+}
+
 /**
  * Returns the standard form of the subfile name.
  */
@@ -2155,6 +2330,30 @@ clear_subfiles() {
     delete subfile;
   }
   _subfiles.clear();
+  _name_index.clear();
+}
+
+/**
+ * Fills up _name_index with the current contents of _subfiles.  This must be
+ * called again (or _name_index cleared) whenever _subfiles is modified.
+ */
+void Multifile::
+rebuild_name_index() {
+  // Keep the table at most half full, so that the probe sequences stay short.
+  size_t table_size = 16;
+  while (table_size < _subfiles.size() * 2) {
+    table_size <<= 1;
+  }
+  _name_index.assign(table_size, -1);
+
+  size_t mask = table_size - 1;
+  for (size_t si = 0; si < _subfiles.size(); ++si) {
+    size_t i = string_hash::add_hash(0, _subfiles[si]->_name) & mask;
+    while (_name_index[i] >= 0) {
+      i = (i + 1) & mask;
+    }
+    _name_index[i] = (int)si;
+  }
 }
 
 /**
@@ -2328,6 +2527,8 @@ read_index() {
     nassertr(before_size == after_size, true);
   }
 
+  rebuild_name_index();
+
   delete subfile;
   _read->release();
   return true;
@@ -2618,7 +2819,7 @@ write_data(ostream &write, istream *read, streampos fpos,
 
   istream *source = _source;
   pifstream source_file;
-  if (source == nullptr && !_source_filename.empty()) {
+  if (!_encoded && source == nullptr && !_source_filename.empty()) {
     // If we have a filename, open it up and read that.
     if (!_source_filename.open_read(source_file)) {
       // Unable to open the source file.
@@ -2632,7 +2833,17 @@ write_data(ostream &write, istream *read, streampos fpos,
     }
   }
 
-  if (source == nullptr) {
+  if (_encoded) {
+    // The data has already been compressed and/or encrypted by
+    // encode_data(), so we only need to copy it in.
+    if (!_encoded_data.empty()) {
+      write.write((const char *)&_encoded_data[0], _encoded_data.size());
+    }
+    _data_length = _encoded_data.size();
+    vector_uchar().swap(_encoded_data);
+    _encoded = false;
+
+  } else if (source == nullptr) {
     // We don't have any source data.  Perhaps we're reading from an already-
     // packed Subfile (e.g.  during repack()).
     if (read == nullptr) {
@@ -2681,17 +2892,14 @@ write_data(ostream &write, istream *read, streampos fpos,
     }
 #endif  // HAVE_OPENSSL
 
-#ifndef HAVE_ZLIB
-    // Without ZLIB, we can't support compression.  The flag had better not be
-    // set.
-    nassertr((_flags & SF_compressed) == 0, fpos);
-#else  // HAVE_ZLIB
     if ((_flags & SF_compressed) != 0) {
-      // Write it compressed.
-      putter = new OCompressStream(putter, delete_putter, _compression_level);
+      // Write it compressed.  The codec had better be available, or the flag
+      // would not have been set.
+      putter = make_compress_stream(putter, delete_putter,
+                                    get_compression_codec(), _compression_level);
+      nassertr(putter != nullptr, fpos);
       delete_putter = true;
     }
-#endif  // HAVE_ZLIB
 
     streampos write_start = fpos;
     _uncompressed_length = 0;
@@ -2796,6 +3004,76 @@ write_data(ostream &write, istream *read, streampos fpos,
   return fpos + (streampos)_data_length;
 }
 
+/**
+ * Reads the source data for this subfile and compresses and/or encrypts it
+ * into memory, so that write_data() only needs to copy it into the
+ * Multifile.  This may be called from a sub-thread, since it doesn't touch
+ * the Multifile's streams.  Returns true on success, or false if the data
+ * could not be read, in which case write_data() will take care of it.
+ *
+ * This is not supported for signature subfiles, which need to read back the
+ * Multifile contents.
+ */
+bool Multifile::Subfile::
+encode_data(Multifile *multifile) {
+  nassertr(!_encoded && (_flags & SF_signature) == 0, false);
+
+  istream *source = _source;
+  pifstream source_file;
+  if (source == nullptr) {
+    if (_source_filename.empty() || !_source_filename.open_read(source_file)) {
+      return false;
+    }
+    source = &source_file;
+  }
+
+  StringStream buffer;
+  ostream *putter = &buffer;
+  bool delete_putter = false;
+
+#ifdef HAVE_OPENSSL
+  if ((_flags & SF_encrypted) != 0) {
+    OEncryptStream *encrypt = new OEncryptStream;
+    encrypt->set_iteration_count(multifile->_encryption_iteration_count);
+    encrypt->open(putter, delete_putter, multifile->_encryption_password);
+
+    putter = encrypt;
+    delete_putter = true;
+    putter->write(_encrypt_header, _encrypt_header_size);
+  }
+#else
+  nassertr((_flags & SF_encrypted) == 0, false);
+#endif  // HAVE_OPENSSL
+
+  if ((_flags & SF_compressed) != 0) {
+    putter = make_compress_stream(putter, delete_putter,
+                                  get_compression_codec(), _compression_level);
+    nassertr(putter != nullptr, false);
+    delete_putter = true;
+  }
+
+  static const size_t buffer_size = 4096;
+  char data[buffer_size];
+
+  _uncompressed_length = 0;
+  source->read(data, buffer_size);
+  size_t count = source->gcount();
+  while (count != 0) {
+    _uncompressed_length += count;
+    putter->write(data, count);
+    source->read(data, buffer_size);
+    count = source->gcount();
+  }
+
+  if (delete_putter) {
+    delete putter;
+  }
+
+  buffer.swap_data(_encoded_data);
+  _encoded = true;
+  return true;
+}
+
 /**
  * Seeks within the indicate pfstream back to the index record and rewrites
  * just the _data_start and _data_length part of the index record.
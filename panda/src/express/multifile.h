@@ -19,12 +19,16 @@
 #include "config_express.h"
 #include "streamWrapper.h"
 #include "subStream.h"
+#include "mappedFile.h"
+#include "compressionCodec.h"
+#include "pointerTo.h"
 #include "filename.h"
 #include "ordered_vector.h"
 #include "indirectLess.h"
 #include "referenceCount.h"
 #include "pvector.h"
 #include "vector_uchar.h"
+#include "vector_int.h"
 
 #ifdef HAVE_OPENSSL
 typedef struct x509_st X509;
@@ -57,6 +61,7 @@ PUBLISHED:
   INLINE bool is_read_valid() const;
   INLINE bool is_write_valid() const;
   INLINE bool needs_repack() const;
+  INLINE bool is_mapped() const;
 
   INLINE time_t get_timestamp() const;
   INLINE void set_timestamp(time_t timestamp);
@@ -67,6 +72,12 @@ PUBLISHED:
   void set_scale_factor(size_t scale_factor);
   INLINE size_t get_scale_factor() const;
 
+  INLINE void set_num_threads(int num_threads);
+  INLINE int get_num_threads() const;
+
+  INLINE void set_compression_codec(CompressionCodec codec);
+  INLINE CompressionCodec get_compression_codec() const;
+
   INLINE void set_encryption_flag(bool flag);
   INLINE bool get_encryption_flag() const;
 
@@ -120,6 +131,7 @@ PUBLISHED:
   size_t get_subfile_length(int index) const;
   time_t get_subfile_timestamp(int index) const;
   bool is_subfile_compressed(int index) const;
+  CompressionCodec get_subfile_compression_codec(int index) const;
   bool is_subfile_encrypted(int index) const;
   bool is_subfile_text(int index) const;
 
@@ -165,6 +177,7 @@ public:
 
   bool read_subfile(int index, std::string &result);
   bool read_subfile(int index, vector_uchar &result);
+  const char *get_subfile_data(int index) const;
 
 private:
   enum SubfileFlags {
@@ -175,6 +188,7 @@ private:
     SF_encrypted      = 0x0010,
     SF_signature      = 0x0020,
     SF_text           = 0x0040,
+    SF_zstd           = 0x0080,
   };
 
   class Subfile {
@@ -185,6 +199,7 @@ private:
                          Multifile *multfile);
     std::streampos write_index(std::ostream &write, std::streampos fpos,
                           Multifile *multifile);
+    bool encode_data(Multifile *multifile);
     std::streampos write_data(std::ostream &write, std::istream *read, std::streampos fpos,
                          Multifile *multifile);
     void rewrite_index_data_start(std::ostream &write, Multifile *multifile);
@@ -193,6 +208,7 @@ private:
     INLINE bool is_index_invalid() const;
     INLINE bool is_data_invalid() const;
     INLINE bool is_cert_special() const;
+    INLINE CompressionCodec get_compression_codec() const;
     INLINE std::streampos get_last_byte_pos() const;
 
     std::string _name;
@@ -206,6 +222,8 @@ private:
     Filename _source_filename;
     int _flags;
     int _compression_level;  // Not preserved on disk.
+    bool _encoded;           // Not preserved on disk.
+    vector_uchar _encoded_data;
 #ifdef HAVE_OPENSSL
     EVP_PKEY *_pkey;         // Not preserved on disk.
 #endif // HAVE_OPENSSL
@@ -217,10 +235,13 @@ private:
   std::streampos pad_to_streampos(std::streampos fpos);
 
   void add_new_subfile(Subfile *subfile, int compression_level);
+  size_t encode_subfiles(const pvector<Subfile *> &subfiles, size_t begin);
   std::istream *open_read_subfile(Subfile *subfile);
+  bool is_subfile_mapped(const Subfile *subfile) const;
   std::string standardize_subfile_name(const std::string &subfile_name) const;
 
   void clear_subfiles();
+  void rebuild_name_index();
   bool read_index();
   bool write_header();
 
@@ -235,6 +256,12 @@ private:
   PendingSubfiles _removed_subfiles;
   PendingSubfiles _cert_special;
 
+  // An open-addressed hash table of indices into _subfiles, keyed on the
+  // subfile name, to speed up find_subfile() on large Multifiles.  This is
+  // emptied whenever _subfiles is modified, in which case find_subfile()
+  // falls back to a binary search until the next read_index() or flush().
+  vector_int _name_index;
+
 #ifdef HAVE_OPENSSL
   typedef pvector<CertChain> Certificates;
   Certificates _signatures;
@@ -242,11 +269,14 @@ private:
 
   std::streampos _offset;
   IStreamWrapper *_read;
+  PT(MappedFile) _mapped;
   std::ostream *_write;
   bool _owns_stream;
   std::streampos _next_index;
   std::streampos _last_index;
   std::streampos _last_data_byte;
+  int _num_threads;
+  CompressionCodec _compression_codec;
 
   bool _needs_repack;
   time_t _timestamp;
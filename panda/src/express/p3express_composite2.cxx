@@ -21,6 +21,7 @@
 #include "virtualFileMountRamdisk.cxx"
 #include "virtualFileMountSystem.cxx"
 #include "virtualFileMountZip.cxx"
+#include "virtualFilePrefetcher.cxx"
 #include "virtualFileSimple.cxx"
 #include "virtualFileSystem.cxx"
 #include "weakPointerCallback.cxx"
@@ -31,4 +32,5 @@
 #include "windowsRegistry.cxx"
 #include "zStream.cxx"
 #include "zStreamBuf.cxx"
+#include "zstdStreamBuf.cxx"
 #include "zipArchive.cxx"
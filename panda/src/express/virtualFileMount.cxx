@@ -123,6 +123,17 @@ is_writable(const Filename &file) const {
   return false;
 }
 
+/**
+ * Returns true if the contents of this mount cannot change for as long as it
+ * remains mounted, for instance because it is backed by a Multifile that is
+ * only open for reading.  The VirtualFileSystem only caches the results of
+ * lookups that pass through such mounts.
+ */
+bool VirtualFileMount::
+is_read_only() const {
+  return false;
+}
+
 /**
  * Fills up the indicated pvector with the contents of the file, if it is a
  * regular file.  Returns true on success, false otherwise.
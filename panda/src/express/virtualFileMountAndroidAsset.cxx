@@ -91,6 +91,15 @@ is_regular_file(const Filename &file) const {
   return true;
 }
 
+/**
+ * Returns true, since the assets packaged with the application cannot be
+ * modified at runtime.
+ */
+bool VirtualFileMountAndroidAsset::
+is_read_only() const {
+  return true;
+}
+
 /**
  * Fills up the indicated pvector with the contents of the file, if it is a
  * regular file.  Returns true on success, false otherwise.
@@ -53,6 +53,15 @@ is_regular_file(const Filename &file) const {
   return (_multifile->find_subfile(file) >= 0);
 }
 
+/**
+ * Returns true if the Multifile is only open for reading, in which case its
+ * contents cannot change while it is mounted.
+ */
+bool VirtualFileMountMultifile::
+is_read_only() const {
+  return !_multifile->is_write_valid();
+}
+
 /**
  * Fills up the indicated pvector with the contents of the file, if it is a
  * regular file.  Returns true on success, false otherwise.
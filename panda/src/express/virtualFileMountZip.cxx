@@ -56,6 +56,15 @@ is_regular_file(const Filename &file) const {
   return (_archive->find_subfile(path) >= 0);
 }
 
+/**
+ * Returns true if the ZipArchive is only open for reading, in which case its
+ * contents cannot change while it is mounted.
+ */
+bool VirtualFileMountZip::
+is_read_only() const {
+  return !_archive->is_write_valid();
+}
+
 /**
  * Fills up the indicated pvector with the contents of the file, if it is a
  * regular file.  Returns true on success, false otherwise.
@@ -35,6 +35,7 @@ public:
   virtual bool has_file(const Filename &file) const;
   virtual bool is_directory(const Filename &file) const;
   virtual bool is_regular_file(const Filename &file) const;
+  virtual bool is_read_only() const;
 
   virtual bool read_file(const Filename &file, bool do_uncompress,
                          vector_uchar &result) const;
@@ -0,0 +1,321 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file virtualFilePrefetcher.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "virtualFilePrefetcher.h"
+#include "config_express.h"
+
+using std::string;
+
+/**
+ *
+ */
+VirtualFilePrefetcher::
+VirtualFilePrefetcher() :
+  _cache_size(0),
+  _num_entries(0),
+  _num_hits(0),
+  _num_misses(0)
+{
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+  _shutdown = false;
+#endif
+}
+
+/**
+ *
+ */
+VirtualFilePrefetcher::
+~VirtualFilePrefetcher() {
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+  _lock.lock();
+  _shutdown = true;
+  _queue.clear();
+  _cvar.notify_all();
+  _lock.unlock();
+
+  for (std::thread &thread : _threads) {
+    thread.join();
+  }
+#endif
+}
+
+/**
+ * Queues up the indicated file to be read by one of the background threads.
+ * Does nothing if the file is already in the cache.  If threading is not
+ * available, the file is read immediately instead.
+ */
+void VirtualFilePrefetcher::
+prefetch(VirtualFileSimple *file) {
+  string key = file->get_filename().get_fullpath();
+
+  _lock.lock();
+  std::pair<Entries::iterator, bool> result = _entries.insert(Entries::value_type(key, Entry()));
+  if (!result.second) {
+    // Already queued, or already read.
+    _lock.unlock();
+    return;
+  }
+
+  Entry &entry = (*result.first).second;
+  entry._state = S_queued;
+  entry._mount = file->get_mount();
+  entry._do_uncompress = get_do_uncompress(file, true);
+  AtomicAdjust::inc(_num_entries);
+
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+  if (_threads.empty()) {
+    int num_threads = vfs_prefetch_threads;
+    if (num_threads <= 0) {
+      num_threads = std::max((int)std::thread::hardware_concurrency(), 1);
+    }
+    for (int i = 0; i < num_threads; ++i) {
+      _threads.push_back(std::thread(&VirtualFilePrefetcher::thread_main, this));
+    }
+  }
+
+  QueuedFile queued;
+  queued._file = file;
+  queued._mount = file->get_mount();
+  _queue.push_back(std::move(queued));
+  _cvar.notify_one();
+  _lock.unlock();
+
+#else
+  entry._state = S_reading;
+  _lock.unlock();
+
+  vector_uchar data;
+  bool success = read_file(file, data);
+
+  _lock.lock();
+  finish_file(key, success, data);
+  _lock.unlock();
+#endif
+}
+
+/**
+ * Called by VirtualFileSimple when the indicated file is about to be read.
+ * If the file has been prefetched, fills result with its contents, removes it
+ * from the cache and returns true.  If the file is still being read by a
+ * background thread, waits for it to finish first.  Otherwise, returns false
+ * and the caller should read the file itself.
+ */
+bool VirtualFilePrefetcher::
+take_file(const VirtualFileSimple *file, bool do_uncompress,
+          vector_uchar &result) {
+  if (AtomicAdjust::get(_num_entries) == 0) {
+    // Nothing has been prefetched; don't bother to look, or to count this as
+    // a miss.
+    return false;
+  }
+
+  string key = file->get_filename().get_fullpath();
+
+  _lock.lock();
+  Entries::iterator ei = _entries.find(key);
+
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+  while (ei != _entries.end() && (*ei).second._state == S_reading) {
+    // One of the threads is reading it right now; it would be a waste to
+    // read it again.
+    _cvar.wait(_lock);
+    ei = _entries.find(key);
+  }
+#endif
+
+  if (ei == _entries.end() ||
+      (*ei).second._mount != file->get_mount() ||
+      (*ei).second._do_uncompress != do_uncompress) {
+    // We don't have it, or we read it from a different mount, or in a
+    // different way than what is being asked for now.
+    _lock.unlock();
+    AtomicAdjust::inc(_num_misses);
+    return false;
+  }
+
+  Entry &entry = (*ei).second;
+  if (entry._state != S_ready) {
+    // It hasn't been started yet.  We can read it faster ourselves than by
+    // waiting for the queue to get to it.
+    _entries.erase(ei);
+    AtomicAdjust::dec(_num_entries);
+    _lock.unlock();
+    AtomicAdjust::inc(_num_misses);
+    return false;
+  }
+
+  result.swap(entry._data);
+  _cache_size -= result.size();
+  _entries.erase(ei);
+  if (!AtomicAdjust::dec(_num_entries)) {
+    _order.clear();
+  }
+  _lock.unlock();
+
+  AtomicAdjust::inc(_num_hits);
+  return true;
+}
+
+/**
+ * Discards all of the prefetched files, and any that are waiting to be read.
+ */
+void VirtualFilePrefetcher::
+clear() {
+  _lock.lock();
+  _entries.clear();
+  _order.clear();
+  _queue.clear();
+  _cache_size = 0;
+  AtomicAdjust::set(_num_entries, 0);
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+  _cvar.notify_all();
+#endif
+  _lock.unlock();
+}
+
+/**
+ * Returns the total number of bytes of file data currently held in the cache.
+ */
+size_t VirtualFilePrefetcher::
+get_cache_size() const {
+  _lock.lock();
+  size_t cache_size = _cache_size;
+  _lock.unlock();
+  return cache_size;
+}
+
+/**
+ * Resets the counts returned by get_num_hits() and get_num_misses() to zero.
+ */
+void VirtualFilePrefetcher::
+reset_statistics() {
+  AtomicAdjust::set(_num_hits, 0);
+  AtomicAdjust::set(_num_misses, 0);
+}
+
+/**
+ * Returns true if reading the indicated file with the given auto_unwrap flag
+ * will decompress it.  This mirrors the logic in VirtualFileSimple.
+ */
+bool VirtualFilePrefetcher::
+get_do_uncompress(const VirtualFileSimple *file, bool auto_unwrap) {
+  if (file->is_implicit_pz_file()) {
+    return true;
+  }
+  if (!auto_unwrap) {
+    return false;
+  }
+  string extension = file->get_local_filename().get_extension();
+  return (extension == "pz" || extension == "gz");
+}
+
+/**
+ * Reads the entire contents of the file, as VirtualFileSimple::read_file()
+ * would with auto_unwrap set, but without consulting the cache.
+ */
+bool VirtualFilePrefetcher::
+read_file(VirtualFileSimple *file, vector_uchar &result) {
+  bool do_uncompress = get_do_uncompress(file, true);
+  Filename local_filename(file->get_local_filename());
+  if (do_uncompress) {
+    local_filename.set_binary();
+  }
+  return file->get_mount()->read_file(local_filename, do_uncompress, result);
+}
+
+/**
+ * Stores the data that was read for the indicated file, if it is still
+ * wanted.  Assumes the lock is held.
+ */
+void VirtualFilePrefetcher::
+finish_file(const string &key, bool success, vector_uchar &data) {
+  Entries::iterator ei = _entries.find(key);
+  if (ei == _entries.end() || (*ei).second._state != S_reading) {
+    // The cache was cleared, or somebody gave up on it, while we were busy
+    // reading it.
+    return;
+  }
+
+  size_t max_size = (size_t)std::max(vfs_prefetch_cache_size.get_value(), (int64_t)0);
+  if (!success || data.size() > max_size) {
+    _entries.erase(ei);
+    AtomicAdjust::dec(_num_entries);
+    return;
+  }
+
+  evict(data.size());
+
+  Entry &entry = (*ei).second;
+  entry._data.swap(data);
+  entry._state = S_ready;
+  _cache_size += entry._data.size();
+  _order.push_back(key);
+}
+
+/**
+ * Discards the oldest prefetched files, until there is room for the indicated
+ * number of additional bytes.  Assumes the lock is held.
+ */
+void VirtualFilePrefetcher::
+evict(size_t size) {
+  size_t max_size = (size_t)std::max(vfs_prefetch_cache_size.get_value(), (int64_t)0);
+  while (_cache_size + size > max_size && !_order.empty()) {
+    Entries::iterator ei = _entries.find(_order.front());
+    _order.pop_front();
+    if (ei != _entries.end() && (*ei).second._state == S_ready) {
+      if (express_cat.is_debug()) {
+        express_cat.debug()
+          << "Discarding unused prefetched file " << (*ei).first << "\n";
+      }
+      _cache_size -= (*ei).second._data.size();
+      _entries.erase(ei);
+      AtomicAdjust::dec(_num_entries);
+    }
+  }
+}
+
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+/**
+ * The main loop of each of the background threads.
+ */
+void VirtualFilePrefetcher::
+thread_main() {
+  _lock.lock();
+  while (!_shutdown) {
+    if (_queue.empty()) {
+      _cvar.wait(_lock);
+      continue;
+    }
+
+    QueuedFile queued = std::move(_queue.front());
+    _queue.pop_front();
+
+    string key = queued._file->get_filename().get_fullpath();
+    Entries::iterator ei = _entries.find(key);
+    if (ei == _entries.end() || (*ei).second._state != S_queued) {
+      // It was already taken off our hands.
+      continue;
+    }
+    (*ei).second._state = S_reading;
+    _lock.unlock();
+
+    vector_uchar data;
+    bool success = read_file(queued._file, data);
+
+    _lock.lock();
+    finish_file(key, success, data);
+    _cvar.notify_all();
+  }
+  _lock.unlock();
+}
+#endif  // HAVE_THREADS && !SIMPLE_THREADS
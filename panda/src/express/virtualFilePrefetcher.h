@@ -0,0 +1,116 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file virtualFilePrefetcher.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef VIRTUALFILEPREFETCHER_H
+#define VIRTUALFILEPREFETCHER_H
+
+#include "pandabase.h"
+#include "virtualFileSimple.h"
+#include "virtualFileMount.h"
+#include "pointerTo.h"
+#include "pmap.h"
+#include "pdeque.h"
+#include "pvector.h"
+#include "vector_uchar.h"
+#include "mutexImpl.h"
+#include "atomicAdjust.h"
+
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+#include <condition_variable>
+#include <thread>
+#endif
+
+/**
+ * Reads files ahead of time on behalf of VirtualFileSystem::prefetch(),
+ * using a small pool of background threads, and holds on to their contents
+ * until they are read through the VirtualFileSystem.  Each prefetched file is
+ * handed out only once, after which it is removed from the cache.
+ *
+ * This is an internal class; use the prefetch() interface on the
+ * VirtualFileSystem instead.
+ */
+class EXPCL_PANDA_EXPRESS VirtualFilePrefetcher {
+public:
+  VirtualFilePrefetcher();
+  ~VirtualFilePrefetcher();
+
+  void prefetch(VirtualFileSimple *file);
+  bool take_file(const VirtualFileSimple *file, bool do_uncompress,
+                 vector_uchar &result);
+  void clear();
+
+  size_t get_cache_size() const;
+  INLINE int get_num_hits() const;
+  INLINE int get_num_misses() const;
+  void reset_statistics();
+
+  static bool get_do_uncompress(const VirtualFileSimple *file, bool auto_unwrap);
+
+private:
+  static bool read_file(VirtualFileSimple *file, vector_uchar &result);
+  void finish_file(const std::string &key, bool success, vector_uchar &data);
+  void evict(size_t size);
+
+  enum State {
+    S_queued,
+    S_reading,
+    S_ready,
+  };
+
+  class Entry {
+  public:
+    State _state;
+    VirtualFileMount *_mount;
+    bool _do_uncompress;
+    vector_uchar _data;
+  };
+
+  typedef pmap<std::string, Entry> Entries;
+  Entries _entries;
+
+  // The keys of the ready entries, in the order in which they were read, so
+  // that the oldest may be evicted first.  This may also contain the keys of
+  // entries that have since been removed; these are simply skipped.
+  typedef pdeque<std::string> Order;
+  Order _order;
+
+  // VirtualFileSimple doesn't hold a reference to its mount, so we do, in
+  // case it is unmounted while the file is waiting to be read.
+  class QueuedFile {
+  public:
+    PT(VirtualFileSimple) _file;
+    PT(VirtualFileMount) _mount;
+  };
+  typedef pdeque<QueuedFile> Queue;
+  Queue _queue;
+
+  size_t _cache_size;
+  AtomicAdjust::Integer _num_entries;
+  AtomicAdjust::Integer _num_hits;
+  AtomicAdjust::Integer _num_misses;
+
+  mutable MutexImpl _lock;
+
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+  void thread_main();
+
+  // Signaled whenever a file is queued or finishes reading.
+  std::condition_variable_any _cvar;
+  pvector<std::thread> _threads;
+  bool _shutdown;
+#endif
+};
+
+#include "virtualFilePrefetcher.I"
+
+#endif
@@ -14,6 +14,8 @@
 #include "virtualFileSimple.h"
 #include "virtualFileMount.h"
 #include "virtualFileList.h"
+#include "virtualFileSystem.h"
+#include "stringStream.h"
 #include "dcast.h"
 
 using std::iostream;
@@ -213,6 +215,15 @@ open_read_file(bool auto_unwrap) const {
     (auto_unwrap && (_local_filename.get_extension() == "pz" ||
                      _local_filename.get_extension() == "gz")));
 
+  // If it was prefetched, we already have the contents in memory.
+  VirtualFileSystem *vfs = _mount->get_file_system();
+  if (vfs != nullptr) {
+    vector_uchar data;
+    if (vfs->get_prefetcher().take_file(this, do_uncompress, data)) {
+      return new StringStream(std::move(data));
+    }
+  }
+
   Filename local_filename(_local_filename);
   if (do_uncompress) {
     // .pz files are always binary, of course.
@@ -384,6 +395,11 @@ read_file(vector_uchar &result, bool auto_unwrap) const {
     (auto_unwrap && (_local_filename.get_extension() == "pz" ||
                      _local_filename.get_extension() == "gz")));
 
+  VirtualFileSystem *vfs = _mount->get_file_system();
+  if (vfs != nullptr && vfs->get_prefetcher().take_file(this, do_uncompress, result)) {
+    return true;
+  }
+
   Filename local_filename(_local_filename);
   if (do_uncompress) {
     // .pz files are always binary, of course.
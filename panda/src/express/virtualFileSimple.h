@@ -33,6 +33,7 @@ public:
 PUBLISHED:
   virtual VirtualFileSystem *get_file_system() const;
   INLINE VirtualFileMount *get_mount() const;
+  INLINE const Filename &get_local_filename() const;
   virtual Filename get_filename() const;
 
   virtual bool has_file() const;
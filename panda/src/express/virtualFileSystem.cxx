@@ -74,7 +74,15 @@ VirtualFileSystem() :
             "will implicitly retrieve a file named 'dirname/mytex.jpg' "
             "within the multifile /c/files/foo.mf, even if the multifile "
             "has not already been mounted.  This makes all of your multifiles "
-            "act like directories."))
+            "act like directories.")),
+  vfs_path_cache
+  ("vfs-path-cache", true,
+   PRC_DESC("When this is true, the VirtualFileSystem remembers which mount "
+            "point each file was found in, so that repeated lookups of the "
+            "same file need not search all of the mount points again.  Only "
+            "files found within read-only mounts, such as Multifiles opened "
+            "for reading, are remembered, and the cache is cleared whenever "
+            "anything is mounted or unmounted."))
 {
   _cwd = "/";
   _mount_seq = 0;
@@ -306,6 +314,8 @@ unmount(Multifile *multifile) {
   int num_removed = _mounts.end() - wi;
   _mounts.erase(wi, _mounts.end());
   ++_mount_seq;
+  _path_cache.clear();
+  _prefetcher.clear();
   _lock.unlock();
   return num_removed;
 }
@@ -348,6 +358,8 @@ unmount(ZipArchive *archive) {
   int num_removed = _mounts.end() - wi;
   _mounts.erase(wi, _mounts.end());
   ++_mount_seq;
+  _path_cache.clear();
+  _prefetcher.clear();
   _lock.unlock();
   return num_removed;
 }
@@ -407,6 +419,8 @@ unmount(const Filename &physical_filename) {
   int num_removed = _mounts.end() - wi;
   _mounts.erase(wi, _mounts.end());
   ++_mount_seq;
+  _path_cache.clear();
+  _prefetcher.clear();
   _lock.unlock();
   return num_removed;
 }
@@ -440,6 +454,8 @@ unmount(VirtualFileMount *mount) {
   int num_removed = _mounts.end() - wi;
   _mounts.erase(wi, _mounts.end());
   ++_mount_seq;
+  _path_cache.clear();
+  _prefetcher.clear();
   _lock.unlock();
   return num_removed;
 }
@@ -476,6 +492,8 @@ unmount_point(const Filename &mount_point) {
   int num_removed = _mounts.end() - wi;
   _mounts.erase(wi, _mounts.end());
   ++_mount_seq;
+  _path_cache.clear();
+  _prefetcher.clear();
   _lock.unlock();
   return num_removed;
 }
@@ -500,6 +518,8 @@ unmount_all() {
   int num_removed = _mounts.size();
   _mounts.clear();
   ++_mount_seq;
+  _path_cache.clear();
+  _prefetcher.clear();
   _lock.unlock();
   return num_removed;
 }
@@ -839,6 +859,54 @@ write(ostream &out) const {
 }
 
 
+/**
+ * Starts reading the indicated file on a background thread, so that a later
+ * attempt to read it, through read_file() or open_read_file(), may be
+ * satisfied from memory instead of waiting for the disk.  This is meant to be
+ * called with the list of files that will soon be needed, for instance when
+ * the player approaches a new zone.
+ *
+ * The file is read as if with auto_unwrap set, so a .pz file is also
+ * decompressed in the background.  Each prefetched file is only handed out
+ * once; a file that is not read before vfs-prefetch-cache-size bytes of newer
+ * files have been prefetched is discarded.  Files that do not exist, or are
+ * not regular files, are silently ignored.
+ */
+void VirtualFileSystem::
+prefetch(const Filename &filename) {
+  PT(VirtualFile) file = get_file(filename, false);
+  if (file == nullptr || !file->is_of_type(VirtualFileSimple::get_class_type()) ||
+      !file->is_regular_file()) {
+    if (express_cat.is_debug()) {
+      express_cat.debug()
+        << "Not prefetching " << filename << ", not a regular file.\n";
+    }
+    return;
+  }
+
+  _prefetcher.prefetch(DCAST(VirtualFileSimple, file));
+}
+
+/**
+ * Starts reading each of the indicated files on a background thread.  See
+ * the single-file version of prefetch().
+ */
+void VirtualFileSystem::
+prefetch(const vector_string &filenames) {
+  for (const string &filename : filenames) {
+    prefetch(Filename(filename));
+  }
+}
+
+/**
+ * Discards all of the files that have been read by prefetch() but not yet
+ * read, and cancels those still waiting to be read.
+ */
+void VirtualFileSystem::
+clear_prefetch_cache() {
+  _prefetcher.clear();
+}
+
 /**
  * Returns the default global VirtualFileSystem.  You may create your own
  * personal VirtualFileSystem objects and use them for whatever you like, but
@@ -1285,6 +1353,7 @@ do_mount(VirtualFileMount *mount, const Filename &mount_point, int flags) {
   mount->_mount_flags = flags;
   _mounts.push_back(mount);
   ++_mount_seq;
+  _path_cache.clear();
   return true;
 }
 
@@ -1310,6 +1379,22 @@ do_get_file(const Filename &filename, int open_flags) const {
   // Also transparently look for a regular file suffixed .pz.
   Filename strpath_pz = strpath + ".pz";
 
+  // Only plain lookups are cached; those that may create a file must always
+  // go through the mounts.
+  bool use_cache = vfs_path_cache && (open_flags & ~OF_status_only) == 0;
+  if (use_cache) {
+    PathCache::const_iterator ci = _path_cache.find(strpath);
+    if (ci != _path_cache.end()) {
+      const PathCacheEntry &entry = (*ci).second;
+      PT(VirtualFile) vfile =
+        entry._mount->make_virtual_file(entry._local_filename, pathname, false, open_flags);
+      if (vfile->has_file()) {
+        return vfile;
+      }
+      _path_cache.erase(strpath);
+    }
+  }
+
   // Now scan all the mount points, from the back (since later mounts override
   // more recent ones), until a match is found.
   PT(VirtualFile) found_file = nullptr;
@@ -1331,16 +1416,25 @@ do_get_file(const Filename &filename, int open_flags) const {
                          false, open_flags)) {
         return found_file;
       }
+      use_cache = false;
+
     } else if (mount_point.empty()) {
       // This is the root mount point; all files are in here.
+      use_cache = use_cache && mount->is_read_only();
       if (consider_match(found_file, composite_file, mount, strpath,
                          pathname, false, open_flags)) {
+        if (use_cache && found_file->is_regular_file()) {
+          record_path(strpath, mount, strpath);
+        }
         return found_file;
       }
 #ifdef HAVE_ZLIB
       if (vfs_implicit_pz) {
         if (consider_match(found_file, composite_file, mount, strpath_pz,
                            pathname, true, open_flags)) {
+          if (use_cache && found_file->is_regular_file()) {
+            record_path(strpath, mount, strpath_pz);
+          }
           return found_file;
         }
       }
@@ -1350,10 +1444,14 @@ do_get_file(const Filename &filename, int open_flags) const {
                mount_point == strpath.substr(0, mount_point.length()) &&
                strpath[mount_point.length()] == '/') {
       // This pathname falls within this mount system.
+      use_cache = use_cache && mount->is_read_only();
       Filename local_filename = strpath.substr(mount_point.length() + 1);
       Filename local_filename_pz = strpath_pz.substr(mount_point.length() + 1);
       if (consider_match(found_file, composite_file, mount, local_filename,
                          pathname, false, open_flags)) {
+        if (use_cache && found_file->is_regular_file()) {
+          record_path(strpath, mount, local_filename);
+        }
         return found_file;
       }
 #ifdef HAVE_ZLIB
@@ -1361,6 +1459,9 @@ do_get_file(const Filename &filename, int open_flags) const {
         // Bingo!
         if (consider_match(found_file, composite_file, mount, local_filename_pz,
                            pathname, true, open_flags)) {
+          if (use_cache && found_file->is_regular_file()) {
+            record_path(strpath, mount, local_filename_pz);
+          }
           return found_file;
         }
       }
@@ -1408,6 +1509,20 @@ do_get_file(const Filename &filename, int open_flags) const {
   return found_file;
 }
 
+/**
+ * Remembers that the indicated path, relative to the root, was found as the
+ * indicated local filename within the given mount, so that the next call to
+ * do_get_file() for the same path can skip the search.  Assumes the lock is
+ * already held.
+ */
+void VirtualFileSystem::
+record_path(const string &strpath, VirtualFileMount *mount,
+            const Filename &local_filename) const {
+  PathCacheEntry &entry = _path_cache[strpath];
+  entry._mount = mount;
+  entry._local_filename = local_filename;
+}
+
 /**
  * Evaluates one possible filename match found during a get_file() operation.
  * There may be multiple matches for a particular filename due to the
@@ -25,7 +25,9 @@
 #include "config_express.h"
 #include "mutexImpl.h"
 #include "pvector.h"
+#include "pmap.h"
 #include "zipArchive.h"
+#include "virtualFilePrefetcher.h"
 
 class Multifile;
 class VirtualFileComposite;
@@ -94,6 +96,14 @@ PUBLISHED:
   INLINE void ls(const Filename &filename) const;
   INLINE void ls_all(const Filename &filename) const;
 
+  void prefetch(const Filename &filename);
+  void prefetch(const vector_string &filenames);
+  void clear_prefetch_cache();
+  INLINE size_t get_prefetch_cache_size() const;
+  INLINE int get_prefetch_hits() const;
+  INLINE int get_prefetch_misses() const;
+  INLINE void reset_prefetch_stats();
+
   void write(std::ostream &out) const;
 
   static VirtualFileSystem *get_global_ptr();
@@ -126,6 +136,8 @@ public:
 
   void scan_mount_points(vector_string &names, const Filename &path) const;
 
+  INLINE VirtualFilePrefetcher &get_prefetcher();
+
   static void parse_options(const std::string &options,
                             int &flags, std::string &password);
   static void parse_option(const std::string &option,
@@ -148,6 +160,7 @@ public:
   ConfigVariableBool vfs_case_sensitive;
   ConfigVariableBool vfs_implicit_pz;
   ConfigVariableBool vfs_implicit_mf;
+  ConfigVariableBool vfs_path_cache;
 
 private:
   Filename normalize_mount_point(const Filename &mount_point) const;
@@ -159,12 +172,27 @@ private:
                       const Filename &original_filename, bool implicit_pz_file,
                       int open_flags) const;
   bool consider_mount_mf(const Filename &filename);
+  void record_path(const std::string &strpath, VirtualFileMount *mount,
+                   const Filename &local_filename) const;
 
   mutable MutexImpl _lock;
   typedef pvector<PT(VirtualFileMount) > Mounts;
   Mounts _mounts;
   unsigned int _mount_seq;
 
+  // Remembers which mount each path was found in, for paths that resolved to
+  // a regular file within a read-only mount.  Cleared whenever the set of
+  // mounts changes.
+  class PathCacheEntry {
+  public:
+    PT(VirtualFileMount) _mount;
+    Filename _local_filename;
+  };
+  typedef pmap<std::string, PathCacheEntry> PathCache;
+  mutable PathCache _path_cache;
+
+  VirtualFilePrefetcher _prefetcher;
+
   Filename _cwd;
 
   static VirtualFileSystem *_global_ptr;
@@ -0,0 +1,367 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file zstdStreamBuf.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "zstdStreamBuf.h"
+
+#ifdef HAVE_ZSTD
+
+#include "pnotify.h"
+#include "config_express.h"
+
+#include <zstd.h>
+
+using std::ios;
+using std::streamoff;
+using std::streampos;
+
+/**
+ *
+ */
+ZstdStreamBuf::
+ZstdStreamBuf() {
+  _source = nullptr;
+  _owns_source = false;
+  _z_source = nullptr;
+  _total_out = 0;
+  _dest = nullptr;
+  _owns_dest = false;
+  _z_dest = nullptr;
+
+  _in_buffer_size = ZSTD_DStreamInSize();
+  _in_buffer = (char *)PANDA_MALLOC_ARRAY(_in_buffer_size);
+  _in_pos = 0;
+  _in_size = 0;
+
+  _buffer = (char *)PANDA_MALLOC_ARRAY(4096);
+  char *ebuf = _buffer + 4096;
+  setg(_buffer, ebuf, ebuf);
+  setp(_buffer, ebuf);
+}
+
+/**
+ *
+ */
+ZstdStreamBuf::
+~ZstdStreamBuf() {
+  close_read();
+  close_write();
+
+  if (_z_source != nullptr) {
+    ZSTD_freeDStream(_z_source);
+  }
+  if (_z_dest != nullptr) {
+    ZSTD_freeCStream(_z_dest);
+  }
+  PANDA_FREE_ARRAY(_in_buffer);
+  PANDA_FREE_ARRAY(_buffer);
+}
+
+/**
+ *
+ */
+void ZstdStreamBuf::
+open_read(std::istream *source, bool owns_source, std::streamsize source_length) {
+  _source = source;
+  _source_bytes_left = source_length;
+  _owns_source = owns_source;
+  _total_out = 0;
+  _in_pos = 0;
+  _in_size = 0;
+
+  // The decompression context is kept around, so that it may be reused if
+  // the streambuf is reopened.
+  if (_z_source == nullptr) {
+    _z_source = ZSTD_createDStream();
+  }
+  size_t result = ZSTD_DCtx_reset(_z_source, ZSTD_reset_session_only);
+  if (ZSTD_isError(result)) {
+    show_zstd_error("ZSTD_DCtx_reset", result);
+    close_read();
+  }
+}
+
+/**
+ *
+ */
+void ZstdStreamBuf::
+close_read() {
+  _source_bytes_left = 0;
+
+  if (_source != nullptr) {
+    if (_owns_source) {
+      delete _source;
+      _owns_source = false;
+    }
+    _source = nullptr;
+  }
+}
+
+/**
+ *
+ */
+void ZstdStreamBuf::
+open_write(std::ostream *dest, bool owns_dest, int compression_level) {
+  _dest = dest;
+  _owns_dest = owns_dest;
+
+  if (_z_dest == nullptr) {
+    _z_dest = ZSTD_createCStream();
+  }
+  ZSTD_CCtx_reset(_z_dest, ZSTD_reset_session_only);
+  size_t result = ZSTD_CCtx_setParameter(_z_dest, ZSTD_c_compressionLevel,
+                                         compression_level);
+  if (ZSTD_isError(result)) {
+    show_zstd_error("ZSTD_CCtx_setParameter", result);
+    close_write();
+  }
+}
+
+/**
+ *
+ */
+void ZstdStreamBuf::
+close_write() {
+  if (_dest != nullptr) {
+    size_t n = pptr() - pbase();
+    write_chars(pbase(), n, ZSTD_e_end);
+    pbump(-(int)n);
+
+    if (_owns_dest) {
+      delete _dest;
+      _owns_dest = false;
+    }
+    _dest = nullptr;
+  }
+}
+
+/**
+ * Implements seeking within the stream.  ZstdStreamBuf only allows seeking
+ * back to the beginning of the stream.
+ */
+streampos ZstdStreamBuf::
+seekoff(streamoff off, ios_seekdir dir, ios_openmode which) {
+  if (which != ios::in) {
+    // We can only do this with the input stream.
+    return -1;
+  }
+
+  // Determine the current position.
+  size_t n = egptr() - gptr();
+  streampos gpos = _total_out - n;
+
+  // Implement tellg() and seeks to current position.
+  if ((dir == ios::cur && off == 0) ||
+      (dir == ios::beg && off == gpos)) {
+    return gpos;
+  }
+
+  if (off != 0 || dir != ios::beg) {
+    // We only know how to reposition to the beginning.
+    return -1;
+  }
+
+  gbump(n);
+
+  if (_source->rdbuf()->pubseekpos(0, ios::in) == (streampos)0) {
+    _source->clear();
+    _total_out = 0;
+    _in_pos = 0;
+    _in_size = 0;
+    ZSTD_DCtx_reset(_z_source, ZSTD_reset_session_only);
+    return 0;
+  }
+
+  return -1;
+}
+
+/**
+ * Implements seeking within the stream.  ZstdStreamBuf only allows seeking
+ * back to the beginning of the stream.
+ */
+streampos ZstdStreamBuf::
+seekpos(streampos pos, ios_openmode which) {
+  return seekoff(pos, ios::beg, which);
+}
+
+/**
+ * Called by the system ostream implementation when its internal buffer is
+ * filled, plus one character.
+ */
+int ZstdStreamBuf::
+overflow(int ch) {
+  size_t n = pptr() - pbase();
+  if (n != 0) {
+    write_chars(pbase(), n, ZSTD_e_continue);
+    pbump(-(int)n);
+  }
+
+  if (ch != EOF) {
+    // Write one more character.
+    char c = ch;
+    write_chars(&c, 1, ZSTD_e_continue);
+  }
+
+  return 0;
+}
+
+/**
+ * Called by the system iostream implementation to implement a flush
+ * operation.
+ */
+int ZstdStreamBuf::
+sync() {
+  if (_source != nullptr) {
+    size_t n = egptr() - gptr();
+    gbump(n);
+  }
+
+  if (_dest != nullptr) {
+    size_t n = pptr() - pbase();
+    write_chars(pbase(), n, ZSTD_e_flush);
+    pbump(-(int)n);
+    _dest->flush();
+  }
+
+  return 0;
+}
+
+/**
+ * Called by the system istream implementation when its internal buffer needs
+ * more characters.
+ */
+int ZstdStreamBuf::
+underflow() {
+  // Sometimes underflow() is called even if the buffer is not empty.
+  if (gptr() >= egptr()) {
+    size_t buffer_size = egptr() - eback();
+    gbump(-(int)buffer_size);
+
+    size_t num_bytes = buffer_size;
+    size_t read_count = read_chars(gptr(), buffer_size);
+
+    if (read_count != num_bytes) {
+      // Oops, we didn't read what we thought we would.
+      if (read_count == 0) {
+        gbump(num_bytes);
+        return EOF;
+      }
+
+      // Slide what we did read to the top of the buffer.
+      nassertr(read_count < num_bytes, EOF);
+      size_t delta = num_bytes - read_count;
+      memmove(gptr() + delta, gptr(), read_count);
+      gbump(delta);
+    }
+  }
+
+  return (unsigned char)*gptr();
+}
+
+/**
+ * Gets some characters from the source stream.
+ */
+size_t ZstdStreamBuf::
+read_chars(char *start, size_t length) {
+  if (_source == nullptr) {
+    return 0;
+  }
+
+  ZSTD_outBuffer out = { start, length, 0 };
+
+  while (out.pos < out.size) {
+    bool no_input = false;
+    if (_in_pos == _in_size) {
+      size_t read_count = 0;
+      if (_source_bytes_left != 0 && !_source->eof() && !_source->fail()) {
+        if (_source_bytes_left >= 0) {
+          // Don't read more than the specified limit.
+          _source->read(_in_buffer,
+            std::min(_source_bytes_left, (std::streamsize)_in_buffer_size));
+          read_count = _source->gcount();
+          _source_bytes_left -= read_count;
+        } else {
+          _source->read(_in_buffer, _in_buffer_size);
+          read_count = _source->gcount();
+        }
+      }
+      _in_pos = 0;
+      _in_size = read_count;
+      no_input = (read_count == 0);
+    }
+
+    // Even without new input, zstd may still have buffered output to flush.
+    ZSTD_inBuffer in = { _in_buffer, _in_size, _in_pos };
+    size_t prev_pos = out.pos;
+    size_t result = ZSTD_decompressStream(_z_source, &out, &in);
+    _in_pos = in.pos;
+    thread_consider_yield();
+
+    if (ZSTD_isError(result)) {
+      show_zstd_error("ZSTD_decompressStream", result);
+      break;
+    }
+    if (no_input && out.pos == prev_pos) {
+      // Here's the end of the file.
+      break;
+    }
+  }
+
+  _total_out += out.pos;
+  return out.pos;
+}
+
+/**
+ * Sends some characters to the dest stream.  The end_op parameter is a
+ * ZSTD_EndDirective, which is passed to ZSTD_compressStream2().
+ */
+void ZstdStreamBuf::
+write_chars(const char *start, size_t length, int end_op) {
+  static const size_t compress_buffer_size = 4096;
+  char compress_buffer[compress_buffer_size];
+
+  ZSTD_inBuffer in = { start, length, 0 };
+  bool finished;
+  do {
+    ZSTD_outBuffer out = { compress_buffer, compress_buffer_size, 0 };
+    size_t remaining = ZSTD_compressStream2(_z_dest, &out, &in, (ZSTD_EndDirective)end_op);
+    thread_consider_yield();
+    if (ZSTD_isError(remaining)) {
+      show_zstd_error("ZSTD_compressStream2", remaining);
+      return;
+    }
+    if (out.pos != 0) {
+      _dest->write(compress_buffer, out.pos);
+    }
+
+    if (end_op == ZSTD_e_continue) {
+      finished = (in.pos == in.size);
+    } else {
+      finished = (remaining == 0);
+    }
+  } while (!finished);
+}
+
+/**
+ * Reports a recent error code returned by zstd.
+ */
+void ZstdStreamBuf::
+show_zstd_error(const char *function, size_t error_code) {
+  std::stringstream error_line;
+
+  error_line
+    << "zstd error in " << function << ": " << ZSTD_getErrorName(error_code);
+
+  express_cat.warning() << error_line.str() << "\n";
+}
+
+#endif  // HAVE_ZSTD
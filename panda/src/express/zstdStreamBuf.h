@@ -0,0 +1,77 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file zstdStreamBuf.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef ZSTDSTREAMBUF_H
+#define ZSTDSTREAMBUF_H
+
+#include "pandabase.h"
+
+// This module is not compiled if zstd is not available.
+#ifdef HAVE_ZSTD
+
+typedef struct ZSTD_DCtx_s ZSTD_DStream;
+typedef struct ZSTD_CCtx_s ZSTD_CStream;
+
+/**
+ * The streambuf object that implements IZstdDecompressStream and
+ * OZstdCompressStream.
+ */
+class EXPCL_PANDA_EXPRESS ZstdStreamBuf : public std::streambuf {
+public:
+  ZstdStreamBuf();
+  virtual ~ZstdStreamBuf();
+
+  void open_read(std::istream *source, bool owns_source, std::streamsize source_length=-1);
+  void close_read();
+
+  void open_write(std::ostream *dest, bool owns_dest, int compression_level);
+  void close_write();
+
+  virtual std::streampos seekoff(std::streamoff off, ios_seekdir dir, ios_openmode which);
+  virtual std::streampos seekpos(std::streampos pos, ios_openmode which);
+
+protected:
+  virtual int overflow(int c);
+  virtual int sync();
+  virtual int underflow();
+
+private:
+  size_t read_chars(char *start, size_t length);
+  void write_chars(const char *start, size_t length, int end_op);
+  void show_zstd_error(const char *function, size_t error_code);
+
+private:
+  std::istream *_source;
+  std::streamsize _source_bytes_left = -1;
+  bool _owns_source;
+  ZSTD_DStream *_z_source;
+  std::streamoff _total_out;
+
+  std::ostream *_dest;
+  bool _owns_dest;
+  ZSTD_CStream *_z_dest;
+
+  char *_buffer;
+
+  // The input buffer is stored on the class object, since zstd might not
+  // consume all of the input characters at each call.
+  char *_in_buffer;
+  size_t _in_buffer_size;
+  size_t _in_pos;
+  size_t _in_size;
+  bool _frame_done;
+};
+
+#endif  // HAVE_ZSTD
+
+#endif
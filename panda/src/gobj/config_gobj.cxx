@@ -187,6 +187,20 @@ ConfigVariableBool hardware_animated_vertices
           "necessary on your computer's bus.  However, in some cases it "
           "may actually reduce performance."));
 
+ConfigVariableBool parallel_skinning
+("parallel-skinning", false,
+ PRC_DESC("Set this true to divide the work of animating large soft-skinned "
+          "meshes in software between the threads of the worker thread "
+          "pool (see worker-threads).  Only meshes with at least "
+          "parallel-skinning-min-vertices animated vertices are divided."));
+
+ConfigVariableInt parallel_skinning_min_vertices
+("parallel-skinning-min-vertices", 4096,
+ PRC_DESC("The minimum number of animated vertices in a GeomVertexData "
+          "before its vertices are animated by multiple threads, when "
+          "parallel-skinning is enabled.  Smaller meshes are not worth "
+          "the overhead of dividing up the work."));
+
 ConfigVariableBool hardware_point_sprites
 ("hardware-point-sprites", true,
  PRC_DESC("Set this true to allow the use of hardware extensions when "
@@ -479,6 +493,33 @@ ConfigVariableInt vertex_data_page_threads
           "is 0, this work will be done in the main thread, which may "
           "introduce occasional random chugs in rendering."));
 
+ConfigVariableInt bam_deferred_vertex_data_size
+("bam-deferred-vertex-data-size", 65536,
+ PRC_DESC("When writing .bam files of version 6.46 or later, vertex arrays "
+          "of at least this many bytes are written in a separate record "
+          "ahead of the object that owns them, so that a reader may skip "
+          "over them and read them later on demand (see "
+          "bam-lazy-vertex-data).  Set this to 0 to always write the vertex "
+          "data inline."));
+
+ConfigVariableBool bam_lazy_vertex_data
+("bam-lazy-vertex-data", false,
+ PRC_DESC("Set this true to defer reading the vertex arrays that were written "
+          "in a separate record of a .bam file until they are first "
+          "accessed, so that the model may be returned before all of its "
+          "vertex data has been read.  The .bam file must not be modified "
+          "or removed while the model is in use, so this should not be "
+          "enabled when models are loaded from and written back to the same "
+          "file."));
+
+ConfigVariableInt bam_deferred_ram_image_size
+("bam-deferred-ram-image-size", 65536,
+ PRC_DESC("When writing .bam files of version 6.47 or later, texture RAM "
+          "images of at least this many bytes are written in a separate "
+          "record ahead of the texture, so that they can be read directly "
+          "into the texture's buffer without first being copied into the "
+          "datagram.  Set this to 0 to always write the images inline."));
+
 ConfigVariableInt graphics_memory_limit
 ("graphics-memory-limit", -1,
  PRC_DESC("This is a default limit that is imposed on each GSG at "
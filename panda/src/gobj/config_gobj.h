@@ -43,6 +43,8 @@ extern EXPCL_PANDA_GOBJ ConfigVariableBool vertex_buffers;
 extern EXPCL_PANDA_GOBJ ConfigVariableBool vertex_arrays;
 extern EXPCL_PANDA_GOBJ ConfigVariableBool display_lists;
 extern EXPCL_PANDA_GOBJ ConfigVariableBool hardware_animated_vertices;
+extern EXPCL_PANDA_GOBJ ConfigVariableBool parallel_skinning;
+extern EXPCL_PANDA_GOBJ ConfigVariableInt parallel_skinning_min_vertices;
 extern EXPCL_PANDA_GOBJ ConfigVariableBool hardware_point_sprites;
 extern EXPCL_PANDA_GOBJ ConfigVariableBool hardware_points;
 extern EXPCL_PANDA_GOBJ ConfigVariableBool singular_points;
@@ -83,6 +85,9 @@ extern EXPCL_PANDA_GOBJ ConfigVariableFilename vertex_save_file_directory;
 extern EXPCL_PANDA_GOBJ ConfigVariableString vertex_save_file_prefix;
 extern EXPCL_PANDA_GOBJ ConfigVariableInt vertex_data_small_size;
 extern EXPCL_PANDA_GOBJ ConfigVariableInt vertex_data_page_threads;
+extern EXPCL_PANDA_GOBJ ConfigVariableInt bam_deferred_vertex_data_size;
+extern EXPCL_PANDA_GOBJ ConfigVariableBool bam_lazy_vertex_data;
+extern EXPCL_PANDA_GOBJ ConfigVariableInt bam_deferred_ram_image_size;
 extern EXPCL_PANDA_GOBJ ConfigVariableInt graphics_memory_limit;
 extern EXPCL_PANDA_GOBJ ConfigVariableInt sampler_object_limit;
 extern EXPCL_PANDA_GOBJ ConfigVariableDouble adaptive_lru_weight;
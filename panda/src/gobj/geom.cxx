@@ -12,6 +12,7 @@
  */
 
 #include "geom.h"
+#include "geomSimplifier.h"
 #include "geomPoints.h"
 #include "geomVertexReader.h"
 #include "geomVertexRewriter.h"
@@ -920,6 +921,75 @@ make_adjacency_in_place() {
   nassertv(all_is_valid);
 }
 
+/**
+ * Reorders the faces of the primitives within this Geom to make better use of
+ * the post-transform vertex cache, which is assumed to hold the indicated
+ * number of vertices.  See GeomPrimitive::optimize_vertex_cache().
+ *
+ * Don't call this in a downstream thread unless you don't mind it blowing
+ * away other changes you might have recently made in an upstream thread.
+ */
+void Geom::
+optimize_vertex_cache_in_place(int cache_size) {
+  Thread *current_thread = Thread::get_current_thread();
+  CDWriter cdata(_cycler, true, current_thread);
+
+  bool any_changed = false;
+  Primitives::iterator pi;
+  for (pi = cdata->_primitives.begin(); pi != cdata->_primitives.end(); ++pi) {
+    CPT(GeomPrimitive) prim = (*pi).get_read_pointer(current_thread);
+    CPT(GeomPrimitive) new_prim = prim->optimize_vertex_cache(cache_size);
+    if (new_prim != prim) {
+      (*pi) = (GeomPrimitive *)new_prim.p();
+      any_changed = true;
+    }
+  }
+
+  if (any_changed) {
+    cdata->_modified = Geom::get_next_modified();
+    clear_cache_stage(current_thread);
+  }
+}
+
+/**
+ * Reduces the number of triangles in this Geom to approximately the indicated
+ * fraction of the original, for use as a lower level of detail.  Triangles
+ * are removed by collapsing the vertices that introduce the least geometric
+ * error; UV and normal seams are preserved, although vertices may still be
+ * removed along them.  See GeomSimplifier.
+ *
+ * The vertex data is not modified, so it may contain unused vertices
+ * afterwards; SceneGraphReducer::simplify() also removes these.
+ */
+void Geom::
+simplify_in_place(PN_stdfloat ratio) {
+  GeomSimplifier simplifier;
+  simplifier.simplify(this, ratio);
+}
+
+/**
+ * Returns the average cache miss ratio of all of the primitives within this
+ * Geom, weighted by the number of faces in each.  See
+ * GeomPrimitive::calc_acmr().
+ */
+double Geom::
+calc_acmr(int cache_size) const {
+  Thread *current_thread = Thread::get_current_thread();
+  CDReader cdata(_cycler, current_thread);
+
+  double total_misses = 0.0;
+  int total_faces = 0;
+  Primitives::const_iterator pi;
+  for (pi = cdata->_primitives.begin(); pi != cdata->_primitives.end(); ++pi) {
+    CPT(GeomPrimitive) prim = (*pi).get_read_pointer(current_thread);
+    int num_faces = prim->get_num_faces();
+    total_misses += prim->calc_acmr(cache_size) * num_faces;
+    total_faces += num_faces;
+  }
+
+  return (total_faces != 0) ? total_misses / total_faces : 0.0;
+}
+
 /**
  * Copies the primitives from the indicated Geom into this one.  This does
  * require that both Geoms contain the same fundamental type primitives, both
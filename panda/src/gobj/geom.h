@@ -110,6 +110,7 @@ PUBLISHED:
   INLINE PT(Geom) make_lines() const;
   INLINE PT(Geom) make_patches() const;
   INLINE PT(Geom) make_adjacency() const;
+  INLINE PT(Geom) simplify(PN_stdfloat ratio) const;
 
   void decompose_in_place();
   void doubleside_in_place();
@@ -120,6 +121,9 @@ PUBLISHED:
   void make_lines_in_place();
   void make_patches_in_place();
   void make_adjacency_in_place();
+  void optimize_vertex_cache_in_place(int cache_size = 32);
+  void simplify_in_place(PN_stdfloat ratio);
+  double calc_acmr(int cache_size = 32) const;
 
   virtual bool copy_primitives_from(const Geom *other);
 
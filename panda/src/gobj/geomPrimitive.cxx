@@ -1103,6 +1103,60 @@ make_adjacency() const {
   return nullptr;
 }
 
+/**
+ * Returns a new primitive that draws the same faces as this one, but in an
+ * order that makes better use of the post-transform vertex cache of the
+ * graphics hardware, which is assumed to hold the indicated number of
+ * vertices.  Returns this primitive unchanged if this type of geometry does
+ * not support this operation.
+ *
+ * This does not change the vertex indices themselves; see
+ * SceneGraphReducer::optimize_vertex_cache() for an operation that also
+ * reorders the vertex data to match.
+ */
+CPT(GeomPrimitive) GeomPrimitive::
+optimize_vertex_cache(int cache_size) const {
+  return this;
+}
+
+/**
+ * Returns the average cache miss ratio (ACMR) of this primitive: the average
+ * number of vertices that would need to be transformed for each face drawn,
+ * assuming a FIFO post-transform vertex cache of the indicated size.  The
+ * best possible value is around 0.5 for a regular triangle mesh, and the
+ * worst is 3 for disconnected triangles.
+ *
+ * Returns 0 if the primitive has no faces.
+ */
+double GeomPrimitive::
+calc_acmr(int cache_size) const {
+  int num_faces = get_num_faces();
+  if (num_faces == 0 || cache_size <= 0) {
+    return 0.0;
+  }
+
+  GeomPrimitivePipelineReader reader(this, Thread::get_current_thread());
+  int num_vertices = reader.get_num_vertices();
+  int strip_cut_index = get_strip_cut_index();
+
+  // Rather than simulating the FIFO directly, we record the number of misses
+  // at the time each vertex was last loaded into the cache; the vertex has
+  // been pushed out of the cache once cache_size more misses have occurred.
+  pvector<int> stamps(reader.get_max_vertex() + 1, -cache_size - 1);
+  int num_misses = 0;
+  for (int i = 0; i < num_vertices; ++i) {
+    int vertex = reader.get_vertex(i);
+    if (vertex == strip_cut_index) {
+      continue;
+    }
+    if (num_misses - stamps[vertex] > cache_size) {
+      stamps[vertex] = num_misses++;
+    }
+  }
+
+  return (double)num_misses / (double)num_faces;
+}
+
 /**
  * Returns the number of bytes consumed by the primitive and its index
  * table(s).
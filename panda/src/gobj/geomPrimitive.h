@@ -136,6 +136,8 @@ PUBLISHED:
   CPT(GeomPrimitive) make_lines() const;
   CPT(GeomPrimitive) make_patches() const;
   virtual CPT(GeomPrimitive) make_adjacency() const;
+  virtual CPT(GeomPrimitive) optimize_vertex_cache(int cache_size = 32) const;
+  double calc_acmr(int cache_size = 32) const;
 
   int get_num_bytes() const;
   INLINE int get_data_size_bytes() const;
@@ -0,0 +1,616 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file geomSimplifier.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "geomSimplifier.h"
+#include "geomTriangles.h"
+#include "geomVertexReader.h"
+#include "pmap.h"
+
+#include <algorithm>
+#include <math.h>
+#include <queue>
+
+/**
+ *
+ */
+GeomSimplifier::
+GeomSimplifier() :
+  _blend_weight(0.0),
+  _num_live_tris(0)
+{
+}
+
+/**
+ * Removes triangles from the indicated Geom until only the indicated fraction
+ * of them remain, or until no more can be removed without violating the
+ * constraints described above.  Any triangle strips or fans in the Geom are
+ * decomposed into triangles first; other kinds of primitives are left
+ * unchanged.
+ *
+ * The vertex data is not modified, so it may contain unused vertices
+ * afterwards.  Returns true if any triangles were removed, false otherwise.
+ */
+bool GeomSimplifier::
+simplify(Geom *geom, PN_stdfloat ratio) {
+  if (ratio >= 1.0f) {
+    return false;
+  }
+
+  geom->decompose_in_place();
+  read_geom(geom);
+
+  int num_tris = _num_live_tris;
+  if (num_tris == 0) {
+    return false;
+  }
+  int target = std::max((int)(num_tris * ratio), 1);
+
+  compute_quadrics();
+
+  std::priority_queue<Collapse> queue;
+  int num_verts = (int)_verts.size();
+  for (int vi = 0; vi < num_verts; ++vi) {
+    Collapse collapse;
+    collapse._from = vi;
+    collapse._seq = _verts[vi]._seq;
+    if (find_collapse(vi, collapse._to, collapse._cost)) {
+      queue.push(collapse);
+    }
+  }
+
+  vector_int neighbors;
+  while (_num_live_tris > target && !queue.empty()) {
+    Collapse collapse = queue.top();
+    queue.pop();
+
+    const Vertex &from = _verts[collapse._from];
+    if (from._removed || from._seq != collapse._seq) {
+      // This entry is out of date.
+      continue;
+    }
+
+    do_collapse(collapse._from, collapse._to);
+
+    // The cost of collapsing the surviving vertex, and each of its neighbors,
+    // has now changed.
+    neighbors.clear();
+    neighbors.push_back(collapse._to);
+    for (int ti : _verts[collapse._to]._tris) {
+      const Triangle &tri = _tris[ti];
+      for (int k = 0; k < 3; ++k) {
+        if (std::find(neighbors.begin(), neighbors.end(), tri._verts[k]) == neighbors.end()) {
+          neighbors.push_back(tri._verts[k]);
+        }
+      }
+    }
+
+    for (int vi : neighbors) {
+      Vertex &vert = _verts[vi];
+      ++vert._seq;
+
+      Collapse next;
+      next._from = vi;
+      next._seq = vert._seq;
+      if (find_collapse(vi, next._to, next._cost)) {
+        queue.push(next);
+      }
+    }
+  }
+
+  if (_num_live_tris == num_tris) {
+    return false;
+  }
+
+  write_geom(geom);
+  return true;
+}
+
+/**
+ * Reads the triangles and the vertex positions from the Geom.  Rows with the
+ * same position are welded into a single vertex; each triangle remembers the
+ * rows it used, so that the seams can be restored afterwards.
+ */
+void GeomSimplifier::
+read_geom(const Geom *geom) {
+  _verts.clear();
+  _tris.clear();
+  _num_live_tris = 0;
+
+  CPT(GeomVertexData) vdata = geom->get_vertex_data();
+  GeomVertexReader vertex(vdata, InternalName::get_vertex());
+  if (!vertex.has_column()) {
+    return;
+  }
+
+  int num_rows = vdata->get_num_rows();
+  _row_verts.assign(num_rows, -1);
+
+  _row_blends.clear();
+  _blend_table = vdata->get_transform_blend_table();
+  if (_blend_table != nullptr) {
+    GeomVertexReader blend(vdata, InternalName::get_transform_blend());
+    if (blend.has_column()) {
+      _row_blends.resize(num_rows);
+      for (int ri = 0; ri < num_rows; ++ri) {
+        _row_blends[ri] = blend.get_data1i();
+      }
+    } else {
+      _blend_table.clear();
+    }
+  }
+
+  pmap<LPoint3d, int> positions;
+
+  size_t num_primitives = geom->get_num_primitives();
+  for (size_t pi = 0; pi < num_primitives; ++pi) {
+    CPT(GeomPrimitive) prim = geom->get_primitive(pi);
+    if (!prim->is_exact_type(GeomTriangles::get_class_type())) {
+      continue;
+    }
+
+    GeomPrimitivePipelineReader reader(prim, Thread::get_current_thread());
+    int num_vertices = reader.get_num_vertices();
+    for (int i = 0; i + 2 < num_vertices; i += 3) {
+      Triangle tri;
+      tri._prim = (int)pi;
+      tri._removed = false;
+
+      for (int k = 0; k < 3; ++k) {
+        int row = reader.get_vertex(i + k);
+        nassertv(row >= 0 && row < num_rows);
+        tri._rows[k] = row;
+
+        int vi = _row_verts[row];
+        if (vi < 0) {
+          vertex.set_row_unsafe(row);
+          LPoint3d pos = vertex.get_data3d();
+
+          auto result = positions.insert(pmap<LPoint3d, int>::value_type(pos, (int)_verts.size()));
+          vi = (*result.first).second;
+          if (result.second) {
+            Vertex vert;
+            vert._pos = pos;
+            vert._row = row;
+            vert._locked = false;
+            vert._removed = false;
+            vert._seq = 0;
+            _verts.push_back(std::move(vert));
+          }
+          _row_verts[row] = vi;
+        }
+        tri._verts[k] = vi;
+      }
+
+      if (tri._verts[0] == tri._verts[1] ||
+          tri._verts[1] == tri._verts[2] ||
+          tri._verts[2] == tri._verts[0]) {
+        // Leave degenerate triangles out altogether.
+        continue;
+      }
+
+      int ti = (int)_tris.size();
+      for (int k = 0; k < 3; ++k) {
+        _verts[tri._verts[k]]._tris.push_back(ti);
+      }
+      _tris.push_back(tri);
+      ++_num_live_tris;
+    }
+  }
+}
+
+/**
+ * Computes the initial error quadric of each vertex from the planes of the
+ * triangles that use it.  Edges on the border of the mesh, or on a seam, get
+ * an additional plane perpendicular to the triangle, to keep the border or
+ * the seam in place.
+ */
+void GeomSimplifier::
+compute_quadrics() {
+  // How strongly the border is held in place, relative to the surface.
+  static const double border_weight = 10.0;
+
+  // For each edge, the number of triangles using it, the rows used by the
+  // first of these, and whether any of the others used different rows.
+  class EdgeInfo {
+  public:
+    int _count;
+    int _rows[2];
+    bool _seam;
+  };
+  typedef pmap<std::pair<int, int>, EdgeInfo> EdgeCounts;
+  EdgeCounts edges;
+
+  LPoint3d min_point, max_point;
+  double total_area = 0.0;
+  bool first = true;
+
+  for (const Triangle &tri : _tris) {
+    const LPoint3d &p0 = _verts[tri._verts[0]]._pos;
+    const LPoint3d &p1 = _verts[tri._verts[1]]._pos;
+    const LPoint3d &p2 = _verts[tri._verts[2]]._pos;
+
+    LVector3d normal = (p1 - p0).cross(p2 - p0);
+    double length = normal.length();
+    if (length > 0.0) {
+      normal /= length;
+      double d = -normal.dot(p0);
+      double area = length * 0.5;
+      total_area += area;
+      for (int k = 0; k < 3; ++k) {
+        _verts[tri._verts[k]]._quadric.add_plane(normal, d, area);
+      }
+    }
+
+    for (int k = 0; k < 3; ++k) {
+      int a = tri._verts[k];
+      int b = tri._verts[(k + 1) % 3];
+      int ra = tri._rows[k];
+      int rb = tri._rows[(k + 1) % 3];
+      if (a > b) {
+        std::swap(a, b);
+        std::swap(ra, rb);
+      }
+      auto result = edges.insert(EdgeCounts::value_type(std::make_pair(a, b), EdgeInfo()));
+      EdgeInfo &info = (*result.first).second;
+      if (result.second) {
+        info._count = 1;
+        info._rows[0] = ra;
+        info._rows[1] = rb;
+        info._seam = false;
+      } else {
+        ++info._count;
+        if (info._rows[0] != ra || info._rows[1] != rb) {
+          info._seam = true;
+        }
+      }
+
+      const LPoint3d &p = _verts[a]._pos;
+      if (first) {
+        min_point = p;
+        max_point = p;
+        first = false;
+      } else {
+        min_point.set(std::min(min_point[0], p[0]), std::min(min_point[1], p[1]), std::min(min_point[2], p[2]));
+        max_point.set(std::max(max_point[0], p[0]), std::max(max_point[1], p[1]), std::max(max_point[2], p[2]));
+      }
+    }
+  }
+
+  for (const Triangle &tri : _tris) {
+    for (int k = 0; k < 3; ++k) {
+      int a = tri._verts[k];
+      int b = tri._verts[(k + 1) % 3];
+      const EdgeInfo &info = edges[std::make_pair(std::min(a, b), std::max(a, b))];
+      if (info._count > 2) {
+        // Don't try to simplify non-manifold geometry.
+        _verts[a]._locked = true;
+        _verts[b]._locked = true;
+
+      } else if (info._count == 1 || info._seam) {
+        const LPoint3d &pa = _verts[a]._pos;
+        const LPoint3d &pb = _verts[b]._pos;
+        const LPoint3d &pc = _verts[tri._verts[(k + 2) % 3]]._pos;
+        LVector3d edge = pb - pa;
+        LVector3d face_normal = edge.cross(pc - pa);
+        LVector3d normal = edge.cross(face_normal);
+        if (normal.normalize()) {
+          double d = -normal.dot(pa);
+          double weight = edge.length_squared() * border_weight;
+          _verts[a]._quadric.add_plane(normal, d, weight);
+          _verts[b]._quadric.add_plane(normal, d, weight);
+        }
+      }
+    }
+  }
+
+  // Collapsing two vertices with entirely different joint weights costs
+  // about as much as moving an average triangle by a tenth of the size of
+  // the model.
+  if (_blend_table != nullptr && !_tris.empty()) {
+    double size = (max_point - min_point).length() * 0.1;
+    _blend_weight = (total_area / _tris.size()) * size * size;
+  }
+}
+
+/**
+ * Finds the cheapest neighbor to collapse the indicated vertex onto.  Returns
+ * false if the vertex may not be removed.
+ */
+bool GeomSimplifier::
+find_collapse(int from, int &to, double &cost) const {
+  const Vertex &vert = _verts[from];
+  if (vert._locked || vert._removed) {
+    return false;
+  }
+
+  // Find the neighboring vertices, and whether each is connected via a
+  // border edge.
+  vector_int neighbors;
+  for (int ti : vert._tris) {
+    const Triangle &tri = _tris[ti];
+    for (int k = 0; k < 3; ++k) {
+      int vi = tri._verts[k];
+      if (vi != from && std::find(neighbors.begin(), neighbors.end(), vi) == neighbors.end()) {
+        neighbors.push_back(vi);
+      }
+    }
+  }
+
+  bool on_border = false;
+  pvector<bool> border_edges(neighbors.size());
+  for (size_t ni = 0; ni < neighbors.size(); ++ni) {
+    border_edges[ni] = is_border_edge(from, neighbors[ni]);
+    on_border = on_border || border_edges[ni];
+  }
+
+  bool found = false;
+  RowMap row_map;
+  for (size_t ni = 0; ni < neighbors.size(); ++ni) {
+    if (on_border && !border_edges[ni]) {
+      // A border vertex may only slide along the border.
+      continue;
+    }
+
+    int vi = neighbors[ni];
+    if (!map_rows(from, vi, row_map)) {
+      // The vertex is on a seam that doesn't continue along this edge.
+      continue;
+    }
+
+    const Vertex &target = _verts[vi];
+    double this_cost = vert._quadric.evaluate(target._pos) +
+                       target._quadric.evaluate(target._pos);
+    if (!_row_blends.empty()) {
+      this_cost += calc_blend_penalty(vert._row, target._row);
+    }
+
+    if ((!found || this_cost < cost) && check_flip(from, vi)) {
+      to = vi;
+      cost = this_cost;
+      found = true;
+    }
+  }
+
+  return found;
+}
+
+/**
+ * Returns true if the edge between the two vertices is used by only one
+ * triangle.
+ */
+bool GeomSimplifier::
+is_border_edge(int from, int to) const {
+  int count = 0;
+  for (int ti : _verts[from]._tris) {
+    const Triangle &tri = _tris[ti];
+    if (tri._verts[0] == to || tri._verts[1] == to || tri._verts[2] == to) {
+      ++count;
+    }
+  }
+  return count == 1;
+}
+
+/**
+ * Determines which row of the second vertex should replace each of the rows
+ * of the first vertex used by its triangles, if the first vertex were
+ * collapsed onto the second.  This is given by the triangles on either side
+ * of the edge between them.  Returns false if there is no such row for one of
+ * the rows, or more than one, which means that the first vertex is on a seam
+ * that does not continue along this edge.
+ */
+bool GeomSimplifier::
+map_rows(int from, int to, RowMap &row_map) const {
+  row_map.clear();
+
+  const Vertex &vert = _verts[from];
+  for (int ti : vert._tris) {
+    const Triangle &tri = _tris[ti];
+    int from_row = -1;
+    int to_row = -1;
+    for (int k = 0; k < 3; ++k) {
+      if (tri._verts[k] == from) {
+        from_row = tri._rows[k];
+      } else if (tri._verts[k] == to) {
+        to_row = tri._rows[k];
+      }
+    }
+    if (to_row < 0) {
+      continue;
+    }
+
+    bool found = false;
+    for (const std::pair<int, int> &rows : row_map) {
+      if (rows.first == from_row) {
+        if (rows.second != to_row) {
+          return false;
+        }
+        found = true;
+        break;
+      }
+    }
+    if (!found) {
+      row_map.push_back(std::make_pair(from_row, to_row));
+    }
+  }
+
+  // Now make sure that every row used by the triangles that remain is
+  // accounted for.
+  for (int ti : vert._tris) {
+    const Triangle &tri = _tris[ti];
+    for (int k = 0; k < 3; ++k) {
+      if (tri._verts[k] == from) {
+        int from_row = tri._rows[k];
+        bool found = false;
+        for (const std::pair<int, int> &rows : row_map) {
+          if (rows.first == from_row) {
+            found = true;
+            break;
+          }
+        }
+        if (!found) {
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Returns true if the indicated vertex can be moved onto the other without
+ * flipping any of the remaining triangles around it.
+ */
+bool GeomSimplifier::
+check_flip(int from, int to) const {
+  const LPoint3d &new_pos = _verts[to]._pos;
+
+  for (int ti : _verts[from]._tris) {
+    const Triangle &tri = _tris[ti];
+    if (tri._verts[0] == to || tri._verts[1] == to || tri._verts[2] == to) {
+      // This triangle will be removed.
+      continue;
+    }
+
+    LPoint3d p[3];
+    for (int k = 0; k < 3; ++k) {
+      p[k] = _verts[tri._verts[k]]._pos;
+    }
+    LVector3d old_normal = (p[1] - p[0]).cross(p[2] - p[0]);
+
+    for (int k = 0; k < 3; ++k) {
+      if (tri._verts[k] == from) {
+        p[k] = new_pos;
+      }
+    }
+    LVector3d new_normal = (p[1] - p[0]).cross(p[2] - p[0]);
+
+    if (old_normal.dot(new_normal) <= 0.0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Returns the additional cost of replacing the joint weights of the first
+ * row with those of the second.
+ */
+double GeomSimplifier::
+calc_blend_penalty(int from_row, int to_row) const {
+  int from_index = _row_blends[from_row];
+  int to_index = _row_blends[to_row];
+  if (from_index == to_index) {
+    return 0.0;
+  }
+
+  int num_blends = (int)_blend_table->get_num_blends();
+  if (from_index < 0 || from_index >= num_blends ||
+      to_index < 0 || to_index >= num_blends) {
+    return 0.0;
+  }
+
+  const TransformBlend &from_blend = _blend_table->get_blend(from_index);
+  const TransformBlend &to_blend = _blend_table->get_blend(to_index);
+
+  // Sum up the differences of the weights of all of the joints, which may
+  // add up to at most 2.
+  double diff = 0.0;
+  size_t num_transforms = from_blend.get_num_transforms();
+  for (size_t i = 0; i < num_transforms; ++i) {
+    const VertexTransform *transform = from_blend.get_transform(i);
+    diff += fabs(from_blend.get_weight(i) - to_blend.get_weight(transform));
+  }
+  num_transforms = to_blend.get_num_transforms();
+  for (size_t i = 0; i < num_transforms; ++i) {
+    if (!from_blend.has_transform(to_blend.get_transform(i))) {
+      diff += to_blend.get_weight(i);
+    }
+  }
+
+  return diff * _blend_weight;
+}
+
+/**
+ * Moves the indicated vertex onto the other one, removing the triangles that
+ * used both of them.
+ */
+void GeomSimplifier::
+do_collapse(int from, int to) {
+  Vertex &from_vert = _verts[from];
+  Vertex &to_vert = _verts[to];
+
+  // Find the rows that the triangles around the removed vertex should use
+  // from now on.  If the vertex is on a seam, this differs for the triangles
+  // on either side of it.
+  RowMap row_map;
+  bool mapped = map_rows(from, to, row_map);
+  nassertv(mapped);
+
+  for (int ti : from_vert._tris) {
+    Triangle &tri = _tris[ti];
+    if (tri._verts[0] == to || tri._verts[1] == to || tri._verts[2] == to) {
+      // This triangle degenerates, so remove it from the other vertices.
+      tri._removed = true;
+      --_num_live_tris;
+      for (int k = 0; k < 3; ++k) {
+        int vi = tri._verts[k];
+        if (vi != from) {
+          vector_int &tris = _verts[vi]._tris;
+          tris.erase(std::find(tris.begin(), tris.end(), ti));
+        }
+      }
+    } else {
+      for (int k = 0; k < 3; ++k) {
+        if (tri._verts[k] == from) {
+          tri._verts[k] = to;
+          for (const std::pair<int, int> &rows : row_map) {
+            if (rows.first == tri._rows[k]) {
+              tri._rows[k] = rows.second;
+              break;
+            }
+          }
+        }
+      }
+      to_vert._tris.push_back(ti);
+    }
+  }
+
+  to_vert._quadric += from_vert._quadric;
+  from_vert._tris.clear();
+  from_vert._removed = true;
+}
+
+/**
+ * Replaces the triangle primitives of the Geom with the remaining triangles.
+ */
+void GeomSimplifier::
+write_geom(Geom *geom) const {
+  size_t num_primitives = geom->get_num_primitives();
+  for (size_t pi = 0; pi < num_primitives; ++pi) {
+    CPT(GeomPrimitive) prim = geom->get_primitive(pi);
+    if (!prim->is_exact_type(GeomTriangles::get_class_type())) {
+      continue;
+    }
+
+    PT(GeomPrimitive) new_prim = prim->make_copy();
+    new_prim->clear_vertices();
+    for (const Triangle &tri : _tris) {
+      if (!tri._removed && tri._prim == (int)pi) {
+        new_prim->add_vertices(tri._rows[0], tri._rows[1], tri._rows[2]);
+      }
+    }
+    geom->set_primitive(pi, new_prim);
+  }
+}
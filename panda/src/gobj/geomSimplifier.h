@@ -0,0 +1,118 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file geomSimplifier.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef GEOMSIMPLIFIER_H
+#define GEOMSIMPLIFIER_H
+
+#include "pandabase.h"
+#include "geom.h"
+#include "geomVertexData.h"
+#include "transformBlendTable.h"
+#include "luse.h"
+#include "pvector.h"
+#include "vector_int.h"
+
+/**
+ * Reduces the number of triangles in a Geom, for the purpose of generating
+ * lower levels of detail, using the quadric error metric of Garland and
+ * Heckbert.
+ *
+ * Vertices are removed by collapsing them onto one of their neighbors, so the
+ * vertex data itself is not modified; the simplified primitives simply
+ * reference fewer of the existing vertices.  A vertex that lies on a UV or
+ * normal seam (that is, whose position is shared by several rows with
+ * different attributes) may only slide along the seam, taking all of its
+ * rows along, so that the attributes on either side of the seam stay intact.
+ * Vertices on the border of an open mesh may only slide along the border.
+ * Collapsing vertices with different joint weights is penalized, so that the
+ * deformation of animated models is preserved.
+ *
+ * This is normally invoked via Geom::simplify_in_place() or
+ * SceneGraphReducer::simplify().
+ */
+class EXPCL_PANDA_GOBJ GeomSimplifier {
+public:
+  GeomSimplifier();
+
+  bool simplify(Geom *geom, PN_stdfloat ratio);
+
+private:
+  // A symmetric 4x4 matrix, representing the sum of the squared distances to
+  // a set of planes.
+  class Quadric {
+  public:
+    INLINE Quadric();
+    INLINE void add_plane(const LVecBase3d &normal, double d, double weight);
+    INLINE void operator += (const Quadric &other);
+    INLINE double evaluate(const LPoint3d &point) const;
+
+    double _a00, _a01, _a02, _a11, _a12, _a22;
+    double _b0, _b1, _b2;
+    double _c;
+  };
+
+  class Vertex {
+  public:
+    LPoint3d _pos;
+    Quadric _quadric;
+    vector_int _tris;
+    int _row;
+    bool _locked;
+    bool _removed;
+    unsigned int _seq;
+  };
+
+  class Triangle {
+  public:
+    int _rows[3];
+    int _verts[3];
+    int _prim;
+    bool _removed;
+  };
+
+  // Maps each of the rows used by a vertex to the row of another vertex that
+  // it would be replaced with by a collapse.
+  typedef pvector<std::pair<int, int> > RowMap;
+
+  class Collapse {
+  public:
+    INLINE bool operator < (const Collapse &other) const;
+
+    double _cost;
+    int _from;
+    int _to;
+    unsigned int _seq;
+  };
+
+  void read_geom(const Geom *geom);
+  void compute_quadrics();
+  bool find_collapse(int from, int &to, double &cost) const;
+  bool is_border_edge(int from, int to) const;
+  bool map_rows(int from, int to, RowMap &row_map) const;
+  bool check_flip(int from, int to) const;
+  double calc_blend_penalty(int from_row, int to_row) const;
+  void do_collapse(int from, int to);
+  void write_geom(Geom *geom) const;
+
+  pvector<Vertex> _verts;
+  pvector<Triangle> _tris;
+  vector_int _row_verts;
+  vector_int _row_blends;
+  CPT(TransformBlendTable) _blend_table;
+  double _blend_weight;
+  int _num_live_tris;
+};
+
+#include "geomSimplifier.I"
+
+#endif
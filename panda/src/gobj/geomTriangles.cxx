@@ -18,6 +18,10 @@
 #include "bamWriter.h"
 #include "graphicsStateGuardianBase.h"
 #include "geomTrianglesAdjacency.h"
+#include "vector_int.h"
+
+#include <algorithm>
+#include <math.h>
 
 using std::map;
 
@@ -141,6 +145,191 @@ make_adjacency() const {
   return adj;
 }
 
+/**
+ * Returns a new primitive that draws the same triangles as this one, but in
+ * an order that makes better use of the post-transform vertex cache of the
+ * graphics hardware, which is assumed to hold the indicated number of
+ * vertices.
+ *
+ * This uses Tom Forsyth's linear-speed vertex cache optimization algorithm,
+ * which greedily picks the next triangle based on a score computed from the
+ * position of its vertices in a simulated LRU cache and the number of
+ * triangles still to be drawn that use each vertex.
+ */
+CPT(GeomPrimitive) GeomTriangles::
+optimize_vertex_cache(int cache_size) const {
+  Thread *current_thread = Thread::get_current_thread();
+  GeomPrimitivePipelineReader from(this, current_thread);
+  int num_vertices = from.get_num_vertices();
+  int num_triangles = num_vertices / 3;
+  if (num_triangles < 2 || cache_size < 4) {
+    return this;
+  }
+
+  // The scoring parameters suggested by Forsyth.
+  static const double cache_decay_power = 1.5;
+  static const double last_tri_score = 0.75;
+  static const double valence_boost_scale = 2.0;
+  static const double valence_boost_power = 0.5;
+
+  int max_vertex = from.get_max_vertex();
+  int num_verts = max_vertex + 1;
+
+  // Build up the list of triangles using each vertex.
+  vector_int indices(num_vertices);
+  for (int i = 0; i < num_vertices; ++i) {
+    indices[i] = from.get_vertex(i);
+  }
+
+  vector_int tri_start(num_verts + 1, 0);
+  for (int i = 0; i < num_vertices; ++i) {
+    ++tri_start[indices[i] + 1];
+  }
+  for (int v = 0; v < num_verts; ++v) {
+    tri_start[v + 1] += tri_start[v];
+  }
+  vector_int vert_tris(num_vertices);
+  {
+    vector_int fill(tri_start);
+    for (int i = 0; i < num_vertices; ++i) {
+      vert_tris[fill[indices[i]]++] = i / 3;
+    }
+  }
+
+  // The number of triangles not yet drawn that use each vertex, and the
+  // position of each vertex in the simulated cache, or -1.
+  vector_int remaining(num_verts);
+  vector_int cache_pos(num_verts, -1);
+  for (int v = 0; v < num_verts; ++v) {
+    remaining[v] = tri_start[v + 1] - tri_start[v];
+  }
+
+  auto vertex_score = [&](int v) -> double {
+    if (remaining[v] == 0) {
+      return -1.0;
+    }
+    double score = 0.0;
+    int pos = cache_pos[v];
+    if (pos >= 0) {
+      if (pos < 3) {
+        // This vertex was used in the last triangle, so it has a fixed
+        // score, so as not to favor drawing triangles that share an edge.
+        score = last_tri_score;
+      } else {
+        double scaler = 1.0 / (cache_size - 3);
+        score = pow(1.0 - (pos - 3) * scaler, cache_decay_power);
+      }
+    }
+    score += valence_boost_scale * pow((double)remaining[v], -valence_boost_power);
+    return score;
+  };
+
+  pvector<double> vert_score(num_verts);
+  for (int v = 0; v < num_verts; ++v) {
+    vert_score[v] = vertex_score(v);
+  }
+
+  pvector<double> tri_score(num_triangles);
+  pvector<bool> tri_added(num_triangles, false);
+  int best_tri = -1;
+  double best_score = -1.0;
+  for (int t = 0; t < num_triangles; ++t) {
+    tri_score[t] = vert_score[indices[t * 3]] +
+                   vert_score[indices[t * 3 + 1]] +
+                   vert_score[indices[t * 3 + 2]];
+    if (tri_score[t] > best_score) {
+      best_score = tri_score[t];
+      best_tri = t;
+    }
+  }
+
+  PT(GeomPrimitive) result = make_copy();
+  result->make_indexed();
+  PT(GeomVertexArrayData) new_vertices = result->make_index_data();
+  new_vertices->unclean_set_num_rows(num_vertices);
+
+  // The simulated cache is slightly larger than the real one, so that we can
+  // add the three vertices of the new triangle before evicting any.
+  vector_int cache, new_cache;
+  cache.reserve(cache_size + 3);
+  new_cache.reserve(cache_size + 3);
+
+  int next_unadded = 0;
+  {
+    GeomVertexWriter to(new_vertices, 0, current_thread);
+    for (int n = 0; n < num_triangles; ++n) {
+      if (best_tri < 0) {
+        // None of the triangles touching the cache are left; start again with
+        // the next triangle that hasn't been drawn yet.
+        while (tri_added[next_unadded]) {
+          ++next_unadded;
+        }
+        best_tri = next_unadded;
+      }
+
+      int tri = best_tri;
+      tri_added[tri] = true;
+
+      new_cache.clear();
+      for (int j = 0; j < 3; ++j) {
+        int v = indices[tri * 3 + j];
+        to.set_data1i(v);
+        new_cache.push_back(v);
+
+        // Remove the triangle from the vertex's list of remaining triangles.
+        int *begin = &vert_tris[tri_start[v]];
+        int *end = begin + remaining[v];
+        int *it = std::find(begin, end, tri);
+        nassertd(it != end) continue;
+        *it = *(end - 1);
+        --remaining[v];
+      }
+      for (int v : cache) {
+        if (v != new_cache[0] && v != new_cache[1] && v != new_cache[2]) {
+          new_cache.push_back(v);
+        }
+      }
+
+      // Update the scores of the vertices in the cache, and of the triangles
+      // using them, and pick the best of those triangles to draw next.
+      for (int v : cache) {
+        cache_pos[v] = -1;
+      }
+      for (size_t i = 0; i < new_cache.size(); ++i) {
+        cache_pos[new_cache[i]] = (i < (size_t)cache_size) ? (int)i : -1;
+      }
+
+      best_tri = -1;
+      best_score = -1.0;
+      for (int v : new_cache) {
+        double new_score = vertex_score(v);
+        double diff = new_score - vert_score[v];
+        vert_score[v] = new_score;
+
+        const int *tris = &vert_tris[tri_start[v]];
+        for (int k = 0; k < remaining[v]; ++k) {
+          int t = tris[k];
+          tri_score[t] += diff;
+          if (tri_score[t] > best_score) {
+            best_score = tri_score[t];
+            best_tri = t;
+          }
+        }
+      }
+
+      if (new_cache.size() > (size_t)cache_size) {
+        new_cache.resize(cache_size);
+      }
+      cache.swap(new_cache);
+    }
+
+    nassertr(to.is_at_end(), this);
+  }
+
+  result->set_vertices(std::move(new_vertices));
+  return result;
+}
+
 /**
  * If the primitive type is a simple type in which all primitives have the
  * same number of vertices, like triangles, returns the number of vertices per
@@ -32,6 +32,7 @@ public:
   virtual PrimitiveType get_primitive_type() const;
 
   CPT(GeomPrimitive) make_adjacency() const;
+  virtual CPT(GeomPrimitive) optimize_vertex_cache(int cache_size = 32) const;
 
   virtual int get_num_vertices_per_primitive() const;
 
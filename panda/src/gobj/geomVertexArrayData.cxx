@@ -511,9 +511,34 @@ write_datagram(BamWriter *manager, Datagram &dg, void *extra_data) const {
   GeomVertexArrayData *array_data = (GeomVertexArrayData *)extra_data;
   dg.add_uint8(_usage_hint);
 
+  // Beginning with bam 6.46, a large array may be written in a separate
+  // record ahead of this one, so that the reader can skip over it and read it
+  // later on demand.  This only makes sense when writing to an actual file.
+  bool deferred = false;
+  if (manager->get_file_minor_ver() >= 46) {
+    DatagramSink *target = manager->get_target();
+    deferred = bam_deferred_vertex_data_size > 0 &&
+      _buffer.get_size() >= (size_t)bam_deferred_vertex_data_size &&
+      target != nullptr && target->get_file() != nullptr;
+    dg.add_bool(deferred);
+  }
+
   dg.add_uint32(_buffer.get_size());
 
-  if (manager->get_file_endian() == BamWriter::BE_native) {
+  if (deferred) {
+    // Since bam 6.47, this is aligned within the file, so that the reader
+    // may use it directly from a memory-mapped file.
+    if (manager->get_file_endian() == BamWriter::BE_native) {
+      manager->write_file_data(_buffer.get_read_pointer(true), _buffer.get_size(),
+                               MEMORY_HOOK_ALIGNMENT);
+    } else {
+      vector_uchar new_data(_buffer.get_size());
+      array_data->reverse_data_endianness(new_data.data(), _buffer.get_read_pointer(true), _buffer.get_size());
+      manager->write_file_data(new_data.data(), new_data.size(),
+                               MEMORY_HOOK_ALIGNMENT);
+    }
+
+  } else if (manager->get_file_endian() == BamWriter::BE_native) {
     // For native endianness, we only have to write the data directly.
     dg.append_data(_buffer.get_read_pointer(true), _buffer.get_size());
 
@@ -542,6 +567,44 @@ fillin(DatagramIterator &scan, BamReader *manager, void *extra_data) {
     _buffer.set_size(new_data.size());
     memcpy(_buffer.get_write_pointer(), &new_data[0], new_data.size());
 
+  } else if (manager->get_file_minor_ver() >= 46 && scan.get_bool()) {
+    // The array data was written in a separate record ahead of this one, and
+    // the BamReader has noted where it can be found.
+    size_t size = scan.get_uint32();
+    SubfileInfo info;
+    manager->read_file_data(info);
+    if ((size_t)info.get_size() != size) {
+      gobj_cat.error()
+        << "Expected " << size << " bytes of vertex data in bam stream, found "
+        << info.get_size() << "\n";
+    }
+
+    PT(MappedFile) mapping;
+    const unsigned char *mapped = nullptr;
+    if (manager->get_file_endian() == BamReader::BE_native) {
+      mapped = manager->map_file_data(info, mapping);
+    }
+
+    if (mapped != nullptr && ((uintptr_t)mapped % MEMORY_HOOK_ALIGNMENT) == 0) {
+      // We can use the data in place, until somebody modifies it.
+      _buffer.set_mapped(mapping, mapped, (size_t)info.get_size());
+
+    } else {
+      // If the data is still in the bam file itself, we make sure it hasn't
+      // been changed by the time we get around to reading it.
+      time_t timestamp = 0;
+      if (info.get_filename() == manager->get_filename()) {
+        timestamp = manager->get_source()->get_timestamp();
+      }
+      _buffer.set_deferred(info, timestamp);
+
+      if (!bam_lazy_vertex_data ||
+          manager->get_file_endian() != BamReader::BE_native) {
+        // Read the data right away, by forcing the buffer to be paged in.
+        _buffer.get_write_pointer();
+      }
+    }
+
   } else {
     // Now, the array data is just stored directly.
     size_t size = scan.get_uint32();
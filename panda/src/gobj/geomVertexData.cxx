@@ -21,6 +21,13 @@
 #include "bamWriter.h"
 #include "pset.h"
 #include "indent.h"
+#include "config_gobj.h"
+#include "workerThreadPool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SKINNING_SSE2 1
+#endif
 
 using std::ostream;
 
@@ -1578,6 +1585,12 @@ update_animated_vertices(GeomVertexData::CData *cdata, Thread *current_thread) {
         new GeomVertexArrayDataHandle(cdata->_arrays[blend_array_index].get_read_pointer(current_thread), current_thread);
       const unsigned short *blendt = (const unsigned short *)blend_array_handle->get_read_pointer(true);
 
+      if (do_skin_float32(new_format, new_data, tb_table, rows, blendt, current_thread)) {
+        return;
+      }
+
+      // Some of the columns aren't 3-component floats; transform each run of
+      // vertices with the same blend using the more general code below.
       size_t ci;
       for (ci = 0; ci < new_format->get_num_points(); ci++) {
         GeomVertexRewriter data(new_data, new_format->get_point(ci));
@@ -1811,30 +1824,7 @@ do_transform_vector_column(const GeomVertexFormat *format, GeomVertexRewriter &d
   LMatrix4 xform;
   bool normalize = false;
   if (data_column->get_contents() == C_normal) {
-    // This is to preserve perpendicularity to the surface.
-    LVecBase3 scale_sq(mat.get_row3(0).length_squared(),
-                       mat.get_row3(1).length_squared(),
-                       mat.get_row3(2).length_squared());
-    if (IS_THRESHOLD_EQUAL(scale_sq[0], scale_sq[1], 2.0e-3f) &&
-        IS_THRESHOLD_EQUAL(scale_sq[0], scale_sq[2], 2.0e-3f)) {
-      // There is a uniform scale.
-      LVecBase3 scale, shear, hpr;
-      if (IS_THRESHOLD_EQUAL(scale_sq[0], 1, 2.0e-3f)) {
-        // No scale to worry about.
-        xform = mat;
-      } else if (decompose_matrix(mat.get_upper_3(), scale, shear, hpr)) {
-        // Make a new matrix with scale/translate taken out of the equation.
-        compose_matrix(xform, LVecBase3(1, 1, 1), shear, hpr, LVecBase3::zero());
-      } else {
-        normalize = true;
-      }
-    } else {
-      // There is a non-uniform scale, so we need to do all this to preserve
-      // orthogonality to the surface.
-      xform.invert_from(mat);
-      xform.transpose_in_place();
-      normalize = true;
-    }
+    normalize = calc_normal_xform(mat, xform);
   } else {
     xform = mat;
   }
@@ -1879,6 +1869,217 @@ do_transform_vector_column(const GeomVertexFormat *format, GeomVertexRewriter &d
   }
 }
 
+/**
+ * Computes the matrix that should be used to transform normals by the
+ * indicated matrix, so that they remain perpendicular to the surface.
+ * Returns true if the transformed normals will also need to be normalized.
+ */
+bool GeomVertexData::
+calc_normal_xform(const LMatrix4 &mat, LMatrix4 &xform) {
+  LVecBase3 scale_sq(mat.get_row3(0).length_squared(),
+                     mat.get_row3(1).length_squared(),
+                     mat.get_row3(2).length_squared());
+  if (IS_THRESHOLD_EQUAL(scale_sq[0], scale_sq[1], 2.0e-3f) &&
+      IS_THRESHOLD_EQUAL(scale_sq[0], scale_sq[2], 2.0e-3f)) {
+    // There is a uniform scale.
+    LVecBase3 scale, shear, hpr;
+    if (IS_THRESHOLD_EQUAL(scale_sq[0], 1, 2.0e-3f)) {
+      // No scale to worry about.
+      xform = mat;
+      return false;
+    } else if (decompose_matrix(mat.get_upper_3(), scale, shear, hpr)) {
+      // Make a new matrix with scale/translate taken out of the equation.
+      compose_matrix(xform, LVecBase3(1, 1, 1), shear, hpr, LVecBase3::zero());
+      return false;
+    } else {
+      xform = mat;
+      return true;
+    }
+  } else {
+    // There is a non-uniform scale, so we need to do all this to preserve
+    // orthogonality to the surface.
+    xform.invert_from(mat);
+    xform.transpose_in_place();
+    return true;
+  }
+}
+
+/**
+ * Applies the transform blends to all of the points and vectors in the
+ * indicated rows of new_data, which is a copy of this data, in the common
+ * case that all of these columns consist of three 32-bit floats and the blend
+ * indices are a table of ushorts.  Each vertex is transformed with the matrix
+ * of its own blend, so the vertices need not be sorted by blend.
+ *
+ * The rows may be divided between the threads of the WorkerThreadPool; see
+ * parallel-skinning.  Returns false, without doing anything, if the columns
+ * are of some other type.
+ */
+bool GeomVertexData::
+do_skin_float32(const GeomVertexFormat *format, GeomVertexData *new_data,
+                const TransformBlendTable *tb_table, const SparseArray &rows,
+                const unsigned short *blendt, Thread *current_thread) {
+  size_t num_points = format->get_num_points();
+  size_t num_vectors = format->get_num_vectors();
+  size_t num_columns = num_points + num_vectors;
+
+  bool any_normals = false;
+  for (size_t ci = 0; ci < num_columns; ++ci) {
+    const InternalName *name = (ci < num_points) ? format->get_point(ci) : format->get_vector(ci - num_points);
+    const GeomVertexColumn *column = format->get_column(name);
+    if (column == nullptr ||
+        column->get_numeric_type() != NT_float32 ||
+        column->get_num_values() != 3) {
+      return false;
+    }
+    if (ci >= num_points && column->get_contents() == C_normal) {
+      any_normals = true;
+    }
+  }
+
+  // Look up the matrix of each blend ahead of time, so that the inner loop
+  // has to do nothing more than index into a table.
+  int num_blends = (int)tb_table->get_num_blends();
+  pvector<LMatrix4f> mats(num_blends);
+  pvector<LMatrix4f> normal_mats;
+  pvector<unsigned char> normalize;
+  if (any_normals) {
+    normal_mats.resize(num_blends);
+    normalize.resize(num_blends);
+  }
+  for (int bi = 0; bi < num_blends; ++bi) {
+    LMatrix4 mat;
+    tb_table->get_blend(bi).get_blend(mat, current_thread);
+    mats[bi] = LCAST(float, mat);
+
+    if (any_normals) {
+      LMatrix4 xform;
+      normalize[bi] = calc_normal_xform(mat, xform);
+      normal_mats[bi] = LCAST(float, xform);
+    }
+  }
+
+  GeomVertexDataPipelineWriter writer(new_data, true, current_thread);
+  writer.check_array_writers();
+
+  pvector<SkinColumn> columns(num_columns);
+  for (size_t ci = 0; ci < num_columns; ++ci) {
+    const InternalName *name = (ci < num_points) ? format->get_point(ci) : format->get_vector(ci - num_points);
+    int array_index = format->get_array_with(name);
+    const GeomVertexColumn *column = format->get_column(name);
+
+    GeomVertexArrayDataHandle *handle = writer.get_array_writer(array_index);
+    SkinColumn &skin_column = columns[ci];
+    skin_column._stride = handle->get_array_format()->get_stride();
+    skin_column._data = handle->get_write_pointer() + column->get_start();
+    skin_column._is_point = (ci < num_points);
+    skin_column._is_normal = (ci >= num_points && column->get_contents() == C_normal);
+  }
+
+  const LMatrix4f *normal_mats_p = any_normals ? &normal_mats[0] : nullptr;
+  const unsigned char *normalize_p = any_normals ? &normalize[0] : nullptr;
+
+  WorkerThreadPool *pool = nullptr;
+  if (parallel_skinning &&
+      rows.get_num_on_bits() >= parallel_skinning_min_vertices) {
+    pool = WorkerThreadPool::get_global_ptr();
+    if (pool->get_num_threads() == 0) {
+      pool = nullptr;
+    }
+  }
+
+  int num_subranges = rows.get_num_subranges();
+  if (pool == nullptr) {
+    for (int i = 0; i < num_subranges; ++i) {
+      do_skin_rows(&columns[0], num_columns, blendt,
+                   rows.get_subrange_begin(i), rows.get_subrange_end(i),
+                   num_blends, &mats[0], normal_mats_p, normalize_p);
+    }
+    return true;
+  }
+
+  // Divide the rows into chunks, a few for each thread, so that the threads
+  // stay busy even if some finish their chunks early.
+  static const int chunk_rows = 1024;
+  pvector<std::pair<int, int> > chunks;
+  for (int i = 0; i < num_subranges; ++i) {
+    int begin = rows.get_subrange_begin(i);
+    int end = rows.get_subrange_end(i);
+    while (begin < end) {
+      int chunk_end = std::min(begin + chunk_rows, end);
+      chunks.push_back(std::make_pair(begin, chunk_end));
+      begin = chunk_end;
+    }
+  }
+
+  pool->parallel_for(chunks.size(), [&] (size_t n, Thread *) {
+    do_skin_rows(&columns[0], num_columns, blendt,
+                 chunks[n].first, chunks[n].second,
+                 num_blends, &mats[0], normal_mats_p, normalize_p);
+  }, current_thread);
+  return true;
+}
+
+/**
+ * The inner loop of do_skin_float32().  Transforms the indicated range of
+ * rows of each of the columns by the matrix of each row's blend.
+ */
+void GeomVertexData::
+do_skin_rows(const SkinColumn *columns, size_t num_columns,
+             const unsigned short *blendt, int begin_row, int end_row,
+             int num_blends, const LMatrix4f *mats,
+             const LMatrix4f *normal_mats, const unsigned char *normalize) {
+  for (size_t ci = 0; ci < num_columns; ++ci) {
+    const SkinColumn &column = columns[ci];
+    unsigned char *datat = column._data + begin_row * column._stride;
+    const LMatrix4f *col_mats = column._is_normal ? normal_mats : mats;
+
+    for (int j = begin_row; j < end_row; ++j, datat += column._stride) {
+      int bi = blendt[j];
+      nassertd(bi < num_blends) continue;
+
+      float *v = (float *)datat;
+      const float *m = col_mats[bi].get_data();
+
+#ifdef SKINNING_SSE2
+      // Compute x * row0 + y * row1 + z * row2 (+ row3 for points).
+      __m128 r = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(v[0]), _mm_loadu_ps(m)),
+                            _mm_mul_ps(_mm_set1_ps(v[1]), _mm_loadu_ps(m + 4)));
+      __m128 t = _mm_mul_ps(_mm_set1_ps(v[2]), _mm_loadu_ps(m + 8));
+      if (column._is_point) {
+        t = _mm_add_ps(t, _mm_loadu_ps(m + 12));
+      }
+      r = _mm_add_ps(r, t);
+
+      if (column._is_normal && normalize[bi]) {
+        __m128 sq = _mm_mul_ps(r, r);
+        float l2 = _mm_cvtss_f32(sq) +
+                   _mm_cvtss_f32(_mm_shuffle_ps(sq, sq, _MM_SHUFFLE(1, 1, 1, 1))) +
+                   _mm_cvtss_f32(_mm_movehl_ps(sq, sq));
+        if (l2 != 0.0f) {
+          r = _mm_div_ps(r, _mm_set1_ps(sqrtf(l2)));
+        }
+      }
+
+      // Store only the three components, leaving the next column alone.
+      _mm_storel_pi((__m64 *)v, r);
+      _mm_store_ss(v + 2, _mm_movehl_ps(r, r));
+#else
+      LVecBase3f &vec = *(LVecBase3f *)v;
+      const LMatrix4f &mat = col_mats[bi];
+      if (column._is_point) {
+        vec = mat.xform_point(vec);
+      } else {
+        vec = mat.xform_vec(vec);
+        if (column._is_normal && normalize[bi]) {
+          vec.normalize();
+        }
+      }
+#endif
+    }
+  }
+}
+
 /**
  * Transforms each of the LPoint3f objects in the indicated table by the
  * indicated matrix.
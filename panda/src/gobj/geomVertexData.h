@@ -350,6 +350,27 @@ private:
                                    size_t stride, const LMatrix4f &matf);
   static void table_xform_vecbase4f(unsigned char *datat, size_t num_rows,
                                     size_t stride, const LMatrix4f &matf);
+  static bool calc_normal_xform(const LMatrix4 &mat, LMatrix4 &xform);
+
+  // Describes one of the float32 columns animated by do_skin_float32().
+  class SkinColumn {
+  public:
+    unsigned char *_data;
+    size_t _stride;
+    bool _is_point;
+    bool _is_normal;
+  };
+  static bool do_skin_float32(const GeomVertexFormat *format,
+                              GeomVertexData *new_data,
+                              const TransformBlendTable *tb_table,
+                              const SparseArray &rows,
+                              const unsigned short *blendt,
+                              Thread *current_thread);
+  static void do_skin_rows(const SkinColumn *columns, size_t num_columns,
+                           const unsigned short *blendt,
+                           int begin_row, int end_row, int num_blends,
+                           const LMatrix4f *mats, const LMatrix4f *normal_mats,
+                           const unsigned char *normalize);
 
   static PStatCollector _convert_pcollector;
   static PStatCollector _scale_color_pcollector;
@@ -10328,11 +10328,32 @@ do_write_datagram_rawdata(CData *cdata, BamWriter *manager, Datagram &me) {
       me.append_data(pixel, pixel_size);
     }
   } else {
+    // Beginning with bam 6.47, a large image may be written in a separate
+    // record ahead of this one, so that it can be read straight into the
+    // image buffer on the way back in.
+    DatagramSink *target = manager->get_target();
+    bool can_defer = manager->get_file_minor_ver() >= 47 &&
+      bam_deferred_ram_image_size > 0 &&
+      target != nullptr && target->get_file() != nullptr;
+
     me.add_uint8(cdata->_ram_images.size());
     for (size_t n = 0; n < cdata->_ram_images.size(); ++n) {
+      const PTA_uchar &image = cdata->_ram_images[n]._image;
       me.add_uint32(cdata->_ram_images[n]._page_size);
-      me.add_uint32(cdata->_ram_images[n]._image.size());
-      me.append_data(cdata->_ram_images[n]._image, cdata->_ram_images[n]._image.size());
+
+      bool deferred = false;
+      if (manager->get_file_minor_ver() >= 47) {
+        deferred = can_defer &&
+          image.size() >= (size_t)bam_deferred_ram_image_size;
+        me.add_bool(deferred);
+      }
+
+      me.add_uint32(image.size());
+      if (deferred) {
+        manager->write_file_data(image.p(), image.size(), MEMORY_HOOK_ALIGNMENT);
+      } else {
+        me.append_data(image, image.size());
+      }
     }
   }
 }
@@ -10659,18 +10680,44 @@ do_fillin_rawdata(CData *cdata, DatagramIterator &scan, BamReader *manager) {
       cdata->_ram_images[n]._page_size = scan.get_uint32();
     }
 
+    bool deferred = false;
+    if (manager->get_file_minor_ver() >= 47) {
+      deferred = scan.get_bool();
+    }
+
     // fill the cdata->_image buffer with image data
     size_t u_size = scan.get_uint32();
 
-    // Protect against large allocation.
-    if (u_size > scan.get_remaining_size()) {
-      gobj_cat.error()
-        << "RAM image " << n << " extends past end of datagram, is texture corrupt?\n";
-      return;
-    }
+    PTA_uchar image;
+    if (deferred) {
+      // The image was written in a separate record; read it directly into
+      // the new buffer.
+      SubfileInfo info;
+      manager->read_file_data(info);
+      if (info.is_empty() || (size_t)info.get_size() != u_size) {
+        gobj_cat.error()
+          << "RAM image " << n << " is missing from bam file, is texture corrupt?\n";
+        return;
+      }
 
-    PTA_uchar image = PTA_uchar::empty_array(u_size, get_class_type());
-    scan.extract_bytes(image.p(), u_size);
+      image = PTA_uchar::empty_array(u_size, get_class_type());
+      if (!manager->extract_file_data(info, image.p())) {
+        gobj_cat.error()
+          << "Could not read RAM image " << n << " from " << info << "\n";
+        return;
+      }
+
+    } else {
+      // Protect against large allocation.
+      if (u_size > scan.get_remaining_size()) {
+        gobj_cat.error()
+          << "RAM image " << n << " extends past end of datagram, is texture corrupt?\n";
+        return;
+      }
+
+      image = PTA_uchar::empty_array(u_size, get_class_type());
+      scan.extract_bytes(image.p(), u_size);
+    }
 
     cdata->_ram_images[n]._image = image;
   }
@@ -14,6 +14,7 @@
 #include "vertexDataBuffer.h"
 #include "config_gobj.h"
 #include "pStatTimer.h"
+#include "virtualFileSystem.h"
 
 TypeHandle VertexDataBuffer::_type_handle;
 
@@ -39,6 +40,9 @@ operator = (const VertexDataBuffer &copy) {
   _size = copy._size;
   _reserved_size = copy._size;
   _block = copy._block;
+  _deferred = copy._deferred;
+  _mapping = copy._mapping;
+  _mapped_data = copy._mapped_data;
   nassertv(_reserved_size >= _size);
 }
 
@@ -55,6 +59,9 @@ swap(VertexDataBuffer &other) {
   size_t reserved_size = _reserved_size;
 
   _block.swap(other._block);
+  _deferred.swap(other._deferred);
+  _mapping.swap(other._mapping);
+  std::swap(_mapped_data, other._mapped_data);
 
   _resident_data = other._resident_data;
   _size = other._size;
@@ -121,6 +128,9 @@ do_unclean_realloc(size_t reserved_size) {
 
     // If we're paged out, discard the page.
     _block = nullptr;
+    _deferred = nullptr;
+    _mapping = nullptr;
+    _mapped_data = nullptr;
 
     if (_resident_data != nullptr) {
       nassertv(_reserved_size != 0);
@@ -151,8 +161,9 @@ do_unclean_realloc(size_t reserved_size) {
  */
 void VertexDataBuffer::
 do_page_out(VertexDataBook &book) {
-  if (_block != nullptr || _reserved_size == 0) {
-    // We're already paged out.
+  if (_block != nullptr || _deferred != nullptr || _mapped_data != nullptr ||
+      _reserved_size == 0) {
+    // We're already paged out, or our data is still in the bam file.
     return;
   }
   nassertv(_resident_data != nullptr);
@@ -194,11 +205,137 @@ do_page_in() {
     return;
   }
 
-  nassertv(_block != nullptr);
   nassertv(_reserved_size == _size);
 
+  if (_mapped_data != nullptr) {
+    // Copy the data out of the mapped file, so that it may be modified.
+    _resident_data = (unsigned char *)get_class_type().allocate_array(_size);
+    nassertv(_resident_data != nullptr);
+
+    memcpy(_resident_data, _mapped_data, _size);
+    _mapping = nullptr;
+    _mapped_data = nullptr;
+    return;
+  }
+
+  if (_deferred != nullptr) {
+    _resident_data = (unsigned char *)get_class_type().allocate_array(_size);
+    nassertv(_resident_data != nullptr);
+
+    if (!do_read_deferred()) {
+      // Better to hand out zeroes than uninitialized memory.
+      memset(_resident_data, 0, _size);
+    }
+    _deferred = nullptr;
+    return;
+  }
+
+  nassertv(_block != nullptr);
+
   _resident_data = (unsigned char *)get_class_type().allocate_array(_size);
   nassertv(_resident_data != nullptr);
 
   memcpy(_resident_data, _block->get_pointer(true), _size);
 }
+
+/**
+ * Empties the buffer, and sets it to read its data from the indicated range
+ * of the indicated file the first time it is accessed, rather than right
+ * away.  The size of the buffer becomes the size of the range.
+ *
+ * If timestamp is nonzero, it should be the modification time of the file at
+ * the time the range was determined; the data will not be read if the file
+ * has since been modified.
+ */
+void VertexDataBuffer::
+set_deferred(const SubfileInfo &source, time_t timestamp) {
+  LightMutexHolder holder(_lock);
+  do_unclean_realloc(0);
+
+  if (source.get_size() == 0) {
+    return;
+  }
+
+  _deferred = new Deferred;
+  _deferred->_source = source;
+  _deferred->_timestamp = timestamp;
+  _size = (size_t)source.get_size();
+  _reserved_size = _size;
+}
+
+/**
+ * Empties the buffer, and sets it to refer directly to the indicated data
+ * within a memory-mapped file, without copying it.  The data is copied into
+ * independent memory when the buffer is modified.  The mapping is kept open
+ * for as long as the buffer refers to it.
+ */
+void VertexDataBuffer::
+set_mapped(MappedFile *mapping, const unsigned char *data, size_t size) {
+  nassertv(mapping != nullptr && data != nullptr);
+  nassertv(((uintptr_t)data % MEMORY_HOOK_ALIGNMENT) == 0);
+
+  LightMutexHolder holder(_lock);
+  do_unclean_realloc(0);
+
+  if (size == 0) {
+    return;
+  }
+
+  _mapping = mapping;
+  _mapped_data = data;
+  _size = size;
+  _reserved_size = size;
+}
+
+/**
+ * Reads the data of a deferred buffer into _resident_data, which must already
+ * have been allocated.  Returns true on success, false on failure.
+ *
+ * Assumes the lock is already held.
+ */
+bool VertexDataBuffer::
+do_read_deferred() {
+  const SubfileInfo &source = _deferred->_source;
+  Filename filename = source.get_filename();
+  filename.set_binary();
+
+  if (gobj_cat.is_debug()) {
+    gobj_cat.debug()
+      << this << ".read_deferred(" << source << ")\n";
+  }
+
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  PT(VirtualFile) vfile = vfs->get_file(filename);
+  if (vfile == nullptr) {
+    gobj_cat.error()
+      << "Unable to read vertex data: " << filename << " no longer exists.\n";
+    return false;
+  }
+
+  if (_deferred->_timestamp != 0 &&
+      vfile->get_timestamp() != _deferred->_timestamp) {
+    gobj_cat.error()
+      << "Unable to read vertex data: " << filename
+      << " has been modified since it was loaded.\n";
+    return false;
+  }
+
+  std::istream *in = vfile->open_read_file(false);
+  if (in == nullptr) {
+    gobj_cat.error()
+      << "Unable to read vertex data from " << filename << "\n";
+    return false;
+  }
+
+  in->seekg(source.get_start());
+  in->read((char *)_resident_data, _size);
+  bool success = !in->fail() && (size_t)in->gcount() == _size;
+  vfile->close_read_file(in);
+
+  if (!success) {
+    gobj_cat.error()
+      << "Unable to read " << _size << " bytes of vertex data from "
+      << filename << "\n";
+  }
+  return success;
+}
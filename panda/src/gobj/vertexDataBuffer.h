@@ -19,6 +19,9 @@
 #include "vertexDataBlock.h"
 #include "pointerTo.h"
 #include "virtualFile.h"
+#include "subfileInfo.h"
+#include "mappedFile.h"
+#include "referenceCount.h"
 #include "pStatCollector.h"
 #include "lightMutex.h"
 #include "lightMutexHolder.h"
@@ -48,6 +51,15 @@
  * VertexDataBuffers resident in easy-to-access memory, while collecting the
  * static and rarely accessed VertexDataBuffers together onto pages, where
  * they may be written to disk as a block when necessary.
+ *
+ * A buffer read from a bam file may also start out in a third, deferred
+ * state, in which its data has not been read yet, but remains in a known
+ * place within the bam file.  It is read into independent memory the first
+ * time it is accessed.
+ *
+ * Finally, a buffer may be mapped, in which case it refers directly to the
+ * contents of a memory-mapped bam file.  This memory is read-only; the buffer
+ * is copied into independent memory as soon as it is modified.
  */
 class EXPCL_PANDA_GOBJ VertexDataBuffer {
 public:
@@ -68,6 +80,10 @@ public:
   INLINE void clear();
 
   INLINE void page_out(VertexDataBook &book);
+  void set_deferred(const SubfileInfo &source, time_t timestamp);
+  INLINE bool is_deferred() const;
+  void set_mapped(MappedFile *mapping, const unsigned char *data, size_t size);
+  INLINE bool is_mapped() const;
 
   void swap(VertexDataBuffer &other);
 
@@ -77,11 +93,23 @@ private:
 
   void do_page_out(VertexDataBook &book);
   void do_page_in();
+  bool do_read_deferred();
+
+  // Records where the data of a deferred buffer may be found.  This is shared
+  // between copies of the buffer, each of which reads it independently.
+  class Deferred : public ReferenceCount {
+  public:
+    SubfileInfo _source;
+    time_t _timestamp;
+  };
 
   unsigned char *_resident_data;
   size_t _size;
   size_t _reserved_size;
   PT(VertexDataBlock) _block;
+  PT(Deferred) _deferred;
+  PT(MappedFile) _mapping;
+  const unsigned char *_mapped_data;
   LightMutex _lock;
 
 public:
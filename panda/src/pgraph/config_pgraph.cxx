@@ -138,6 +138,41 @@ ConfigVariableBool show_occluder_volumes
  PRC_DESC("Set this true to enable debug visualization of the volumes used "
           "to cull objects behind an occluder."));
 
+ConfigVariableBool parallel_cull
+("parallel-cull", false,
+ PRC_DESC("Set this true to split up the cull traversal of each "
+          "DisplayRegion among the threads of the global worker thread "
+          "pool (see worker-threads).  Any node with at least "
+          "parallel-cull-min-children children has its children traversed "
+          "in parallel.  This only helps for large scenes, and requires "
+          "that any cull callbacks in the scene graph be thread-safe.  "
+          "It is not used with portal culling, or with custom "
+          "CullTraverser subclasses."));
+
+ConfigVariableBool persistent_cull
+("persistent-cull", false,
+ PRC_DESC("Set this true to have each DisplayRegion remember the objects "
+          "that were found below the nodes near the top of the scene graph "
+          "during the cull traversal, and reuse them in the following "
+          "frames instead of traversing those nodes again, as long as the "
+          "camera has not moved and nothing below the node has changed.  "
+          "This helps for large scenes that are mostly static, viewed by "
+          "a camera that often stands still."));
+
+ConfigVariableInt persistent_cull_depth
+("persistent-cull-depth", 3,
+ PRC_DESC("The number of levels of the scene graph, counting from the "
+          "scene root, at which the cull results are remembered when "
+          "persistent-cull is enabled.  Higher values allow more of the "
+          "scene to be reused when only a small part of it changes, at the "
+          "cost of more memory."));
+
+ConfigVariableInt parallel_cull_min_children
+("parallel-cull-min-children", 8,
+ PRC_DESC("The minimum number of children a node must have before its "
+          "children are traversed in parallel, when parallel-cull is "
+          "enabled."));
+
 ConfigVariableBool unambiguous_graph
 ("unambiguous-graph", false,
  PRC_DESC("Set this true to make ambiguous path warning messages generate an "
@@ -207,6 +242,23 @@ ConfigVariableDouble garbage_collect_states_rate
           "performance if states accumulate faster than they can be "
           "cleaned up."));
 
+ConfigVariableDouble garbage_collect_states_budget
+("garbage-collect-states-budget", 0.0,
+ PRC_DESC("The maximum amount of time, in seconds, that each call to "
+          "TransformState::garbage_collect() or RenderState::garbage_collect() "
+          "may spend checking states, both the recently created ones and "
+          "the long-lived ones.  When this time runs out, the remaining "
+          "states are deferred to the next call.  Set this to 0 to impose "
+          "no limit."));
+
+ConfigVariableInt garbage_collect_states_young_age
+("garbage-collect-states-young-age", 4,
+ PRC_DESC("The number of garbage collection steps for which a newly created "
+          "TransformState or RenderState is checked on every step, before "
+          "it is considered long-lived and is instead visited at the rate "
+          "given by garbage-collect-states-rate.  Most states that are "
+          "discarded at all are discarded shortly after being created."));
+
 ConfigVariableBool transform_cache
 ("transform-cache", true,
  PRC_DESC("Set this true to enable the cache of TransformState objects.  "
@@ -220,6 +272,22 @@ ALIGN_16BYTE ConfigVariableBool state_cache
           "similar to the TransformState cache controlled via "
           "transform-cache."));
 
+ConfigVariableInt local_composition_cache_size
+("local-composition-cache-size", 0,
+ PRC_DESC("The number of entries in the small cache of recent TransformState "
+          "and RenderState compositions that is kept separately by each "
+          "thread.  It is consulted before the shared composition cache, "
+          "so that threads repeating the same compose() operations do not "
+          "need to contend for the global state lock.  Each entry holds a "
+          "reference to the states involved, which a thread only lets go of "
+          "the next time it composes a state after the cache is cleared; "
+          "so states may be kept alive by threads that have stopped "
+          "composing states.  This is 0 by default, which disables the "
+          "per-thread cache; try 256 in an application that composes states "
+          "from several threads at once.  The value is read when each "
+          "thread first composes a state.  This has no effect unless Panda "
+          "was compiled with true threading support."));
+
 ConfigVariableBool uniquify_transforms
 ("uniquify-transforms", true,
  PRC_DESC("Set this true to ensure that equivalent TransformStates "
@@ -312,6 +380,23 @@ ConfigVariableBool flatten_geoms
           "only the NodePath interfaces; you may still make the lower-level "
           "SceneGraphReducer calls directly."));
 
+ConfigVariableBool flatten_optimize_vertex_cache
+("flatten-optimize-vertex-cache", false,
+ PRC_DESC("Set this true to have NodePath::flatten_strong() also reorder the "
+          "triangles and vertices of the flattened Geoms to make better use "
+          "of the post-transform vertex cache of the graphics hardware.  "
+          "This makes flattening slower, but may improve the rendering "
+          "performance of large meshes.  It has no effect when flatten-geoms "
+          "is false."));
+
+ConfigVariableInt vertex_cache_size
+("vertex-cache-size", 32,
+ PRC_DESC("Specifies the number of vertices assumed to fit in the "
+          "post-transform vertex cache of the graphics hardware, for the "
+          "purposes of SceneGraphReducer::optimize_vertex_cache().  The "
+          "optimization is not very sensitive to the exact value; it need "
+          "not match the actual hardware precisely."));
+
 ConfigVariableInt max_lenses
 ("max-lenses", 100,
  PRC_DESC("Specifies an upper limit on the maximum number of lenses "
@@ -35,6 +35,10 @@ extern ConfigVariableBool clip_plane_cull;
 extern ConfigVariableBool allow_portal_cull;
 extern ConfigVariableBool debug_portal_cull;
 extern ConfigVariableBool show_occluder_volumes;
+extern ConfigVariableBool parallel_cull;
+extern ConfigVariableInt parallel_cull_min_children;
+extern ConfigVariableBool persistent_cull;
+extern ConfigVariableInt persistent_cull_depth;
 extern ConfigVariableBool unambiguous_graph;
 extern ConfigVariableBool detect_graph_cycles;
 extern ConfigVariableBool no_unsupported_copy;
@@ -45,8 +49,11 @@ extern ConfigVariableBool paranoid_const;
 extern ConfigVariableBool auto_break_cycles;
 extern EXPCL_PANDA_PGRAPH ConfigVariableBool garbage_collect_states;
 extern ConfigVariableDouble garbage_collect_states_rate;
+extern ConfigVariableDouble garbage_collect_states_budget;
+extern ConfigVariableInt garbage_collect_states_young_age;
 extern ConfigVariableBool transform_cache;
 extern ALIGN_16BYTE EXPCL_PANDA_PGRAPH ConfigVariableBool state_cache;
+extern ConfigVariableInt local_composition_cache_size;
 extern ConfigVariableBool uniquify_transforms;
 extern EXPCL_PANDA_PGRAPH ConfigVariableBool uniquify_states;
 extern ALIGN_16BYTE EXPCL_PANDA_PGRAPH ConfigVariableBool uniquify_attribs;
@@ -58,6 +65,8 @@ extern EXPCL_PANDA_PGRAPH ConfigVariableBool premunge_data;
 extern ConfigVariableBool premunge_remove_unused_vertices;
 extern ConfigVariableBool preserve_geom_nodes;
 extern ConfigVariableBool flatten_geoms;
+extern ConfigVariableBool flatten_optimize_vertex_cache;
+extern ConfigVariableInt vertex_cache_size;
 extern EXPCL_PANDA_PGRAPH ConfigVariableInt max_lenses;
 
 extern ConfigVariableBool polylight_info;
@@ -0,0 +1,186 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file cullResultCache.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "cullResultCache.h"
+#include "cullTraverser.h"
+#include "sceneSetup.h"
+#include "camera.h"
+#include "config_pgraph.h"
+
+UpdateSeq CullResultCache::_global_stale_seq;
+
+/**
+ *
+ */
+CullResultCache::
+CullResultCache() :
+  _scene_root(nullptr),
+  _gsg(nullptr),
+  _incomplete_render(false),
+  _frame(0),
+  _depth(0),
+  _max_depth(0),
+  _num_reused(0),
+  _num_recomputed(0),
+  _num_volatile_nodes(0)
+{
+}
+
+/**
+ * Called at the start of each traversal.  If anything about the scene or the
+ * camera has changed since the last traversal, or mark_stale() has been
+ * called, the cache is emptied.
+ */
+void CullResultCache::
+begin_traverse(const CullTraverser *trav) {
+  SceneSetup *scene = trav->get_scene();
+  const Lens *lens = scene->get_lens();
+
+  if (_scene_root != scene->get_scene_root().node() ||
+      _cs_world_transform != scene->get_cs_world_transform() ||
+      _lens != lens || _lens_change != lens->get_last_change() ||
+      _initial_state != trav->get_initial_state() ||
+      _camera_mask != trav->get_camera_mask() ||
+      _gsg != trav->get_gsg() ||
+      _incomplete_render != trav->get_effective_incomplete_render() ||
+      _stale_seq != _global_stale_seq) {
+    clear();
+
+    _scene_root = scene->get_scene_root().node();
+    _cs_world_transform = scene->get_cs_world_transform();
+    _lens = lens;
+    _lens_change = lens->get_last_change();
+    _initial_state = trav->get_initial_state();
+    _camera_mask = trav->get_camera_mask();
+    _gsg = trav->get_gsg();
+    _incomplete_render = trav->get_effective_incomplete_render();
+    _stale_seq = _global_stale_seq;
+  }
+
+  ++_frame;
+  _depth = 0;
+  _max_depth = persistent_cull_depth;
+  _num_reused = 0;
+  _num_recomputed = 0;
+}
+
+/**
+ * Called at the end of each traversal.  Removes the results for any nodes
+ * that were not visited during this traversal.
+ */
+void CullResultCache::
+end_traverse() {
+  Entries::iterator ei = _entries.begin();
+  while (ei != _entries.end()) {
+    if ((*ei).second._last_used != _frame) {
+      ei = _entries.erase(ei);
+    } else {
+      ++ei;
+    }
+  }
+}
+
+/**
+ * If the results of traversing the indicated node are available in the
+ * cache, passes them on to the traverser's CullHandler and returns true.
+ * Otherwise, returns false, and the node should be traversed normally.
+ */
+bool CullResultCache::
+replay(CullTraverserData &data, CullTraverser *trav) {
+  Entries::iterator ei = _entries.find(Key(data));
+  if (ei == _entries.end()) {
+    return false;
+  }
+
+  Entry &entry = (*ei).second;
+  PandaNodePipelineReader *node_reader = data.node_reader();
+  node_reader->check_cached(false);
+  if (entry._seq != node_reader->get_update_seq() ||
+      entry._draw_mask != data._draw_mask ||
+      entry._instances != data._instances ||
+      entry._has_view_frustum != (data._view_frustum != nullptr)) {
+    return false;
+  }
+
+  entry._last_used = _frame;
+
+  ++_num_reused;
+  CullTraverser::_nodes_reused_pcollector.add_level(1);
+  CullTraverser::_geoms_pcollector.add_level(entry._objects.size());
+
+  CullHandler *handler = trav->get_cull_handler();
+  for (const CullableObject &object : entry._objects) {
+    handler->record_object(CullableObject(object), trav);
+  }
+  return true;
+}
+
+/**
+ * Traverses the indicated node, and stores the objects found below it in the
+ * cache, unless something was found that makes this impossible.
+ */
+void CullResultCache::
+record(CullTraverserData &data, CullTraverser *trav) {
+  ++_num_recomputed;
+  CullTraverser::_nodes_recomputed_pcollector.add_level(1);
+
+  // We have to grab these before the traversal modifies the data.
+  Key key(data);
+  PandaNodePipelineReader *node_reader = data.node_reader();
+  node_reader->check_cached(false);
+  UpdateSeq seq = node_reader->get_update_seq();
+  DrawMask draw_mask = data._draw_mask;
+  CPT(InstanceList) instances = data._instances;
+  bool has_view_frustum = (data._view_frustum != nullptr);
+  PT(PandaNode) node = data.node();
+
+  unsigned int num_volatile_nodes = _num_volatile_nodes.load(std::memory_order_relaxed);
+
+  Recorder recorder(trav->_cull_handler);
+  trav->_cull_handler = &recorder;
+  ++_depth;
+  trav->traverse_node(data);
+  --_depth;
+  trav->_cull_handler = recorder._next;
+
+  if (num_volatile_nodes != _num_volatile_nodes.load(std::memory_order_relaxed)) {
+    // Something below this node may render differently next frame.
+    return;
+  }
+
+  Entry &entry = _entries[std::move(key)];
+  entry._node = std::move(node);
+  entry._seq = seq;
+  entry._draw_mask = draw_mask;
+  entry._instances = std::move(instances);
+  entry._has_view_frustum = has_view_frustum;
+  entry._last_used = _frame;
+  entry._objects.swap(recorder._objects);
+}
+
+/**
+ * Removes all of the results from the cache.
+ */
+void CullResultCache::
+clear() {
+  _entries.clear();
+}
+
+/**
+ *
+ */
+void CullResultCache::Recorder::
+record_object(CullableObject &&object, const CullTraverser *traverser) {
+  _objects.push_back(object);
+  _next->record_object(std::move(object), traverser);
+}
@@ -0,0 +1,146 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file cullResultCache.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef CULLRESULTCACHE_H
+#define CULLRESULTCACHE_H
+
+#include "pandabase.h"
+#include "cullHandler.h"
+#include "cullableObject.h"
+#include "cullTraverserData.h"
+#include "referenceCount.h"
+#include "pointerTo.h"
+#include "updateSeq.h"
+#include "drawMask.h"
+#include "lens.h"
+#include "patomic.h"
+#include "pvector.h"
+#include "pmap.h"
+
+class CullTraverser;
+class GraphicsStateGuardianBase;
+class InstanceList;
+class PandaNode;
+class RenderState;
+class TransformState;
+
+/**
+ * This is used by the CullTraverser when persistent-cull is enabled to keep
+ * the objects that were found below each of the nodes near the top of the
+ * scene graph, so that the following frames can reuse them without
+ * traversing the nodes again, as long as nothing about the camera or the
+ * subgraph has changed since.
+ *
+ * A node is considered unchanged as long as its transform, state and
+ * bounding volume, and those of all nodes below it, are unchanged, and it is
+ * reached with the same net transform and state.  Subgraphs containing nodes
+ * that do something special during cull (such as LODNodes, Characters or
+ * billboards) are never cached, since they may produce different results
+ * each frame even if nothing else has changed.
+ *
+ * Changes that affect what is rendered without changing the bounding volume,
+ * such as the effects on a node or the state of a Geom, are rare enough that
+ * they simply invalidate all caches, by calling mark_stale().
+ */
+class EXPCL_PANDA_PGRAPH CullResultCache : public ReferenceCount {
+public:
+  CullResultCache();
+  CullResultCache(const CullResultCache &copy) = delete;
+
+  void begin_traverse(const CullTraverser *trav);
+  void end_traverse();
+
+  INLINE bool is_cacheable(const CullTraverserData &data) const;
+  bool replay(CullTraverserData &data, CullTraverser *trav);
+  void record(CullTraverserData &data, CullTraverser *trav);
+
+  INLINE void note_volatile_node();
+
+  INLINE size_t get_num_entries() const;
+  INLINE int get_num_reused() const;
+  INLINE int get_num_recomputed() const;
+  void clear();
+
+  INLINE static void mark_stale();
+
+private:
+  class Key {
+  public:
+    INLINE Key(const CullTraverserData &data);
+    INLINE bool operator < (const Key &other) const;
+
+    const PandaNode *_node;
+    CPT(TransformState) _net_transform;
+    CPT(RenderState) _state;
+  };
+
+  class Entry {
+  public:
+    PT(PandaNode) _node;
+    UpdateSeq _seq;
+    DrawMask _draw_mask;
+    CPT(InstanceList) _instances;
+    bool _has_view_frustum;
+    unsigned int _last_used;
+
+    typedef pvector<CullableObject> Objects;
+    Objects _objects;
+  };
+  typedef pmap<Key, Entry> Entries;
+  Entries _entries;
+
+  // This passes on the objects recorded below a node to the real CullHandler,
+  // while also keeping a copy of them.
+  class Recorder : public CullHandler {
+  public:
+    INLINE Recorder(CullHandler *next);
+
+    virtual void record_object(CullableObject &&object,
+                               const CullTraverser *traverser);
+
+    CullHandler *_next;
+    Entry::Objects _objects;
+  };
+
+  // These describe the scene the cached results are valid for.
+  const PandaNode *_scene_root;
+  CPT(TransformState) _cs_world_transform;
+  CPT(Lens) _lens;
+  UpdateSeq _lens_change;
+  CPT(RenderState) _initial_state;
+  DrawMask _camera_mask;
+  GraphicsStateGuardianBase *_gsg;
+  bool _incomplete_render;
+  UpdateSeq _stale_seq;
+
+  unsigned int _frame;
+  int _depth;
+  int _max_depth;
+
+  // These count the nodes found in and added to the cache during the last
+  // traversal.
+  int _num_reused;
+  int _num_recomputed;
+
+  // Incremented whenever a node is encountered whose cull results may
+  // change from frame to frame.  This is atomic since it may be incremented
+  // by the worker threads during parallel cull.
+  patomic<unsigned int> _num_volatile_nodes;
+
+  // Incremented by mark_stale().
+  static UpdateSeq _global_stale_seq;
+};
+
+#include "cullResultCache.I"
+
+#endif
@@ -35,12 +35,19 @@
 #include "geomLinestrips.h"
 #include "geomLines.h"
 #include "geomVertexWriter.h"
+#include "workerThreadPool.h"
+#include "cullResultCache.h"
+#include "camera.h"
+#include "pStatTimer.h"
 
 PStatCollector CullTraverser::_nodes_pcollector("Nodes");
 PStatCollector CullTraverser::_geom_nodes_pcollector("Nodes:GeomNodes");
 PStatCollector CullTraverser::_pgui_nodes_pcollector("Nodes:GUI");
 PStatCollector CullTraverser::_geoms_pcollector("Geoms");
 PStatCollector CullTraverser::_geoms_occluded_pcollector("Geoms:Occluded");
+PStatCollector CullTraverser::_parallel_merge_pcollector("Cull:Parallel merge");
+PStatCollector CullTraverser::_nodes_reused_pcollector("Nodes:Reused");
+PStatCollector CullTraverser::_nodes_recomputed_pcollector("Nodes:Recomputed");
 
 TypeHandle CullTraverser::_type_handle;
 
@@ -57,7 +64,9 @@ CullTraverser() :
   _initial_state(RenderState::make_empty()),
   _cull_handler(nullptr),
   _portal_clipper(nullptr),
-  _effective_incomplete_render(false)
+  _effective_incomplete_render(false),
+  _parallel_cull(false),
+  _persistent_cull(false)
 {
 }
 
@@ -77,8 +86,21 @@ CullTraverser(const CullTraverser &copy) :
   _view_frustum(copy._view_frustum),
   _cull_handler(copy._cull_handler),
   _portal_clipper(copy._portal_clipper),
-  _effective_incomplete_render(copy._effective_incomplete_render)
+  _effective_incomplete_render(copy._effective_incomplete_render),
+  _parallel_cull(false),
+  _persistent_cull(false),
+  _result_cache(copy._result_cache)
 {
+  // Copies are made to perform nested traversals, which we always do in the
+  // current thread.  They don't consult the cache themselves, but they do
+  // need to tell it about any nodes that prevent caching.
+}
+
+/**
+ *
+ */
+CullTraverser::
+~CullTraverser() {
 }
 
 /**
@@ -107,6 +129,28 @@ set_scene(SceneSetup *scene_setup, GraphicsStateGuardianBase *gsg,
 #ifndef NDEBUG
   _fake_view_frustum_cull = fake_view_frustum_cull;
 #endif
+
+  // Subclasses of CullTraverser may keep state that is modified during the
+  // traversal, so we only do this for the base class.
+  _parallel_cull = parallel_cull && !allow_portal_cull &&
+    get_type() == CullTraverser::get_class_type() &&
+    WorkerThreadPool::get_global_ptr()->get_num_threads() > 0;
+
+  // The cached results depend only on the camera's transform and lens, so
+  // we don't use the cache if the camera culls from somewhere else, or if it
+  // uses tag states.
+  _persistent_cull = persistent_cull && !allow_portal_cull &&
+    get_type() == CullTraverser::get_class_type() &&
+    !_has_tag_state_key && camera->get_cull_center().is_empty() &&
+    camera->get_cull_bounds() == nullptr;
+  if (_persistent_cull) {
+    if (_result_cache == nullptr) {
+      _result_cache = new CullResultCache;
+    }
+    _result_cache->begin_traverse(this);
+  } else {
+    _result_cache.clear();
+  }
 }
 
 /**
@@ -177,6 +221,20 @@ traverse(const NodePath &root) {
  */
 void CullTraverser::
 do_traverse(CullTraverserData &data) {
+  if (_persistent_cull && _result_cache->is_cacheable(data)) {
+    if (!_result_cache->replay(data, this)) {
+      _result_cache->record(data, this);
+    }
+  } else {
+    traverse_node(data);
+  }
+}
+
+/**
+ * The implementation of do_traverse(), which actually traverses the node.
+ */
+void CullTraverser::
+traverse_node(CullTraverserData &data) {
 #ifndef NDEBUG
   if (UNLIKELY(pgraph_cat.is_spam())) {
     pgraph_cat.spam()
@@ -200,8 +258,23 @@ do_traverse(CullTraverserData &data) {
       show_bounds(data, (fancy_bits & PandaNode::FB_show_tight_bounds) != 0);
     }
 
+    if (_result_cache != nullptr &&
+        ((fancy_bits & PandaNode::FB_cull_callback) != 0 ||
+         ((fancy_bits & PandaNode::FB_effects) != 0 &&
+          node_reader->get_effects()->has_cull_callback()))) {
+      // What this node renders may change from frame to frame, even if
+      // nothing in the scene graph changes.
+      _result_cache->note_volatile_node();
+    }
+
     data.apply_transform_and_state(this);
 
+    if (_result_cache != nullptr && data._state->has_cull_callback()) {
+      // The same goes for a state with a cull callback, such as one with a
+      // MovieTexture.
+      _result_cache->note_volatile_node();
+    }
+
     if (fancy_bits & PandaNode::FB_cull_callback) {
       if (!node->cull_callback(this, data)) {
         return;
@@ -234,18 +307,109 @@ do_traverse(CullTraverserData &data) {
   PandaNode::Children children = node_reader->get_children();
   node_reader->release();
   int num_children = children.get_num_children();
+  if (_parallel_cull && num_children >= parallel_cull_min_children) {
+    traverse_children_parallel(data, children);
+    return;
+  }
   for (int i = 0; i < num_children; ++i) {
     const PandaNode::DownConnection &child = children.get_child_connection(i);
     traverse_down(data, child, data._state);
   }
 }
 
+/**
+ * A CullHandler that saves up the objects it is given, so that they may be
+ * passed on to the real CullHandler afterwards, from the original thread.
+ */
+class DeferredCullHandler final : public CullHandler {
+public:
+  virtual void record_object(CullableObject &&object,
+                             const CullTraverser *traverser) override {
+    _objects.push_back(std::move(object));
+  }
+
+  pvector<CullableObject> _objects;
+};
+
+/**
+ * Called by do_traverse() when parallel-cull is enabled, to traverse the
+ * children of the given node using the worker thread pool.  Each child is
+ * traversed by a separate copy of this CullTraverser, and the objects it
+ * finds are collected and then handed to our CullHandler in the same order
+ * that a serial traversal would have produced them.
+ *
+ * Nodes further down are always traversed serially.
+ */
+void CullTraverser::
+traverse_children_parallel(CullTraverserData &data,
+                           const PandaNode::Children &children) {
+  size_t num_children = (size_t)children.get_num_children();
+  pvector<DeferredCullHandler> handlers(num_children);
+
+  WorkerThreadPool *pool = WorkerThreadPool::get_global_ptr();
+  pool->parallel_for(num_children, [&] (size_t i, Thread *current_thread) {
+    PT(CullTraverser) trav = new CullTraverser(*this);
+    trav->_current_thread = current_thread;
+    trav->_cull_handler = &handlers[i];
+
+    // The node must be read anew, using this thread.
+    CullTraverserData parent_data(data, current_thread);
+    parent_data.node_reader()->release();
+    trav->traverse_down(parent_data, children.get_child_connection(i),
+                        parent_data._state);
+  }, _current_thread);
+
+  PStatTimer timer(_parallel_merge_pcollector, _current_thread);
+  for (DeferredCullHandler &handler : handlers) {
+    for (CullableObject &object : handler._objects) {
+      _cull_handler->record_object(std::move(object), this);
+    }
+  }
+}
+
+/**
+ * Returns the number of nodes for which the objects found during the
+ * previous traversal were reused during the last traversal, rather than
+ * traversing them again.  This is always 0 unless persistent-cull is enabled.
+ */
+int CullTraverser::
+get_num_nodes_reused() const {
+  return (_result_cache != nullptr) ? _result_cache->get_num_reused() : 0;
+}
+
+/**
+ * Returns the number of nodes that could not be reused from the previous
+ * traversal during the last traversal, and had to be traversed again.  This
+ * is always 0 unless persistent-cull is enabled.
+ */
+int CullTraverser::
+get_num_nodes_recomputed() const {
+  return (_result_cache != nullptr) ? _result_cache->get_num_recomputed() : 0;
+}
+
+/**
+ * Should be called by a node's add_for_draw() or cull_callback() when it
+ * finds something whose rendering may change from frame to frame, even if
+ * nothing in the scene graph changes, such as a Geom state with a cull
+ * callback.  This prevents the results of the nodes above it from being
+ * reused in the next frame when persistent-cull is enabled.
+ */
+void CullTraverser::
+note_volatile_node() {
+  if (_result_cache != nullptr) {
+    _result_cache->note_volatile_node();
+  }
+}
+
 /**
  * Should be called when the traverser has finished traversing its scene, this
  * gives it a chance to do any necessary finalization.
  */
 void CullTraverser::
 end_traverse() {
+  if (_persistent_cull) {
+    _result_cache->end_traverse();
+  }
   _cull_handler->end_traverse();
 }
 
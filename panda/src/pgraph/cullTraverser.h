@@ -34,6 +34,7 @@ class CullHandler;
 class CullableObject;
 class CullTraverserData;
 class PortalClipper;
+class CullResultCache;
 class NodePath;
 
 /**
@@ -46,6 +47,7 @@ class EXPCL_PANDA_PGRAPH CullTraverser : public TypedReferenceCount {
 PUBLISHED:
   CullTraverser();
   CullTraverser(const CullTraverser &copy);
+  virtual ~CullTraverser();
 
   INLINE GraphicsStateGuardianBase *get_gsg() const;
   INLINE Thread *get_current_thread() const;
@@ -78,6 +80,9 @@ PUBLISHED:
   INLINE bool get_effective_incomplete_render() const;
   INLINE bool get_fake_view_frustum_cull() const;
 
+  int get_num_nodes_reused() const;
+  int get_num_nodes_recomputed() const;
+
   INLINE static void flush_level();
 
   void traverse(const NodePath &root);
@@ -104,6 +109,8 @@ public:
                     const TransformState *net_transform,
                     const RenderState *state);
 
+  void note_volatile_node();
+
 public:
   // Statistics
   static PStatCollector _nodes_pcollector;
@@ -111,8 +118,15 @@ public:
   static PStatCollector _pgui_nodes_pcollector;
   static PStatCollector _geoms_pcollector;
   static PStatCollector _geoms_occluded_pcollector;
+  static PStatCollector _parallel_merge_pcollector;
+  static PStatCollector _nodes_reused_pcollector;
+  static PStatCollector _nodes_recomputed_pcollector;
 
 private:
+  void traverse_node(CullTraverserData &data);
+  void traverse_children_parallel(CullTraverserData &data,
+                                  const PandaNode::Children &children);
+
   void show_bounds(CullTraverserData &data, bool tight);
   static PT(Geom) make_bounds_viz(const BoundingVolume *vol);
   PT(Geom) make_tight_bounds_viz(PandaNode *node) const;
@@ -134,6 +148,9 @@ private:
   CullHandler *_cull_handler;
   PortalClipper *_portal_clipper;
   bool _effective_incomplete_render;
+  bool _parallel_cull;
+  bool _persistent_cull;
+  PT(CullResultCache) _result_cache;
 
 public:
   static TypeHandle get_class_type() {
@@ -151,6 +168,8 @@ public:
 
 private:
   static TypeHandle _type_handle;
+
+  friend class CullResultCache;
 };
 
 #include "cullTraverserData.h"
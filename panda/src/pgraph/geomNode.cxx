@@ -40,6 +40,7 @@
 #include "config_mathutil.h"
 #include "preparedGraphicsObjects.h"
 #include "instanceList.h"
+#include "cullResultCache.h"
 
 
 bool allow_flatten_color = ConfigVariableBool
@@ -537,11 +538,16 @@ add_for_draw(CullTraverser *trav, CullTraverserData &data) {
     CPT(Geom) geom = geoms.get_geom(0);
     if (!geom->is_empty()) {
       CPT(RenderState) state = data._state->compose(geoms.get_geom_state(0));
-      if (!state->has_cull_callback() || state->cull_callback(trav, data)) {
-        CullableObject object(std::move(geom), std::move(state), std::move(internal_transform));
-        object._instances = data._instances;
-        trav->get_cull_handler()->record_object(std::move(object), trav);
+      if (state->has_cull_callback()) {
+        // This Geom may render differently next frame.
+        trav->note_volatile_node();
+        if (!state->cull_callback(trav, data)) {
+          return;
+        }
       }
+      CullableObject object(std::move(geom), std::move(state), std::move(internal_transform));
+      object._instances = data._instances;
+      trav->get_cull_handler()->record_object(std::move(object), trav);
     }
   }
   else {
@@ -553,9 +559,12 @@ add_for_draw(CullTraverser *trav, CullTraverserData &data) {
       }
 
       CPT(RenderState) state = data._state->compose(geoms.get_geom_state(i));
-      if (state->has_cull_callback() && !state->cull_callback(trav, data)) {
-        // Cull.
-        continue;
+      if (state->has_cull_callback()) {
+        trav->note_volatile_node();
+        if (!state->cull_callback(trav, data)) {
+          // Cull.
+          continue;
+        }
       }
 
       if (data._instances != nullptr) {
@@ -605,6 +614,29 @@ get_legal_collide_mask() const {
   return CollideMask::all_on();
 }
 
+/**
+ * Changes the RenderState associated with the nth geom of the node.  This is
+ * just the RenderState directly associated with the Geom; the actual state in
+ * which the Geom is rendered will also be affected by RenderStates that
+ * appear on the scene graph in nodes above this GeomNode.
+ *
+ * Note that if this method is called in a downstream stage (for instance,
+ * during cull or draw), then it will propagate the new list of Geoms upstream
+ * all the way to pipeline stage 0, which may step on changes that were made
+ * independently in pipeline stage 0. Use with caution.
+ */
+void GeomNode::
+set_geom_state(int n, const RenderState *state) {
+  CDWriter cdata(_cycler, true);
+  PT(GeomList) geoms = cdata->modify_geoms();
+  nassertv(n >= 0 && n < (int)geoms->size());
+  (*geoms)[n]._state = state;
+
+  // This doesn't change the bounding volume, but it does change what is
+  // rendered.
+  CullResultCache::mark_stale();
+}
+
 /**
  * Adds a new Geom to the node.  The geom is given the indicated state (which
  * may be RenderState::make_empty(), to completely inherit its state from the
@@ -718,6 +750,7 @@ decompose() {
     }
   }
   CLOSE_ITERATE_CURRENT_AND_UPSTREAM(_cycler);
+  CullResultCache::mark_stale();
 }
 
 /**
@@ -72,7 +72,7 @@ PUBLISHED:
   MAKE_SEQ(modify_geoms, get_num_geoms, modify_geom);
   INLINE const RenderState *get_geom_state(int n) const;
   MAKE_SEQ(get_geom_states, get_num_geoms, get_geom_state);
-  INLINE void set_geom_state(int n, const RenderState *state);
+  void set_geom_state(int n, const RenderState *state);
 
   void add_geom(Geom *geom, const RenderState *state = RenderState::make_empty());
   void add_geoms_from(const GeomNode *other);
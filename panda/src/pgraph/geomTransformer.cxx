@@ -914,6 +914,33 @@ reverse(GeomNode *node) {
   return (num_geoms != 0);
 }
 
+/**
+ * Reorders the triangles of all of the Geoms in the node to make better use
+ * of a post-transform vertex cache of the indicated size.  The vertices
+ * themselves will also be reordered to match the order in which they are
+ * first used, for better locality of reference, at the next call to
+ * finish_apply().
+ *
+ * Returns true if any Geoms are modified, false otherwise.
+ */
+bool GeomTransformer::
+optimize_vertex_cache(GeomNode *node, int cache_size) {
+  bool any_changed = false;
+
+  int num_geoms = node->get_num_geoms();
+  for (int i = 0; i < num_geoms; ++i) {
+    PT(Geom) geom = node->modify_geom(i);
+    geom->optimize_vertex_cache_in_place(cache_size);
+
+    VertexDataAssoc &assoc = _vdata_assoc[geom->get_vertex_data()];
+    assoc._geoms.push_back(geom);
+    assoc._reorder_vertices = true;
+    any_changed = true;
+  }
+
+  return any_changed;
+}
+
 /**
  * Should be called after performing any operations--particularly
  * PandaNode::apply_attribs_to_vertices()--that might result in new
@@ -927,7 +954,10 @@ finish_apply() {
   for (vi = _vdata_assoc.begin(); vi != _vdata_assoc.end(); ++vi) {
     const GeomVertexData *vdata = (*vi).first;
     VertexDataAssoc &assoc = (*vi).second;
-    if (assoc._might_have_unused) {
+    if (assoc._reorder_vertices) {
+      // This also removes any unused vertices.
+      assoc.reorder_vertices(vdata);
+    } else if (assoc._might_have_unused) {
       assoc.remove_unused_vertices(vdata);
     }
   }
@@ -1565,3 +1595,162 @@ remove_unused_vertices(const GeomVertexData *vdata) {
     geom->set_vertex_data(new_vdata);
   }
 }
+
+/**
+ * Rearranges the vertices in the indicated GeomVertexData so that they appear
+ * in the order in which they are first referenced by the associated Geoms,
+ * removing any vertices that aren't referenced at all.  This improves the
+ * locality of the vertex fetches after the primitives have been optimized
+ * for the vertex cache.
+ */
+void GeomTransformer::VertexDataAssoc::
+reorder_vertices(const GeomVertexData *vdata) {
+  if (_geoms.empty()) {
+    // Trivial case.
+    return;
+  }
+
+  PT(Thread) current_thread = Thread::get_current_thread();
+
+  int num_vertices = vdata->get_num_rows();
+  if (num_vertices <= 0) {
+    return;
+  }
+
+  // Number the vertices in the order in which they are first referenced.
+  vector_int remap_array(num_vertices, -1);
+  vector_int new_to_old;
+  new_to_old.reserve(num_vertices);
+
+  bool any_referenced = false;
+  GeomList::iterator gi;
+  for (gi = _geoms.begin(); gi != _geoms.end(); ++gi) {
+    Geom *geom = (*gi);
+    if (geom->get_vertex_data() != vdata) {
+      continue;
+    }
+
+    any_referenced = true;
+    int num_primitives = geom->get_num_primitives();
+    for (int i = 0; i < num_primitives; ++i) {
+      CPT(GeomPrimitive) prim = geom->get_primitive(i);
+      int strip_cut_index = prim->get_strip_cut_index();
+      GeomPrimitivePipelineReader reader(prim, current_thread);
+      int num_prim_vertices = reader.get_num_vertices();
+      for (int vi = 0; vi < num_prim_vertices; ++vi) {
+        int index = reader.get_vertex(vi);
+        if (index == strip_cut_index) {
+          continue;
+        }
+        nassertv(index >= 0 && index < num_vertices);
+        if (remap_array[index] < 0) {
+          remap_array[index] = (int)new_to_old.size();
+          new_to_old.push_back(index);
+        }
+      }
+    }
+  }
+
+  if (!any_referenced) {
+    return;
+  }
+
+  int new_num_vertices = (int)new_to_old.size();
+  bool any_moved = (new_num_vertices != num_vertices);
+  for (int new_index = 0; new_index < new_num_vertices && !any_moved; ++new_index) {
+    any_moved = (new_to_old[new_index] != new_index);
+  }
+  if (!any_moved) {
+    // The vertices are already in order.
+    return;
+  }
+
+  // Now recopy the actual vertex data, one array at a time.
+  PT(GeomVertexData) new_vdata = new GeomVertexData(*vdata);
+  new_vdata->unclean_set_num_rows(new_num_vertices);
+
+  size_t num_arrays = vdata->get_num_arrays();
+  nassertv(num_arrays == new_vdata->get_num_arrays());
+
+  {
+    GeomVertexDataPipelineReader reader(vdata, current_thread);
+    reader.check_array_readers();
+    GeomVertexDataPipelineWriter writer(new_vdata, true, current_thread);
+    writer.check_array_writers();
+
+    for (size_t a = 0; a < num_arrays; ++a) {
+      const GeomVertexArrayDataHandle *array_reader = reader.get_array_reader(a);
+      GeomVertexArrayDataHandle *array_writer = writer.get_array_writer(a);
+
+      int stride = array_reader->get_array_format()->get_stride();
+      nassertv(stride == array_writer->get_array_format()->get_stride());
+
+      const unsigned char *from = array_reader->get_read_pointer(true);
+      unsigned char *to = array_writer->get_write_pointer();
+      for (int new_index = 0; new_index < new_num_vertices; ++new_index) {
+        memcpy(to + new_index * stride, from + new_to_old[new_index] * stride, stride);
+      }
+    }
+  }
+
+  // Update the rows in the TransformBlendTable and SliderTable, if any.
+  // Since the rows are no longer in order, we have to remap them one at a
+  // time.
+  PT(TransformBlendTable) tbtable = new_vdata->modify_transform_blend_table();
+  if (!tbtable.is_null()) {
+    const SparseArray &rows = tbtable->get_rows();
+    SparseArray new_rows;
+    for (int new_index = 0; new_index < new_num_vertices; ++new_index) {
+      if (rows.get_bit(new_to_old[new_index])) {
+        new_rows.set_bit(new_index);
+      }
+    }
+    tbtable->set_rows(new_rows);
+  }
+
+  const SliderTable *sliders = new_vdata->get_slider_table();
+  if (sliders != nullptr) {
+    PT(SliderTable) new_sliders = new SliderTable(*sliders);
+    size_t num_sliders = new_sliders->get_num_sliders();
+    for (size_t si = 0; si < num_sliders; ++si) {
+      const SparseArray &rows = new_sliders->get_slider_rows(si);
+      SparseArray new_rows;
+      for (int new_index = 0; new_index < new_num_vertices; ++new_index) {
+        if (rows.get_bit(new_to_old[new_index])) {
+          new_rows.set_bit(new_index);
+        }
+      }
+      new_sliders->set_slider_rows(si, new_rows);
+    }
+    new_vdata->set_slider_table(SliderTable::register_table(new_sliders));
+  }
+
+  // Finally, reindex the Geoms.
+  for (gi = _geoms.begin(); gi != _geoms.end(); ++gi) {
+    Geom *geom = (*gi);
+    if (geom->get_vertex_data() != vdata) {
+      continue;
+    }
+
+    int num_primitives = geom->get_num_primitives();
+    for (int i = 0; i < num_primitives; ++i) {
+      PT(GeomPrimitive) prim = geom->modify_primitive(i);
+      prim->make_indexed();
+      int strip_cut_index = prim->get_strip_cut_index();
+      PT(GeomVertexArrayData) vertices = prim->modify_vertices();
+      GeomVertexRewriter rewriter(vertices, 0, current_thread);
+
+      while (!rewriter.is_at_end()) {
+        int index = rewriter.get_data1i();
+        if (index == strip_cut_index) {
+          rewriter.set_data1i(index);
+          continue;
+        }
+        nassertv(index >= 0 && index < num_vertices);
+        rewriter.set_data1i(remap_array[index]);
+      }
+    }
+
+    geom->set_vertex_data(new_vdata);
+  }
+}
@@ -81,6 +81,7 @@ public:
   bool reverse_normals(Geom *geom);
   bool doubleside(GeomNode *node);
   bool reverse(GeomNode *node);
+  bool optimize_vertex_cache(GeomNode *node, int cache_size);
 
   void finish_apply();
 
@@ -97,13 +98,16 @@ private:
 
   // Keeps track of the Geoms that are associated with a particular
   // GeomVertexData.  Also tracks whether the vertex data might have unused
-  // vertices because of our actions.
+  // vertices because of our actions, or should be reordered to match the
+  // order in which the vertices are used.
   class VertexDataAssoc {
   public:
     INLINE VertexDataAssoc();
     bool _might_have_unused;
+    bool _reorder_vertices;
     GeomList _geoms;
     void remove_unused_vertices(const GeomVertexData *vdata);
+    void reorder_vertices(const GeomVertexData *vdata);
   };
   typedef pmap<CPT(GeomVertexData), VertexDataAssoc> VertexDataAssocMap;
   VertexDataAssocMap _vdata_assoc;
@@ -0,0 +1,72 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file localCompositionCache.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef LOCALCOMPOSITIONCACHE_H
+#define LOCALCOMPOSITIONCACHE_H
+
+#include "pandabase.h"
+#include "pointerTo.h"
+#include "pvector.h"
+#include "patomic.h"
+#include "stl_compares.h"
+
+/**
+ * A small, direct-mapped cache of recently computed compositions, of which
+ * each thread keeps its own copy.  RenderState and TransformState consult
+ * this before their shared composition cache, which may only be examined
+ * while holding the global _states_lock; a hit here requires no lock at all.
+ *
+ * Each entry holds a reference to both operands as well as to the result, so
+ * a pointer in the cache cannot be recycled for a different object while the
+ * entry is still alive.  Calling flush_all() causes every thread to drop its
+ * entries the next time it consults its cache.
+ *
+ * This is a private helper class of RenderState and TransformState.
+ */
+template<class State>
+class LocalCompositionCache {
+public:
+  INLINE explicit LocalCompositionCache(size_t size);
+
+  INLINE bool lookup(const State *a, const State *b, bool invert,
+                     CPT(State) &result);
+  INLINE void store(const State *a, const State *b, bool invert,
+                    const State *result);
+
+  INLINE bool check_epoch();
+  INLINE static void flush_all();
+
+private:
+  INLINE size_t get_index(const State *a, const State *b, bool invert) const;
+
+  class Entry {
+  public:
+    CPT(State) _a;
+    CPT(State) _b;
+    CPT(State) _result;
+    bool _invert = false;
+  };
+  typedef pvector<Entry> Entries;
+  Entries _entries;
+  size_t _mask;
+  unsigned int _epoch;
+
+  static patomic<unsigned int> _global_epoch;
+};
+
+template<class State>
+patomic<unsigned int> LocalCompositionCache<State>::_global_epoch {0};
+
+#include "localCompositionCache.I"
+
+#endif
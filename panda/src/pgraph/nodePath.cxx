@@ -5683,11 +5683,31 @@ flatten_strong() {
     gr.make_compatible_state(node());
     gr.collect_vertex_data(node(), ~(SceneGraphReducer::CVD_format | SceneGraphReducer::CVD_name | SceneGraphReducer::CVD_animation_type));
     gr.unify(node(), false);
+
+    if (flatten_optimize_vertex_cache) {
+      gr.optimize_vertex_cache(node());
+    }
   }
 
   return num_removed;
 }
 
+/**
+ * Reduces the number of triangles in the Geoms at this node and below to
+ * approximately the indicated fraction of the original, for instance to make
+ * a lower level of detail from a copy of a model.  UV and normal seams and
+ * the borders of open meshes are preserved.  See
+ * SceneGraphReducer::simplify().
+ *
+ * The return value is the number of GeomNodes modified.
+ */
+int NodePath::
+simplify(PN_stdfloat ratio) {
+  nassertr_always(!is_empty(), 0);
+  SceneGraphReducer gr;
+  return gr.simplify(node(), ratio);
+}
+
 /**
  * Removes textures from Geoms at this node and below by applying the texture
  * colors to the vertices.  This is primarily useful to simplify a low-LOD
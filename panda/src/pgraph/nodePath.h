@@ -918,6 +918,7 @@ PUBLISHED:
   int flatten_light();
   int flatten_medium();
   int flatten_strong();
+  int simplify(PN_stdfloat ratio);
   void apply_texture_colors();
   INLINE int clear_model_nodes();
 
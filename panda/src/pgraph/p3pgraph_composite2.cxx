@@ -5,6 +5,7 @@
 #include "cullHandler.cxx"
 #include "cullPlanes.cxx"
 #include "cullResult.cxx"
+#include "cullResultCache.cxx"
 #include "cullTraverser.cxx"
 #include "cullTraverserData.cxx"
 #include "cullableObject.cxx"
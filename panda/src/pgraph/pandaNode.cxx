@@ -29,6 +29,7 @@
 #include "graphicsStateGuardianBase.h"
 #include "decalEffect.h"
 #include "showBoundsEffect.h"
+#include "cullResultCache.h"
 
 using std::ostream;
 using std::ostringstream;
@@ -968,6 +969,10 @@ set_effect(const RenderEffect *effect) {
     }
   }
   CLOSE_ITERATE_CURRENT_AND_UPSTREAM(_cycler);
+
+  // This doesn't change the bounding volume, but it may change what is
+  // rendered.
+  CullResultCache::mark_stale();
   mark_bam_modified();
 }
 
@@ -990,6 +995,7 @@ clear_effect(TypeHandle type) {
     }
   }
   CLOSE_ITERATE_CURRENT_AND_UPSTREAM(_cycler);
+  CullResultCache::mark_stale();
   mark_bam_modified();
 }
 
@@ -1041,6 +1047,7 @@ set_effects(const RenderEffects *effects, Thread *current_thread) {
     cdata->set_fancy_bit(FB_show_tight_bounds, effects->has_show_tight_bounds());
   }
   CLOSE_ITERATE_CURRENT_AND_UPSTREAM(_cycler);
+  CullResultCache::mark_stale();
   mark_bam_modified();
 }
 
@@ -907,6 +907,7 @@ public:
   INLINE const RenderAttrib *get_off_clip_planes() const;
   INLINE const BoundingVolume *get_bounds() const;
   INLINE int get_nested_vertices() const;
+  INLINE UpdateSeq get_update_seq() const;
   INLINE bool is_final() const;
   INLINE int get_fancy_bits() const;
 
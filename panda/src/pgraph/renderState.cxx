@@ -34,15 +34,17 @@
 #include "lightReMutexHolder.h"
 #include "lightMutexHolder.h"
 #include "thread.h"
+#include "trueClock.h"
 #include "renderAttribRegistry.h"
 
 using std::ostream;
 
 LightReMutex *RenderState::_states_lock = nullptr;
-RenderState::States RenderState::_states;
+RenderState::StatesShard *RenderState::_states_shards = nullptr;
 const RenderState *RenderState::_empty_state = nullptr;
+size_t RenderState::_garbage_shard = 0;
+size_t RenderState::_garbage_young_shard = 0;
 UpdateSeq RenderState::_last_cycle_detect;
-size_t RenderState::_garbage_index = 0;
 
 PStatCollector RenderState::_cache_update_pcollector("*:State Cache:Update");
 PStatCollector RenderState::_garbage_collect_pcollector("*:State Cache:Garbage Collect");
@@ -50,6 +52,9 @@ PStatCollector RenderState::_state_compose_pcollector("*:State Cache:Compose Sta
 PStatCollector RenderState::_state_invert_pcollector("*:State Cache:Invert State");
 PStatCollector RenderState::_node_counter("RenderStates:On nodes");
 PStatCollector RenderState::_cache_counter("RenderStates:Cached");
+PStatCollector RenderState::_collected_counter("RenderStates:Collected");
+PStatCollector RenderState::_young_counter("RenderStates:Young");
+PStatCollector RenderState::_deferred_counter("RenderStates:Deferred");
 PStatCollector RenderState::_state_break_cycles_pcollector("*:State Cache:Break Cycles");
 PStatCollector RenderState::_state_validate_pcollector("*:State Cache:Validate");
 
@@ -72,6 +77,7 @@ RenderState() :
     init_states();
   }
   _saved_entry = -1;
+  _young_index = -1;
   _last_mi = -1;
   _cache_stats.add_num_states(1);
   _read_overrides = nullptr;
@@ -97,6 +103,7 @@ RenderState(const RenderState &copy) :
   }
 
   _saved_entry = -1;
+  _young_index = -1;
   _last_mi = -1;
   _cache_stats.add_num_states(1);
   _read_overrides = nullptr;
@@ -356,6 +363,71 @@ compose(const RenderState *other) const {
     return do_compose(other);
   }
 
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+  // Before taking the lock, see if this thread has recently computed the
+  // same composition.
+  LocalCompositionCache<RenderState> &local_cache = get_local_cache();
+  CPT(RenderState) result;
+  if (local_cache.lookup(this, other, false, result)) {
+    return result;
+  }
+  result = cached_compose(other);
+  local_cache.store(this, other, false, result);
+  return result;
+#else
+  return cached_compose(other);
+#endif
+}
+
+/**
+ * Returns a new RenderState object that represents the composition of this
+ * state's inverse with the other state.
+ *
+ * This is similar to compose(), but is particularly useful for computing the
+ * relative state of a node as viewed from some other node.
+ */
+CPT(RenderState) RenderState::
+invert_compose(const RenderState *other) const {
+  // This method isn't strictly const, because it updates the cache, but we
+  // pretend that it is because it's only a cache which is transparent to the
+  // rest of the interface.
+
+  // We handle empty state (identity) as a trivial special case.
+  if (is_empty()) {
+    return other;
+  }
+  // Unlike compose(), the case of other->is_empty() is not quite as trivial
+  // for invert_compose().
+
+  if (other == this) {
+    // a->invert_compose(a) always produces identity.
+    return _empty_state;
+  }
+
+  if (!state_cache) {
+    return do_invert_compose(other);
+  }
+
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+  LocalCompositionCache<RenderState> &local_cache = get_local_cache();
+  CPT(RenderState) result;
+  if (local_cache.lookup(this, other, true, result)) {
+    return result;
+  }
+  result = cached_invert_compose(other);
+  local_cache.store(this, other, true, result);
+  return result;
+#else
+  return cached_invert_compose(other);
+#endif
+}
+
+/**
+ * The part of compose() that consults and updates the shared composition
+ * cache.
+ */
+CPT(RenderState) RenderState::
+cached_compose(const RenderState *other) const {
   LightReMutexHolder holder(*_states_lock);
 
   // Is this composition already cached?
@@ -417,34 +489,11 @@ compose(const RenderState *other) const {
 }
 
 /**
- * Returns a new RenderState object that represents the composition of this
- * state's inverse with the other state.
- *
- * This is similar to compose(), but is particularly useful for computing the
- * relative state of a node as viewed from some other node.
+ * The part of invert_compose() that consults and updates the shared
+ * composition cache.
  */
 CPT(RenderState) RenderState::
-invert_compose(const RenderState *other) const {
-  // This method isn't strictly const, because it updates the cache, but we
-  // pretend that it is because it's only a cache which is transparent to the
-  // rest of the interface.
-
-  // We handle empty state (identity) as a trivial special case.
-  if (is_empty()) {
-    return other;
-  }
-  // Unlike compose(), the case of other->is_empty() is not quite as trivial
-  // for invert_compose().
-
-  if (other == this) {
-    // a->invert_compose(a) always produces identity.
-    return _empty_state;
-  }
-
-  if (!state_cache) {
-    return do_invert_compose(other);
-  }
-
+cached_invert_compose(const RenderState *other) const {
   LightReMutexHolder holder(*_states_lock);
 
   // Is this composition already cached?
@@ -633,15 +682,20 @@ unref() const {
     }
   }
 
-  if (ReferenceCount::unref()) {
-    // The reference count is still nonzero.
-    return true;
-  }
+  {
+    // We also need to hold the lock on our shard of the global state table,
+    // since another thread may find us there without holding _states_lock.
+    LightReMutexHolder shard_holder(get_states_shard()._lock);
+    if (ReferenceCount::unref()) {
+      // The reference count is still nonzero.
+      return true;
+    }
 
-  // The reference count has just reached zero.  Make sure the object is
-  // removed from the global object pool, before anyone else finds it and
-  // tries to ref it.
-  ((RenderState *)this)->release_new();
+    // The reference count has just reached zero.  Make sure the object is
+    // removed from the global object pool, before anyone else finds it and
+    // tries to ref it.
+    ((RenderState *)this)->release_new();
+  }
   ((RenderState *)this)->remove_cache_pointers();
 
   return false;
@@ -714,8 +768,17 @@ get_max_priority() {
  */
 int RenderState::
 get_num_states() {
-  LightReMutexHolder holder(*_states_lock);
-  return _states.get_num_entries();
+  if (_states_shards == nullptr) {
+    return 0;
+  }
+
+  size_t num_states = 0;
+  for (size_t shi = 0; shi < num_states_shards; ++shi) {
+    StatesShard &shard = _states_shards[shi];
+    LightReMutexHolder holder(shard._lock);
+    num_states += shard._states.get_num_entries();
+  }
+  return (int)num_states;
 }
 
 /**
@@ -740,41 +803,45 @@ get_num_unused_states() {
   typedef pmap<const RenderState *, int> StateCount;
   StateCount state_count;
 
-  size_t size = _states.get_num_entries();
-  for (size_t si = 0; si < size; ++si) {
-    const RenderState *state = _states.get_key(si);
-
-    std::pair<StateCount::iterator, bool> ir =
-      state_count.insert(StateCount::value_type(state, 1));
-    if (!ir.second) {
-      // If the above insert operation fails, then it's already in the
-      // cache; increment its value.
-      (*(ir.first)).second++;
-    }
+  for (size_t shi = 0; shi < num_states_shards; ++shi) {
+    StatesShard &shard = _states_shards[shi];
+    LightReMutexHolder shard_holder(shard._lock);
+    size_t size = shard._states.get_num_entries();
+    for (size_t si = 0; si < size; ++si) {
+      const RenderState *state = shard._states.get_key(si);
+
+      std::pair<StateCount::iterator, bool> ir =
+        state_count.insert(StateCount::value_type(state, 1));
+      if (!ir.second) {
+        // If the above insert operation fails, then it's already in the
+        // cache; increment its value.
+        (*(ir.first)).second++;
+      }
 
-    size_t i;
-    size_t cache_size = state->_composition_cache.get_num_entries();
-    for (i = 0; i < cache_size; ++i) {
-      const RenderState *result = state->_composition_cache.get_data(i)._result;
-      if (result != nullptr && result != state) {
-        // Here's a RenderState that's recorded in the cache.  Count it.
-        std::pair<StateCount::iterator, bool> ir =
-          state_count.insert(StateCount::value_type(result, 1));
-        if (!ir.second) {
-          // If the above insert operation fails, then it's already in the
-          // cache; increment its value.
-          (*(ir.first)).second++;
+      size_t i;
+      size_t cache_size = state->_composition_cache.get_num_entries();
+      for (i = 0; i < cache_size; ++i) {
+        const RenderState *result = state->_composition_cache.get_data(i)._result;
+        if (result != nullptr && result != state) {
+          // Here's a RenderState that's recorded in the cache.  Count it.
+          std::pair<StateCount::iterator, bool> ir =
+            state_count.insert(StateCount::value_type(result, 1));
+          if (!ir.second) {
+            // If the above insert operation fails, then it's already in the
+            // cache; increment its value.
+            (*(ir.first)).second++;
+          }
         }
       }
-    }
-    cache_size = state->_invert_composition_cache.get_num_entries();
-    for (i = 0; i < cache_size; ++i) {
-      const RenderState *result = state->_invert_composition_cache.get_data(i)._result;
-      if (result != nullptr && result != state) {
-        std::pair<StateCount::iterator, bool> ir =
-          state_count.insert(StateCount::value_type(result, 1));
-        if (!ir.second) {
-          (*(ir.first)).second++;
+      cache_size = state->_invert_composition_cache.get_num_entries();
+      for (i = 0; i < cache_size; ++i) {
+        const RenderState *result = state->_invert_composition_cache.get_data(i)._result;
+        if (result != nullptr && result != state) {
+          std::pair<StateCount::iterator, bool> ir =
+            state_count.insert(StateCount::value_type(result, 1));
+          if (!ir.second) {
+            (*(ir.first)).second++;
+          }
         }
       }
     }
@@ -821,10 +888,17 @@ get_num_unused_states() {
  */
 int RenderState::
 clear_cache() {
+  // Make sure that the per-thread caches let go of their references, too.
+  // The other threads will release theirs the next time they compose.
+  LocalCompositionCache<RenderState>::flush_all();
+#if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+  get_local_cache().check_epoch();
+#endif
+
   LightReMutexHolder holder(*_states_lock);
 
   PStatTimer timer(_cache_update_pcollector);
-  int orig_size = _states.get_num_entries();
+  int orig_size = get_num_states();
 
   // First, we need to copy the entire set of states to a temporary vector,
   // reference-counting each object.  That way we can walk through the copy,
@@ -835,10 +909,14 @@ clear_cache() {
     TempStates temp_states;
     temp_states.reserve(orig_size);
 
-    size_t size = _states.get_num_entries();
-    for (size_t si = 0; si < size; ++si) {
-      const RenderState *state = _states.get_key(si);
-      temp_states.push_back(state);
+    for (size_t shi = 0; shi < num_states_shards; ++shi) {
+      StatesShard &shard = _states_shards[shi];
+      LightReMutexHolder shard_holder(shard._lock);
+      size_t size = shard._states.get_num_entries();
+      for (size_t si = 0; si < size; ++si) {
+        const RenderState *state = shard._states.get_key(si);
+        temp_states.push_back(state);
+      }
     }
 
     // Now it's safe to walk through the list, destroying the cache within
@@ -876,7 +954,7 @@ clear_cache() {
     // the various objects' caches will go away.
   }
 
-  int new_size = _states.get_num_entries();
+  int new_size = get_num_states();
   return orig_size - new_size;
 }
 
@@ -886,6 +964,12 @@ clear_cache() {
  * appropriately.  It does no harm to call it even if this variable is not
  * true, but there is probably no advantage in that case.
  *
+ * Recently created states are checked on every call, since these are the
+ * most likely to have been discarded already.  The remaining states are
+ * visited incrementally, at the rate given by garbage-collect-states-rate.
+ * If garbage-collect-states-budget is set, this stops after that much time
+ * has elapsed, and the next call resumes where this one left off.
+ *
  * This automatically calls RenderAttrib::garbage_collect() as well.
  */
 int RenderState::
@@ -899,76 +983,180 @@ garbage_collect() {
   LightReMutexHolder holder(*_states_lock);
 
   PStatTimer timer(_garbage_collect_pcollector);
-  size_t orig_size = _states.get_num_entries();
-
-  // How many elements to process this pass?
-  size_t size = orig_size;
-  size_t num_this_pass = std::max(0, int(size * garbage_collect_states_rate));
-  if (num_this_pass <= 0) {
-    return num_attribs;
-  }
 
   bool break_and_uniquify = (auto_break_cycles && uniquify_transforms);
 
-  size_t si = _garbage_index;
-  if (si >= size) {
-    si = 0;
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double budget = garbage_collect_states_budget;
+  double deadline = (budget > 0.0) ? clock->get_short_time() + budget : 0.0;
+  bool out_of_time = false;
+
+  int num_collected = 0;
+  size_t num_young = 0;
+  size_t num_deferred = 0;
+
+  // First, check all of the young states, starting at the shard where we ran
+  // out of time last time, if that happened.  We walk backwards, so that
+  // elements that are removed from the list don't disturb our iteration.
+  int max_young_age = garbage_collect_states_young_age;
+  size_t num_visited = 0;
+  for (size_t sc = 0; sc < num_states_shards; ++sc) {
+    size_t shi = (_garbage_young_shard + sc) % num_states_shards;
+    StatesShard &shard = _states_shards[shi];
+    LightReMutexHolder shard_holder(shard._lock);
+
+    size_t yi = shard._young.size();
+    if (out_of_time) {
+      num_deferred += yi;
+      yi = 0;
+    }
+    while (yi > 0) {
+      --yi;
+      RenderState *state = shard._young[yi]._state;
+      if (collect_state(state, break_and_uniquify)) {
+        // This also removed it from the list of young states.
+        ++num_collected;
+
+      } else if (++shard._young[yi]._age >= max_young_age) {
+        // It has survived long enough to be considered long-lived.
+        state->_young_index = -1;
+        if (yi + 1 < shard._young.size()) {
+          shard._young[yi] = shard._young.back();
+          shard._young[yi]._state->_young_index = (int)yi;
+        }
+        shard._young.pop_back();
+      }
+
+      if (deadline != 0.0 && (++num_visited & 0x3f) == 0 &&
+          clock->get_short_time() >= deadline) {
+        // The rest of the young states will be checked next time.
+        out_of_time = true;
+        _garbage_young_shard = shi;
+        num_deferred += yi;
+        break;
+      }
+    }
+    num_young += shard._young.size();
   }
 
-  num_this_pass = std::min(num_this_pass, size);
-  size_t stop_at_element = (si + num_this_pass) % size;
+  // Now walk through a portion of the rest of the states, resuming at the
+  // shard where we ran out of time last time, if that happened.
+  for (size_t sc = 0; sc < num_states_shards; ++sc) {
+    size_t shi = (_garbage_shard + sc) % num_states_shards;
+    StatesShard &shard = _states_shards[shi];
+    LightReMutexHolder shard_holder(shard._lock);
 
-  do {
-    RenderState *state = (RenderState *)_states.get_key(si);
-    if (break_and_uniquify) {
-      if (state->get_cache_ref_count() > 0 &&
-          state->get_ref_count() == state->get_cache_ref_count()) {
-        // If we have removed all the references to this state not in the
-        // cache, leaving only references in the cache, then we need to
-        // check for a cycle involving this RenderState and break it if it
-        // exists.
-        state->detect_and_break_cycles();
-      }
+    // How many elements to process this pass?
+    size_t size = shard._states.get_num_entries();
+    size_t num_this_pass = std::max(0, int(size * garbage_collect_states_rate));
+    if (num_this_pass <= 0) {
+      continue;
+    }
+    if (out_of_time) {
+      num_deferred += std::min(num_this_pass, size);
+      continue;
     }
 
-    if (!state->unref_if_one()) {
-      // This state has recently been unreffed to 1 (the one we added when
-      // we stored it in the cache).  Now it's time to delete it.  This is
-      // safe, because we're holding the _states_lock, so it's not possible
-      // for some other thread to find the state in the cache and ref it
-      // while we're doing this.  Also, we've just made sure to unref it to 0,
-      // to ensure that another thread can't get it via a weak pointer.
-
-      state->release_new();
-      state->remove_cache_pointers();
-      state->cache_unref_only();
-      delete state;
+    size_t si = shard._garbage_index;
+    if (si >= size) {
+      si = 0;
+    }
 
-      // When we removed it from the hash map, it swapped the last element
-      // with the one we just removed.  So the current index contains one we
-      // still need to visit.
-      --size;
-      --si;
-      if (stop_at_element > 0) {
-        --stop_at_element;
+    num_this_pass = std::min(num_this_pass, size);
+    size_t stop_at_element = (si + num_this_pass) % size;
+    size_t num_left = num_this_pass;
+
+    do {
+      RenderState *state = (RenderState *)shard._states.get_key(si);
+      --num_left;
+
+      // Young states were already checked above.
+      if (state->_young_index == -1 &&
+          collect_state(state, break_and_uniquify)) {
+        ++num_collected;
+
+        // When we removed it from the hash map, it swapped the last element
+        // with the one we just removed.  So the current index contains one
+        // we still need to visit.
+        --size;
+        --si;
+        if (stop_at_element > 0) {
+          --stop_at_element;
+        }
+        if (size == 0) {
+          // Unlike the table as a whole, a shard may become entirely empty.
+          si = 0;
+          break;
+        }
       }
-    }
 
-    si = (si + 1) % size;
-  } while (si != stop_at_element);
-  _garbage_index = si;
+      si = (si + 1) % size;
+
+      if (deadline != 0.0 && (++num_visited & 0x3f) == 0 &&
+          clock->get_short_time() >= deadline) {
+        // We've used up our time for this frame.  Pick up from here next
+        // time.
+        out_of_time = true;
+        _garbage_shard = shi;
+        num_deferred += num_left;
+        break;
+      }
+    } while (si != stop_at_element);
+    shard._garbage_index = si;
 
-  nassertr(_states.get_num_entries() == size, 0);
+    nassertr(shard._states.get_num_entries() == size, 0);
 
 #ifdef _DEBUG
-  nassertr(_states.validate(), 0);
+    nassertr(shard._states.validate(), 0);
 #endif
 
-  // If we just cleaned up a lot of states, see if we can reduce the table in
-  // size.  This will help reduce iteration overhead in the future.
-  _states.consider_shrink_table();
+    // If we just cleaned up a lot of states, see if we can reduce the table
+    // in size.  This will help reduce iteration overhead in the future.
+    shard._states.consider_shrink_table();
+  }
+
+  _collected_counter.set_level(num_collected);
+  _young_counter.set_level(num_young);
+  _deferred_counter.set_level(num_deferred);
+
+  return num_collected + num_attribs;
+}
+
+/**
+ * Checks whether the indicated state, which must be stored in the cache, is
+ * referenced only by the cache, and if so, removes and deletes it.  Returns
+ * true if the state was deleted, false if it is still in use.
+ *
+ * You must already be holding _states_lock as well as the lock of the shard
+ * this state belongs to before you call this method.
+ */
+bool RenderState::
+collect_state(RenderState *state, bool break_cycles) {
+  if (break_cycles) {
+    if (state->get_cache_ref_count() > 0 &&
+        state->get_ref_count() == state->get_cache_ref_count()) {
+      // If we have removed all the references to this state not in the
+      // cache, leaving only references in the cache, then we need to check
+      // for a cycle involving this RenderState and break it if it exists.
+      state->detect_and_break_cycles();
+    }
+  }
+
+  if (state->unref_if_one()) {
+    return false;
+  }
 
-  return (int)orig_size - (int)size + num_attribs;
+  // This state has recently been unreffed to 1 (the one we added when we
+  // stored it in the cache).  Now it's time to delete it.  This is safe,
+  // because we're holding the lock on its shard, so it's not possible for
+  // some other thread to find the state in the cache and ref it while we're
+  // doing this.  Also, we've just made sure to unref it to 0, to ensure that
+  // another thread can't get it via a weak pointer.
+  state->release_new();
+  state->remove_cache_pointers();
+  state->cache_unref_only();
+  delete state;
+  return true;
 }
 
 /**
@@ -979,12 +1167,16 @@ void RenderState::
 clear_munger_cache() {
   LightReMutexHolder holder(*_states_lock);
 
-  size_t size = _states.get_num_entries();
-  for (size_t si = 0; si < size; ++si) {
-    RenderState *state = (RenderState *)(_states.get_key(si));
-    state->_mungers.clear();
-    state->_munged_states.clear();
-    state->_last_mi = -1;
+  for (size_t shi = 0; shi < num_states_shards; ++shi) {
+    StatesShard &shard = _states_shards[shi];
+    LightReMutexHolder shard_holder(shard._lock);
+    size_t size = shard._states.get_num_entries();
+    for (size_t si = 0; si < size; ++si) {
+      RenderState *state = (RenderState *)(shard._states.get_key(si));
+      state->_mungers.clear();
+      state->_munged_states.clear();
+      state->_last_mi = -1;
+    }
   }
 }
 
@@ -1009,60 +1201,64 @@ list_cycles(ostream &out) {
   VisitedStates visited;
   CompositionCycleDesc cycle_desc;
 
-  size_t size = _states.get_num_entries();
-  for (size_t si = 0; si < size; ++si) {
-    const RenderState *state = _states.get_key(si);
-
-    bool inserted = visited.insert(state).second;
-    if (inserted) {
-      ++_last_cycle_detect;
-      if (r_detect_cycles(state, state, 1, _last_cycle_detect, &cycle_desc)) {
-        // This state begins a cycle.
-        CompositionCycleDesc::reverse_iterator csi;
-
-        out << "\nCycle detected of length " << cycle_desc.size() + 1 << ":\n"
-            << "state " << (void *)state << ":" << state->get_ref_count()
-            << " =\n";
-        state->write(out, 2);
-        for (csi = cycle_desc.rbegin(); csi != cycle_desc.rend(); ++csi) {
-          const CompositionCycleDescEntry &entry = (*csi);
-          if (entry._inverted) {
-            out << "invert composed with ";
-          } else {
-            out << "composed with ";
-          }
-          out << (const void *)entry._obj << ":" << entry._obj->get_ref_count()
-              << " " << *entry._obj << "\n"
-              << "produces " << (const void *)entry._result << ":"
-              << entry._result->get_ref_count() << " =\n";
-          entry._result->write(out, 2);
-          visited.insert(entry._result);
-        }
+  for (size_t shi = 0; shi < num_states_shards; ++shi) {
+    StatesShard &shard = _states_shards[shi];
+    LightReMutexHolder shard_holder(shard._lock);
+    size_t size = shard._states.get_num_entries();
+    for (size_t si = 0; si < size; ++si) {
+      const RenderState *state = shard._states.get_key(si);
 
-        cycle_desc.clear();
-      } else {
+      bool inserted = visited.insert(state).second;
+      if (inserted) {
         ++_last_cycle_detect;
-        if (r_detect_reverse_cycles(state, state, 1, _last_cycle_detect, &cycle_desc)) {
+        if (r_detect_cycles(state, state, 1, _last_cycle_detect, &cycle_desc)) {
           // This state begins a cycle.
-          CompositionCycleDesc::iterator csi;
+          CompositionCycleDesc::reverse_iterator csi;
 
-          out << "\nReverse cycle detected of length " << cycle_desc.size() + 1 << ":\n"
-              << "state ";
-          for (csi = cycle_desc.begin(); csi != cycle_desc.end(); ++csi) {
+          out << "\nCycle detected of length " << cycle_desc.size() + 1 << ":\n"
+              << "state " << (void *)state << ":" << state->get_ref_count()
+              << " =\n";
+          state->write(out, 2);
+          for (csi = cycle_desc.rbegin(); csi != cycle_desc.rend(); ++csi) {
             const CompositionCycleDescEntry &entry = (*csi);
-            out << (const void *)entry._result << ":"
+            if (entry._inverted) {
+              out << "invert composed with ";
+            } else {
+              out << "composed with ";
+            }
+            out << (const void *)entry._obj << ":" << entry._obj->get_ref_count()
+                << " " << *entry._obj << "\n"
+                << "produces " << (const void *)entry._result << ":"
                 << entry._result->get_ref_count() << " =\n";
             entry._result->write(out, 2);
-            out << (const void *)entry._obj << ":"
-                << entry._obj->get_ref_count() << " =\n";
-            entry._obj->write(out, 2);
             visited.insert(entry._result);
           }
-          out << (void *)state << ":"
-              << state->get_ref_count() << " =\n";
-          state->write(out, 2);
 
           cycle_desc.clear();
+        } else {
+          ++_last_cycle_detect;
+          if (r_detect_reverse_cycles(state, state, 1, _last_cycle_detect, &cycle_desc)) {
+            // This state begins a cycle.
+            CompositionCycleDesc::iterator csi;
+
+            out << "\nReverse cycle detected of length " << cycle_desc.size() + 1 << ":\n"
+                << "state ";
+            for (csi = cycle_desc.begin(); csi != cycle_desc.end(); ++csi) {
+              const CompositionCycleDescEntry &entry = (*csi);
+              out << (const void *)entry._result << ":"
+                  << entry._result->get_ref_count() << " =\n";
+              entry._result->write(out, 2);
+              out << (const void *)entry._obj << ":"
+                  << entry._obj->get_ref_count() << " =\n";
+              entry._obj->write(out, 2);
+              visited.insert(entry._result);
+            }
+            out << (void *)state << ":"
+                << state->get_ref_count() << " =\n";
+            state->write(out, 2);
+
+            cycle_desc.clear();
+          }
         }
       }
     }
@@ -1079,11 +1275,15 @@ void RenderState::
 list_states(ostream &out) {
   LightReMutexHolder holder(*_states_lock);
 
-  size_t size = _states.get_num_entries();
-  out << size << " states:\n";
-  for (size_t si = 0; si < size; ++si) {
-    const RenderState *state = _states.get_key(si);
-    state->write(out, 2);
+  out << get_num_states() << " states:\n";
+  for (size_t shi = 0; shi < num_states_shards; ++shi) {
+    StatesShard &shard = _states_shards[shi];
+    LightReMutexHolder shard_holder(shard._lock);
+    size_t size = shard._states.get_num_entries();
+    for (size_t si = 0; si < size; ++si) {
+      const RenderState *state = shard._states.get_key(si);
+      state->write(out, 2);
+    }
   }
 }
 
@@ -1098,43 +1298,47 @@ validate_states() {
   PStatTimer timer(_state_validate_pcollector);
 
   LightReMutexHolder holder(*_states_lock);
-  if (_states.is_empty()) {
-    return true;
-  }
-
-  if (!_states.validate()) {
-    pgraph_cat.error()
-      << "RenderState::_states cache is invalid!\n";
-    return false;
-  }
+  for (size_t shi = 0; shi < num_states_shards; ++shi) {
+    StatesShard &shard = _states_shards[shi];
+    LightReMutexHolder shard_holder(shard._lock);
+    if (shard._states.is_empty()) {
+      continue;
+    }
 
-  size_t size = _states.get_num_entries();
-  size_t si = 0;
-  nassertr(si < size, false);
-  nassertr(_states.get_key(si)->get_ref_count() >= 0, false);
-  size_t snext = si;
-  ++snext;
-  while (snext < size) {
-    nassertr(_states.get_key(snext)->get_ref_count() >= 0, false);
-    const RenderState *ssi = _states.get_key(si);
-    const RenderState *ssnext = _states.get_key(snext);
-    int c = ssi->compare_to(*ssnext);
-    int ci = ssnext->compare_to(*ssi);
-    if ((ci < 0) != (c > 0) ||
-        (ci > 0) != (c < 0) ||
-        (ci == 0) != (c == 0)) {
+    if (!shard._states.validate()) {
       pgraph_cat.error()
-        << "RenderState::compare_to() not defined properly!\n";
-      pgraph_cat.error(false)
-        << "(a, b): " << c << "\n";
-      pgraph_cat.error(false)
-        << "(b, a): " << ci << "\n";
-      ssi->write(pgraph_cat.error(false), 2);
-      ssnext->write(pgraph_cat.error(false), 2);
+        << "RenderState::_states cache is invalid!\n";
       return false;
     }
-    si = snext;
+
+    size_t size = shard._states.get_num_entries();
+    size_t si = 0;
+    nassertr(si < size, false);
+    nassertr(shard._states.get_key(si)->get_ref_count() >= 0, false);
+    size_t snext = si;
     ++snext;
+    while (snext < size) {
+      nassertr(shard._states.get_key(snext)->get_ref_count() >= 0, false);
+      const RenderState *ssi = shard._states.get_key(si);
+      const RenderState *ssnext = shard._states.get_key(snext);
+      int c = ssi->compare_to(*ssnext);
+      int ci = ssnext->compare_to(*ssi);
+      if ((ci < 0) != (c > 0) ||
+          (ci > 0) != (c < 0) ||
+          (ci == 0) != (c == 0)) {
+        pgraph_cat.error()
+          << "RenderState::compare_to() not defined properly!\n";
+        pgraph_cat.error(false)
+          << "(a, b): " << c << "\n";
+        pgraph_cat.error(false)
+          << "(b, a): " << ci << "\n";
+        ssi->write(pgraph_cat.error(false), 2);
+        ssnext->write(pgraph_cat.error(false), 2);
+        return false;
+      }
+      si = snext;
+      ++snext;
+    }
   }
 
   return true;
@@ -1284,11 +1488,9 @@ return_unique(RenderState *state) {
   }
 #endif
 
-  LightReMutexHolder holder(*_states_lock);
-
   if (state->_saved_entry != -1) {
-    // This state is already in the cache.
-    //nassertr(_states.find(state) == state->_saved_entry, pt_state);
+    // This state is already in the cache.  Since the caller holds a reference
+    // to it, it can't be removed from the cache while we're looking at it.
     return state;
   }
 
@@ -1306,7 +1508,12 @@ return_unique(RenderState *state) {
     }
   }
 
-  int si = _states.find(state);
+  // We only need to lock the shard that the state belongs in; this is
+  // allowed whether or not we are already holding _states_lock.
+  StatesShard &shard = state->get_states_shard();
+  LightReMutexHolder holder(shard._lock);
+
+  int si = shard._states.find(state);
   if (si != -1) {
     // There's an equivalent state already in the set.  Return it.  The state
     // that was passed may be newly created and therefore may not be
@@ -1314,7 +1521,7 @@ return_unique(RenderState *state) {
     if (state->get_ref_count() == 0) {
       delete state;
     }
-    return _states.get_key(si);
+    return shard._states.get_key(si);
   }
 
   // Not already in the set; add it.
@@ -1324,10 +1531,18 @@ return_unique(RenderState *state) {
     // deleted while it's in it.
     state->cache_ref();
   }
-  si = _states.store(state, nullptr);
+  si = shard._states.store(state, nullptr);
 
   // Save the index and return the input state.
   state->_saved_entry = si;
+
+  if (garbage_collect_states) {
+    // Newly created states are the most likely to be discarded soon, so we
+    // keep a separate list of these for the garbage collector to check more
+    // often than the rest.
+    state->_young_index = (int)shard._young.size();
+    shard._young.push_back({state, 0});
+  }
   return state;
 }
 
@@ -1592,15 +1807,31 @@ r_detect_reverse_cycles(const RenderState *start_state,
  * This inverse of return_new, this releases this object from the global
  * RenderState table.
  *
- * You must already be holding _states_lock before you call this method.
+ * You must already be holding _states_lock as well as the lock of the shard
+ * this state belongs to before you call this method.
  */
 void RenderState::
 release_new() {
   nassertv(_states_lock->debug_is_locked());
 
   if (_saved_entry != -1) {
+    StatesShard &shard = get_states_shard();
+    nassertv(shard._lock.debug_is_locked());
     _saved_entry = -1;
-    nassertv_always(_states.remove(this));
+    nassertv_always(shard._states.remove(this));
+
+    if (_young_index != -1) {
+      // Also remove it from the list of young states.
+      StatesShard::YoungStates &young = shard._young;
+      nassertv((size_t)_young_index < young.size() &&
+               young[_young_index]._state == this);
+      if ((size_t)_young_index + 1 < young.size()) {
+        young[_young_index] = young.back();
+        young[_young_index]._state->_young_index = _young_index;
+      }
+      young.pop_back();
+      _young_index = -1;
+    }
   }
 }
 
@@ -1842,6 +2073,7 @@ init_states() {
   // OK because we guarantee that this method is called at static init time,
   // presumably when there is still only one thread in the world.
   _states_lock = new LightReMutex("RenderState::_states_lock");
+  _states_shards = new StatesShard[num_states_shards];
   _cache_stats.init();
   nassertv(Thread::get_current_thread() == Thread::get_main_thread());
 
@@ -1850,10 +2082,30 @@ init_states() {
   RenderState *state = new RenderState;
   state->local_object();
   state->cache_ref_only();
-  state->_saved_entry = _states.store(state, nullptr);
+  state->_saved_entry = state->get_states_shard()._states.store(state, nullptr);
   _empty_state = state;
 }
 
+/**
+ * Returns the calling thread's cache of recently composed states.  This is
+ * only used when compiling with true threads.
+ */
+LocalCompositionCache<RenderState> &RenderState::
+get_local_cache() {
+  static thread_local LocalCompositionCache<RenderState> cache(local_composition_cache_size);
+  return cache;
+}
+
+/**
+ *
+ */
+RenderState::StatesShard::
+StatesShard() :
+  _lock("RenderState::StatesShard"),
+  _garbage_index(0)
+{
+}
+
 /**
  * Tells the BamReader how to create objects of type RenderState.
  */
@@ -32,6 +32,7 @@
 #include "simpleHashMap.h"
 #include "cacheStats.h"
 #include "renderAttribRegistry.h"
+#include "localCompositionCache.h"
 
 class FactoryParams;
 class ShaderAttrib;
@@ -201,8 +202,11 @@ private:
 
   static CPT(RenderState) return_new(RenderState *state);
   static CPT(RenderState) return_unique(RenderState *state);
+  CPT(RenderState) cached_compose(const RenderState *other) const;
+  CPT(RenderState) cached_invert_compose(const RenderState *other) const;
   CPT(RenderState) do_compose(const RenderState *other) const;
   CPT(RenderState) do_invert_compose(const RenderState *other) const;
+  static LocalCompositionCache<RenderState> &get_local_cache();
   void detect_and_break_cycles();
   static bool r_detect_cycles(const RenderState *start_state,
                               const RenderState *current_state,
@@ -215,6 +219,7 @@ private:
 
   void release_new();
   void remove_cache_pointers();
+  static bool collect_state(RenderState *state, bool break_cycles);
 
   void determine_bin_index();
   void determine_cull_callback();
@@ -237,19 +242,60 @@ public:
   mutable UpdateSeq _generated_shader_seq;
 
 private:
-  // This mutex protects _states.  It also protects any modification to the
-  // cache, which is encoded in _composition_cache and
-  // _invert_composition_cache.
+  // This mutex protects any modification to the cache, which is encoded in
+  // _composition_cache and _invert_composition_cache.  It must be held
+  // before any of the shard locks below, never after.
   static LightReMutex *_states_lock;
   typedef SimpleHashMap<const RenderState *, std::nullptr_t, indirect_compare_to_hash<const RenderState *> > States;
-  static States _states;
+
+  // The global set of unique RenderStates is divided into a number of
+  // shards, chosen by hash, each protected by its own mutex.  This allows
+  // threads to look up or store unrelated states without contending with
+  // each other.
+  enum { num_states_shards = 16 };
+  class StatesShard {
+  public:
+    StatesShard();
+
+    LightReMutex _lock;
+    States _states;
+
+    // This keeps track of our current position through the garbage
+    // collection cycle.
+    size_t _garbage_index;
+
+    // The states that were stored in this shard recently.  Since most
+    // states are discarded soon after being created, these are checked on
+    // every garbage collection cycle, until they have survived long enough
+    // to be treated like the rest.
+    class YoungState {
+    public:
+      RenderState *_state;
+      int _age;
+    };
+    typedef pvector<YoungState> YoungStates;
+    YoungStates _young;
+  };
+  static StatesShard *_states_shards;
   static const RenderState *_empty_state;
 
-  // This iterator records the entry corresponding to this RenderState object
-  // in the above global set.  We keep the index around so we can remove it
-  // when the RenderState destructs.
+  // The shards at which the next garbage collection cycle should resume its
+  // check of the young states and of the rest of the states, respectively,
+  // if the previous one ran out of time.
+  static size_t _garbage_young_shard;
+  static size_t _garbage_shard;
+
+  INLINE StatesShard &get_states_shard() const;
+
+  // This records the entry corresponding to this RenderState object in its
+  // shard of the above global set.  We keep the index around so we can
+  // remove it when the RenderState destructs.
   int _saved_entry;
 
+  // The index of this object in its shard's list of young states, or -1 if
+  // it is not considered young.
+  int _young_index;
+
   // This data structure manages the job of caching the composition of two
   // RenderStates.  It's complicated because we have to be sure to remove the
   // entry if *either* of the input RenderStates destructs.  To implement
@@ -288,10 +334,6 @@ private:
   UpdateSeq _cycle_detect;
   static UpdateSeq _last_cycle_detect;
 
-  // This keeps track of our current position through the garbage collection
-  // cycle.
-  static size_t _garbage_index;
-
   static PStatCollector _cache_update_pcollector;
   static PStatCollector _garbage_collect_pcollector;
   static PStatCollector _state_compose_pcollector;
@@ -301,6 +343,9 @@ private:
 
   static PStatCollector _node_counter;
   static PStatCollector _cache_counter;
+  static PStatCollector _collected_counter;
+  static PStatCollector _young_counter;
+  static PStatCollector _deferred_counter;
 
 private:
   // This is the actual data within the RenderState: a set of max_slots
@@ -174,22 +174,24 @@ get_states() {
   extern struct Dtool_PyTypedObject Dtool_RenderState;
   LightReMutexHolder holder(*RenderState::_states_lock);
 
-  size_t num_states = RenderState::_states.get_num_entries();
-  PyObject *list = PyList_New(num_states);
-  size_t i = 0;
-
-  size_t size = RenderState::_states.get_num_entries();
-  for (size_t si = 0; si < size; ++si) {
-    const RenderState *state = RenderState::_states.get_key(si);
-    state->ref();
-    PyObject *a =
-      DTool_CreatePyInstanceTyped((void *)state, Dtool_RenderState,
-                                  true, true, state->get_type_index());
-    nassertr(i < num_states, list);
-    PyList_SET_ITEM(list, i, a);
-    ++i;
+  // The shards are locked one at a time, so the number of states may change
+  // while we are walking through them.
+  PyObject *list = PyList_New(0);
+
+  for (size_t shi = 0; shi < RenderState::num_states_shards; ++shi) {
+    RenderState::StatesShard &shard = RenderState::_states_shards[shi];
+    LightReMutexHolder shard_holder(shard._lock);
+    size_t size = shard._states.get_num_entries();
+    for (size_t si = 0; si < size; ++si) {
+      const RenderState *state = shard._states.get_key(si);
+      state->ref();
+      PyObject *a =
+        DTool_CreatePyInstanceTyped((void *)state, Dtool_RenderState,
+                                    true, true, state->get_type_index());
+      PyList_Append(list, a);
+      Py_DECREF(a);
+    }
   }
-  nassertr(i == num_states, list);
   return list;
 }
 
@@ -203,16 +205,20 @@ get_unused_states() {
   LightReMutexHolder holder(*RenderState::_states_lock);
 
   PyObject *list = PyList_New(0);
-  size_t size = RenderState::_states.get_num_entries();
-  for (size_t si = 0; si < size; ++si) {
-    const RenderState *state = RenderState::_states.get_key(si);
-    if (state->get_cache_ref_count() == state->get_ref_count()) {
-      state->ref();
-      PyObject *a =
-        DTool_CreatePyInstanceTyped((void *)state, Dtool_RenderState,
-                                    true, true, state->get_type_index());
-      PyList_Append(list, a);
-      Py_DECREF(a);
+  for (size_t shi = 0; shi < RenderState::num_states_shards; ++shi) {
+    RenderState::StatesShard &shard = RenderState::_states_shards[shi];
+    LightReMutexHolder shard_holder(shard._lock);
+    size_t size = shard._states.get_num_entries();
+    for (size_t si = 0; si < size; ++si) {
+      const RenderState *state = shard._states.get_key(si);
+      if (state->get_cache_ref_count() == state->get_ref_count()) {
+        state->ref();
+        PyObject *a =
+          DTool_CreatePyInstanceTyped((void *)state, Dtool_RenderState,
+                                      true, true, state->get_type_index());
+        PyList_Append(list, a);
+        Py_DECREF(a);
+      }
     }
   }
   return list;
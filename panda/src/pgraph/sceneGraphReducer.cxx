@@ -31,6 +31,8 @@ PStatCollector SceneGraphReducer::_collect_collector("*:Flatten:collect");
 PStatCollector SceneGraphReducer::_make_nonindexed_collector("*:Flatten:make nonindexed");
 PStatCollector SceneGraphReducer::_unify_collector("*:Flatten:unify");
 PStatCollector SceneGraphReducer::_remove_unused_collector("*:Flatten:remove unused vertices");
+PStatCollector SceneGraphReducer::_vertex_cache_collector("*:Flatten:optimize vertex cache");
+PStatCollector SceneGraphReducer::_simplify_collector("*:Flatten:simplify");
 PStatCollector SceneGraphReducer::_premunge_collector("*:Premunge");
 
 /**
@@ -202,6 +204,61 @@ remove_unused_vertices(PandaNode *root) {
   Thread::consider_yield();
 }
 
+/**
+ * Reorders the triangles of all GeomNodes at this level and below to make
+ * better use of the post-transform vertex cache of the graphics hardware,
+ * whose size is given by the config variable vertex-cache-size.  The
+ * vertices in each GeomVertexData are then reordered to match the order in
+ * which they are first used, so that they are also fetched in order.
+ *
+ * This is best called after unify(), since it can only reorder the triangles
+ * within each GeomPrimitive.  Returns the number of GeomNodes modified.
+ */
+int SceneGraphReducer::
+optimize_vertex_cache(PandaNode *root) {
+  nassertr(check_live_flatten(root), 0);
+  PStatTimer timer(_vertex_cache_collector);
+
+  int count = r_optimize_vertex_cache(root, vertex_cache_size, _transformer);
+  _transformer.finish_apply();
+  return count;
+}
+
+/**
+ * Returns the average cache miss ratio (ACMR) of all of the GeomPrimitives at
+ * this level and below: the average number of vertices that need to be
+ * transformed for each triangle drawn, assuming a post-transform vertex cache
+ * of vertex-cache-size vertices.  Lower is better.  This is useful for
+ * measuring the effect of optimize_vertex_cache().
+ */
+double SceneGraphReducer::
+calc_acmr(PandaNode *root) const {
+  double num_misses = 0.0;
+  int num_faces = 0;
+  r_calc_acmr(root, vertex_cache_size, num_misses, num_faces);
+  return (num_faces != 0) ? num_misses / num_faces : 0.0;
+}
+
+/**
+ * Reduces the number of triangles in all GeomNodes at this level and below to
+ * approximately the indicated fraction of the original, by collapsing the
+ * vertices that contribute the least to the shape of each mesh.  This is
+ * intended for generating lower levels of detail; see Geom::simplify_in_place()
+ * for the details.  Any vertices that are no longer used are removed.
+ *
+ * The Geoms are copied as needed, so this does not affect other GeomNodes
+ * that share the same Geoms.  Returns the number of GeomNodes modified.
+ */
+int SceneGraphReducer::
+simplify(PandaNode *root, PN_stdfloat ratio) {
+  nassertr(check_live_flatten(root), 0);
+  PStatTimer timer(_simplify_collector);
+
+  int count = r_simplify(root, ratio, _transformer);
+  _transformer.finish_apply();
+  return count;
+}
+
 /**
  * In a non-release build, returns false if the node is correctly not in a
  * live scene graph.  (Calling flatten on a node that is part of a live scene
@@ -931,6 +988,85 @@ r_register_vertices(PandaNode *node, GeomTransformer &transformer) {
   }
 }
 
+/**
+ * The recursive implementation of optimize_vertex_cache().
+ */
+int SceneGraphReducer::
+r_optimize_vertex_cache(PandaNode *node, int cache_size,
+                        GeomTransformer &transformer) {
+  int count = 0;
+  if (node->is_geom_node()) {
+    GeomNode *geom_node = DCAST(GeomNode, node);
+    if (transformer.optimize_vertex_cache(geom_node, cache_size)) {
+      ++count;
+    }
+  }
+
+  PandaNode::Children children = node->get_children();
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    count += r_optimize_vertex_cache(children.get_child(i), cache_size, transformer);
+  }
+  Thread::consider_yield();
+  return count;
+}
+
+/**
+ * The recursive implementation of calc_acmr().
+ */
+void SceneGraphReducer::
+r_calc_acmr(PandaNode *node, int cache_size,
+            double &num_misses, int &num_faces) const {
+  if (node->is_geom_node()) {
+    GeomNode *geom_node = DCAST(GeomNode, node);
+    int num_geoms = geom_node->get_num_geoms();
+    for (int i = 0; i < num_geoms; ++i) {
+      CPT(Geom) geom = geom_node->get_geom(i);
+      int num_primitives = geom->get_num_primitives();
+      for (int j = 0; j < num_primitives; ++j) {
+        CPT(GeomPrimitive) prim = geom->get_primitive(j);
+        int prim_faces = prim->get_num_faces();
+        num_misses += prim->calc_acmr(cache_size) * prim_faces;
+        num_faces += prim_faces;
+      }
+    }
+  }
+
+  PandaNode::Children children = node->get_children();
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    r_calc_acmr(children.get_child(i), cache_size, num_misses, num_faces);
+  }
+}
+
+/**
+ * The recursive implementation of simplify().
+ */
+int SceneGraphReducer::
+r_simplify(PandaNode *node, PN_stdfloat ratio, GeomTransformer &transformer) {
+  int count = 0;
+  if (node->is_geom_node()) {
+    GeomNode *geom_node = DCAST(GeomNode, node);
+    int num_geoms = geom_node->get_num_geoms();
+    for (int i = 0; i < num_geoms; ++i) {
+      PT(Geom) geom = geom_node->modify_geom(i);
+      geom->simplify_in_place(ratio);
+      transformer.register_vertices(geom, true);
+    }
+    if (num_geoms != 0) {
+      ++count;
+    }
+  }
+
+  PandaNode::Children children = node->get_children();
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    count += r_simplify(children.get_child(i), ratio, transformer);
+  }
+  Thread::consider_yield();
+  return count;
+}
+
 /**
  * The recursive implementation of decompose().
  */
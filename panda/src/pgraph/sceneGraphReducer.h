@@ -137,6 +137,9 @@ PUBLISHED:
   INLINE int make_nonindexed(PandaNode *root, int nonindexed_bits = ~0);
   void unify(PandaNode *root, bool preserve_order);
   void remove_unused_vertices(PandaNode *root);
+  int optimize_vertex_cache(PandaNode *root);
+  double calc_acmr(PandaNode *root) const;
+  int simplify(PandaNode *root, PN_stdfloat ratio);
 
   INLINE void premunge(PandaNode *root, const RenderState *initial_state);
   bool check_live_flatten(PandaNode *node);
@@ -176,6 +179,12 @@ protected:
   int r_make_nonindexed(PandaNode *node, int collect_bits);
   void r_unify(PandaNode *node, int max_indices, bool preserve_order);
   void r_register_vertices(PandaNode *node, GeomTransformer &transformer);
+  int r_optimize_vertex_cache(PandaNode *node, int cache_size,
+                              GeomTransformer &transformer);
+  void r_calc_acmr(PandaNode *node, int cache_size,
+                   double &num_misses, int &num_faces) const;
+  int r_simplify(PandaNode *node, PN_stdfloat ratio,
+                 GeomTransformer &transformer);
   void r_decompose(PandaNode *node);
 
   void r_premunge(PandaNode *node, const RenderState *state);
@@ -193,6 +202,8 @@ private:
   static PStatCollector _make_nonindexed_collector;
   static PStatCollector _unify_collector;
   static PStatCollector _remove_unused_collector;
+  static PStatCollector _vertex_cache_collector;
+  static PStatCollector _simplify_collector;
   static PStatCollector _premunge_collector;
 };
 
@@ -32,6 +32,7 @@
 #include "simpleHashMap.h"
 #include "cacheStats.h"
 #include "extension.h"
+#include "localCompositionCache.h"
 
 class GraphicsStateGuardianBase;
 class FactoryParams;
@@ -252,8 +253,11 @@ private:
   static CPT(TransformState) return_new(TransformState *state);
   static CPT(TransformState) return_unique(TransformState *state);
 
+  CPT(TransformState) cached_compose(const TransformState *other) const;
+  CPT(TransformState) cached_invert_compose(const TransformState *other) const;
   CPT(TransformState) do_compose(const TransformState *other) const;
   CPT(TransformState) do_invert_compose(const TransformState *other) const;
+  static LocalCompositionCache<TransformState> &get_local_cache();
   void detect_and_break_cycles();
   static bool r_detect_cycles(const TransformState *start_state,
                               const TransformState *current_state,
@@ -266,22 +270,62 @@ private:
 
   void release_new();
   void remove_cache_pointers();
+  static bool collect_state(TransformState *state, bool break_cycles);
 
 private:
-  // This mutex protects _states.  It also protects any modification to the
-  // cache, which is encoded in _composition_cache and
-  // _invert_composition_cache.
+  // This mutex protects any modification to the cache, which is encoded in
+  // _composition_cache and _invert_composition_cache.  It must be held before
+  // any of the shard locks below, never after.
   static LightReMutex *_states_lock;
   typedef SimpleHashMap<const TransformState *, std::nullptr_t, indirect_equals_hash<const TransformState *> > States;
-  static States _states;
+
+  // The global set of unique TransformStates is divided into a number of
+  // shards, chosen by hash, each protected by its own mutex.  This allows
+  // threads to look up or store unrelated transforms without contending with
+  // each other.
+  enum { num_states_shards = 16 };
+  class StatesShard {
+  public:
+    StatesShard();
+
+    LightReMutex _lock;
+    States _states;
+
+    // This keeps track of our current position through the garbage
+    // collection cycle.
+    size_t _garbage_index;
+
+    // The transforms that were stored in this shard recently; see the
+    // corresponding comment in RenderState.
+    class YoungState {
+    public:
+      TransformState *_state;
+      int _age;
+    };
+    typedef pvector<YoungState> YoungStates;
+    YoungStates _young;
+  };
+  static StatesShard *_states_shards;
   static CPT(TransformState) _identity_state;
   static CPT(TransformState) _invalid_state;
 
-  // This iterator records the entry corresponding to this TransformState
-  // object in the above global set.  We keep the index around so we can
+  // The shards at which the next garbage collection cycle should resume its
+  // check of the young states and of the rest of the states, respectively,
+  // if the previous one ran out of time.
+  static size_t _garbage_young_shard;
+  static size_t _garbage_shard;
+
+  INLINE StatesShard &get_states_shard() const;
+
+  // This records the entry corresponding to this TransformState object in
+  // its shard of the above global set.  We keep the index around so we can
   // remove it when the TransformState destructs.
   int _saved_entry = -1;
 
+  // The index of this object in its shard's list of young transforms, or -1
+  // if it is not considered young.
+  int _young_index = -1;
+
   // This data structure manages the job of caching the composition of two
   // TransformStates.  It's complicated because we have to be sure to remove
   // the entry if *either* of the input TransformStates destructs.  To
@@ -307,10 +351,6 @@ private:
   UpdateSeq _cycle_detect;
   static UpdateSeq _last_cycle_detect;
 
-  // This keeps track of our current position through the garbage collection
-  // cycle.
-  static size_t _garbage_index;
-
   static bool _uniquify_matrix;
 
   static PStatCollector _cache_update_pcollector;
@@ -325,6 +365,9 @@ private:
 
   static PStatCollector _node_counter;
   static PStatCollector _cache_counter;
+  static PStatCollector _collected_counter;
+  static PStatCollector _young_counter;
+  static PStatCollector _deferred_counter;
 
 private:
   // This is the actual data within the TransformState.
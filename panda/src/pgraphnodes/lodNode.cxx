@@ -60,6 +60,59 @@ make_default_lod(const std::string &name) {
   }
 }
 
+/**
+ * Generates lower levels of detail for the indicated model automatically.  A
+ * new LODNode is inserted above the model, which becomes its highest level of
+ * detail, and num_levels copies of the model are added below it, each with
+ * the number of triangles reduced to the indicated fraction of the previous
+ * level (see NodePath::simplify()).
+ *
+ * The model switches out at the indicated distance from the camera, and each
+ * subsequent level at twice the distance of the previous one.  If distance is
+ * 0, it is chosen as ten times the radius of the model.
+ *
+ * For animated models, this should be applied to the GeomNodes below the
+ * Character, rather than to the Character itself.  Returns the new LODNode.
+ */
+NodePath LODNode::
+generate_lods(NodePath model, int num_levels, PN_stdfloat ratio,
+              PN_stdfloat distance) {
+  nassertr(!model.is_empty(), NodePath::fail());
+  nassertr(num_levels >= 0 && ratio > 0.0f && ratio < 1.0f, NodePath::fail());
+
+  PT(LODNode) lod = make_default_lod(model.get_name());
+  NodePath lod_np;
+  if (model.has_parent()) {
+    lod_np = model.get_parent().attach_new_node(lod, model.get_sort());
+  } else {
+    lod_np = NodePath(lod);
+  }
+  model.reparent_to(lod_np);
+
+  LPoint3 min_point, max_point;
+  if (model.calc_tight_bounds(min_point, max_point, lod_np)) {
+    lod->set_center((min_point + max_point) * 0.5f);
+    if (distance <= 0.0f) {
+      distance = (max_point - min_point).length() * 5.0f;
+    }
+  }
+  if (distance <= 0.0f) {
+    distance = 1.0f;
+  }
+
+  lod->add_switch(distance, 0.0f);
+
+  NodePath level = model;
+  for (int i = 0; i < num_levels; ++i) {
+    level = level.copy_to(lod_np);
+    level.simplify(ratio);
+    lod->add_switch(distance * 2.0f, distance);
+    distance *= 2.0f;
+  }
+
+  return lod_np;
+}
+
 /**
  * Returns a newly-allocated Node that is a shallow copy of this one.  It will
  * be a different Node pointer, but its internal data may or may not be shared
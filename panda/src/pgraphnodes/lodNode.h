@@ -17,6 +17,7 @@
 #include "pandabase.h"
 #include "config_pgraphnodes.h"
 #include "pandaNode.h"
+#include "nodePath.h"
 #include "luse.h"
 #include "memoryBase.h"
 #include "pvector.h"
@@ -31,6 +32,9 @@ PUBLISHED:
   INLINE explicit LODNode(const std::string &name);
 
   static PT(LODNode) make_default_lod(const std::string &name);
+  static NodePath generate_lods(NodePath model, int num_levels,
+                                PN_stdfloat ratio = 0.5,
+                                PN_stdfloat distance = 0.0);
 
 protected:
   INLINE LODNode(const LODNode &copy);
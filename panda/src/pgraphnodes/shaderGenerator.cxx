@@ -612,25 +612,29 @@ rehash_generated_shaders() {
 
   // With uniquify-states turned on, we can actually go through all the states
   // and check whether their generated shader is still OK.
-  size_t size = RenderState::_states.get_num_entries();
-  for (size_t si = 0; si < size; ++si) {
-    const RenderState *state = RenderState::_states.get_key(si);
-
-    if (state->_generated_shader != nullptr) {
-      ShaderKey key;
-      analyze_renderstate(key, state);
-
-      GeneratedShaders::const_iterator si;
-      si = _generated_shaders.find(key);
-      if (si != _generated_shaders.end()) {
-        if (si->second != state->_generated_shader) {
-          state->_generated_shader = si->second;
+  for (size_t shi = 0; shi < RenderState::num_states_shards; ++shi) {
+    RenderState::StatesShard &shard = RenderState::_states_shards[shi];
+    LightReMutexHolder shard_holder(shard._lock);
+    size_t size = shard._states.get_num_entries();
+    for (size_t si = 0; si < size; ++si) {
+      const RenderState *state = shard._states.get_key(si);
+
+      if (state->_generated_shader != nullptr) {
+        ShaderKey key;
+        analyze_renderstate(key, state);
+
+        GeneratedShaders::const_iterator si;
+        si = _generated_shaders.find(key);
+        if (si != _generated_shaders.end()) {
+          if (si->second != state->_generated_shader) {
+            state->_generated_shader = si->second;
+            state->_munged_states.clear();
+          }
+        } else {
+          // We have not yet generated a shader for this modified state.
+          state->_generated_shader.clear();
           state->_munged_states.clear();
         }
-      } else {
-        // We have not yet generated a shader for this modified state.
-        state->_generated_shader.clear();
-        state->_munged_states.clear();
       }
     }
   }
@@ -653,10 +657,14 @@ void ShaderGenerator::
 clear_generated_shaders() {
   LightReMutexHolder holder(*RenderState::_states_lock);
 
-  size_t size = RenderState::_states.get_num_entries();
-  for (size_t si = 0; si < size; ++si) {
-    const RenderState *state = RenderState::_states.get_key(si);
-    state->_generated_shader.clear();
+  for (size_t shi = 0; shi < RenderState::num_states_shards; ++shi) {
+    RenderState::StatesShard &shard = RenderState::_states_shards[shi];
+    LightReMutexHolder shard_holder(shard._lock);
+    size_t size = shard._states.get_num_entries();
+    for (size_t si = 0; si < size; ++si) {
+      const RenderState *state = shard._states.get_key(si);
+      state->_generated_shader.clear();
+    }
   }
 
   _generated_shaders.clear();
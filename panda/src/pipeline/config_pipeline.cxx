@@ -57,6 +57,14 @@ ConfigVariableInt thread_stack_size
           "created for each newly-created thread.  Not all thread "
           "implementations respect this value."));
 
+ConfigVariableInt worker_threads
+("worker-threads", -1,
+ PRC_DESC("Specifies the number of threads in the global pool of worker "
+          "threads, which is used by some operations (such as parallel "
+          "cull) to split up their work.  The default, -1, creates one "
+          "fewer thread than the number of CPU cores.  Set this to 0 to "
+          "perform all such work on the calling thread."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
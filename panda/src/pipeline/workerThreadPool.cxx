@@ -0,0 +1,201 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file workerThreadPool.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "workerThreadPool.h"
+#include "config_pipeline.h"
+#include "mutexHolder.h"
+
+#include <algorithm>
+#include <thread>
+
+patomic<WorkerThreadPool *> WorkerThreadPool::_global_ptr(nullptr);
+
+/**
+ *
+ */
+WorkerThreadPool::Job::
+~Job() {
+}
+
+/**
+ * Creates a pool with the indicated number of worker threads, which are
+ * started immediately.  If threading is not available, no threads are
+ * created and all work will be performed by the calling thread.
+ */
+WorkerThreadPool::
+WorkerThreadPool(int num_threads) :
+  _lock("WorkerThreadPool"),
+  _shutdown(false),
+  _batch_cvar(_lock),
+  _done_cvar(_lock)
+{
+  if (!Thread::is_true_threads()) {
+    return;
+  }
+
+  _threads.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    std::ostringstream strm;
+    strm << "worker" << i;
+    PT(WorkerThread) thread = new WorkerThread(this, strm.str());
+    if (!thread->start(TP_normal, true)) {
+      break;
+    }
+    _threads.push_back(thread);
+  }
+}
+
+/**
+ * Stops and joins all of the worker threads.  There must not be any calls to
+ * run() in progress.
+ */
+WorkerThreadPool::
+~WorkerThreadPool() {
+  {
+    MutexHolder holder(_lock);
+    nassertv(_batches.empty());
+    _shutdown = true;
+    _batch_cvar.notify_all();
+  }
+
+  for (WorkerThread *thread : _threads) {
+    thread->join();
+  }
+}
+
+/**
+ * Calls job.do_item(n, thread) for each n in the range [0, num_items), using
+ * the worker threads as well as the calling thread.  Does not return until
+ * all of the items have been processed.
+ *
+ * The worker threads observe the same pipeline stage as the calling thread
+ * while they are working on this job.
+ */
+void WorkerThreadPool::
+run(Job &job, size_t num_items, Thread *current_thread) {
+  if (num_items == 0) {
+    return;
+  }
+
+  if (_threads.empty() || num_items == 1) {
+    // Nothing to be gained by involving the other threads.
+    for (size_t n = 0; n < num_items; ++n) {
+      job.do_item(n, current_thread);
+    }
+    return;
+  }
+
+  Batch batch(job, num_items, current_thread->get_pipeline_stage());
+  {
+    MutexHolder holder(_lock);
+    _batches.push_back(&batch);
+    if (num_items - 1 < _threads.size()) {
+      for (size_t i = 0; i < num_items - 1; ++i) {
+        _batch_cvar.notify();
+      }
+    } else {
+      _batch_cvar.notify_all();
+    }
+  }
+
+  // Do as much of the work ourselves as we can.
+  batch.process(current_thread);
+
+  // Now wait for any workers that are still busy with the last items.
+  MutexHolder holder(_lock);
+  remove_batch(&batch);
+  while (batch._num_workers > 0) {
+    _done_cvar.wait();
+  }
+}
+
+/**
+ * Returns a pointer to the global pool, which is created on first use with
+ * the number of threads given by worker-threads.
+ */
+WorkerThreadPool *WorkerThreadPool::
+get_global_ptr() {
+  WorkerThreadPool *pool = _global_ptr.load(std::memory_order_acquire);
+  if (UNLIKELY(pool == nullptr)) {
+    int num_threads = worker_threads;
+    if (num_threads < 0) {
+      // Leave one core for the calling thread.
+      num_threads = std::max((int)std::thread::hardware_concurrency() - 1, 0);
+    }
+    WorkerThreadPool *new_pool = new WorkerThreadPool(num_threads);
+    if (_global_ptr.compare_exchange_strong(pool, new_pool)) {
+      pool = new_pool;
+    } else {
+      // Someone else beat us to it.
+      delete new_pool;
+    }
+  }
+  return pool;
+}
+
+/**
+ * Removes the indicated batch from the queue, if it is still there, so that
+ * no more worker threads will pick it up.  Assumes the lock is held.
+ */
+void WorkerThreadPool::
+remove_batch(Batch *batch) {
+  Batches::iterator bi = std::find(_batches.begin(), _batches.end(), batch);
+  if (bi != _batches.end()) {
+    _batches.erase(bi);
+  }
+}
+
+/**
+ *
+ */
+WorkerThreadPool::WorkerThread::
+WorkerThread(WorkerThreadPool *pool, const std::string &name) :
+  Thread(name, name),
+  _pool(pool)
+{
+}
+
+/**
+ * The main processing loop for each worker thread.
+ */
+void WorkerThreadPool::WorkerThread::
+thread_main() {
+  MutexHolder holder(_pool->_lock);
+
+  while (true) {
+    while (_pool->_batches.empty()) {
+      if (_pool->_shutdown) {
+        return;
+      }
+      _pool->_batch_cvar.wait();
+    }
+
+    Batch *batch = _pool->_batches.front();
+    ++batch->_num_workers;
+    _pool->_lock.release();
+
+    if (get_pipeline_stage() != batch->_pipeline_stage) {
+      set_pipeline_stage(batch->_pipeline_stage);
+    }
+    batch->process(this);
+
+    _pool->_lock.acquire();
+
+    // All of the items have been claimed; make sure nobody else picks up
+    // this batch, and let the submitting thread know we're done with it.
+    _pool->remove_batch(batch);
+    if (--batch->_num_workers == 0) {
+      _pool->_done_cvar.notify_all();
+    }
+  }
+}
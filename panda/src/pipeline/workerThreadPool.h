@@ -0,0 +1,124 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file workerThreadPool.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef WORKERTHREADPOOL_H
+#define WORKERTHREADPOOL_H
+
+#include "pandabase.h"
+#include "thread.h"
+#include "pmutex.h"
+#include "conditionVar.h"
+#include "patomic.h"
+#include "pvector.h"
+#include "pdeque.h"
+
+/**
+ * A pool of threads that can be used to split up a piece of work into a
+ * number of independent items, which are processed in parallel.  The thread
+ * that submits the work participates in processing it, and run() does not
+ * return until all of the items have been processed.
+ *
+ * Several threads may submit work to the same pool at the same time; the
+ * worker threads will be shared among them.  Since the submitting thread
+ * always helps out, work is still completed (serially, if necessary) when all
+ * of the worker threads are busy elsewhere.
+ *
+ * The items are processed in no particular order, and the caller is
+ * responsible for ensuring that processing them in parallel is safe.
+ */
+class EXPCL_PANDA_PIPELINE WorkerThreadPool {
+public:
+  class EXPCL_PANDA_PIPELINE Job {
+  public:
+    virtual ~Job();
+    virtual void do_item(size_t n, Thread *current_thread)=0;
+  };
+
+  explicit WorkerThreadPool(int num_threads);
+  WorkerThreadPool(const WorkerThreadPool &copy) = delete;
+  ~WorkerThreadPool();
+
+  INLINE int get_num_threads() const;
+
+  void run(Job &job, size_t num_items,
+           Thread *current_thread = Thread::get_current_thread());
+
+  template<class Callable>
+  INLINE void parallel_for(size_t num_items, Callable func,
+                           Thread *current_thread = Thread::get_current_thread());
+
+  static WorkerThreadPool *get_global_ptr();
+
+private:
+  // This represents a call to run() that is in progress.
+  class Batch {
+  public:
+    INLINE Batch(Job &job, size_t num_items, int pipeline_stage);
+
+    INLINE void process(Thread *current_thread);
+
+    Job &_job;
+    size_t _num_items;
+    int _pipeline_stage;
+    patomic<size_t> _next_item;
+
+    // The number of worker threads currently working on this batch.  This
+    // is protected by the pool's _lock.
+    int _num_workers;
+  };
+
+  void remove_batch(Batch *batch);
+
+  class WorkerThread : public Thread {
+  public:
+    WorkerThread(WorkerThreadPool *pool, const std::string &name);
+
+  protected:
+    virtual void thread_main();
+
+  private:
+    WorkerThreadPool *_pool;
+  };
+  typedef pvector<PT(WorkerThread)> Threads;
+
+  template<class Callable>
+  class CallableJob final : public Job {
+  public:
+    INLINE CallableJob(Callable &func);
+    virtual void do_item(size_t n, Thread *current_thread) override;
+
+  private:
+    Callable &_func;
+  };
+
+  Mutex _lock;
+  typedef pdeque<Batch *> Batches;
+  Batches _batches;
+  bool _shutdown;
+
+  // Signaled when a new batch is added, or when _shutdown is set.
+  ConditionVar _batch_cvar;
+
+  // Signaled when a worker thread stops working on a batch.
+  ConditionVar _done_cvar;
+
+  Threads _threads;
+
+  static patomic<WorkerThreadPool *> _global_ptr;
+
+  friend class WorkerThread;
+};
+
+#include "workerThreadPool.I"
+
+#endif
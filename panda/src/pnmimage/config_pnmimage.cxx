@@ -62,6 +62,21 @@ ConfigVariableDouble pfm_resize_radius
           "always call box_filter() or gaussian_filter() explicitly with "
           "a specific radius."));
 
+ConfigVariableBool pnmimage_parallel_filter
+("pnmimage-parallel-filter", true,
+ PRC_DESC("Set this true to divide the rows of a large image among the "
+          "threads of the worker thread pool when resizing it with "
+          "PNMImage::box_filter_from(), gaussian_filter_from(), "
+          "lanczos_filter_from() or quick_filter_from().  See "
+          "pnmimage-parallel-filter-min-pixels and worker-threads."));
+
+ConfigVariableInt pnmimage_parallel_filter_min_pixels
+("pnmimage-parallel-filter-min-pixels", 65536,
+ PRC_DESC("The minimum number of pixels in the destination image before "
+          "the filtering is divided among threads, when "
+          "pnmimage-parallel-filter is true.  Smaller images are filtered "
+          "on the calling thread only."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
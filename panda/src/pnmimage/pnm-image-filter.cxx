@@ -32,7 +32,10 @@
 #include "pandabase.h"
 #include <math.h>
 #include "cmath.h"
+#include "mathNumbers.h"
 #include "thread.h"
+#include "workerThreadPool.h"
+#include "config_pnmimage.h"
 
 #include "pnmImage.h"
 #include "pfmFile.h"
@@ -328,214 +331,353 @@ gaussian_filter_impl(float scale, float width,
 }
 
 
-// We have a function, defined in pnm-image-filter-core.cxx, that will scale
-// an image in both X and Y directions for a particular channel, by setting up
-// the temporary matrix appropriately and calling the above functions.
+static void
+lanczos_filter_impl(float scale, float width,
+                    WorkType *&filter, float &filter_width,
+                    int &actual_width) {
+  float fscale;
+  if (scale < 1.0) {
+    // If we are compressing the image, we want to expand the range of the
+    // filter function to prevent dropping below the Nyquist rate.  Hence, we
+    // divide by scale (to make fscale larger).
+    fscale = 1.0 / scale;
+  } else {
+    // If we are expanding the image, we want to increase the granularity of
+    // the filter function since we will need to access fractional cel values.
+    // Hence, we multiply by scale (to make fscale larger).
+    fscale = scale;
+  }
 
-// What we really need is a series of such functions, one for each channel,
-// and also one to scale by X first, and one to scale by Y first.  This sounds
-// a lot like a C++ template: we want to compile the same function several
-// times to work on slightly different sorts of things each time.  However,
-// the things we want to vary are the particular member functions of PNMImage
-// that we call (e.g.  Red(), Green(), etc.), and we can't declare a template
-// of member functions, only of types.
+  // The width is the number of lobes of the sinc function to keep, usually 2
+  // or 3.
+  filter_width = max(width, 1.0f);
 
-// It's doable using templates.  It would involve the declaration of lots of
-// silly little functor objects.  This is much more compact and no more
-// difficult to read.
+  // It seems we need a buffer of two extra values in the filter array
+  // to allow room for all calculations (especially including the 1/2
+  // pixel offset).
+  actual_width = (int)cceil((filter_width + 1) * fscale) + 2;
 
-// The function in pnm-image-filter-core.cxx uses macros to access the member
-// functions of PNMImage.  Hence, we only need to redefine those macros with
-// each instance of the function to cause each instance to operate on the
-// correct member.
+  // L(x) = sinc(x) * sinc(x / a) for |x| < a, 0 otherwise.
 
+  // Unlike the others, this filter has negative lobes, so the filtered values
+  // may overshoot the range of the source values slightly.
 
-// These instances scale by X first, then by Y.
+  filter = (WorkType *)PANDA_MALLOC_ARRAY(actual_width * sizeof(WorkType));
 
-#define FUNCTION_NAME filter_red_xy
-#define IMAGETYPE PNMImage
-#define ASIZE get_x_size
-#define BSIZE get_y_size
-#define GETVAL(a, b, channel) get_red(a, b)
-#define SETVAL(a, b, channel, v) set_red(a, b, v)
-#include "pnm-image-filter-core.cxx"
-#undef SETVAL
-#undef GETVAL
-#undef BSIZE
-#undef ASIZE
-#undef IMAGETYPE
-#undef FUNCTION_NAME
+  for (int i = 0; i < actual_width; i++) {
+    float x = i / fscale;
+    if (x == 0.0f) {
+      filter[i] = filter_max;
+    } else if (x >= filter_width) {
+      filter[i] = 0;
+    } else {
+      float px = MathNumbers::pi_f * x;
+      filter[i] = (WorkType)(filter_max * filter_width * csin(px) *
+                             csin(px / filter_width) / (px * px));
+    }
+  }
+}
 
-#define FUNCTION_NAME filter_green_xy
-#define IMAGETYPE PNMImage
-#define ASIZE get_x_size
-#define BSIZE get_y_size
-#define GETVAL(a, b, channel) get_green(a, b)
-#define SETVAL(a, b, channel, v) set_green(a, b, v)
-#include "pnm-image-filter-core.cxx"
-#undef SETVAL
-#undef GETVAL
-#undef BSIZE
-#undef ASIZE
-#undef IMAGETYPE
-#undef FUNCTION_NAME
 
-#define FUNCTION_NAME filter_blue_xy
-#define IMAGETYPE PNMImage
-#define ASIZE get_x_size
-#define BSIZE get_y_size
-#define GETVAL(a, b, channel) get_blue(a, b)
-#define SETVAL(a, b, channel, v) set_blue(a, b, v)
-#include "pnm-image-filter-core.cxx"
-#undef SETVAL
-#undef GETVAL
-#undef BSIZE
-#undef ASIZE
-#undef IMAGETYPE
-#undef FUNCTION_NAME
+// For the PNMImage, all of the channels are filtered together, in rows of
+// floats with the channels interleaved.  Rather than looking up the kernel
+// for each value, as filter_row() does, we compute a table of normalized
+// weights once for each axis.  Since every destination value then has the
+// same number of weights, and the second axis is filtered by adding together
+// whole rows of the intermediate image, the inner loops are simple enough
+// for the compiler to vectorize them.  The rows are independent of each
+// other, so they may be divided among the threads of the WorkerThreadPool.
+
+// A FilterWeights table holds, for each value along the destination axis, the
+// index of the first source value that contributes to it, followed by
+// _num_taps weights (some of which may be zero) for that and the following
+// source values.
+class FilterWeights {
+public:
+  void compute(int dest_len, int source_len,
+               float width, FilterFunction *make_filter);
+
+  INLINE const float *get_weights(int dest_x) const {
+    return &_weights[(size_t)dest_x * _num_taps];
+  }
 
-#define FUNCTION_NAME filter_gray_xy
-#define IMAGETYPE PNMImage
-#define ASIZE get_x_size
-#define BSIZE get_y_size
-#define GETVAL(a, b, channel) get_bright(a, b)
-#define SETVAL(a, b, channel, v) set_xel(a, b, v)
-#include "pnm-image-filter-core.cxx"
-#undef SETVAL
-#undef GETVAL
-#undef BSIZE
-#undef ASIZE
-#undef IMAGETYPE
-#undef FUNCTION_NAME
+  int _num_taps;
+  pvector<int> _first;
+  pvector<float> _weights;
+};
 
-#define FUNCTION_NAME filter_alpha_xy
-#define IMAGETYPE PNMImage
-#define ASIZE get_x_size
-#define BSIZE get_y_size
-#define GETVAL(a, b, channel) get_alpha(a, b)
-#define SETVAL(a, b, channel, v) set_alpha(a, b, v)
-#include "pnm-image-filter-core.cxx"
-#undef SETVAL
-#undef GETVAL
-#undef BSIZE
-#undef ASIZE
-#undef IMAGETYPE
-#undef FUNCTION_NAME
+// Computes the weights by sampling the kernel exactly as filter_row() does.
+void FilterWeights::
+compute(int dest_len, int source_len, float width, FilterFunction *make_filter) {
+  float scale = (float)dest_len / (float)source_len;
 
+  WorkType *filter;
+  float filter_width;
+  int actual_width;
+  make_filter(scale, width, filter, filter_width, actual_width);
 
-// These instances scale by Y first, then by X.
+  float iscale;
+  if (scale < 1.0f) {
+    iscale = 1.0f;
+    filter_width /= scale;
+  } else {
+    iscale = scale;
+  }
 
-#define FUNCTION_NAME filter_red_yx
-#define IMAGETYPE PNMImage
-#define ASIZE get_y_size
-#define BSIZE get_x_size
-#define GETVAL(a, b, channel) get_red(b, a)
-#define SETVAL(a, b, channel, v) set_red(b, a, v)
-#include "pnm-image-filter-core.cxx"
-#undef SETVAL
-#undef GETVAL
-#undef BSIZE
-#undef ASIZE
-#undef IMAGETYPE
-#undef FUNCTION_NAME
+  // First, find the range of source values for each destination value, so we
+  // know how many weights to store for each.
+  pvector<int> lefts(dest_len), rights(dest_len);
+  _num_taps = 1;
+  for (int dest_x = 0; dest_x < dest_len; dest_x++) {
+    float center = (dest_x + 0.5f) / scale - 0.5f;
+    lefts[dest_x] = max((int)cfloor(center - filter_width), 0);
+    rights[dest_x] = min((int)cceil(center + filter_width), source_len - 1);
+    _num_taps = max(_num_taps, rights[dest_x] - lefts[dest_x] + 1);
+  }
+  nassertv(_num_taps <= source_len);
 
-#define FUNCTION_NAME filter_green_yx
-#define IMAGETYPE PNMImage
-#define ASIZE get_y_size
-#define BSIZE get_x_size
-#define GETVAL(a, b, channel) get_green(b, a)
-#define SETVAL(a, b, channel, v) set_green(b, a, v)
-#include "pnm-image-filter-core.cxx"
-#undef SETVAL
-#undef GETVAL
-#undef BSIZE
-#undef ASIZE
-#undef IMAGETYPE
-#undef FUNCTION_NAME
+  _first.resize(dest_len);
+  _weights.assign((size_t)dest_len * _num_taps, 0.0f);
 
-#define FUNCTION_NAME filter_blue_yx
-#define IMAGETYPE PNMImage
-#define ASIZE get_y_size
-#define BSIZE get_x_size
-#define GETVAL(a, b, channel) get_blue(b, a)
-#define SETVAL(a, b, channel, v) set_blue(b, a, v)
-#include "pnm-image-filter-core.cxx"
-#undef SETVAL
-#undef GETVAL
-#undef BSIZE
-#undef ASIZE
-#undef IMAGETYPE
-#undef FUNCTION_NAME
+  for (int dest_x = 0; dest_x < dest_len; dest_x++) {
+    float center = (dest_x + 0.5f) / scale - 0.5f;
+    int left = lefts[dest_x];
+    int right = rights[dest_x];
+    int right_center = (int)cceil(center);
 
-#define FUNCTION_NAME filter_gray_yx
-#define IMAGETYPE PNMImage
-#define ASIZE get_y_size
-#define BSIZE get_x_size
-#define GETVAL(a, b, channel) get_bright(b, a)
-#define SETVAL(a, b, channel, v) set_xel(b, a, v)
-#include "pnm-image-filter-core.cxx"
-#undef SETVAL
-#undef GETVAL
-#undef BSIZE
-#undef ASIZE
-#undef IMAGETYPE
-#undef FUNCTION_NAME
+    // Near the right edge, we start the window early, so that we never read
+    // past the end of the source row.
+    int first = min(left, source_len - _num_taps);
+    _first[dest_x] = first;
+    float *weights = &_weights[(size_t)dest_x * _num_taps] + (left - first);
 
-#define FUNCTION_NAME filter_alpha_yx
-#define IMAGETYPE PNMImage
-#define ASIZE get_y_size
-#define BSIZE get_x_size
-#define GETVAL(a, b, channel) get_alpha(b, a)
-#define SETVAL(a, b, channel, v) set_alpha(b, a, v)
-#include "pnm-image-filter-core.cxx"
-#undef SETVAL
-#undef GETVAL
-#undef BSIZE
-#undef ASIZE
-#undef IMAGETYPE
-#undef FUNCTION_NAME
+    WorkType net_weight = 0;
+    for (int source_x = left; source_x <= right; source_x++) {
+      int index;
+      if (source_x < right_center) {
+        index = (int)cfloor(iscale * (center - source_x) + 0.5f);
+      } else {
+        index = (int)cfloor(iscale * (source_x - center) + 0.5f);
+      }
+      nassertd(index >= 0 && index < actual_width) continue;
+      weights[source_x - left] = filter[index];
+      net_weight += filter[index];
+    }
 
+    if (net_weight > 0) {
+      for (int source_x = left; source_x <= right; source_x++) {
+        weights[source_x - left] /= net_weight;
+      }
+    } else {
+      for (int source_x = left; source_x <= right; source_x++) {
+        weights[source_x - left] = 0.0f;
+      }
+    }
+  }
 
-// filter_image pulls everything together, and filters one image into another.
-// Both images can be the same with no ill effects.
-static void
-filter_image(PNMImage &dest, const PNMImage &source,
-             float width, FilterFunction *make_filter) {
+  PANDA_FREE_ARRAY(filter);
+}
 
-  // We want to scale by the smallest destination axis first, for a slight
-  // performance gain.
+// Filters a row of pixels of num_channels interleaved floats along its
+// length.
+template<int num_channels>
+static void
+filter_pixel_row(float *dest, int dest_len, const float *source,
+                 const FilterWeights &weights) {
+  int num_taps = weights._num_taps;
+  for (int dest_x = 0; dest_x < dest_len; dest_x++) {
+    const float *w = weights.get_weights(dest_x);
+    const float *s = source + (size_t)weights._first[dest_x] * num_channels;
 
-  // In the PNMImage case (unlike the PfmFile case), the channel parameter is
-  // not used.  We *could* use it to avoid the replication of quite so many
-  // functions, but we replicate them anyway, for another tiny performance
-  // gain.
+    float net_value[num_channels] = {0.0f};
+    for (int i = 0; i < num_taps; ++i) {
+      for (int c = 0; c < num_channels; ++c) {
+        net_value[c] += w[i] * s[c];
+      }
+      s += num_channels;
+    }
 
-  if (dest.get_x_size() <= dest.get_y_size()) {
-    if (dest.is_grayscale() || source.is_grayscale()) {
-      filter_gray_xy(dest, source, width, make_filter, 0);
-    } else {
-      filter_red_xy(dest, source, width, make_filter, 0);
-      filter_green_xy(dest, source, width, make_filter, 0);
-      filter_blue_xy(dest, source, width, make_filter, 0);
+    for (int c = 0; c < num_channels; ++c) {
+      dest[c] = net_value[c];
     }
+    dest += num_channels;
+  }
+}
+
+static void
+filter_pixel_row(float *dest, int dest_len, const float *source,
+                 int num_channels, const FilterWeights &weights) {
+  switch (num_channels) {
+  case 1:
+    filter_pixel_row<1>(dest, dest_len, source, weights);
+    break;
+  case 2:
+    filter_pixel_row<2>(dest, dest_len, source, weights);
+    break;
+  case 3:
+    filter_pixel_row<3>(dest, dest_len, source, weights);
+    break;
+  case 4:
+    filter_pixel_row<4>(dest, dest_len, source, weights);
+    break;
+  default:
+    nassertv(false);
+  }
+}
 
-    if (dest.has_alpha() && source.has_alpha()) {
-      filter_alpha_xy(dest, source, width, make_filter, 0);
+// Computes the indicated row of the destination image by filtering the rows
+// of the source image across one another.  Each row contains row_len floats.
+static void
+filter_pixel_column(float *dest, int dest_y, const float *source,
+                    size_t row_len, const FilterWeights &weights) {
+  const float *w = weights.get_weights(dest_y);
+  const float *s = source + (size_t)weights._first[dest_y] * row_len;
+
+  std::fill(dest, dest + row_len, 0.0f);
+  for (int i = 0; i < weights._num_taps; ++i) {
+    float weight = w[i];
+    if (weight != 0.0f) {
+      for (size_t j = 0; j < row_len; ++j) {
+        dest[j] += weight * s[j];
+      }
     }
+    s += row_len;
+  }
+}
 
+// Calls func(y) for each row from 0 to num_rows, dividing the rows among the
+// threads of the indicated pool, or on the current thread if it is NULL.
+template<class Callable>
+static void
+for_each_row(WorkerThreadPool *pool, int num_rows, Callable func) {
+  if (pool != nullptr) {
+    pool->parallel_for(num_rows, [&](size_t y, Thread *current_thread) {
+      func((int)y);
+    });
   } else {
-    if (dest.is_grayscale() || source.is_grayscale()) {
-      filter_gray_yx(dest, source, width, make_filter, 0);
-    } else {
-      filter_red_yx(dest, source, width, make_filter, 0);
-      filter_green_yx(dest, source, width, make_filter, 0);
-      filter_blue_yx(dest, source, width, make_filter, 0);
+    for (int y = 0; y < num_rows; ++y) {
+      func(y);
+      Thread::consider_yield();
     }
+  }
+}
+
+// Returns the WorkerThreadPool that should be used to filter an image with
+// the indicated number of pixels, or NULL if it should be filtered on the
+// current thread.
+static WorkerThreadPool *
+get_filter_pool(int x_size, int y_size) {
+  if (!pnmimage_parallel_filter ||
+      (size_t)x_size * (size_t)y_size < (size_t)pnmimage_parallel_filter_min_pixels) {
+    return nullptr;
+  }
+  WorkerThreadPool *pool = WorkerThreadPool::get_global_ptr();
+  if (pool->get_num_threads() == 0) {
+    return nullptr;
+  }
+  return pool;
+}
 
-    if (dest.has_alpha() && source.has_alpha()) {
-      filter_alpha_yx(dest, source, width, make_filter, 0);
+// filter_image pulls everything together, and filters one image into another.
+// Both images can be the same with no ill effects.
+static void
+filter_image(PNMImage &dest, const PNMImage &source,
+             float width, FilterFunction *make_filter) {
+  if (!dest.is_valid() || !source.is_valid()) {
+    return;
+  }
+
+  // If either image is grayscale, we filter only the brightness.
+  bool is_gray = dest.is_grayscale() || source.is_grayscale();
+  bool has_alpha = dest.has_alpha() && source.has_alpha();
+  int num_channels = (is_gray ? 1 : 3) + (has_alpha ? 1 : 0);
+
+  int source_x_size = source.get_x_size();
+  int source_y_size = source.get_y_size();
+  int dest_x_size = dest.get_x_size();
+  int dest_y_size = dest.get_y_size();
+
+  WorkerThreadPool *pool = get_filter_pool(dest_x_size, dest_y_size);
+
+  FilterWeights x_weights, y_weights;
+  x_weights.compute(dest_x_size, source_x_size, width, make_filter);
+  y_weights.compute(dest_y_size, source_y_size, width, make_filter);
+
+  // First, copy the source image into rows of floats.  We read the whole
+  // image before writing any of it, which is what makes it safe for dest and
+  // source to be the same image.
+  size_t source_row_len = (size_t)source_x_size * num_channels;
+  pvector<float> source_data(source_row_len * source_y_size);
+  for_each_row(pool, source_y_size, [&](int y) {
+    float *p = &source_data[source_row_len * y];
+    for (int x = 0; x < source_x_size; ++x) {
+      if (is_gray) {
+        *p++ = source.get_bright(x, y);
+      } else {
+        LRGBColorf color = source.get_xel(x, y);
+        *p++ = color[0];
+        *p++ = color[1];
+        *p++ = color[2];
+      }
+      if (has_alpha) {
+        *p++ = source.get_alpha(x, y);
+      }
     }
+  });
+
+  // We filter the axis that does less work first.  The second pass costs the
+  // same either way, so the order is decided by the first pass.
+  size_t dest_row_len = (size_t)dest_x_size * num_channels;
+  pvector<float> dest_data(dest_row_len * dest_y_size);
+
+  size_t cost_x_first = (size_t)source_y_size * dest_x_size * x_weights._num_taps;
+  size_t cost_y_first = (size_t)dest_y_size * source_x_size * y_weights._num_taps;
+  if (cost_x_first <= cost_y_first) {
+    pvector<float> temp_data(dest_row_len * source_y_size);
+    for_each_row(pool, source_y_size, [&](int y) {
+      filter_pixel_row(&temp_data[dest_row_len * y], dest_x_size,
+                       &source_data[source_row_len * y],
+                       num_channels, x_weights);
+    });
+    pvector<float>().swap(source_data);
+
+    for_each_row(pool, dest_y_size, [&](int y) {
+      filter_pixel_column(&dest_data[dest_row_len * y], y, &temp_data[0],
+                          dest_row_len, y_weights);
+    });
+
+  } else {
+    pvector<float> temp_data(source_row_len * dest_y_size);
+    for_each_row(pool, dest_y_size, [&](int y) {
+      filter_pixel_column(&temp_data[source_row_len * y], y, &source_data[0],
+                          source_row_len, y_weights);
+    });
+    pvector<float>().swap(source_data);
+
+    for_each_row(pool, dest_y_size, [&](int y) {
+      filter_pixel_row(&dest_data[dest_row_len * y], dest_x_size,
+                       &temp_data[source_row_len * y],
+                       num_channels, x_weights);
+    });
   }
+
+  // Finally, store the result in the destination image.
+  for_each_row(pool, dest_y_size, [&](int y) {
+    const float *p = &dest_data[dest_row_len * y];
+    for (int x = 0; x < dest_x_size; ++x) {
+      if (is_gray) {
+        dest.set_xel(x, y, min(max(*p++, 0.0f), 1.0f));
+      } else {
+        dest.set_xel(x, y, LRGBColorf(min(max(p[0], 0.0f), 1.0f),
+                                      min(max(p[1], 0.0f), 1.0f),
+                                      min(max(p[2], 0.0f), 1.0f)));
+        p += 3;
+      }
+      if (has_alpha) {
+        dest.set_alpha(x, y, min(max(*p++, 0.0f), 1.0f));
+      }
+    }
+  });
 }
 
 /**
@@ -560,7 +702,40 @@ gaussian_filter_from(float width, const PNMImage &copy) {
   filter_image(*this, copy, width, &gaussian_filter_impl);
 }
 
-// Now we do it again, this time for PfmFile.  In this case we also need to
+/**
+ * Makes a resized copy of the indicated image into this one using a Lanczos
+ * filter, which keeps the result sharper than gaussian_filter_from() does.
+ * The width is the number of lobes of the filter; 2 or 3 are the usual
+ * choices.  The image to be copied is squashed and stretched to match the
+ * dimensions of the current image.
+ */
+void PNMImage::
+lanczos_filter_from(float width, const PNMImage &copy) {
+  filter_image(*this, copy, width, &lanczos_filter_impl);
+}
+
+// We have a function, defined in pnm-image-filter-core.cxx, that will scale
+// an image in both X and Y directions for a particular channel, by setting up
+// the temporary matrix appropriately and calling the above functions.
+
+// What we really need is a series of such functions, one for each channel,
+// and also one to scale by X first, and one to scale by Y first.  This sounds
+// a lot like a C++ template: we want to compile the same function several
+// times to work on slightly different sorts of things each time.  However,
+// the things we want to vary are the particular member functions that we
+// call (e.g.  get_channel(), has_point(), etc.), and we can't declare a
+// template of member functions, only of types.
+
+// It's doable using templates.  It would involve the declaration of lots of
+// silly little functor objects.  This is much more compact and no more
+// difficult to read.
+
+// The function in pnm-image-filter-core.cxx uses macros to access the member
+// functions of the image.  Hence, we only need to redefine those macros with
+// each instance of the function to cause each instance to operate on the
+// correct member.
+
+// These instances are for PfmFile.  In this case we also need to
 // support the sparse variants, since PfmFiles can be incomplete.  However, we
 // don't need to have a different function for each channel.
 
@@ -777,36 +952,39 @@ quick_filter_from(const PNMImage &from, int xborder, int yborder) {
   int to_xoff = xborder / 2;
   int to_yoff = yborder / 2;
 
-  float from_x0, from_x1, from_y0, from_y1;
-  int to_x, to_y;
-
   float x_scale = (float)from_xs / (float)to_xs;
   float y_scale = (float)from_ys / (float)to_ys;
 
-  LColorf color;
+  int to_x_begin = max(0, -to_xoff);
+  int to_x_end = min(to_xs, get_x_size()-to_xoff);
+  int to_y_begin = max(0, -to_yoff);
+  int to_y_end = min(to_ys, get_y_size()-to_yoff);
+  if (to_x_begin >= to_x_end || to_y_begin >= to_y_end) {
+    return;
+  }
+
+  // Each row of the result depends only on the source image, so the rows may
+  // be computed in parallel.
+  WorkerThreadPool *pool =
+    get_filter_pool(to_x_end - to_x_begin, to_y_end - to_y_begin);
 
-  from_y0 = max(0, -to_yoff) * y_scale;
-  for (to_y = max(0, -to_yoff);
-       to_y < min(to_ys, get_y_size()-to_yoff);
-       to_y++) {
-    from_y1 = (to_y+1) * y_scale;
+  for_each_row(pool, to_y_end - to_y_begin, [&](int row) {
+    int to_y = to_y_begin + row;
+    float from_y0 = to_y * y_scale;
+    float from_y1 = (to_y+1) * y_scale;
 
-    from_x0 = max(0, -to_xoff) * x_scale;
-    for (to_x = max(0, -to_xoff);
-         to_x < min(to_xs, get_x_size()-to_xoff);
-         to_x++) {
-      from_x1 = (to_x+1) * x_scale;
+    float from_x0 = to_x_begin * x_scale;
+    for (int to_x = to_x_begin; to_x < to_x_end; to_x++) {
+      float from_x1 = (to_x+1) * x_scale;
 
       // Now the box from (from_x0, from_y0) - (from_x1, from_y1) but not
       // including (from_x1, from_y1) maps to the pixel (to_x, to_y).
-      color = box_filter_region(from,
-                                from_x0, from_y0, from_x1, from_y1);
+      LColorf color = box_filter_region(from,
+                                        from_x0, from_y0, from_x1, from_y1);
 
       set_xel_a(to_xoff + to_x, to_yoff + to_y, color);
 
       from_x0 = from_x1;
     }
-    from_y0 = from_y1;
-    Thread::consider_yield();
-  }
+  });
 }
@@ -252,6 +252,7 @@ PUBLISHED:
   BLOCKING void unfiltered_stretch_from(const PNMImage &copy);
   BLOCKING void box_filter_from(float radius, const PNMImage &copy);
   BLOCKING void gaussian_filter_from(float radius, const PNMImage &copy);
+  BLOCKING void lanczos_filter_from(float radius, const PNMImage &copy);
   BLOCKING void quick_filter_from(const PNMImage &copy,
                                   int xborder = 0, int yborder = 0);
 
@@ -25,7 +25,12 @@
 #include "configVariableInt.h"
 #include "configVariableString.h"
 #include "configVariableFilename.h"
+#include "configVariableEnum.h"
 #include "virtualFileSystem.h"
+#include "mutexHolder.h"
+
+#include <memory>
+#include <stdlib.h>
 
 using std::istream;
 using std::ostream;
@@ -34,6 +39,9 @@ using std::string;
 
 BamCache *BamCache::_global_ptr = nullptr;
 
+// The digits used to name the shards of the index.
+static const char index_shard_digits[] = "0123456789abcdef";
+
 /**
  *
  */
@@ -42,7 +50,10 @@ BamCache() :
   _active(true),
   _read_only(false),
   _index(new BamCacheIndex),
-  _index_stale_since(0)
+  _index_stale_since(0),
+  _store_shutdown(false),
+  _store_lock("BamCache::_store_lock"),
+  _store_cvar(_store_lock)
 {
   ConfigVariableFilename model_cache_dir
     ("model-cache-dir", Filename(),
@@ -84,7 +95,31 @@ BamCache() :
 
   ConfigVariableInt model_cache_max_kbytes
     ("model-cache-max-kbytes", 10485760,
-     PRC_DESC("This is the maximum size of the model cache, in kilobytes."));
+     PRC_DESC("This is the maximum size of the model cache, in kilobytes.  "
+              "When the cache grows beyond this, the least-recently-used "
+              "files are removed from it."));
+
+  ConfigVariableEnum<CompressionCodec> model_cache_compression
+    ("model-cache-compression", CC_none,
+     PRC_DESC("Specifies the compression codec used to write new files to "
+              "the model cache.  The default, none, writes them uncompressed; "
+              "zstd is recommended if Panda was built with it, since it "
+              "decompresses much faster than zlib.  Cache files are always "
+              "read back correctly regardless of this setting."));
+
+  ConfigVariableInt model_cache_compression_level
+    ("model-cache-compression-level", 3,
+     PRC_DESC("The compression level used for writing model cache files, "
+              "if model-cache-compression is not none."));
+
+  ConfigVariableBool model_cache_async_store
+    ("model-cache-async-store", true,
+     PRC_DESC("If this is true, new files are compressed and written to the "
+              "model cache by a background thread, so that caching a model "
+              "does not add to the time it takes to load it the first time.  "
+              "Any writes still pending for the global cache are finished "
+              "when the process exits.  This has no effect if Panda was "
+              "built without threads."));
 
   _cache_models = model_cache_models;
   _cache_textures = model_cache_textures;
@@ -93,6 +128,9 @@ BamCache() :
 
   _flush_time = model_cache_flush;
   _max_kbytes = model_cache_max_kbytes;
+  _compression_codec = model_cache_compression;
+  _compression_level = model_cache_compression_level;
+  _async_store = model_cache_async_store;
 
   if (!model_cache_dir.empty()) {
     set_root(model_cache_dir);
@@ -104,6 +142,7 @@ BamCache() :
  */
 BamCache::
 ~BamCache() {
+  stop_store_thread();
   flush_index();
   delete _index;
   _index = nullptr;
@@ -120,8 +159,11 @@ BamCache::
  */
 void BamCache::
 set_root(const Filename &root) {
+  // Any records still waiting to be written belong in the old root.
+  wait_for_stores();
+
   ReMutexHolder holder(_lock);
-  flush_index();
+  do_flush_index();
   _root = root;
 
   // The root filename must be a directory.
@@ -133,6 +175,9 @@ set_root(const Filename &root) {
   delete _index;
   _index = new BamCacheIndex;
   _index_stale_since = 0;
+  for (int si = 0; si < num_index_shards; ++si) {
+    _shards[si] = IndexShard();
+  }
 
   if (!vfs->is_directory(_root)) {
     util_cat.error()
@@ -160,10 +205,12 @@ set_root(const Filename &root) {
  * source file), and then call record->set_data() to record the resulting
  * loaded object; and finally, you should call store() to write the cached
  * record to disk.
+ *
+ * The cache file itself is read without holding the lock on the index, so
+ * that several threads may look up different files at the same time.
  */
 PT(BamCacheRecord) BamCache::
 lookup(const Filename &source_filename, const string &cache_extension) {
-  ReMutexHolder holder(_lock);
   consider_flush_index();
 
   VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
@@ -172,7 +219,7 @@ lookup(const Filename &source_filename, const string &cache_extension) {
   source_pathname.make_absolute(vfs->get_cwd());
 
   Filename rel_pathname(source_pathname);
-  rel_pathname.make_relative_to(_root, false);
+  rel_pathname.make_relative_to(get_root(), false);
   if (rel_pathname.is_local()) {
     // If the source pathname is already within the cache directory, don't
     // cache it further.
@@ -182,6 +229,10 @@ lookup(const Filename &source_filename, const string &cache_extension) {
   Filename cache_filename = hash_filename(source_pathname.get_fullpath());
   cache_filename.set_extension(cache_extension);
 
+  // If the store thread hasn't finished writing this file yet, wait for it,
+  // so we don't go and declare a new record for it.
+  wait_for_store(source_pathname);
+
   return find_and_read_record(source_pathname, cache_filename);
 }
 
@@ -189,120 +240,81 @@ lookup(const Filename &source_filename, const string &cache_extension) {
  * Flushes a cache entry to disk.  You must have retrieved the cache record
  * via a prior call to lookup(), and then stored the data via
  * record->set_data().  Returns true on success, false on failure.
+ *
+ * If get_async_store() is true, the object is only serialized by this call;
+ * the cache file is written to disk by a background thread some time later.
+ * In this case, a true return value means only that the record has been
+ * queued for writing.
  */
 bool BamCache::
 store(BamCacheRecord *record) {
-  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
-  ReMutexHolder holder(_lock);
   nassertr(!record->_cache_pathname.empty(), false);
   nassertr(record->has_data(), false);
 
-  if (_read_only) {
-    return false;
-  }
+  bool async_store;
+  {
+    ReMutexHolder holder(_lock);
+    if (_read_only) {
+      return false;
+    }
 
-  consider_flush_index();
+    consider_flush_index();
 
 #ifndef NDEBUG
-  // Ensure that the cache_pathname is within the _root directory tree.
-  Filename rel_pathname(record->_cache_pathname);
-  rel_pathname.make_relative_to(_root, false);
-  nassertr(rel_pathname.is_local(), false);
+    // Ensure that the cache_pathname is within the _root directory tree.
+    Filename rel_pathname(record->_cache_pathname);
+    rel_pathname.make_relative_to(_root, false);
+    nassertr(rel_pathname.is_local(), false);
 #endif  // NDEBUG
 
-  record->_recorded_time = time(nullptr);
-
-  Filename cache_pathname = Filename::binary_filename(record->_cache_pathname);
-
-  // We actually do the write to a temporary filename first, and then move it
-  // into place, so that no one attempts to read the file while it is in the
-  // process of being written.
-  Thread *current_thread = Thread::get_current_thread();
-  string extension = current_thread->get_unique_id() + string(".tmp");
-  Filename temp_pathname = cache_pathname;
-  temp_pathname.set_extension(extension);
-  temp_pathname.set_binary();
-
-  DatagramOutputFile dout;
-  if (!dout.open(temp_pathname)) {
-    util_cat.error()
-      << "Could not write cache file: " << temp_pathname << "\n";
-    vfs->delete_file(temp_pathname);
-    emergency_read_only();
-    return false;
+    async_store = _async_store && Thread::is_true_threads();
   }
 
-  if (!dout.write_header(_bam_header)) {
-    util_cat.error()
-      << "Unable to write to " << temp_pathname << "\n";
-    vfs->delete_file(temp_pathname);
-    return false;
-  }
-
-  {
-    BamWriter writer(&dout);
-    if (!writer.init()) {
-      util_cat.error()
-        << "Unable to write Bam header to " << temp_pathname << "\n";
-      vfs->delete_file(temp_pathname);
-      return false;
-    }
-
-    TypeRegistry *type_registry = TypeRegistry::ptr();
-    TypeHandle texture_type = type_registry->find_type("Texture");
-    if (record->get_data()->is_of_type(texture_type)) {
-      // Texture objects write the actual texture image.
-      writer.set_file_texture_mode(BamWriter::BTM_rawdata);
-    } else {
-      // Any other kinds of objects write texture references.
-      writer.set_file_texture_mode(BamWriter::BTM_fullpath);
-    }
+  record->_recorded_time = time(nullptr);
 
-    // This is necessary for relative NodePaths to work.
-    TypeHandle node_type = type_registry->find_type("PandaNode");
-    if (record->get_data()->is_of_type(node_type)) {
-      writer.set_root_node(record->get_data());
-    }
+  Filename cache_pathname = Filename::binary_filename(record->_cache_pathname);
 
-    if (!writer.write_object(record)) {
-      util_cat.error()
-        << "Unable to write object to " << temp_pathname << "\n";
-      vfs->delete_file(temp_pathname);
+  string data;
+  const string *data_ptr = nullptr;
+  if (async_store) {
+    // The object must be serialized now, while the caller waits, since the
+    // caller is free to modify it as soon as we return.  But compressing it
+    // and writing it to disk is left to the store thread.
+    ostringstream strm;
+    if (!do_write_record(strm, cache_pathname, record)) {
       return false;
     }
+    data = strm.str();
 
-    if (!writer.write_object(record->get_data())) {
-      util_cat.error()
-        << "Unable to write object data to " << temp_pathname << "\n";
-      vfs->delete_file(temp_pathname);
-      return false;
+    if (queue_store(record->make_copy(), cache_pathname, data, false)) {
+      return true;
     }
 
-    // Now that we are done with the BamWriter, it's important to let it
-    // destruct now and clean itself up, or it might get mad if we delete any
-    // TypedWritables below that haven't been written yet.
+    // We couldn't start the store thread, so write it out ourselves.
+    data_ptr = &data;
   }
 
-  record->_record_size = dout.get_file_pos();
-  dout.close();
-
-  // Now move the file into place.
-  if (!vfs->rename_file(temp_pathname, cache_pathname) && vfs->exists(temp_pathname)) {
-    vfs->delete_file(cache_pathname);
-    if (!vfs->rename_file(temp_pathname, cache_pathname)) {
-      util_cat.error()
-        << "Unable to rename " << temp_pathname << " to "
-        << cache_pathname << "\n";
-      vfs->delete_file(temp_pathname);
-      return false;
-    }
+  if (!write_cache_file(record, cache_pathname, data_ptr)) {
+    return false;
   }
 
   add_to_index(record);
-
   return true;
 }
 
+/**
+ * Blocks until the store thread has finished writing all of the records that
+ * have been passed to store() so far.  This has no effect if
+ * get_async_store() is false.
+ */
+void BamCache::
+wait_for_stores() {
+  MutexHolder holder(_store_lock);
+  while (!_pending_stores.empty()) {
+    _store_cvar.wait();
+  }
+}
+
 /**
  * Called when an attempt to write to the cache dir has failed, usually for
  * lack of disk space or because of incorrect file permissions.  Outputs an
@@ -312,6 +324,7 @@ void BamCache::
 emergency_read_only() {
   util_cat.error() <<
     "Could not write to the Bam Cache.  Disabling future attempts.\n";
+  ReMutexHolder holder(_lock);
   _read_only = true;
 }
 
@@ -332,7 +345,7 @@ consider_flush_index() {
   if (_index_stale_since != 0) {
     int elapsed = (int)time(nullptr) - (int)_index_stale_since;
     if (elapsed > _flush_time) {
-      flush_index();
+      do_flush_index();
     }
   }
 
@@ -342,33 +355,81 @@ consider_flush_index() {
 }
 
 /**
- * Ensures the index is written to disk.
+ * Ensures the index is written to disk.  Any records still waiting to be
+ * written by the store thread are written first.
  */
 void BamCache::
 flush_index() {
+  wait_for_stores();
+
   ReMutexHolder holder(_lock);
+  do_flush_index();
+}
+
+/**
+ * Writes out each shard of the index that has been modified since it was
+ * last written.  Assumes the lock is held.
+ */
+void BamCache::
+do_flush_index() {
   if (_index_stale_since == 0) {
     // Never mind.
     return;
   }
 
+  for (int si = 0; si < num_index_shards; ++si) {
+    if (_shards[si]._stale && !flush_index_shard(si)) {
+      return;
+    }
+  }
+
+  _index_stale_since = 0;
+}
+
+/**
+ * Writes the records belonging to the indicated shard to a new index file,
+ * and makes it the official one for that shard.  Returns true on success,
+ * false if the cache could not be written.
+ */
+bool BamCache::
+flush_index_shard(int shard) {
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  IndexShard &index_shard = _shards[shard];
+
   while (true) {
     if (_read_only) {
-      return;
+      return false;
     }
 
-    Filename temp_pathname = Filename::temporary(_root, "index-", ".boo");
+    string prefix = string("index-") + index_shard_digits[shard] + "-";
+    Filename temp_pathname = Filename::temporary(_root, prefix, ".boo");
+
+    // Collect just the records that belong to this shard into a temporary
+    // index.  They remain part of our own index, so we have to take them
+    // back out again before it destructs.
+    bool written;
+    {
+      BamCacheIndex shard_index;
+      BamCacheIndex::Records::const_iterator ri;
+      for (ri = _index->_records.begin(); ri != _index->_records.end(); ++ri) {
+        if (get_index_shard((*ri).second->get_cache_filename()) == shard) {
+          shard_index._records.insert(shard_index._records.end(), *ri);
+        }
+      }
+
+      written = do_write_index(temp_pathname, &shard_index);
+      shard_index._records.clear();
+    }
 
-    if (!do_write_index(temp_pathname, _index)) {
+    if (!written) {
       emergency_read_only();
-      return;
+      return false;
     }
 
     // Now atomically write the name of this index file to the index reference
     // file.
-    VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
-    Filename index_ref_pathname(_root, Filename("index_name.txt"));
-    string old_index = _index_ref_contents;
+    Filename index_ref_pathname = get_index_ref_pathname(shard);
+    string old_index = index_shard._index_ref_contents;
     string new_index = temp_pathname.get_basename() + "\n";
     string orig_index;
 
@@ -376,21 +437,25 @@ flush_index() {
       // We successfully wrote our version of the index, and no other process
       // beat us to it.  Our index is now the official one.  Remove the old
       // index.
-      vfs->delete_file(_index_pathname);
-      _index_pathname = temp_pathname;
-      _index_ref_contents = new_index;
-      _index_stale_since = 0;
-      return;
+      vfs->delete_file(index_shard._index_pathname);
+      index_shard._index_pathname = temp_pathname;
+      index_shard._index_ref_contents = new_index;
+      index_shard._stale = false;
+      return true;
     }
 
     // Shoot, some other process updated the index while we were trying to
     // update it, and they beat us to it.  We have to merge, and try again.
     vfs->delete_file(temp_pathname);
-    _index_pathname = Filename(_root, Filename(trim(orig_index)));
-    _index_ref_contents = orig_index;
-    read_index();
+    index_shard._index_pathname = Filename(_root, Filename(trim(orig_index)));
+    index_shard._index_ref_contents = orig_index;
+    read_index_shard(shard);
+
+    if (!index_shard._stale) {
+      // The index was rebuilt and flushed in the meantime.
+      return true;
+    }
   }
-  check_cache_size();
 }
 
 /**
@@ -398,57 +463,77 @@ flush_index() {
  */
 void BamCache::
 list_index(ostream &out, int indent_level) const {
+  ReMutexHolder holder(_lock);
   _index->write(out, indent_level);
 }
 
 /**
- * Reads, or re-reads the index file from disk.  If _index_stale_since is
- * nonzero, the index file is read and then merged with our current index.
+ * Reads, or re-reads the index files from disk.  If a shard of our index is
+ * stale, the corresponding index file is read and then merged with it.
  */
 void BamCache::
 read_index() {
-  if (!read_index_pathname(_index_pathname, _index_ref_contents)) {
-    // Couldn't read the index ref; rebuild the index.
-    rebuild_index();
-    return;
+  for (int si = 0; si < num_index_shards; ++si) {
+    IndexShard &index_shard = _shards[si];
+    if (!read_index_pathname(si, index_shard._index_pathname,
+                             index_shard._index_ref_contents)) {
+      // Couldn't read one of the index refs; rebuild the whole index.
+      rebuild_index();
+      return;
+    }
+  }
+
+  for (int si = 0; si < num_index_shards; ++si) {
+    read_index_shard(si);
   }
+}
+
+/**
+ * Reads, or re-reads the index file for the indicated shard, and merges it
+ * with our current index.
+ */
+void BamCache::
+read_index_shard(int shard) {
+  IndexShard &index_shard = _shards[shard];
 
   while (true) {
-    BamCacheIndex *new_index = do_read_index(_index_pathname);
+    BamCacheIndex *new_index = do_read_index(index_shard._index_pathname);
     if (new_index != nullptr) {
-      merge_index(new_index);
+      merge_index(new_index, shard);
       return;
     }
 
     // We couldn't read the index.  Maybe it's been removed already.  See if
     // the index_pathname has changed.
-    Filename old_index_pathname = _index_pathname;
-    if (!read_index_pathname(_index_pathname, _index_ref_contents)) {
+    Filename old_index_pathname = index_shard._index_pathname;
+    if (!read_index_pathname(shard, index_shard._index_pathname,
+                             index_shard._index_ref_contents)) {
       // Couldn't read the index ref; rebuild the index.
       rebuild_index();
       return;
     }
 
-    if (old_index_pathname == _index_pathname) {
+    if (old_index_pathname == index_shard._index_pathname) {
       // Nope, we just couldn't read it.  Delete it and build a new one.
       VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
-      vfs->delete_file(_index_pathname);
+      vfs->delete_file(index_shard._index_pathname);
       rebuild_index();
-      flush_index();
       return;
     }
   }
 }
 
 /**
- * Atomically reads the current index filename from the index reference file.
- * The index filename moves around as different processes update the index.
+ * Atomically reads the current index filename for the indicated shard from
+ * its index reference file.  The index filename moves around as different
+ * processes update the index.
  */
 bool BamCache::
-read_index_pathname(Filename &index_pathname, string &index_ref_contents) const {
+read_index_pathname(int shard, Filename &index_pathname,
+                    string &index_ref_contents) const {
   VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
   index_ref_contents.clear();
-  Filename index_ref_pathname(_root, Filename("index_name.txt"));
+  Filename index_ref_pathname = get_index_ref_pathname(shard);
   if (!vfs->atomic_read_contents(index_ref_pathname, index_ref_contents)) {
     return false;
   }
@@ -463,100 +548,115 @@ read_index_pathname(Filename &index_pathname, string &index_ref_contents) const
 }
 
 /**
- * The supplied index file has been updated by some other process.  Merge it
- * with our current index.
+ * The supplied index file, which holds the records of the indicated shard,
+ * has been updated by some other process.  Merge it with our current index.
+ * The records in the other shards are not affected.
  *
  * Ownership of the pointer is transferred with this call.  The caller should
  * assume that new_index will be deleted by this method.
  */
 void BamCache::
-merge_index(BamCacheIndex *new_index) {
-  if (_index_stale_since == 0) {
-    // If our index isn't stale, just replace it.
-    delete _index;
-    _index = new_index;
-    return;
+merge_index(BamCacheIndex *new_index, int shard) {
+  _index->release_records();
+  new_index->release_records();
+
+  // Pull the records of this shard out of our index.
+  BamCacheIndex::Records old_records;
+  BamCacheIndex::Records &records = _index->_records;
+  BamCacheIndex::Records::iterator ri = records.begin();
+  while (ri != records.end()) {
+    if (get_index_shard((*ri).second->get_cache_filename()) == shard) {
+      old_records.insert(old_records.end(), *ri);
+      ri = records.erase(ri);
+    } else {
+      ++ri;
+    }
   }
 
-  BamCacheIndex *old_index = _index;
-  old_index->release_records();
-  new_index->release_records();
-  _index = new BamCacheIndex;
+  if (!_shards[shard]._stale) {
+    // If this shard of our index isn't stale, just replace it.
+    records.insert(new_index->_records.begin(), new_index->_records.end());
 
-  BamCacheIndex::Records::const_iterator ai = old_index->_records.begin();
-  BamCacheIndex::Records::const_iterator bi = new_index->_records.begin();
+  } else {
+    BamCacheIndex::Records::const_iterator ai = old_records.begin();
+    BamCacheIndex::Records::const_iterator bi = new_index->_records.begin();
+
+    while (ai != old_records.end() &&
+           bi != new_index->_records.end()) {
+      if ((*ai).first < (*bi).first) {
+        // Here is an entry we have in our index, not present in the new
+        // index.
+        PT(BamCacheRecord) record = (*ai).second;
+        Filename cache_pathname(_root, record->get_cache_filename());
+        if (cache_pathname.exists()) {
+          // The file exists; keep it.
+          records.insert(BamCacheIndex::Records::value_type(record->get_source_pathname(), record));
+        }
+        ++ai;
+
+      } else if ((*bi).first < (*ai).first) {
+        // Here is an entry in the new index, not present in our index.
+        PT(BamCacheRecord) record = (*bi).second;
+        Filename cache_pathname(_root, record->get_cache_filename());
+        if (cache_pathname.exists()) {
+          // The file exists; keep it.
+          records.insert(BamCacheIndex::Records::value_type(record->get_source_pathname(), record));
+        }
+        ++bi;
 
-  while (ai != old_index->_records.end() &&
-         bi != new_index->_records.end()) {
-    if ((*ai).first < (*bi).first) {
+      } else {
+        // Here is an entry we have in both.
+        PT(BamCacheRecord) a_record = (*ai).second;
+        PT(BamCacheRecord) b_record = (*bi).second;
+        if (*a_record == *b_record) {
+          // They're the same entry.  It doesn't really matter which one we
+          // keep.
+          records.insert(BamCacheIndex::Records::value_type(a_record->get_source_pathname(), a_record));
+
+        } else {
+          // They're different.  Just throw them both away, and re-read the
+          // current data from the cache file.
+
+          Filename cache_pathname(_root, a_record->get_cache_filename());
+
+          if (cache_pathname.exists()) {
+            PT(BamCacheRecord) record = do_read_record(cache_pathname, false);
+            if (record != nullptr) {
+              records.insert(BamCacheIndex::Records::value_type(record->get_source_pathname(), record));
+            }
+          }
+        }
+
+        ++ai;
+        ++bi;
+      }
+    }
+
+    while (ai != old_records.end()) {
       // Here is an entry we have in our index, not present in the new index.
       PT(BamCacheRecord) record = (*ai).second;
       Filename cache_pathname(_root, record->get_cache_filename());
       if (cache_pathname.exists()) {
         // The file exists; keep it.
-        _index->_records.insert(_index->_records.end(), BamCacheIndex::Records::value_type(record->get_source_pathname(), record));
+        records.insert(BamCacheIndex::Records::value_type(record->get_source_pathname(), record));
       }
       ++ai;
+    }
 
-    } else if ((*bi).first < (*ai).first) {
+    while (bi != new_index->_records.end()) {
       // Here is an entry in the new index, not present in our index.
       PT(BamCacheRecord) record = (*bi).second;
       Filename cache_pathname(_root, record->get_cache_filename());
       if (cache_pathname.exists()) {
         // The file exists; keep it.
-        _index->_records.insert(_index->_records.end(), BamCacheIndex::Records::value_type(record->get_source_pathname(), record));
+        records.insert(BamCacheIndex::Records::value_type(record->get_source_pathname(), record));
       }
       ++bi;
-
-    } else {
-      // Here is an entry we have in both.
-      PT(BamCacheRecord) a_record = (*ai).second;
-      PT(BamCacheRecord) b_record = (*bi).second;
-      if (*a_record == *b_record) {
-        // They're the same entry.  It doesn't really matter which one we
-        // keep.
-        _index->_records.insert(_index->_records.end(), BamCacheIndex::Records::value_type(a_record->get_source_pathname(), a_record));
-
-      } else {
-        // They're different.  Just throw them both away, and re-read the
-        // current data from the cache file.
-
-        Filename cache_pathname(_root, a_record->get_cache_filename());
-
-        if (cache_pathname.exists()) {
-          PT(BamCacheRecord) record = do_read_record(cache_pathname, false);
-          if (record != nullptr) {
-            _index->_records.insert(_index->_records.end(), BamCacheIndex::Records::value_type(record->get_source_pathname(), record));
-          }
-        }
-      }
-
-      ++ai;
-      ++bi;
-    }
-  }
-
-  while (ai != old_index->_records.end()) {
-    // Here is an entry we have in our index, not present in the new index.
-    PT(BamCacheRecord) record = (*ai).second;
-    Filename cache_pathname(_root, record->get_cache_filename());
-    if (cache_pathname.exists()) {
-      // The file exists; keep it.
-      _index->_records.insert(_index->_records.end(), BamCacheIndex::Records::value_type(record->get_source_pathname(), record));
     }
-    ++ai;
   }
 
-  while (bi != new_index->_records.end()) {
-    // Here is an entry in the new index, not present in our index.
-    PT(BamCacheRecord) record = (*bi).second;
-    Filename cache_pathname(_root, record->get_cache_filename());
-    if (cache_pathname.exists()) {
-      // The file exists; keep it.
-      _index->_records.insert(_index->_records.end(), BamCacheIndex::Records::value_type(record->get_source_pathname(), record));
-    }
-    ++bi;
-  }
+  new_index->_records.clear();
+  delete new_index;
 
   _index->process_new_records();
 }
@@ -610,9 +710,42 @@ rebuild_index() {
   }
   _index->process_new_records();
 
-  _index_stale_since = time(nullptr);
+  // Every shard has to be written out again.
+  for (int si = 0; si < num_index_shards; ++si) {
+    mark_index_stale(si);
+  }
   check_cache_size();
-  flush_index();
+  do_flush_index();
+}
+
+/**
+ * Returns the name of the file that holds the name of the current index file
+ * for the indicated shard.
+ */
+Filename BamCache::
+get_index_ref_pathname(int shard) const {
+  nassertr(shard >= 0 && shard < num_index_shards, Filename());
+  string basename = string("index_name_") + index_shard_digits[shard] + ".txt";
+  return Filename(_root, Filename(basename));
+}
+
+/**
+ * Returns the shard of the index that the record with the indicated cache
+ * filename belongs in.  Since the cache filename is a hash of the source
+ * filename, its first digit spreads the records evenly over the shards.
+ */
+int BamCache::
+get_index_shard(const Filename &cache_filename) {
+  string basename = cache_filename.get_basename();
+  if (!basename.empty()) {
+    char ch = tolower(basename[0]);
+    if (ch >= '0' && ch <= '9') {
+      return ch - '0';
+    } else if (ch >= 'a' && ch <= 'f') {
+      return ch - 'a' + 10;
+    }
+  }
+  return 0;
 }
 
 /**
@@ -621,10 +754,11 @@ rebuild_index() {
  */
 void BamCache::
 add_to_index(const BamCacheRecord *record) {
+  ReMutexHolder holder(_lock);
   PT(BamCacheRecord) new_record = record->make_copy();
 
   if (_index->add_record(new_record)) {
-    mark_index_stale();
+    mark_index_stale(get_index_shard(new_record->get_cache_filename()));
     check_cache_size();
   }
 }
@@ -634,14 +768,23 @@ add_to_index(const BamCacheRecord *record) {
  */
 void BamCache::
 remove_from_index(const Filename &source_pathname) {
+  ReMutexHolder holder(_lock);
+  BamCacheIndex::Records::const_iterator ri = _index->_records.find(source_pathname);
+  if (ri == _index->_records.end()) {
+    return;
+  }
+
+  int shard = get_index_shard((*ri).second->get_cache_filename());
   if (_index->remove_record(source_pathname)) {
-    mark_index_stale();
+    mark_index_stale(shard);
   }
 }
 
 /**
- * If the cache size has exceeded its specified size limit, removes an old
- * file.
+ * If the cache size has exceeded its specified size limit, removes the
+ * least-recently-used files until it is back within the limit.  This is
+ * called whenever a record is added to the index, so the cache is trimmed a
+ * little at a time as it grows.
  */
 void BamCache::
 check_cache_size() {
@@ -650,23 +793,30 @@ check_cache_size() {
     return;
   }
 
-  if (_index->_cache_size / 1024 > _max_kbytes) {
-    while (_index->_cache_size / 1024 > _max_kbytes) {
-      PT(BamCacheRecord) record = _index->evict_old_file();
-      if (record == nullptr) {
-        // Never mind; the cache is empty.
-        break;
-      }
+  bool async_store = _async_store && Thread::is_true_threads();
+
+  while (_index->_cache_size / 1024 > _max_kbytes) {
+    PT(BamCacheRecord) record = _index->evict_old_file();
+    if (record == nullptr) {
+      // Never mind; the cache is empty.
+      break;
+    }
+    mark_index_stale(get_index_shard(record->get_cache_filename()));
+
+    Filename cache_pathname(_root, record->get_cache_filename());
+    if (util_cat.is_debug()) {
+      util_cat.debug()
+        << "Deleting " << cache_pathname
+        << " to keep cache size below " << _max_kbytes << "K\n";
+    }
+
+    // If we have a store thread, let it delete the file, so that it is
+    // ordered correctly with any pending write of the same file.
+    string no_data;
+    if (!async_store || !queue_store(record, cache_pathname, no_data, true)) {
       VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
-      Filename cache_pathname(_root, record->get_cache_filename());
-      if (util_cat.is_debug()) {
-        util_cat.debug()
-          << "Deleting " << cache_pathname
-          << " to keep cache size below " << _max_kbytes << "K\n";
-      }
       vfs->delete_file(cache_pathname);
     }
-    mark_index_stale();
   }
 }
 
@@ -801,7 +951,7 @@ read_record(const Filename &source_pathname,
             const Filename &cache_filename,
             int pass) {
   VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
-  Filename cache_pathname(_root, cache_filename);
+  Filename cache_pathname(get_root(), cache_filename);
   if (pass != 0) {
     ostringstream strm;
     strm << cache_pathname.get_basename_wo_extension() << "_" << pass;
@@ -866,8 +1016,35 @@ read_record(const Filename &source_pathname,
  */
 PT(BamCacheRecord) BamCache::
 do_read_record(const Filename &cache_pathname, bool read_data) {
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  PT(VirtualFile) vfile = vfs->get_file(cache_pathname);
+  istream *raw_in = nullptr;
+  if (vfile != nullptr) {
+    raw_in = vfile->open_read_file(false);
+  }
+  if (raw_in == nullptr) {
+    if (util_cat.is_debug()) {
+      util_cat.debug()
+        << "Could not read cache file: " << cache_pathname << "\n";
+    }
+    return nullptr;
+  }
+
+  // The cache file may have been written compressed; we can tell from the
+  // first few bytes.
+  CompressionCodec codec = detect_compression_codec(*raw_in);
+  std::unique_ptr<istream> in(make_decompress_stream(raw_in, true, codec));
+  if (in == nullptr) {
+    if (util_cat.is_debug()) {
+      util_cat.debug()
+        << cache_pathname << " is compressed with " << codec
+        << ", which is not available.\n";
+    }
+    return nullptr;
+  }
+
   DatagramInputFile din;
-  if (!din.open(cache_pathname)) {
+  if (!din.open(*in, cache_pathname)) {
     if (util_cat.is_debug()) {
       util_cat.debug()
         << "Could not read cache file: " << cache_pathname << "\n";
@@ -948,10 +1125,7 @@ do_read_record(const Filename &cache_pathname, bool read_data) {
   }
 
   // Also get the total file size.
-  PT(VirtualFile) vfile = din.get_vfile();
-  istream &in = din.get_stream();
-  in.clear();
-  record->_record_size = vfile->get_file_size(&in);
+  record->_record_size = vfile->get_file_size();
 
   // And the last access time is now, duh.
   record->_record_access_time = time(nullptr);
@@ -959,6 +1133,277 @@ do_read_record(const Filename &cache_pathname, bool read_data) {
   return record;
 }
 
+/**
+ * Writes the indicated record to its cache file on disk, compressing it if
+ * so configured.  If data is not NULL, it contains the record and its object
+ * already serialized by do_write_record(); otherwise, they are serialized
+ * directly to the file.  Returns true on success, false on failure.
+ */
+bool BamCache::
+write_cache_file(BamCacheRecord *record, const Filename &cache_pathname,
+                 const string *data) {
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+
+  CompressionCodec codec;
+  int level;
+  {
+    ReMutexHolder holder(_lock);
+    codec = _compression_codec;
+    level = _compression_level;
+  }
+
+  // We actually do the write to a temporary filename first, and then move it
+  // into place, so that no one attempts to read the file while it is in the
+  // process of being written.
+  Thread *current_thread = Thread::get_current_thread();
+  string extension = current_thread->get_unique_id() + string(".tmp");
+  Filename temp_pathname = cache_pathname;
+  temp_pathname.set_extension(extension);
+  temp_pathname.set_binary();
+
+  std::unique_ptr<ostream> out;
+  ostream *raw_out = vfs->open_write_file(temp_pathname, false, true);
+  if (raw_out != nullptr) {
+    out.reset(make_compress_stream(raw_out, true, codec, level));
+  }
+  if (out == nullptr) {
+    util_cat.error()
+      << "Could not write cache file: " << temp_pathname << "\n";
+    vfs->delete_file(temp_pathname);
+    emergency_read_only();
+    return false;
+  }
+
+  bool success;
+  if (data != nullptr) {
+    out->write(data->data(), data->size());
+    success = !out->fail();
+    if (!success) {
+      util_cat.error()
+        << "Unable to write to " << temp_pathname << "\n";
+    }
+  } else {
+    success = do_write_record(*out, temp_pathname, record);
+  }
+  out.reset();
+
+  if (!success) {
+    vfs->delete_file(temp_pathname);
+    return false;
+  }
+
+  // Record the size of the file as it is on disk, which may have been
+  // compressed.
+  {
+    PT(VirtualFile) vfile = vfs->get_file(temp_pathname);
+    record->_record_size = (vfile != nullptr) ? vfile->get_file_size() : 0;
+  }
+
+  // Now move the file into place.
+  if (!vfs->rename_file(temp_pathname, cache_pathname) && vfs->exists(temp_pathname)) {
+    vfs->delete_file(cache_pathname);
+    if (!vfs->rename_file(temp_pathname, cache_pathname)) {
+      util_cat.error()
+        << "Unable to rename " << temp_pathname << " to "
+        << cache_pathname << "\n";
+      vfs->delete_file(temp_pathname);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Writes the indicated record, followed by the object it holds, to the
+ * indicated stream in bam format.  The pathname is used for error messages
+ * and for any data written out-of-line.  Returns true on success.
+ */
+bool BamCache::
+do_write_record(ostream &out, const Filename &pathname, BamCacheRecord *record) {
+  DatagramOutputFile dout;
+  if (!dout.open(out, pathname)) {
+    util_cat.error()
+      << "Could not write cache file: " << pathname << "\n";
+    return false;
+  }
+
+  if (!dout.write_header(_bam_header)) {
+    util_cat.error()
+      << "Unable to write to " << pathname << "\n";
+    return false;
+  }
+
+  {
+    BamWriter writer(&dout);
+    if (!writer.init()) {
+      util_cat.error()
+        << "Unable to write Bam header to " << pathname << "\n";
+      return false;
+    }
+
+    TypeRegistry *type_registry = TypeRegistry::ptr();
+    TypeHandle texture_type = type_registry->find_type("Texture");
+    if (record->get_data()->is_of_type(texture_type)) {
+      // Texture objects write the actual texture image.
+      writer.set_file_texture_mode(BamWriter::BTM_rawdata);
+    } else {
+      // Any other kinds of objects write texture references.
+      writer.set_file_texture_mode(BamWriter::BTM_fullpath);
+    }
+
+    // This is necessary for relative NodePaths to work.
+    TypeHandle node_type = type_registry->find_type("PandaNode");
+    if (record->get_data()->is_of_type(node_type)) {
+      writer.set_root_node(record->get_data());
+    }
+
+    if (!writer.write_object(record)) {
+      util_cat.error()
+        << "Unable to write object to " << pathname << "\n";
+      return false;
+    }
+
+    if (!writer.write_object(record->get_data())) {
+      util_cat.error()
+        << "Unable to write object data to " << pathname << "\n";
+      return false;
+    }
+
+    // Now that we are done with the BamWriter, it's important to let it
+    // destruct now and clean itself up, or it might get mad if we delete any
+    // TypedWritables below that haven't been written yet.
+  }
+
+  dout.close();
+  return true;
+}
+
+/**
+ * Adds the indicated record to the queue of records to be written to disk by
+ * the store thread, starting the thread if necessary.  If remove is true, the
+ * cache file is deleted instead.  On success, the contents of data are taken
+ * over by the queue.  Returns false if the store thread could not be started,
+ * in which case the caller should do the work itself.
+ */
+bool BamCache::
+queue_store(BamCacheRecord *record, const Filename &cache_pathname,
+            string &data, bool remove) {
+  MutexHolder holder(_store_lock);
+  if (_store_thread == nullptr) {
+    PT(StoreThread) thread = new StoreThread(this);
+    if (!thread->start(TP_low, true)) {
+      return false;
+    }
+    _store_thread = thread;
+    _store_shutdown = false;
+  }
+
+  _pending_stores.push_back(PendingStore());
+  PendingStore &pending = _pending_stores.back();
+  pending._record = record;
+  pending._cache_pathname = cache_pathname;
+  pending._data.swap(data);
+  pending._remove = remove;
+  _store_cvar.notify_all();
+  return true;
+}
+
+/**
+ * Blocks until the store thread is no longer working on the record for the
+ * indicated source file.
+ */
+void BamCache::
+wait_for_store(const Filename &source_pathname) {
+  MutexHolder holder(_store_lock);
+  PendingStores::const_iterator pi = _pending_stores.begin();
+  while (pi != _pending_stores.end()) {
+    if ((*pi)._record->get_source_pathname() == source_pathname) {
+      // Wait for it, and then start over, since the queue has changed.
+      _store_cvar.wait();
+      pi = _pending_stores.begin();
+    } else {
+      ++pi;
+    }
+  }
+}
+
+/**
+ * Waits for the store thread to finish the records on its queue, and then
+ * shuts it down.
+ */
+void BamCache::
+stop_store_thread() {
+  PT(StoreThread) thread;
+  {
+    MutexHolder holder(_store_lock);
+    thread = _store_thread;
+    _store_thread = nullptr;
+    _store_shutdown = true;
+    _store_cvar.notify_all();
+  }
+
+  if (thread != nullptr) {
+    thread->join();
+  }
+}
+
+/**
+ * The main processing loop of the store thread.
+ */
+void BamCache::
+run_store_thread() {
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  _store_lock.acquire();
+
+  while (true) {
+    while (_pending_stores.empty()) {
+      if (_store_shutdown) {
+        _store_lock.release();
+        return;
+      }
+      _store_cvar.wait();
+    }
+
+    // The record stays on the queue while we work on it, so that lookup()
+    // knows to wait for it.  Other threads only ever add to the back of the
+    // queue, which doesn't invalidate this reference.
+    PendingStore &pending = _pending_stores.front();
+    _store_lock.release();
+
+    if (pending._remove) {
+      vfs->delete_file(pending._cache_pathname);
+
+    } else if (!get_read_only() &&
+               write_cache_file(pending._record, pending._cache_pathname,
+                                &pending._data)) {
+      add_to_index(pending._record);
+    }
+
+    _store_lock.acquire();
+    _pending_stores.pop_front();
+    _store_cvar.notify_all();
+  }
+}
+
+/**
+ *
+ */
+BamCache::StoreThread::
+StoreThread(BamCache *cache) :
+  Thread("BamCacheStore", "BamCacheStore"),
+  _cache(cache)
+{
+}
+
+/**
+ *
+ */
+void BamCache::StoreThread::
+thread_main() {
+  _cache->run_store_thread();
+}
+
 /**
  * Returns the appropriate filename to use for a cache file, given the
  * fullpath string to the source filename.
@@ -983,4 +1428,21 @@ make_global() {
   if (_global_ptr->_root.empty()) {
     _global_ptr->set_active(false);
   }
+
+  // The global cache is never destructed, so we need to make sure that any
+  // records still waiting for the store thread are written before the
+  // process goes away.
+  atexit(&shutdown_global);
+}
+
+/**
+ * Called at process exit to finish writing out the pending records of the
+ * global BamCache, and its index.
+ */
+void BamCache::
+shutdown_global() {
+  if (_global_ptr != nullptr) {
+    _global_ptr->stop_store_thread();
+    _global_ptr->flush_index();
+  }
 }
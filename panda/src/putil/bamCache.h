@@ -22,6 +22,11 @@
 #include "pvector.h"
 #include "reMutex.h"
 #include "reMutexHolder.h"
+#include "pmutex.h"
+#include "conditionVar.h"
+#include "pdeque.h"
+#include "thread.h"
+#include "compressionCodec.h"
 
 #include <time.h>
 
@@ -37,7 +42,11 @@ class BamCacheIndex;
  * sure this index gets saved correctly to disk, even in the presence of
  * multiple different processes writing to the same index, and without relying
  * too heavily on low-level os-provided file locks (which work poorly with C++
- * iostreams).
+ * iostreams).  The index is split into a number of shards on disk, so that
+ * flushing it only rewrites the parts that have changed.
+ *
+ * New records are normally written to disk by a background thread, so that
+ * storing a freshly-loaded model in the cache does not hold up the load.
  */
 class EXPCL_PANDA_PUTIL BamCache {
 PUBLISHED:
@@ -71,9 +80,16 @@ PUBLISHED:
   INLINE void set_read_only(bool ro);
   INLINE bool get_read_only() const;
 
+  INLINE void set_compression_codec(CompressionCodec codec);
+  INLINE CompressionCodec get_compression_codec() const;
+
+  INLINE void set_async_store(bool flag);
+  INLINE bool get_async_store() const;
+
   PT(BamCacheRecord) lookup(const Filename &source_filename,
                             const std::string &cache_extension);
   bool store(BamCacheRecord *record);
+  void wait_for_stores();
 
   void consider_flush_index();
   void flush_index();
@@ -96,14 +112,22 @@ PUBLISHED:
   MAKE_PROPERTY(flush_time, get_flush_time, set_flush_time);
   MAKE_PROPERTY(cache_max_kbytes, get_cache_max_kbytes, set_cache_max_kbytes);
   MAKE_PROPERTY(read_only, get_read_only, set_read_only);
+  MAKE_PROPERTY(compression_codec, get_compression_codec,
+                                   set_compression_codec);
+  MAKE_PROPERTY(async_store, get_async_store, set_async_store);
 
 private:
+  void do_flush_index();
+  bool flush_index_shard(int shard);
   void read_index();
-  bool read_index_pathname(Filename &index_pathname,
+  void read_index_shard(int shard);
+  bool read_index_pathname(int shard, Filename &index_pathname,
                            std::string &index_ref_contents) const;
-  void merge_index(BamCacheIndex *new_index);
+  void merge_index(BamCacheIndex *new_index, int shard);
   void rebuild_index();
-  INLINE void mark_index_stale();
+  INLINE void mark_index_stale(int shard);
+  Filename get_index_ref_pathname(int shard) const;
+  static int get_index_shard(const Filename &cache_filename);
 
   void add_to_index(const BamCacheRecord *record);
   void remove_from_index(const Filename &source_filename);
@@ -123,8 +147,20 @@ private:
   static PT(BamCacheRecord) do_read_record(const Filename &cache_pathname,
                                            bool read_data);
 
+  bool write_cache_file(BamCacheRecord *record, const Filename &cache_pathname,
+                        const std::string *data);
+  static bool do_write_record(std::ostream &out, const Filename &pathname,
+                              BamCacheRecord *record);
+
+  bool queue_store(BamCacheRecord *record, const Filename &cache_pathname,
+                   std::string &data, bool remove);
+  void wait_for_store(const Filename &source_pathname);
+  void stop_store_thread();
+  void run_store_thread();
+
   static std::string hash_filename(const std::string &filename);
   static void make_global();
+  static void shutdown_global();
 
   bool _active;
   bool _cache_models;
@@ -132,18 +168,62 @@ private:
   bool _cache_compressed_textures;
   bool _cache_compiled_shaders;
   bool _read_only;
+  bool _async_store;
   Filename _root;
   int _flush_time;
   int _max_kbytes;
+  CompressionCodec _compression_codec;
+  int _compression_level;
   static BamCache *_global_ptr;
 
   BamCacheIndex *_index;
   time_t _index_stale_since;
 
-  Filename _index_pathname;
-  std::string _index_ref_contents;
+  // The on-disk index is split into this many shards, by the first hex digit
+  // of the cache filename.  Each shard has its own index file and reference
+  // file, and is only rewritten when one of its records has changed.
+  static const int num_index_shards = 16;
+
+  class IndexShard {
+  public:
+    INLINE IndexShard();
+
+    Filename _index_pathname;
+    std::string _index_ref_contents;
+    bool _stale;
+  };
+  IndexShard _shards[num_index_shards];
 
   ReMutex _lock;
+
+  // These are the records waiting to be written to disk (or evicted files
+  // waiting to be deleted) by the store thread.  The record at the front of
+  // the queue remains there while it is being processed.
+  class PendingStore {
+  public:
+    PT(BamCacheRecord) _record;
+    Filename _cache_pathname;
+    std::string _data;
+    bool _remove;
+  };
+  typedef pdeque<PendingStore> PendingStores;
+
+  class StoreThread : public Thread {
+  public:
+    StoreThread(BamCache *cache);
+
+  protected:
+    virtual void thread_main();
+
+  private:
+    BamCache *_cache;
+  };
+
+  PendingStores _pending_stores;
+  PT(StoreThread) _store_thread;
+  bool _store_shutdown;
+  Mutex _store_lock;
+  ConditionVar _store_cvar;
 };
 
 #include "bamCache.I"
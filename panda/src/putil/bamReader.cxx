@@ -19,6 +19,7 @@
 #include "datagramIterator.h"
 #include "config_putil.h"
 #include "pipelineCyclerBase.h"
+#include "virtualFileSystem.h"
 
 using std::string;
 
@@ -49,6 +50,7 @@ BamReader(DatagramGenerator *source)
   _pta_id = -1;
   _long_object_id = false;
   _long_pta_id = false;
+  _tried_map_source = false;
 }
 
 
@@ -689,6 +691,88 @@ read_file_data(SubfileInfo &info) {
   _file_data_records.pop_front();
 }
 
+/**
+ * Returns a pointer to the contents of a block of file data returned by
+ * read_file_data(), if it may be accessed directly in memory, and fills in
+ * mapping with the object that must be kept around for as long as the pointer
+ * is in use.  Otherwise, returns NULL, and the data must be read with
+ * extract_file_data() instead.
+ *
+ * This is only possible when bam-map-file-data is set, and the bam file is
+ * stored uncompressed on disk, or in an uncompressed Multifile.
+ */
+const unsigned char *BamReader::
+map_file_data(const SubfileInfo &info, PT(MappedFile) &mapping) {
+  if (!bam_map_file_data || info.is_empty() ||
+      _source == nullptr || info.get_file() != _source->get_file()) {
+    // This data was copied elsewhere, probably because the source isn't a
+    // file we can seek in.
+    return nullptr;
+  }
+
+  if (!_tried_map_source) {
+    _tried_map_source = true;
+    VirtualFile *vfile = _source->get_vfile();
+    SubfileInfo system_info;
+    if (vfile != nullptr && vfile->get_system_info(system_info)) {
+      PT(MappedFile) mapped = new MappedFile;
+      if (mapped->open(system_info.get_filename(), system_info.get_start(),
+                       (size_t)system_info.get_size())) {
+        _mapped_source = std::move(mapped);
+      }
+    }
+    if (_mapped_source == nullptr && bam_cat.is_debug()) {
+      bam_cat.debug()
+        << "Unable to map " << get_filename() << " into memory.\n";
+    }
+  }
+
+  if (_mapped_source == nullptr ||
+      (size_t)info.get_start() + (size_t)info.get_size() > _mapped_source->get_size()) {
+    return nullptr;
+  }
+
+  mapping = _mapped_source;
+  return (const unsigned char *)_mapped_source->get_data() + (size_t)info.get_start();
+}
+
+/**
+ * Copies the contents of a block of file data returned by read_file_data()
+ * into the indicated buffer, which must be large enough to hold
+ * info.get_size() bytes.  Returns true on success, false on failure.
+ */
+bool BamReader::
+extract_file_data(const SubfileInfo &info, unsigned char *data) {
+  PT(MappedFile) mapping;
+  const unsigned char *mapped = map_file_data(info, mapping);
+  if (mapped != nullptr) {
+    memcpy(data, mapped, (size_t)info.get_size());
+    return true;
+  }
+
+  Filename filename = info.get_filename();
+  filename.set_binary();
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  std::istream *in = vfs->open_read_file(filename, false);
+  if (in == nullptr) {
+    bam_cat.error()
+      << "Unable to open " << filename << " to read file data.\n";
+    return false;
+  }
+
+  in->seekg(info.get_start());
+  in->read((char *)data, info.get_size());
+  bool success = !in->fail() && in->gcount() == info.get_size();
+  vfs->close_read_file(in);
+
+  if (!success) {
+    bam_cat.error()
+      << "Unable to read " << info.get_size() << " bytes of file data from "
+      << filename << "\n";
+  }
+  return success;
+}
+
 /**
  * Reads in the indicated CycleData object.  This should be used by classes
  * that store some or all of their data within a CycleData subclass, in
@@ -1104,12 +1188,24 @@ p_read_object() {
     // skip over for now, but we note its position within the stream, so that
     // we can hand it to a future object who may request it.
     {
+      size_t padding = 0;
+      if (get_file_minor_ver() >= 47) {
+        // The data may be preceded by some padding, to align it within the
+        // file.
+        padding = scan.get_uint16();
+      }
+
       SubfileInfo info;
-      if (!_source->save_datagram(info)) {
+      if (!_source->save_datagram(info) ||
+          (std::streamsize)padding > info.get_size()) {
         bam_cat.error()
           << "Failed to read file data.\n";
         return 0;
       }
+      if (padding != 0) {
+        info = SubfileInfo(info.get_file(), info.get_start() + (std::streamoff)padding,
+                           info.get_size() - (std::streamsize)padding);
+      }
       _file_data_records.push_back(info);
     }
 
@@ -25,6 +25,7 @@
 #include "bamReaderParam.h"
 #include "bamEnums.h"
 #include "subfileInfo.h"
+#include "mappedFile.h"
 #include "loaderOptions.h"
 #include "factory.h"
 #include "vector_int.h"
@@ -171,6 +172,8 @@ public:
   void skip_pointer(DatagramIterator &scan);
 
   void read_file_data(SubfileInfo &info);
+  const unsigned char *map_file_data(const SubfileInfo &info, PT(MappedFile) &mapping);
+  bool extract_file_data(const SubfileInfo &info, unsigned char *data);
 
   void read_cdata(DatagramIterator &scan, PipelineCyclerBase &cycler);
   void read_cdata(DatagramIterator &scan, PipelineCyclerBase &cycler,
@@ -325,6 +328,11 @@ private:
   typedef pdeque<SubfileInfo> FileDataRecords;
   FileDataRecords _file_data_records;
 
+  // The source file, mapped into memory on the first call to
+  // map_file_data(), if bam-map-file-data is set.
+  PT(MappedFile) _mapped_source;
+  bool _tried_map_source;
+
   // This is used internally to record all of the new types created on-the-fly
   // to satisfy bam requirements.  We keep track of this just so we can
   // suppress warning messages from attempts to create objects of these types.
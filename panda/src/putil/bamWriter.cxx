@@ -362,9 +362,13 @@ write_pointer(Datagram &packet, const TypedWritable *object) {
 void BamWriter::
 write_file_data(SubfileInfo &result, const Filename &filename) {
   // We write file data by preceding with a singleton datagram that contains
-  // only the BOC_file_data token.
+  // only the BOC_file_data token.  Since bam 6.47, this is followed by the
+  // number of bytes of padding, which is always zero here.
   Datagram dg;
   dg.add_uint8(BOC_file_data);
+  if (_file_minor >= 47) {
+    dg.add_uint16(0);
+  }
   if (!_target->put_datagram(dg)) {
     util_cat.error()
       << "Unable to write data to output.\n";
@@ -393,9 +397,13 @@ write_file_data(SubfileInfo &result, const Filename &filename) {
 void BamWriter::
 write_file_data(SubfileInfo &result, const SubfileInfo &source) {
   // We write file data by preceding with a singleton datagram that contains
-  // only the BOC_file_data token.
+  // only the BOC_file_data token.  Since bam 6.47, this is followed by the
+  // number of bytes of padding, which is always zero here.
   Datagram dg;
   dg.add_uint8(BOC_file_data);
+  if (_file_minor >= 47) {
+    dg.add_uint16(0);
+  }
   if (!_target->put_datagram(dg)) {
     util_cat.error()
       << "Unable to write data to output.\n";
@@ -415,6 +423,55 @@ write_file_data(SubfileInfo &result, const SubfileInfo &source) {
   // order and queued up in the BamReader.
 }
 
+/**
+ * Writes a block of auxiliary data that is already held in memory.  This is
+ * intended for large blocks of data belonging to an object, which the reader
+ * may choose to skip over and read later on demand, or use in place from a
+ * memory-mapped file.  This must be balanced by a matching call to
+ * read_file_data() on restore.
+ *
+ * If the bam version allows it, and the position within the file is known,
+ * the data will be padded so that it begins at a multiple of the indicated
+ * alignment, counting from the start of the file.
+ */
+void BamWriter::
+write_file_data(const void *data, size_t size, size_t alignment) {
+  // As above, we precede the data with a singleton datagram containing the
+  // BOC_file_data token.  Since bam 6.47, this also contains the number of
+  // bytes of padding that precede the data in the datagram that follows.
+  Datagram dg;
+  dg.add_uint8(BOC_file_data);
+
+  size_t padding = 0;
+  if (_file_minor >= 47) {
+    nassertv(alignment > 0 && alignment <= 0xffff);
+    std::streamoff pos = (std::streamoff)_target->get_file_pos();
+    if (alignment > 1 && pos > 0) {
+      // Skip over this datagram and the length of the following one, taking
+      // care to account for the longer length used by very large datagrams.
+      pos += 4 + 3;
+      pos += (size + alignment >= 0xffffffff) ? 12 : 4;
+      padding = (alignment - (size_t)(pos % alignment)) % alignment;
+    }
+    dg.add_uint16(padding);
+  }
+
+  if (!_target->put_datagram(dg)) {
+    util_cat.error()
+      << "Unable to write data to output.\n";
+    return;
+  }
+
+  Datagram payload;
+  payload.pad_bytes(padding);
+  payload.append_data(data, size);
+  if (!_target->put_datagram(payload)) {
+    util_cat.error()
+      << "Unable to write file data to output.\n";
+    return;
+  }
+}
+
 /**
  * Writes out the indicated CycleData object.  This should be used by classes
  * that store some or all of their data within a CycleData subclass, in
@@ -108,6 +108,7 @@ public:
 
   void write_file_data(SubfileInfo &result, const Filename &filename);
   void write_file_data(SubfileInfo &result, const SubfileInfo &source);
+  void write_file_data(const void *data, size_t size, size_t alignment = 1);
 
   void write_cdata(Datagram &packet, const PipelineCyclerBase &cycler);
   void write_cdata(Datagram &packet, const PipelineCyclerBase &cycler,
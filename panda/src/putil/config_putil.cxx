@@ -89,6 +89,16 @@ ConfigVariableEnum<BamEnums::BamTextureMode> bam_texture_mode
  PRC_DESC("Set this to specify how textures should be written into Bam files."
           "See the panda source or documentation for available options."));
 
+ConfigVariableBool bam_map_file_data
+("bam-map-file-data", false,
+ PRC_DESC("Set this true to map .bam files into memory while they are being "
+          "read, so that large blocks of data stored out-of-line, such as "
+          "vertex arrays, may be used directly from the mapped file rather "
+          "than copied into newly allocated memory.  This only applies to "
+          "uncompressed files on disk or in an uncompressed Multifile.  The "
+          "file must not be modified while the objects read from it are in "
+          "use."));
+
 ConfigureFn(config_putil) {
   init_libputil();
 }
@@ -240,9 +240,17 @@ save_datagram(SubfileInfo &info) {
   // If this stream is file-based, we can just point the SubfileInfo directly
   // into this file.
   if (_file != nullptr) {
-    info = SubfileInfo(_file, _in->tellg(), num_bytes);
+    streampos start = _in->tellg();
     _in->seekg(num_bytes, std::ios::cur);
-    return true;
+    if (!_in->fail()) {
+      info = SubfileInfo(_file, start, num_bytes);
+      return true;
+    }
+
+    // The stream can't seek forward, which happens when the file is being
+    // decompressed on the fly.  The offset would be meaningless anyway, so
+    // fall back to copying the data out.
+    _in->clear();
   }
 
   // Otherwise, we have to dump the data into a temporary file.
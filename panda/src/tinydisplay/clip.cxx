@@ -1,4 +1,5 @@
 #include "zgl.h"
+#include "tinyTileRenderer.h"
 #include <limits.h>
 
 /* fill triangle profile */
@@ -406,7 +407,22 @@ void gl_draw_triangle_fill(GLContext *c,
   }
 #endif
 
-  (*c->zb_fill_tri)(c->zb,&p0->zp,&p1->zp,&p2->zp);
+  if (c->hz_test && ZB_hzTestTriangle(c->zb,&p0->zp,&p1->zp,&p2->zp)) {
+    /* it's entirely behind what has already been drawn */
+#ifdef DO_PSTATS
+    hz_triangles_rejected++;
+#endif
+    return;
+  }
+  if (c->hz_mark_state >= 0) {
+    ZB_hzMarkTriangle(c->zb,&p0->zp,&p1->zp,&p2->zp,c->hz_mark_state);
+  }
+
+  if (c->tile_renderer != nullptr) {
+    c->tile_renderer->add_triangle(&p0->zp,&p1->zp,&p2->zp);
+  } else {
+    (*c->zb_fill_tri)(c->zb,&p0->zp,&p1->zp,&p2->zp);
+  }
 }
 
 /* Render a clipped triangle in line mode */  
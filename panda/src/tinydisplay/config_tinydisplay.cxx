@@ -57,6 +57,41 @@ ConfigVariableBool td_perspective_textures
             "textures on the tinydisplay software renderer, for a small "
             "performance gain."));
 
+ConfigVariableBool td_parallel_raster
+  ("td-parallel-raster", false,
+   PRC_DESC("Configure this true to rasterize large batches of triangles on "
+            "multiple threads.  The frame buffer is divided into horizontal "
+            "bands, each of which is drawn by one thread at a time, so the "
+            "results are identical to those of single-threaded rendering.  "
+            "The number of threads is controlled by worker-threads."));
+
+ConfigVariableInt td_parallel_raster_rows
+  ("td-parallel-raster-rows", 32,
+   PRC_DESC("The height, in pixels, of each of the bands into which the frame "
+            "buffer is divided when td-parallel-raster is in effect."));
+
+ConfigVariableBool td_hierarchical_z
+  ("td-hierarchical-z", false,
+   PRC_DESC("Configure this true to keep a coarse, per-tile copy of the depth "
+            "buffer on the tinydisplay software renderer, which is used to "
+            "skip triangles that are entirely hidden behind what has already "
+            "been drawn.  This helps for scenes with a lot of occlusion, "
+            "especially when they are drawn roughly front-to-back."));
+
+ConfigVariableBool td_sse2
+  ("td-sse2", true,
+   PRC_DESC("Configure this false to prevent the tinydisplay software "
+            "renderer from using its SSE2 versions of the most common "
+            "triangle fillers and texture filters, even if the CPU supports "
+            "them.  The results should be identical either way; this is "
+            "mainly useful to compare against the plain versions."));
+
+ConfigVariableInt td_parallel_raster_min_triangles
+  ("td-parallel-raster-min-triangles", 64,
+   PRC_DESC("When td-parallel-raster is in effect, Geoms with fewer than "
+            "this many triangles are still rasterized on a single thread, "
+            "since they are not worth the overhead of dividing the work."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
@@ -29,5 +29,10 @@ extern ConfigVariableInt td_texture_ram;
 extern ConfigVariableBool td_ignore_mipmaps;
 extern ConfigVariableBool td_ignore_clamp;
 extern ConfigVariableBool td_perspective_textures;
+extern ConfigVariableBool td_parallel_raster;
+extern ConfigVariableInt td_parallel_raster_rows;
+extern ConfigVariableInt td_parallel_raster_min_triangles;
+extern ConfigVariableBool td_hierarchical_z;
+extern ConfigVariableBool td_sse2;
 
 #endif
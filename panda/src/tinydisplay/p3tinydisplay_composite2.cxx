@@ -4,6 +4,7 @@
 #include "tinySDLGraphicsPipe.cxx"
 #include "tinySDLGraphicsWindow.cxx"
 #include "tinyTextureContext.cxx"
+#include "tinyTileRenderer.cxx"
 #include "tinyWinGraphicsPipe.cxx"
 #include "tinyWinGraphicsWindow.cxx"
 #include "tinyXGraphicsPipe.cxx"
@@ -58,6 +58,7 @@ PStatCollector TinyGraphicsStateGuardian::_pixel_count_flat_perspective_pcollect
 PStatCollector TinyGraphicsStateGuardian::_pixel_count_smooth_perspective_pcollector("Pixels:Smooth perspective");
 PStatCollector TinyGraphicsStateGuardian::_pixel_count_smooth_multitex2_pcollector("Pixels:Smooth multitex 2");
 PStatCollector TinyGraphicsStateGuardian::_pixel_count_smooth_multitex3_pcollector("Pixels:Smooth multitex 3");
+PStatCollector TinyGraphicsStateGuardian::_hz_triangles_rejected_pcollector("Occluded triangles");
 
 /**
  *
@@ -368,6 +369,7 @@ begin_frame(Thread *current_thread) {
   _pixel_count_smooth_perspective_pcollector.clear_level();
   _pixel_count_smooth_multitex2_pcollector.clear_level();
   _pixel_count_smooth_multitex3_pcollector.clear_level();
+  _hz_triangles_rejected_pcollector.clear_level();
 #endif
 
   return true;
@@ -460,6 +462,7 @@ end_frame(Thread *current_thread) {
   _pixel_count_smooth_perspective_pcollector.flush_level();
   _pixel_count_smooth_multitex2_pcollector.flush_level();
   _pixel_count_smooth_multitex3_pcollector.flush_level();
+  _hz_triangles_rejected_pcollector.flush_level();
 #endif  // DO_PSTATS
 }
 
@@ -923,6 +926,34 @@ begin_draw_primitives(const GeomPipelineReader *geom_reader,
 
   _c->zb_fill_tri = fill_tri_funcs[depth_write_state][color_write_state][alpha_test_state][depth_test_state][texfilter_state][shade_model_state][texturing_state];
 
+#ifdef ZB_HAVE_SSE2
+  if (color_write_state == 0 && alpha_test_state == 0 &&
+      texturing_state < 3 && shade_model_state < 2 &&
+      td_sse2 && ZB_has_sse2()) {
+    // We have a faster version of the most common fillers, with at most one
+    // texture and no per-vertex colors.
+    _c->zb_fill_tri = fill_tri_funcs_sse2[depth_write_state][depth_test_state][texfilter_state][shade_model_state][texturing_state];
+  }
+#endif
+
+  // If we are rasterizing in parallel, the triangles are collected by the
+  // tile renderer, and drawn by end_draw_primitives().
+  _c->tile_renderer = td_parallel_raster ? &_tile_renderer : nullptr;
+
+  // Hierarchical z rejection is only possible with the depth test enabled,
+  // but whenever we write depth, the coarse depth buffer must be updated.
+  _c->hz_test = (td_hierarchical_z && depth_test_state == 1);
+  _c->hz_mark_state = -1;
+  if (depth_write_state == 0) {
+    if (td_hierarchical_z) {
+      // Writes that pass the depth test only move the depth values further
+      // away from the lower bounds, so they remain valid.
+      _c->hz_mark_state = (depth_test_state == 1) ? ZB_HZ_LOOSE : ZB_HZ_INVALID;
+    } else {
+      ZB_hzInvalidate(_c->zb);
+    }
+  }
+
 #ifdef DO_PSTATS
   pixel_count_white_untextured = 0;
   pixel_count_flat_untextured = 0;
@@ -935,6 +966,7 @@ begin_draw_primitives(const GeomPipelineReader *geom_reader,
   pixel_count_smooth_perspective = 0;
   pixel_count_smooth_multitex2 = 0;
   pixel_count_smooth_multitex3 = 0;
+  hz_triangles_rejected = 0;
 #endif  // DO_PSTATS
 
   return true;
@@ -1175,6 +1207,8 @@ draw_lines(const GeomPrimitivePipelineReader *reader, bool force) {
   }
 #endif  // NDEBUG
 
+  flush_tiles(reader->get_current_thread());
+
   int num_vertices = reader->get_num_vertices();
   _vertices_other_pcollector.add_level(num_vertices);
 
@@ -1252,6 +1286,8 @@ draw_points(const GeomPrimitivePipelineReader *reader, bool force) {
   }
 #endif  // NDEBUG
 
+  flush_tiles(reader->get_current_thread());
+
   int num_vertices = reader->get_num_vertices();
   _vertices_other_pcollector.add_level(num_vertices);
 
@@ -1319,6 +1355,8 @@ draw_points(const GeomPrimitivePipelineReader *reader, bool force) {
  */
 void TinyGraphicsStateGuardian::
 end_draw_primitives() {
+  flush_tiles(Thread::get_current_thread());
+  _c->tile_renderer = nullptr;
 
 #ifdef DO_PSTATS
   _pixel_count_white_untextured_pcollector.add_level(pixel_count_white_untextured);
@@ -1332,6 +1370,7 @@ end_draw_primitives() {
   _pixel_count_smooth_perspective_pcollector.add_level(pixel_count_smooth_perspective);
   _pixel_count_smooth_multitex2_pcollector.add_level(pixel_count_smooth_multitex2);
   _pixel_count_smooth_multitex3_pcollector.add_level(pixel_count_smooth_multitex3);
+  _hz_triangles_rejected_pcollector.add_level(hz_triangles_rejected);
 #endif  // DO_PSTATS
 
   GraphicsStateGuardian::end_draw_primitives();
@@ -3101,6 +3140,27 @@ get_color_blend_op(ColorBlendAttrib::Operand operand) {
  */
 ZB_lookupTextureFunc TinyGraphicsStateGuardian::
 get_tex_filter_func(SamplerState::FilterType filter) {
+#ifdef ZB_HAVE_SSE2
+  if (td_sse2 && ZB_has_sse2()) {
+    switch (filter) {
+    case SamplerState::FT_linear:
+      return &lookup_texture_bilinear_sse2;
+
+    case SamplerState::FT_nearest_mipmap_linear:
+      return &lookup_texture_mipmap_linear_sse2;
+
+    case SamplerState::FT_linear_mipmap_nearest:
+      return &lookup_texture_mipmap_bilinear_sse2;
+
+    case SamplerState::FT_linear_mipmap_linear:
+      return &lookup_texture_mipmap_trilinear_sse2;
+
+    default:
+      break;
+    }
+  }
+#endif
+
   switch (filter) {
   case SamplerState::FT_nearest:
     return &lookup_texture_nearest;
@@ -22,6 +22,7 @@
 #include "zmath.h"
 #include "zbuffer.h"
 #include "zgl.h"
+#include "tinyTileRenderer.h"
 #include "geomVertexReader.h"
 
 class TinyTextureContext;
@@ -130,6 +131,7 @@ private:
   static ZB_texWrapFunc get_tex_wrap_func(SamplerState::WrapMode wrap_mode);
 
   INLINE void clear_light_state();
+  INLINE void flush_tiles(Thread *current_thread);
 
   // Methods used to generate texture coordinates.
   class TexCoordData {
@@ -155,6 +157,10 @@ private:
 
   GLContext *_c;
 
+  // Used instead of drawing the triangles directly when td-parallel-raster
+  // is enabled.
+  TinyTileRenderer _tile_renderer;
+
   enum ColorMaterialFlags {
     CMF_ambient   = 0x001,
     CMF_diffuse   = 0x002,
@@ -193,6 +199,7 @@ private:
   static PStatCollector _pixel_count_smooth_perspective_pcollector;
   static PStatCollector _pixel_count_smooth_multitex2_pcollector;
   static PStatCollector _pixel_count_smooth_multitex3_pcollector;
+  static PStatCollector _hz_triangles_rejected_pcollector;
 
 public:
   static TypeHandle get_class_type() {
@@ -0,0 +1,115 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file tinyTileRenderer.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "tinyTileRenderer.h"
+#include "config_tinydisplay.h"
+#include "workerThreadPool.h"
+#include "pStatTimer.h"
+
+PStatCollector TinyTileRenderer::_bin_pcollector("Draw:Tiles:Bin");
+PStatCollector TinyTileRenderer::_raster_pcollector("Draw:Tiles:Rasterize");
+
+/**
+ *
+ */
+TinyTileRenderer::
+TinyTileRenderer() {
+}
+
+/**
+ * Draws all of the triangles that have been added since the last call to
+ * flush() into the indicated ZBuffer, using the indicated fill function.
+ * Does not return until they have all been drawn.
+ */
+void TinyTileRenderer::
+flush(ZBuffer *zb, ZB_fillTriangleFunc fill_tri, Thread *current_thread) {
+  if (_triangles.empty()) {
+    return;
+  }
+
+  int tile_rows = std::max((int)td_parallel_raster_rows, 1);
+  int num_tiles = (zb->ysize + tile_rows - 1) / tile_rows;
+
+  WorkerThreadPool *pool = WorkerThreadPool::get_global_ptr();
+  if (pool->get_num_threads() == 0 || num_tiles < 2 ||
+      _triangles.size() < (size_t)td_parallel_raster_min_triangles) {
+    // Not worth it; just draw them in order.
+    for (Triangle &tri : _triangles) {
+      (*fill_tri)(zb, &tri._p[0], &tri._p[1], &tri._p[2]);
+    }
+    _triangles.clear();
+    return;
+  }
+
+  bin_triangles(num_tiles, tile_rows);
+
+  {
+    PStatTimer timer(_raster_pcollector, current_thread);
+    pool->parallel_for(num_tiles, [&](size_t tile, Thread *) {
+      draw_tile((int)tile, tile_rows, zb, fill_tri);
+    }, current_thread);
+  }
+
+  _triangles.clear();
+}
+
+/**
+ * Fills in _bins with the list of triangles that overlap each tile.
+ */
+void TinyTileRenderer::
+bin_triangles(int num_tiles, int tile_rows) {
+  PStatTimer timer(_bin_pcollector);
+
+  if ((int)_bins.size() < num_tiles) {
+    _bins.resize(num_tiles);
+  }
+  for (int i = 0; i < num_tiles; ++i) {
+    _bins[i].clear();
+  }
+
+  int num_triangles = (int)_triangles.size();
+  for (int ti = 0; ti < num_triangles; ++ti) {
+    const ZBufferPoint *p = _triangles[ti]._p;
+    int ymin = std::min(p[0].y, std::min(p[1].y, p[2].y));
+    int ymax = std::max(p[0].y, std::max(p[1].y, p[2].y));
+
+    // The triangles have already been clipped to the viewport, but we clamp
+    // anyway to be safe.
+    int first = std::max(ymin / tile_rows, 0);
+    int last = std::min(ymax / tile_rows, num_tiles - 1);
+    for (int tile = first; tile <= last; ++tile) {
+      _bins[tile].push_back(ti);
+    }
+  }
+}
+
+/**
+ * Draws all of the triangles that overlap the indicated tile, clipped to the
+ * scan lines of that tile.  This is called by the worker threads.
+ */
+void TinyTileRenderer::
+draw_tile(int tile, int tile_rows, const ZBuffer *zb,
+          ZB_fillTriangleFunc fill_tri) const {
+  // Each tile gets its own copy of the ZBuffer structure, which shares the
+  // same frame buffer and depth buffer, but only draws its own scan lines.
+  ZBuffer tile_zb = *zb;
+  tile_zb.band_ymin = tile * tile_rows;
+  tile_zb.band_ymax = std::min(tile_zb.band_ymin + tile_rows, zb->ysize);
+
+  for (int ti : _bins[tile]) {
+    // The fill functions scribble on the points, and another thread may be
+    // drawing the same triangle at the same time, so make a copy.
+    Triangle tri = _triangles[ti];
+    (*fill_tri)(&tile_zb, &tri._p[0], &tri._p[1], &tri._p[2]);
+  }
+}
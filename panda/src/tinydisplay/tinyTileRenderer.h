@@ -0,0 +1,73 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file tinyTileRenderer.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef TINYTILERENDERER_H
+#define TINYTILERENDERER_H
+
+#include "pandabase.h"
+#include "zbuffer.h"
+#include "pvector.h"
+#include "pStatCollector.h"
+
+class Thread;
+
+/**
+ * Collects the triangles drawn by a TinyGraphicsStateGuardian between calls
+ * to flush(), and then rasterizes them on several threads at once.
+ *
+ * The frame buffer is divided into tiles, each of which spans the full width
+ * of the buffer and td-parallel-raster-rows pixels of its height, since the
+ * triangle fillers work one scan line at a time.  Each triangle is binned
+ * into the tiles that it overlaps, and each tile is then drawn by a single
+ * thread, in the order in which the triangles were added.  Since every pixel
+ * is written by only one thread, in the same order, the results are exactly
+ * the same as those of drawing the triangles directly.
+ *
+ * All of the triangles drawn between flushes must be rendered with the same
+ * state, since the ZBuffer and fill function are only consulted by flush().
+ */
+class EXPCL_TINYDISPLAY TinyTileRenderer {
+public:
+  TinyTileRenderer();
+
+  INLINE void add_triangle(const ZBufferPoint *p0, const ZBufferPoint *p1,
+                           const ZBufferPoint *p2);
+  INLINE size_t get_num_triangles() const;
+
+  void flush(ZBuffer *zb, ZB_fillTriangleFunc fill_tri,
+             Thread *current_thread);
+
+private:
+  void bin_triangles(int num_tiles, int tile_rows);
+  void draw_tile(int tile, int tile_rows, const ZBuffer *zb,
+                 ZB_fillTriangleFunc fill_tri) const;
+
+  class Triangle {
+  public:
+    ZBufferPoint _p[3];
+  };
+  typedef pvector<Triangle> Triangles;
+  Triangles _triangles;
+
+  // The indices of the triangles that overlap each tile.
+  typedef pvector<int> Bin;
+  typedef pvector<Bin> Bins;
+  Bins _bins;
+
+  static PStatCollector _bin_pcollector;
+  static PStatCollector _raster_pcollector;
+};
+
+#include "tinyTileRenderer.I"
+
+#endif
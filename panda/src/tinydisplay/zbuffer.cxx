@@ -7,26 +7,61 @@
 #include <stdio.h>
 #include <assert.h>
 #include <string.h>
+#include <math.h>
 #include "zbuffer.h"
 #include "pnotify.h"
 
 #ifdef DO_PSTATS
-int pixel_count_white_untextured;
-int pixel_count_flat_untextured;
-int pixel_count_smooth_untextured;
-int pixel_count_white_textured;
-int pixel_count_flat_textured;
-int pixel_count_smooth_textured;
-int pixel_count_white_perspective;
-int pixel_count_flat_perspective;
-int pixel_count_smooth_perspective;
-int pixel_count_smooth_multitex2;
-int pixel_count_smooth_multitex3;
+patomic<int> pixel_count_white_untextured(0);
+patomic<int> pixel_count_flat_untextured(0);
+patomic<int> pixel_count_smooth_untextured(0);
+patomic<int> pixel_count_white_textured(0);
+patomic<int> pixel_count_flat_textured(0);
+patomic<int> pixel_count_smooth_textured(0);
+patomic<int> pixel_count_white_perspective(0);
+patomic<int> pixel_count_flat_perspective(0);
+patomic<int> pixel_count_smooth_perspective(0);
+patomic<int> pixel_count_smooth_multitex2(0);
+patomic<int> pixel_count_smooth_multitex3(0);
+int hz_triangles_rejected;
 #endif  // DO_PSTATS
 
 using std::max;
 using std::min;
 
+/*
+ * Allocates the coarse depth buffer to match the size of the zbuffer.  If
+ * this fails, hierarchical z rejection is simply not performed.
+ */
+static void ZB_hzFree(ZBuffer *zb);
+
+static void
+ZB_hzAlloc(ZBuffer *zb) {
+  zb->hz_xsize = (zb->xsize + ZB_HZ_TILE_SIZE - 1) >> ZB_HZ_TILE_BITS;
+  zb->hz_ysize = (zb->ysize + ZB_HZ_TILE_SIZE - 1) >> ZB_HZ_TILE_BITS;
+
+  int num_tiles = zb->hz_xsize * zb->hz_ysize;
+  zb->hz_min = (ZPOINT *)gl_malloc(num_tiles * sizeof(ZPOINT));
+  zb->hz_state = (unsigned char *)gl_malloc(num_tiles);
+  if (zb->hz_min == nullptr || zb->hz_state == nullptr) {
+    ZB_hzFree(zb);
+    return;
+  }
+  ZB_hzInvalidate(zb);
+}
+
+static void
+ZB_hzFree(ZBuffer *zb) {
+  if (zb->hz_min != nullptr) {
+    gl_free(zb->hz_min);
+    zb->hz_min = nullptr;
+  }
+  if (zb->hz_state != nullptr) {
+    gl_free(zb->hz_state);
+    zb->hz_state = nullptr;
+  }
+}
+
 ZBuffer *
 ZB_open(int xsize, int ysize, int mode,
         int nb_colors,
@@ -48,6 +83,8 @@ ZB_open(int xsize, int ysize, int mode,
   zb->ysize = ysize;
   zb->mode = mode;
   zb->linesize = (xsize * PSZB + 3) & ~3;
+  zb->band_ymin = 0;
+  zb->band_ymax = ysize;
 
   switch (mode) {
 #ifdef TGL_FEATURE_8_BITS
@@ -86,6 +123,8 @@ ZB_open(int xsize, int ysize, int mode,
     zb->pbuf = (PIXEL *)frame_buffer;
   }
 
+  ZB_hzAlloc(zb);
+
   return zb;
  error:
   gl_free(zb);
@@ -102,6 +141,7 @@ ZB_close(ZBuffer * zb) {
   if (zb->frame_buffer_allocated)
     gl_free(zb->pbuf);
 
+  ZB_hzFree(zb);
   gl_free(zb->zbuf);
   gl_free(zb);
 }
@@ -118,6 +158,8 @@ ZB_resize(ZBuffer * zb, void *frame_buffer, int xsize, int ysize) {
   zb->xsize = xsize;
   zb->ysize = ysize;
   zb->linesize = (xsize * PSZB + 3) & ~3;
+  zb->band_ymin = 0;
+  zb->band_ymax = ysize;
 
   size = zb->xsize * zb->ysize * sizeof(ZPOINT);
   gl_free(zb->zbuf);
@@ -133,6 +175,9 @@ ZB_resize(ZBuffer * zb, void *frame_buffer, int xsize, int ysize) {
     zb->pbuf = (PIXEL *)frame_buffer;
     zb->frame_buffer_allocated = 0;
   }
+
+  ZB_hzFree(zb);
+  ZB_hzAlloc(zb);
 }
 
 static void
@@ -306,6 +351,8 @@ void ZB_zoomFrameBuffer(ZBuffer *dest, int dest_xmin, int dest_ymin, int dest_xs
       tz[tx] = fz[fx];
     }
   }
+
+  ZB_hzInvalidate(dest);
 }
 
 
@@ -395,6 +442,11 @@ ZB_clear(ZBuffer * zb, int clear_z, ZPOINT z, int clear_color, PIXEL color) {
 
   if (clear_z) {
     memset(zb->zbuf, 0, zb->xsize * zb->ysize * sizeof(ZPOINT));
+    if (zb->hz_min != nullptr) {
+      memset(zb->hz_min, 0, zb->hz_xsize * zb->hz_ysize * sizeof(ZPOINT));
+      memset(zb->hz_state, ZB_HZ_EXACT, zb->hz_xsize * zb->hz_ysize);
+      zb->hz_all_invalid = 0;
+    }
   }
   if (clear_color) {
     pp = zb->pbuf;
@@ -423,6 +475,29 @@ ZB_clear_viewport(ZBuffer * zb, int clear_z, ZPOINT z, int clear_color, PIXEL co
       memset(zz, 0, xsize * sizeof(ZPOINT));
       zz += zb->xsize;
     }
+
+    /* 0 is the lowest possible depth value, so it is the exact minimum of
+       the tiles that were entirely cleared, and a lower bound for the tiles
+       that were partially cleared. */
+    if (zb->hz_min != nullptr && xsize > 0 && ysize > 0 && !zb->hz_all_invalid) {
+      int xmax = xmin + xsize;
+      int ymax = ymin + ysize;
+      for (int ty = ymin >> ZB_HZ_TILE_BITS; ty <= (ymax - 1) >> ZB_HZ_TILE_BITS; ++ty) {
+        int y0 = ty << ZB_HZ_TILE_BITS;
+        int y1 = min(y0 + ZB_HZ_TILE_SIZE, zb->ysize);
+        for (int tx = xmin >> ZB_HZ_TILE_BITS; tx <= (xmax - 1) >> ZB_HZ_TILE_BITS; ++tx) {
+          int x0 = tx << ZB_HZ_TILE_BITS;
+          int x1 = min(x0 + ZB_HZ_TILE_SIZE, zb->xsize);
+          int i = ty * zb->hz_xsize + tx;
+          zb->hz_min[i] = 0;
+          if (x0 >= xmin && x1 <= xmax && y0 >= ymin && y1 <= ymax) {
+            zb->hz_state[i] = ZB_HZ_EXACT;
+          } else {
+            zb->hz_state[i] = max(zb->hz_state[i], (unsigned char)ZB_HZ_LOOSE);
+          }
+        }
+      }
+    }
   }
   if (clear_color) {
     pp = zb->pbuf + xmin + ymin * (zb->linesize / PSZB);
@@ -433,6 +508,160 @@ ZB_clear_viewport(ZBuffer * zb, int clear_z, ZPOINT z, int clear_color, PIXEL co
   }
 }
 
+/*
+ * Hierarchical z rejection.  The zbuffer is divided into square tiles of
+ * ZB_HZ_TILE_SIZE pixels, and for each tile we keep a lower bound on the
+ * depth values in that tile.  A triangle that is not nearer than that bound
+ * anywhere in any of the tiles it touches can't pass the depth test, so it
+ * need not be rasterized at all.
+ *
+ * Since drawing with the depth test enabled can only increase the depth
+ * values, the bounds stay valid while drawing such triangles; the tiles are
+ * merely marked ZB_HZ_LOOSE, to be tightened when this might help.  Anything
+ * else that writes to the zbuffer must mark the tiles it touches
+ * ZB_HZ_INVALID, or call ZB_hzInvalidate().
+ */
+
+/*
+ * Indicates that anything may have been written to the zbuffer, so that none
+ * of the tiles may be trusted until they are recomputed.
+ */
+void
+ZB_hzInvalidate(ZBuffer *zb) {
+  zb->hz_all_invalid = 1;
+}
+
+/*
+ * Computes the range of tiles covered by the bounding box of the triangle.
+ */
+static inline void
+ZB_hzTileRange(ZBuffer *zb, const ZBufferPoint *p0, const ZBufferPoint *p1, const ZBufferPoint *p2,
+               int &tx0, int &ty0, int &tx1, int &ty1) {
+  int xmin = min(min(p0->x, p1->x), p2->x);
+  int ymin = min(min(p0->y, p1->y), p2->y);
+  int xmax = max(max(p0->x, p1->x), p2->x);
+  int ymax = max(max(p0->y, p1->y), p2->y);
+
+  tx0 = max(xmin, 0) >> ZB_HZ_TILE_BITS;
+  ty0 = max(ymin, 0) >> ZB_HZ_TILE_BITS;
+  tx1 = min(xmax, zb->xsize - 1) >> ZB_HZ_TILE_BITS;
+  ty1 = min(ymax, zb->ysize - 1) >> ZB_HZ_TILE_BITS;
+}
+
+/*
+ * Recomputes the lowest depth value in the indicated tile.
+ */
+static void
+ZB_hzUpdateTile(ZBuffer *zb, int tx, int ty) {
+  int x0 = tx << ZB_HZ_TILE_BITS;
+  int y0 = ty << ZB_HZ_TILE_BITS;
+  int width = min(ZB_HZ_TILE_SIZE, zb->xsize - x0);
+  int height = min(ZB_HZ_TILE_SIZE, zb->ysize - y0);
+
+  ZPOINT zmin = ~(ZPOINT)0;
+  const ZPOINT *pz = zb->zbuf + x0 + y0 * zb->xsize;
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      zmin = min(zmin, pz[x]);
+    }
+    pz += zb->xsize;
+  }
+
+  int i = ty * zb->hz_xsize + tx;
+  zb->hz_min[i] = zmin;
+  zb->hz_state[i] = ZB_HZ_EXACT;
+}
+
+/*
+ * Returns 1 if the triangle is known to fail the depth test (with
+ * ZCMP(zpix, z) being zpix < z) for every pixel it covers, or 0 if it might
+ * be visible.  May update the coarse depth buffer as a side-effect.
+ */
+int
+ZB_hzTestTriangle(ZBuffer *zb, const ZBufferPoint *p0, const ZBufferPoint *p1, const ZBufferPoint *p2) {
+  if (zb->hz_min == nullptr) {
+    return 0;
+  }
+
+  /* The rasterizer interpolates the depth with truncated fixed-point
+     gradients, and may touch pixels that are up to one pixel outside the
+     triangle, so we must allow for the nearest depth value it may actually
+     produce to be somewhat nearer than the nearest vertex. */
+  double fdx1 = p1->x - p0->x;
+  double fdy1 = p1->y - p0->y;
+  double fdx2 = p2->x - p0->x;
+  double fdy2 = p2->y - p0->y;
+  double area = fdx1 * fdy2 - fdx2 * fdy1;
+  if (area == 0.0) {
+    return 0;
+  }
+  double d1 = (double)p1->z - (double)p0->z;
+  double d2 = (double)p2->z - (double)p0->z;
+  double dzdx = (fdy2 * d1 - fdy1 * d2) / area;
+  double dzdy = (fdx1 * d2 - fdx2 * d1) / area;
+
+  double zmax = (double)max(max(p0->z, p1->z), p2->z);
+  zmax += fabs(dzdx) + fabs(dzdy) + zb->xsize + zb->ysize + 2.0;
+  zmax /= (double)(1 << ZB_POINT_Z_FRAC_BITS);
+  if (zmax >= (double)0xffffffffU) {
+    return 0;
+  }
+  ZPOINT zz = (ZPOINT)zmax + 1;
+
+  if (zb->hz_all_invalid) {
+    memset(zb->hz_state, ZB_HZ_INVALID, zb->hz_xsize * zb->hz_ysize);
+    zb->hz_all_invalid = 0;
+  }
+
+  int tx0, ty0, tx1, ty1;
+  ZB_hzTileRange(zb, p0, p1, p2, tx0, ty0, tx1, ty1);
+
+  for (int ty = ty0; ty <= ty1; ++ty) {
+    for (int tx = tx0; tx <= tx1; ++tx) {
+      int i = ty * zb->hz_xsize + tx;
+      if (zb->hz_state[i] == ZB_HZ_INVALID) {
+        ZB_hzUpdateTile(zb, tx, ty);
+      }
+      if (zb->hz_min[i] < zz) {
+        /* The bound doesn't hide the triangle, but maybe it will if it is
+           made tighter. */
+        if (zb->hz_state[i] == ZB_HZ_EXACT) {
+          return 0;
+        }
+        ZB_hzUpdateTile(zb, tx, ty);
+        if (zb->hz_min[i] < zz) {
+          return 0;
+        }
+      }
+    }
+  }
+
+  return 1;
+}
+
+/*
+ * Should be called for each triangle that is drawn with depth writes
+ * enabled, to mark the tiles it touches with the indicated state:
+ * ZB_HZ_LOOSE if the triangle is drawn with the depth test, or
+ * ZB_HZ_INVALID if it is not.
+ */
+void
+ZB_hzMarkTriangle(ZBuffer *zb, const ZBufferPoint *p0, const ZBufferPoint *p1, const ZBufferPoint *p2, int state) {
+  if (zb->hz_min == nullptr || zb->hz_all_invalid) {
+    return;
+  }
+
+  int tx0, ty0, tx1, ty1;
+  ZB_hzTileRange(zb, p0, p1, p2, tx0, ty0, tx1, ty1);
+
+  for (int ty = ty0; ty <= ty1; ++ty) {
+    unsigned char *ps = zb->hz_state + ty * zb->hz_xsize;
+    for (int tx = tx0; tx <= tx1; ++tx) {
+      ps[tx] = max(ps[tx], (unsigned char)state);
+    }
+  }
+}
+
 #define ZB_ST_FRAC_HIGH (1 << ZB_POINT_ST_FRAC_BITS)
 #define ZB_ST_FRAC_MASK (ZB_ST_FRAC_HIGH - 1)
 
@@ -659,3 +888,45 @@ texcoord_mirror_once(int coord, int max_coord) {
   }
   return max(coord, 0);
 }
+
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+/* SSE2 support enabled at compile time.  No runtime detection mechanism
+   needed. */
+bool
+ZB_has_sse2() {
+  return true;
+}
+
+#elif defined(__i386__) || defined(_M_IX86)
+/* SSE2 support not guaranteed.  Use a runtime detection mechanism. */
+
+#ifdef __GNUC__
+#include <cpuid.h>
+#endif
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN 1
+#endif
+#include <windows.h>
+#endif
+
+bool
+ZB_has_sse2() {
+#if defined(__GNUC__)
+  unsigned int a, b, c, d;
+  static const bool has_support =
+    (__get_cpuid(1, &a, &b, &c, &d) == 1 && (d & 0x04000000) != 0);
+
+#elif defined(_WIN32)
+  static const bool has_support =
+    (IsProcessorFeaturePresent(PF_XMMI64_INSTRUCTIONS_AVAILABLE) != FALSE);
+
+#else
+  static const bool has_support = false;
+#endif
+
+  return has_support;
+}
+
+#endif
@@ -8,6 +8,7 @@
 #include "zfeatures.h"
 #include "pbitops.h"
 #include "srgb_tables.h"
+#include "patomic.h"
 
 typedef unsigned int ZPOINT;
 #define ZB_Z_BITS 20
@@ -51,6 +52,15 @@ typedef unsigned int ZPOINT;
     (mipmap_dx) &= ((1 << (((mipmap_level) - 1) + ZB_POINT_ST_FRAC_BITS)) - 1); \
   }
 
+/* The size of the tiles of the coarse depth buffer, as a power of 2. */
+#define ZB_HZ_TILE_BITS 3
+#define ZB_HZ_TILE_SIZE (1 << ZB_HZ_TILE_BITS)
+
+/* The states of a tile of the coarse depth buffer. */
+#define ZB_HZ_EXACT   0  /* hz_min is the lowest depth value in the tile */
+#define ZB_HZ_LOOSE   1  /* hz_min is a lower bound, but may be tightened */
+#define ZB_HZ_INVALID 2  /* hz_min must be recomputed before it is used */
+
 #define ZB_POINT_RED_MIN   0x0000
 #define ZB_POINT_RED_MAX   0xffff
 #define ZB_POINT_GREEN_MIN 0x0000
@@ -174,6 +184,17 @@ struct ZBuffer {
   int reference_alpha;
   int blend_r, blend_g, blend_b, blend_a;
   ZB_storePixelFunc store_pix_func;
+
+  /* the triangle fillers only draw the scan lines in [band_ymin, band_ymax);
+     this is normally the whole buffer, but see TinyTileRenderer */
+  int band_ymin, band_ymax;
+
+  /* coarse depth buffer used for hierarchical z rejection; see
+     ZB_hzTestTriangle() */
+  ZPOINT *hz_min;
+  unsigned char *hz_state;
+  int hz_xsize, hz_ysize;
+  int hz_all_invalid;
 };
 
 struct ZBufferPoint {
@@ -193,20 +214,23 @@ struct ZBufferPoint {
 /* zbuffer.c */
 
 #ifdef DO_PSTATS
-extern int pixel_count_white_untextured;
-extern int pixel_count_flat_untextured;
-extern int pixel_count_smooth_untextured;
-extern int pixel_count_white_textured;
-extern int pixel_count_flat_textured;
-extern int pixel_count_smooth_textured;
-extern int pixel_count_white_perspective;
-extern int pixel_count_flat_perspective;
-extern int pixel_count_smooth_perspective;
-extern int pixel_count_smooth_multitex2;
-extern int pixel_count_smooth_multitex3;
-
+extern patomic<int> pixel_count_white_untextured;
+extern patomic<int> pixel_count_flat_untextured;
+extern patomic<int> pixel_count_smooth_untextured;
+extern patomic<int> pixel_count_white_textured;
+extern patomic<int> pixel_count_flat_textured;
+extern patomic<int> pixel_count_smooth_textured;
+extern patomic<int> pixel_count_white_perspective;
+extern patomic<int> pixel_count_flat_perspective;
+extern patomic<int> pixel_count_smooth_perspective;
+extern patomic<int> pixel_count_smooth_multitex2;
+extern patomic<int> pixel_count_smooth_multitex3;
+extern int hz_triangles_rejected;
+
+/* the pixel counts are atomic, since the triangles may be drawn by several
+   threads at once; see TinyTileRenderer */
 #define COUNT_PIXELS(pixel_count, p0, p1, p2) \
-  (pixel_count) += abs((p0)->x * ((p1)->y - (p2)->y) + (p1)->x * ((p2)->y - (p0)->y) + (p2)->x * ((p0)->y - (p1)->y)) / 2
+  (pixel_count).fetch_add(abs((p0)->x * ((p1)->y - (p2)->y) + (p1)->x * ((p2)->y - (p0)->y) + (p2)->x * ((p0)->y - (p1)->y)) / 2, std::memory_order_relaxed)
 
 #else
 
@@ -224,6 +248,10 @@ ZBuffer *ZB_open(int xsize,int ysize,int mode,
 void ZB_close(ZBuffer *zb);
 
 void ZB_resize(ZBuffer *zb,void *frame_buffer,int xsize,int ysize);
+void ZB_hzInvalidate(ZBuffer *zb);
+int ZB_hzTestTriangle(ZBuffer *zb, const ZBufferPoint *p0, const ZBufferPoint *p1, const ZBufferPoint *p2);
+void ZB_hzMarkTriangle(ZBuffer *zb, const ZBufferPoint *p0, const ZBufferPoint *p1, const ZBufferPoint *p2, int state);
+
 void ZB_clear(ZBuffer *zb, int clear_z, ZPOINT z, int clear_color, PIXEL color);
 void ZB_clear_viewport(ZBuffer * zb, int clear_z, ZPOINT z, int clear_color, PIXEL color,
                        int xmin, int ymin, int xsize, int ysize);
@@ -235,6 +263,24 @@ PIXEL lookup_texture_mipmap_linear(ZTextureDef *texture_def, int s, int t, unsig
 PIXEL lookup_texture_mipmap_bilinear(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx);
 PIXEL lookup_texture_mipmap_trilinear(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx);
 
+/* These use SSE2 instructions, and may only be called if ZB_has_sse2()
+   returns true.  They produce the same results as the above. */
+#if defined(__SSE2__) || defined(__i386__) || defined(_M_IX86) || defined(_M_X64) || defined(_M_AMD64)
+#define ZB_HAVE_SSE2 1
+
+bool ZB_has_sse2();
+
+PIXEL lookup_texture_bilinear_sse2(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx);
+PIXEL lookup_texture_mipmap_linear_sse2(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx);
+PIXEL lookup_texture_mipmap_bilinear_sse2(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx);
+PIXEL lookup_texture_mipmap_trilinear_sse2(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx);
+
+/* Indexed by [depth_write][depth_test][texfilter][white, flat][untextured,
+   textured, perspective]; only for triangles without alpha test, writing the
+   color unmodified. */
+extern const ZB_fillTriangleFunc fill_tri_funcs_sse2[2][2][3][2][3];
+#endif
+
 PIXEL apply_wrap_general_minfilter(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx);
 PIXEL apply_wrap_general_magfilter(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx);
 
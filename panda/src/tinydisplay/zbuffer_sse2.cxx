@@ -0,0 +1,188 @@
+/*
+ * SSE2 versions of the texture filtering functions in zbuffer.cxx.
+ *
+ * This file should always be compiled with SSE2 support.  These functions
+ * will only be called when ZB_has_sse2() returns true.  They produce exactly
+ * the same results as their scalar counterparts.
+ */
+
+#include "zbuffer.h"
+
+using std::max;
+
+#define ZB_ST_FRAC_HIGH (1 << ZB_POINT_ST_FRAC_BITS)
+#define ZB_ST_FRAC_MASK (ZB_ST_FRAC_HIGH - 1)
+
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+
+#include <xmmintrin.h>
+#include <emmintrin.h>
+
+/*
+ * Computes (c * f) >> ZB_POINT_ST_FRAC_BITS for each of the 16-bit lanes,
+ * without losing the high bits of the intermediate product.
+ */
+static INLINE __m128i
+mul_shift_sse2(__m128i c, __m128i f) {
+  __m128i lo = _mm_mullo_epi16(c, f);
+  __m128i hi = _mm_mulhi_epu16(c, f);
+  return _mm_or_si128(_mm_slli_epi16(hi, 16 - ZB_POINT_ST_FRAC_BITS),
+                      _mm_srli_epi16(lo, ZB_POINT_ST_FRAC_BITS));
+}
+
+/*
+ * The equivalent of LINEAR_FILTER, applied to each of the 16-bit lanes.
+ */
+static INLINE __m128i
+linear_filter_sse2(__m128i c1, __m128i c2, __m128i f) {
+  __m128i g = _mm_sub_epi16(_mm_set1_epi16(ZB_ST_FRAC_HIGH), f);
+  return _mm_add_epi16(mul_shift_sse2(c2, f), mul_shift_sse2(c1, g));
+}
+
+/*
+ * Expands the two pixels into the 16-bit lanes of a vector, each component
+ * multiplied by 256, as the PIXEL_R() etc. macros do.
+ */
+static INLINE __m128i
+unpack_pixels_sse2(PIXEL p1, PIXEL p2) {
+  __m128i pp = _mm_unpacklo_epi32(_mm_cvtsi32_si128((int)p1),
+                                  _mm_cvtsi32_si128((int)p2));
+  return _mm_unpacklo_epi8(_mm_setzero_si128(), pp);
+}
+
+/*
+ * The inverse of unpack_pixels_sse2(), for the pixel in the lower half.
+ */
+static INLINE PIXEL
+pack_pixel_sse2(__m128i c) {
+  c = _mm_srli_epi16(c, 8);
+  return (PIXEL)_mm_cvtsi128_si32(_mm_packus_epi16(c, c));
+}
+
+/*
+ * The equivalent of LINEAR_FILTER, computed without SSE2.
+ */
+static INLINE unsigned int
+linear_filter_scalar(unsigned int c1, unsigned int c2, unsigned int f) {
+  return ((c2 * f) >> ZB_POINT_ST_FRAC_BITS) +
+    ((c1 * (ZB_ST_FRAC_HIGH - f)) >> ZB_POINT_ST_FRAC_BITS);
+}
+
+static INLINE PIXEL
+linear_filter_pixels_sse2(PIXEL p1, PIXEL p2, unsigned int f) {
+  if (f > ZB_ST_FRAC_HIGH) {
+    // The mipmap filters may ask for a factor greater than 1, which gives p1
+    // a negative weight.  The scalar versions compute this in 32-bit
+    // unsigned arithmetic, the result of which doesn't fit in the 16-bit
+    // lanes, so we have to do the same to get the same pixel.
+    return RGBA_TO_PIXEL(linear_filter_scalar(PIXEL_R(p1), PIXEL_R(p2), f),
+                         linear_filter_scalar(PIXEL_G(p1), PIXEL_G(p2), f),
+                         linear_filter_scalar(PIXEL_B(p1), PIXEL_B(p2), f),
+                         linear_filter_scalar(PIXEL_A(p1), PIXEL_A(p2), f));
+  }
+
+  __m128i c = unpack_pixels_sse2(p1, p2);
+  __m128i c2 = _mm_unpackhi_epi64(c, c);
+  return pack_pixel_sse2(linear_filter_sse2(c, c2, _mm_set1_epi16((short)f)));
+}
+
+static INLINE PIXEL
+bilinear_filter_pixels_sse2(PIXEL p1, PIXEL p2, PIXEL p3, PIXEL p4,
+                            int sf, int tf) {
+  // Filter the top and bottom rows at the same time, then filter the results
+  // together.
+  __m128i c13 = unpack_pixels_sse2(p1, p3);
+  __m128i c24 = unpack_pixels_sse2(p2, p4);
+  __m128i rows = linear_filter_sse2(c13, c24, _mm_set1_epi16((short)sf));
+  __m128i bottom = _mm_unpackhi_epi64(rows, rows);
+  return pack_pixel_sse2(linear_filter_sse2(rows, bottom, _mm_set1_epi16((short)tf)));
+}
+
+static INLINE PIXEL
+lookup_mipmap_bilinear_sse2(ZTextureDef *texture_def, int s, int t, unsigned int level) {
+  PIXEL p1, p2, p3, p4;
+
+  p1 = ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s - ZB_ST_FRAC_HIGH, t - ZB_ST_FRAC_HIGH, level);
+  p2 = ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t - ZB_ST_FRAC_HIGH, level);
+  p3 = ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s - ZB_ST_FRAC_HIGH, t, level);
+  p4 = ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level);
+
+  return bilinear_filter_pixels_sse2(p1, p2, p3, p4,
+                                     (s >> level) & ZB_ST_FRAC_MASK,
+                                     (t >> level) & ZB_ST_FRAC_MASK);
+}
+
+// Bilinear filter four texels in the base level.
+PIXEL
+lookup_texture_bilinear_sse2(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
+  PIXEL p1, p2, p3, p4;
+
+  p1 = ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s - ZB_ST_FRAC_HIGH, t - ZB_ST_FRAC_HIGH);
+  p2 = ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t - ZB_ST_FRAC_HIGH);
+  p3 = ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s - ZB_ST_FRAC_HIGH, t);
+  p4 = ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t);
+
+  return bilinear_filter_pixels_sse2(p1, p2, p3, p4,
+                                     s & ZB_ST_FRAC_MASK, t & ZB_ST_FRAC_MASK);
+}
+
+// Linear filter the two texels from the two nearest mipmap levels.
+PIXEL
+lookup_texture_mipmap_linear_sse2(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
+  PIXEL p1, p2;
+
+  p1 = ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level);
+  level = max((int)level - 1, 0);
+  p2 = ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level);
+
+  unsigned int f = level_dx >> (level - 1);
+  return linear_filter_pixels_sse2(p1, p2, f);
+}
+
+// Bilinear filter four texels in the nearest mipmap level.
+PIXEL
+lookup_texture_mipmap_bilinear_sse2(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
+  return lookup_mipmap_bilinear_sse2(texture_def, s, t, level);
+}
+
+// Bilinear filter four texels in each of the nearest two mipmap
+// levels, then linear filter them together.
+PIXEL
+lookup_texture_mipmap_trilinear_sse2(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
+  PIXEL p1a, p2a;
+
+  p1a = lookup_mipmap_bilinear_sse2(texture_def, s, t, level);
+  level = max((int)level - 1, 0);
+  p2a = lookup_mipmap_bilinear_sse2(texture_def, s, t, level);
+
+  unsigned int f = level_dx >> (level - 1);
+  return linear_filter_pixels_sse2(p1a, p2a, f);
+}
+
+#elif defined(__i386__) || defined(_M_IX86)
+// Somehow we ended up compiling this file without SSE2 support, even though
+// the header file told us we should have.  Fall back to the scalar versions,
+// but emit a warning that the build system isn't configured properly.
+#warning zbuffer_sse2.cxx is being compiled without SSE2 support!
+
+PIXEL
+lookup_texture_bilinear_sse2(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
+  return lookup_texture_bilinear(texture_def, s, t, level, level_dx);
+}
+
+PIXEL
+lookup_texture_mipmap_linear_sse2(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
+  return lookup_texture_mipmap_linear(texture_def, s, t, level, level_dx);
+}
+
+PIXEL
+lookup_texture_mipmap_bilinear_sse2(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
+  return lookup_texture_mipmap_bilinear(texture_def, s, t, level, level_dx);
+}
+
+PIXEL
+lookup_texture_mipmap_trilinear_sse2(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
+  return lookup_texture_mipmap_trilinear(texture_def, s, t, level, level_dx);
+}
+
+#endif
@@ -137,6 +137,7 @@ typedef struct GLTexture {
 } GLTexture;
 
 struct GLContext;
+class TinyTileRenderer;
 
 typedef void (*gl_draw_triangle_func)(struct GLContext *c,
                                       GLVertex *p0,GLVertex *p1,GLVertex *p2);
@@ -185,6 +186,16 @@ typedef struct GLContext {
   gl_draw_triangle_func draw_triangle_front,draw_triangle_back;
   ZB_fillTriangleFunc zb_fill_tri;
 
+  /* if not null, filled triangles are passed to this instead of being drawn
+     immediately */
+  TinyTileRenderer *tile_renderer;
+
+  /* hierarchical z rejection: whether filled triangles should be tested
+     against the coarse depth buffer, and the ZB_HZ_* state to mark the tiles
+     they touch with, or -1 if they don't write depth */
+  int hz_test;
+  int hz_mark_state;
+
   /* current vertex state */
   V4 current_color;
   V4 current_normal;
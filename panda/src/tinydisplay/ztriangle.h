@@ -8,6 +8,7 @@
   ZPOINT *pz1;
   PIXEL *pp1;
   int part, update_left, update_right;
+  int y;
 
   int nb_lines, dx1, dy1, tmp, dx2, dy2;
 
@@ -53,8 +54,6 @@
 
   EARLY_OUT();
 
-  COUNT_PIXELS(PIXEL_COUNT, p0, p1, p2);
-
   /* we sort the vertex with increasing y */
   if (p1->y < p0->y) {
     t = p0;
@@ -72,6 +71,12 @@
     p2 = t;
   }
 
+  /* when the triangle is drawn in bands, only count it in the band that
+     contains its top vertex */
+  if (p0->y >= zb->band_ymin) {
+    COUNT_PIXELS(PIXEL_COUNT, p0, p1, p2);
+  }
+
   /* we compute dXdx and dXdy for all interpolated values */
   
   fdx1 = (PN_stdfloat) (p1->x - p0->x);
@@ -216,6 +221,7 @@
 
   DRAW_INIT();
 
+  y = p0->y;
   for(part=0;part<2;part++) {
     if (part == 0) {
       if (fz > 0) {
@@ -337,9 +343,87 @@
       x2 = pr1->x << 16;
     }
 
+    /* when the triangle is drawn in bands, skip straight to the first scan
+       line of the band.  The integer interpolants take one step of
+       dXdl_max for every carry out of the left edge error term, so we can
+       advance them all at once; the floating-point ones are stepped one
+       line at a time, so that they round exactly as they would otherwise */
+
+    if (y < zb->band_ymin && nb_lines > 0) {
+      int nb_skip, nb_carry;
+      nb_skip = zb->band_ymin - y;
+      if (nb_skip > nb_lines) {
+        nb_skip = nb_lines;
+      }
+#if defined(INTERP_STZ) || defined(INTERP_STZA) || defined(INTERP_STZB)
+      {
+        int n, e = error;
+        for (n = 0; n < nb_skip; ++n) {
+          e += derror;
+          if (e > 0) {
+            e -= 0x10000;
+#ifdef INTERP_STZ
+            sz1+=dszdl_max;
+            tz1+=dtzdl_max;
+#endif
+#ifdef INTERP_STZA
+            sza1+=dszadl_max;
+            tza1+=dtzadl_max;
+#endif
+#ifdef INTERP_STZB
+            szb1+=dszbdl_max;
+            tzb1+=dtzbdl_max;
+#endif
+          } else {
+#ifdef INTERP_STZ
+            sz1+=dszdl_min;
+            tz1+=dtzdl_min;
+#endif
+#ifdef INTERP_STZA
+            sza1+=dszadl_min;
+            tza1+=dtzadl_min;
+#endif
+#ifdef INTERP_STZB
+            szb1+=dszbdl_min;
+            tzb1+=dtzbdl_min;
+#endif
+          }
+        }
+      }
+#endif
+      error += nb_skip * derror;
+      nb_carry = (error + 0xffff) >> 16;
+      error -= nb_carry << 16;
+
+      x1 += nb_skip * dxdy_min + nb_carry;
+#ifdef INTERP_Z
+      z1 += nb_skip * dzdl_min + nb_carry * dzdx;
+#endif
+#ifdef INTERP_RGB
+      r1 += nb_skip * drdl_min + nb_carry * drdx;
+      g1 += nb_skip * dgdl_min + nb_carry * dgdx;
+      b1 += nb_skip * dbdl_min + nb_carry * dbdx;
+      a1 += nb_skip * dadl_min + nb_carry * dadx;
+#endif
+#ifdef INTERP_ST
+      s1 += nb_skip * dsdl_min + nb_carry * dsdx;
+      t1 += nb_skip * dtdl_min + nb_carry * dtdx;
+#endif
+      x2 += nb_skip * dx2dy2;
+
+      pp1 = (PIXEL *)((char *)pp1 + nb_skip * zb->linesize);
+      pz1 += nb_skip * zb->xsize;
+      y += nb_skip;
+      nb_lines -= nb_skip;
+    }
+
     /* we draw all the scan line of the part */
 
     while (nb_lines>0) {
+      if (y >= zb->band_ymax) {
+        /* the rest of the triangle belongs to the bands below this one */
+        return;
+      }
       nb_lines--;
 #ifndef DRAW_LINE
       /* generic draw line */
@@ -417,6 +501,7 @@
 #else
       DRAW_LINE();
 #endif
+      y++;
       
       /* left edge */
       error+=derror;
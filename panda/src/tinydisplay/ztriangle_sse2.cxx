@@ -0,0 +1,514 @@
+/*
+ * SSE2 versions of the white and flat triangle fillers, untextured and with a
+ * single texture, which depth test and write four pixels of each span at a
+ * time.
+ *
+ * This file should always be compiled with SSE2 support.  These functions
+ * will only be called when ZB_has_sse2() returns true.  They produce exactly
+ * the same results as the generated functions in ztriangle_code_*.h.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "pandabase.h"
+#include "zbuffer.h"
+
+#ifdef ZB_HAVE_SSE2
+
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#define USE_SSE2_INTRINSICS 1
+#else
+// Somehow we ended up compiling this file without SSE2 support, even though
+// the header file told us we should have.  Fall back to scalar code, but emit
+// a warning that the build system isn't configured properly.
+#warning ztriangle_sse2.cxx is being compiled without SSE2 support!
+#endif
+
+#ifdef USE_SSE2_INTRINSICS
+/*
+ * Returns the depth values of the four pixels of a span, and fills in mask
+ * with the pixels that pass the depth test.  The return value is the result
+ * of _mm_movemask_epi8() on the mask.
+ */
+template<bool depth_test>
+static INLINE int
+test_depth_sse2(const ZPOINT *pz, __m128i zz, __m128i &mask, __m128i &old_z) {
+  if (!depth_test) {
+    mask = _mm_set1_epi32(-1);
+    old_z = mask;
+    return 0xffff;
+  }
+
+  // ZPOINT is unsigned, but SSE2 only has a signed comparison; flipping the
+  // sign bit of both operands gives the same result.
+  const __m128i sign = _mm_set1_epi32((int)0x80000000);
+  old_z = _mm_loadu_si128((const __m128i *)pz);
+  mask = _mm_cmpgt_epi32(_mm_xor_si128(zz, sign), _mm_xor_si128(old_z, sign));
+  return _mm_movemask_epi8(mask);
+}
+
+/*
+ * Writes the four pixels of a span that passed test_depth_sse2(), leaving the
+ * others unchanged.
+ */
+template<bool depth_write>
+static INLINE void
+store_pixels_sse2(PIXEL *pp, ZPOINT *pz, __m128i colors, __m128i zz,
+                  __m128i mask, __m128i old_z, int bits) {
+  if (bits == 0xffff) {
+    _mm_storeu_si128((__m128i *)pp, colors);
+    if (depth_write) {
+      _mm_storeu_si128((__m128i *)pz, zz);
+    }
+  } else {
+    __m128i old_pix = _mm_loadu_si128((const __m128i *)pp);
+    _mm_storeu_si128((__m128i *)pp,
+                     _mm_or_si128(_mm_and_si128(mask, colors),
+                                  _mm_andnot_si128(mask, old_pix)));
+    if (depth_write) {
+      _mm_storeu_si128((__m128i *)pz,
+                       _mm_or_si128(_mm_and_si128(mask, zz),
+                                    _mm_andnot_si128(mask, old_z)));
+    }
+  }
+}
+
+/*
+ * Returns the value of an interpolant at each of the first four pixels of a
+ * span, relative to the first.
+ */
+static INLINE __m128i
+span_steps_sse2(int d) {
+  unsigned int ud = (unsigned int)d;
+  return _mm_setr_epi32(0, (int)ud, (int)(ud * 2), (int)(ud * 3));
+}
+
+/*
+ * Returns the indices of the four texels at the given coordinates, as
+ * ZB_TEXEL() computes them.
+ */
+static INLINE __m128i
+texel_index_sse2(const ZTextureLevel &level, __m128i s, __m128i t) {
+  __m128i ti = _mm_srl_epi32(_mm_and_si128(t, _mm_set1_epi32((int)level.t_mask)),
+                             _mm_cvtsi32_si128((int)level.t_shift));
+  __m128i si = _mm_srl_epi32(_mm_and_si128(s, _mm_set1_epi32((int)level.s_mask)),
+                             _mm_cvtsi32_si128((int)level.s_shift));
+  return _mm_or_si128(ti, si);
+}
+
+/*
+ * Fetches the four texels at the given coordinates of the indicated level.
+ * SSE2 has no gather instruction, so only the addressing is vectorized.
+ */
+static INLINE __m128i
+fetch_texels_sse2(const ZTextureLevel &level, __m128i s, __m128i t) {
+  __m128i index = texel_index_sse2(level, s, t);
+  const PIXEL *pixmap = level.pixmap;
+  PIXEL p0 = pixmap[(unsigned int)_mm_cvtsi128_si32(index)];
+  PIXEL p1 = pixmap[(unsigned int)_mm_cvtsi128_si32(_mm_shuffle_epi32(index, 0x55))];
+  PIXEL p2 = pixmap[(unsigned int)_mm_cvtsi128_si32(_mm_shuffle_epi32(index, 0xaa))];
+  PIXEL p3 = pixmap[(unsigned int)_mm_cvtsi128_si32(_mm_shuffle_epi32(index, 0xff))];
+  return _mm_setr_epi32((int)p0, (int)p1, (int)p2, (int)p3);
+}
+
+/*
+ * The four-pixel equivalents of ZB_LOOKUP_TEXTURE for each of the texture
+ * filter modes in ztriangle.py.
+ */
+static INLINE __m128i
+lookup_texels_nearest_sse2(ZTextureDef *texture_def, __m128i s, __m128i t,
+                           unsigned int level, unsigned int level_dx) {
+  return fetch_texels_sse2(texture_def->levels[0], s, t);
+}
+
+static INLINE __m128i
+lookup_texels_mipmap_sse2(ZTextureDef *texture_def, __m128i s, __m128i t,
+                          unsigned int level, unsigned int level_dx) {
+  return fetch_texels_sse2(texture_def->levels[level], s, t);
+}
+
+static INLINE __m128i
+lookup_texels_general_sse2(ZTextureDef *texture_def, __m128i s, __m128i t,
+                           unsigned int level, unsigned int level_dx) {
+  ZB_lookupTextureFunc func = (level == 0) ? texture_def->tex_magfilter_func
+                                           : texture_def->tex_minfilter_func;
+  PIXEL p[4];
+  for (int i = 0; i < 4; ++i) {
+    p[i] = (*func)(texture_def, _mm_cvtsi128_si32(s), _mm_cvtsi128_si32(t),
+                   level, level_dx);
+    s = _mm_srli_si128(s, 4);
+    t = _mm_srli_si128(t, 4);
+  }
+  return _mm_setr_epi32((int)p[0], (int)p[1], (int)p[2], (int)p[3]);
+}
+
+/*
+ * Returns the flat color in the form expected by modulate_texels_sse2().  The
+ * components must be in the range 0 .. 0xffff.
+ */
+static INLINE __m128i
+modulate_color_sse2(int r, int g, int b, int a) {
+  // PALPHA_MULT() drops the lower two bits of the alpha.
+  a &= ~3;
+  return _mm_setr_epi16((short)b, (short)g, (short)r, (short)a,
+                        (short)b, (short)g, (short)r, (short)a);
+}
+
+/*
+ * Multiplies each of the four texels by the flat color, giving the same
+ * result as PCOMPONENT_MULT() and PALPHA_MULT() do in the flat textured
+ * fillers.
+ */
+static INLINE __m128i
+modulate_texels_sse2(__m128i texels, __m128i color) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i lo = _mm_mulhi_epu16(_mm_unpacklo_epi8(texels, zero), color);
+  __m128i hi = _mm_mulhi_epu16(_mm_unpackhi_epi8(texels, zero), color);
+  return _mm_packus_epi16(lo, hi);
+}
+#endif  // USE_SSE2_INTRINSICS
+
+/*
+ * Fills n pixels of a single span with the indicated color, interpolating
+ * the depth value and performing the depth test and write as indicated.
+ */
+template<bool depth_write, bool depth_test>
+static INLINE void
+fill_span_sse2(PIXEL *pp, ZPOINT *pz, int n, unsigned int z, int dzdx,
+               PIXEL color) {
+#ifdef USE_SSE2_INTRINSICS
+  if (n >= 4) {
+    const __m128i colorv = _mm_set1_epi32((int)color);
+    const __m128i dz4 = _mm_set1_epi32((int)((unsigned int)dzdx * 4));
+    __m128i zv = _mm_add_epi32(_mm_set1_epi32((int)z), span_steps_sse2(dzdx));
+
+    do {
+      __m128i zz = _mm_srli_epi32(zv, ZB_POINT_Z_FRAC_BITS);
+      __m128i mask, old_z;
+      int bits = test_depth_sse2<depth_test>(pz, zz, mask, old_z);
+      if (bits != 0) {
+        store_pixels_sse2<depth_write>(pp, pz, colorv, zz, mask, old_z, bits);
+      }
+
+      zv = _mm_add_epi32(zv, dz4);
+      pp += 4;
+      pz += 4;
+      n -= 4;
+    } while (n >= 4);
+
+    z = (unsigned int)_mm_cvtsi128_si32(zv);
+  }
+#endif  // USE_SSE2_INTRINSICS
+
+  while (n > 0) {
+    ZPOINT zz = z >> ZB_POINT_Z_FRAC_BITS;
+    if (!depth_test || *pz < zz) {
+      *pp = color;
+      if (depth_write) {
+        *pz = zz;
+      }
+    }
+    z += dzdx;
+    ++pp;
+    ++pz;
+    --n;
+  }
+}
+
+#define DEPTH_WRITE true
+#define DEPTH_TEST false
+#define FNAME(name) FB_triangle_sse2_zon_znone_ ## name
+#include "ztriangle_two_sse2.h"
+
+#define DEPTH_WRITE true
+#define DEPTH_TEST true
+#define FNAME(name) FB_triangle_sse2_zon_zless_ ## name
+#include "ztriangle_two_sse2.h"
+
+#define DEPTH_WRITE false
+#define DEPTH_TEST false
+#define FNAME(name) FB_triangle_sse2_zoff_znone_ ## name
+#include "ztriangle_two_sse2.h"
+
+#define DEPTH_WRITE false
+#define DEPTH_TEST true
+#define FNAME(name) FB_triangle_sse2_zoff_zless_ ## name
+#include "ztriangle_two_sse2.h"
+
+/*
+ * The textured fillers are generated once for each texture filter mode, with
+ * the same definitions of CALC_MIPMAP_LEVEL and ZB_LOOKUP_TEXTURE as in
+ * ztriangle.py.  We always define INTERP_MIPMAP, so that the mipmap_level
+ * variables exist; it is simply left at 0 for tnearest.
+ */
+
+#define DEPTH_WRITE true
+#define DEPTH_TEST false
+#define INTERP_MIPMAP
+#define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
+#define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
+#define LOOKUP_TEXELS lookup_texels_nearest_sse2
+#define FNAME(name) FB_triangle_sse2_zon_znone_tnearest_ ## name
+#include "ztriangle_textured_sse2.h"
+
+#define DEPTH_WRITE true
+#define DEPTH_TEST false
+#define INTERP_MIPMAP
+#define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
+#define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
+#define LOOKUP_TEXELS lookup_texels_mipmap_sse2
+#define FNAME(name) FB_triangle_sse2_zon_znone_tmipmap_ ## name
+#include "ztriangle_textured_sse2.h"
+
+#define DEPTH_WRITE true
+#define DEPTH_TEST false
+#define INTERP_MIPMAP
+#define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
+#define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
+#define LOOKUP_TEXELS lookup_texels_general_sse2
+#define FNAME(name) FB_triangle_sse2_zon_znone_tgeneral_ ## name
+#include "ztriangle_textured_sse2.h"
+
+#define DEPTH_WRITE true
+#define DEPTH_TEST true
+#define INTERP_MIPMAP
+#define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
+#define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
+#define LOOKUP_TEXELS lookup_texels_nearest_sse2
+#define FNAME(name) FB_triangle_sse2_zon_zless_tnearest_ ## name
+#include "ztriangle_textured_sse2.h"
+
+#define DEPTH_WRITE true
+#define DEPTH_TEST true
+#define INTERP_MIPMAP
+#define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
+#define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
+#define LOOKUP_TEXELS lookup_texels_mipmap_sse2
+#define FNAME(name) FB_triangle_sse2_zon_zless_tmipmap_ ## name
+#include "ztriangle_textured_sse2.h"
+
+#define DEPTH_WRITE true
+#define DEPTH_TEST true
+#define INTERP_MIPMAP
+#define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
+#define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
+#define LOOKUP_TEXELS lookup_texels_general_sse2
+#define FNAME(name) FB_triangle_sse2_zon_zless_tgeneral_ ## name
+#include "ztriangle_textured_sse2.h"
+
+#define DEPTH_WRITE false
+#define DEPTH_TEST false
+#define INTERP_MIPMAP
+#define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
+#define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
+#define LOOKUP_TEXELS lookup_texels_nearest_sse2
+#define FNAME(name) FB_triangle_sse2_zoff_znone_tnearest_ ## name
+#include "ztriangle_textured_sse2.h"
+
+#define DEPTH_WRITE false
+#define DEPTH_TEST false
+#define INTERP_MIPMAP
+#define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
+#define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
+#define LOOKUP_TEXELS lookup_texels_mipmap_sse2
+#define FNAME(name) FB_triangle_sse2_zoff_znone_tmipmap_ ## name
+#include "ztriangle_textured_sse2.h"
+
+#define DEPTH_WRITE false
+#define DEPTH_TEST false
+#define INTERP_MIPMAP
+#define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
+#define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
+#define LOOKUP_TEXELS lookup_texels_general_sse2
+#define FNAME(name) FB_triangle_sse2_zoff_znone_tgeneral_ ## name
+#include "ztriangle_textured_sse2.h"
+
+#define DEPTH_WRITE false
+#define DEPTH_TEST true
+#define INTERP_MIPMAP
+#define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
+#define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
+#define LOOKUP_TEXELS lookup_texels_nearest_sse2
+#define FNAME(name) FB_triangle_sse2_zoff_zless_tnearest_ ## name
+#include "ztriangle_textured_sse2.h"
+
+#define DEPTH_WRITE false
+#define DEPTH_TEST true
+#define INTERP_MIPMAP
+#define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
+#define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_MIPMAP_NEAREST(texture_def, s, t, level)
+#define LOOKUP_TEXELS lookup_texels_mipmap_sse2
+#define FNAME(name) FB_triangle_sse2_zoff_zless_tmipmap_ ## name
+#include "ztriangle_textured_sse2.h"
+
+#define DEPTH_WRITE false
+#define DEPTH_TEST true
+#define INTERP_MIPMAP
+#define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx) DO_CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
+#define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ((level == 0) ? (texture_def)->tex_magfilter_func(texture_def, s, t, level, level_dx) : (texture_def)->tex_minfilter_func(texture_def, s, t, level, level_dx))
+#define LOOKUP_TEXELS lookup_texels_general_sse2
+#define FNAME(name) FB_triangle_sse2_zoff_zless_tgeneral_ ## name
+#include "ztriangle_textured_sse2.h"
+
+const ZB_fillTriangleFunc fill_tri_funcs_sse2[2][2][3][2][3] = {
+  {
+    {
+      {
+        {
+          FB_triangle_sse2_zon_znone_white_untextured,
+          FB_triangle_sse2_zon_znone_tnearest_white_textured,
+          FB_triangle_sse2_zon_znone_tnearest_white_perspective,
+        },
+        {
+          FB_triangle_sse2_zon_znone_flat_untextured,
+          FB_triangle_sse2_zon_znone_tnearest_flat_textured,
+          FB_triangle_sse2_zon_znone_tnearest_flat_perspective,
+        },
+      },
+      {
+        {
+          FB_triangle_sse2_zon_znone_white_untextured,
+          FB_triangle_sse2_zon_znone_tmipmap_white_textured,
+          FB_triangle_sse2_zon_znone_tmipmap_white_perspective,
+        },
+        {
+          FB_triangle_sse2_zon_znone_flat_untextured,
+          FB_triangle_sse2_zon_znone_tmipmap_flat_textured,
+          FB_triangle_sse2_zon_znone_tmipmap_flat_perspective,
+        },
+      },
+      {
+        {
+          FB_triangle_sse2_zon_znone_white_untextured,
+          FB_triangle_sse2_zon_znone_tgeneral_white_textured,
+          FB_triangle_sse2_zon_znone_tgeneral_white_perspective,
+        },
+        {
+          FB_triangle_sse2_zon_znone_flat_untextured,
+          FB_triangle_sse2_zon_znone_tgeneral_flat_textured,
+          FB_triangle_sse2_zon_znone_tgeneral_flat_perspective,
+        },
+      },
+    },
+    {
+      {
+        {
+          FB_triangle_sse2_zon_zless_white_untextured,
+          FB_triangle_sse2_zon_zless_tnearest_white_textured,
+          FB_triangle_sse2_zon_zless_tnearest_white_perspective,
+        },
+        {
+          FB_triangle_sse2_zon_zless_flat_untextured,
+          FB_triangle_sse2_zon_zless_tnearest_flat_textured,
+          FB_triangle_sse2_zon_zless_tnearest_flat_perspective,
+        },
+      },
+      {
+        {
+          FB_triangle_sse2_zon_zless_white_untextured,
+          FB_triangle_sse2_zon_zless_tmipmap_white_textured,
+          FB_triangle_sse2_zon_zless_tmipmap_white_perspective,
+        },
+        {
+          FB_triangle_sse2_zon_zless_flat_untextured,
+          FB_triangle_sse2_zon_zless_tmipmap_flat_textured,
+          FB_triangle_sse2_zon_zless_tmipmap_flat_perspective,
+        },
+      },
+      {
+        {
+          FB_triangle_sse2_zon_zless_white_untextured,
+          FB_triangle_sse2_zon_zless_tgeneral_white_textured,
+          FB_triangle_sse2_zon_zless_tgeneral_white_perspective,
+        },
+        {
+          FB_triangle_sse2_zon_zless_flat_untextured,
+          FB_triangle_sse2_zon_zless_tgeneral_flat_textured,
+          FB_triangle_sse2_zon_zless_tgeneral_flat_perspective,
+        },
+      },
+    },
+  },
+  {
+    {
+      {
+        {
+          FB_triangle_sse2_zoff_znone_white_untextured,
+          FB_triangle_sse2_zoff_znone_tnearest_white_textured,
+          FB_triangle_sse2_zoff_znone_tnearest_white_perspective,
+        },
+        {
+          FB_triangle_sse2_zoff_znone_flat_untextured,
+          FB_triangle_sse2_zoff_znone_tnearest_flat_textured,
+          FB_triangle_sse2_zoff_znone_tnearest_flat_perspective,
+        },
+      },
+      {
+        {
+          FB_triangle_sse2_zoff_znone_white_untextured,
+          FB_triangle_sse2_zoff_znone_tmipmap_white_textured,
+          FB_triangle_sse2_zoff_znone_tmipmap_white_perspective,
+        },
+        {
+          FB_triangle_sse2_zoff_znone_flat_untextured,
+          FB_triangle_sse2_zoff_znone_tmipmap_flat_textured,
+          FB_triangle_sse2_zoff_znone_tmipmap_flat_perspective,
+        },
+      },
+      {
+        {
+          FB_triangle_sse2_zoff_znone_white_untextured,
+          FB_triangle_sse2_zoff_znone_tgeneral_white_textured,
+          FB_triangle_sse2_zoff_znone_tgeneral_white_perspective,
+        },
+        {
+          FB_triangle_sse2_zoff_znone_flat_untextured,
+          FB_triangle_sse2_zoff_znone_tgeneral_flat_textured,
+          FB_triangle_sse2_zoff_znone_tgeneral_flat_perspective,
+        },
+      },
+    },
+    {
+      {
+        {
+          FB_triangle_sse2_zoff_zless_white_untextured,
+          FB_triangle_sse2_zoff_zless_tnearest_white_textured,
+          FB_triangle_sse2_zoff_zless_tnearest_white_perspective,
+        },
+        {
+          FB_triangle_sse2_zoff_zless_flat_untextured,
+          FB_triangle_sse2_zoff_zless_tnearest_flat_textured,
+          FB_triangle_sse2_zoff_zless_tnearest_flat_perspective,
+        },
+      },
+      {
+        {
+          FB_triangle_sse2_zoff_zless_white_untextured,
+          FB_triangle_sse2_zoff_zless_tmipmap_white_textured,
+          FB_triangle_sse2_zoff_zless_tmipmap_white_perspective,
+        },
+        {
+          FB_triangle_sse2_zoff_zless_flat_untextured,
+          FB_triangle_sse2_zoff_zless_tmipmap_flat_textured,
+          FB_triangle_sse2_zoff_zless_tmipmap_flat_perspective,
+        },
+      },
+      {
+        {
+          FB_triangle_sse2_zoff_zless_white_untextured,
+          FB_triangle_sse2_zoff_zless_tgeneral_white_textured,
+          FB_triangle_sse2_zoff_zless_tgeneral_white_perspective,
+        },
+        {
+          FB_triangle_sse2_zoff_zless_flat_untextured,
+          FB_triangle_sse2_zoff_zless_tgeneral_flat_textured,
+          FB_triangle_sse2_zoff_zless_tgeneral_flat_perspective,
+        },
+      },
+    },
+  },
+};
+
+#endif  // ZB_HAVE_SSE2
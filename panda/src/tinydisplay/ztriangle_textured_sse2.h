@@ -0,0 +1,298 @@
+/*
+ * SSE2 versions of the white and flat textured triangle fillers in
+ * ztriangle_two.h, both with and without perspective correction.  These are
+ * included once for each combination of DEPTH_WRITE, DEPTH_TEST and texture
+ * filter, by ztriangle_sse2.cxx.
+ */
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wunused-but-set-variable"
+#endif
+
+#ifndef NB_INTERP
+#define NB_INTERP 8
+#endif
+
+/*
+ * Draws n pixels of a single textured span.  If rgba is not NULL, the texels
+ * are modulated by the indicated flat color.  The interpolants are left
+ * pointing just past the end of the span.
+ */
+static INLINE void
+FNAME(textured_span) (PIXEL *pp, ZPOINT *pz, int n,
+                      unsigned int &z, int dzdx,
+                      unsigned int &s, int dsdx, unsigned int &t, int dtdx,
+                      ZTextureDef *texture_def,
+                      unsigned int mipmap_level, unsigned int mipmap_dx,
+                      const int *rgba)
+{
+#ifdef USE_SSE2_INTRINSICS
+  // The vector modulate is only exact for colors in the normal range, which
+  // is all we ever get, except from out-of-range vertex colors.
+  if (n >= 4 &&
+      (rgba == nullptr ||
+       ((unsigned int)rgba[0] <= 0xffff && (unsigned int)rgba[1] <= 0xffff &&
+        (unsigned int)rgba[2] <= 0xffff && (unsigned int)rgba[3] <= 0xffff))) {
+    __m128i color = _mm_setzero_si128();
+    if (rgba != nullptr) {
+      color = modulate_color_sse2(rgba[0], rgba[1], rgba[2], rgba[3]);
+    }
+    __m128i zv = _mm_add_epi32(_mm_set1_epi32((int)z), span_steps_sse2(dzdx));
+    __m128i sv = _mm_add_epi32(_mm_set1_epi32((int)s), span_steps_sse2(dsdx));
+    __m128i tv = _mm_add_epi32(_mm_set1_epi32((int)t), span_steps_sse2(dtdx));
+    const __m128i dz4 = _mm_set1_epi32((int)((unsigned int)dzdx * 4));
+    const __m128i ds4 = _mm_set1_epi32((int)((unsigned int)dsdx * 4));
+    const __m128i dt4 = _mm_set1_epi32((int)((unsigned int)dtdx * 4));
+
+    do {
+      __m128i zz = _mm_srli_epi32(zv, ZB_POINT_Z_FRAC_BITS);
+      __m128i mask, old_z;
+      int bits = test_depth_sse2<DEPTH_TEST>(pz, zz, mask, old_z);
+      if (bits != 0) {
+        // Only look up the texels if at least one of them will be visible.
+        __m128i texels = LOOKUP_TEXELS(texture_def, sv, tv, mipmap_level, mipmap_dx);
+        if (rgba != nullptr) {
+          texels = modulate_texels_sse2(texels, color);
+        }
+        store_pixels_sse2<DEPTH_WRITE>(pp, pz, texels, zz, mask, old_z, bits);
+      }
+
+      zv = _mm_add_epi32(zv, dz4);
+      sv = _mm_add_epi32(sv, ds4);
+      tv = _mm_add_epi32(tv, dt4);
+      pp += 4;
+      pz += 4;
+      n -= 4;
+    } while (n >= 4);
+
+    z = (unsigned int)_mm_cvtsi128_si32(zv);
+    s = (unsigned int)_mm_cvtsi128_si32(sv);
+    t = (unsigned int)_mm_cvtsi128_si32(tv);
+  }
+#endif  // USE_SSE2_INTRINSICS
+
+  while (n > 0) {
+    ZPOINT zz = z >> ZB_POINT_Z_FRAC_BITS;
+    if (!DEPTH_TEST || *pz < zz) {
+      PIXEL tmp = ZB_LOOKUP_TEXTURE(texture_def, s, t, mipmap_level, mipmap_dx);
+      if (rgba != nullptr) {
+        tmp = RGBA_TO_PIXEL(PCOMPONENT_MULT(rgba[0], PIXEL_R(tmp)),
+                            PCOMPONENT_MULT(rgba[1], PIXEL_G(tmp)),
+                            PCOMPONENT_MULT(rgba[2], PIXEL_B(tmp)),
+                            PALPHA_MULT(rgba[3], PIXEL_A(tmp)));
+      }
+      *pp = tmp;
+      if (DEPTH_WRITE) {
+        *pz = zz;
+      }
+    }
+    z += dzdx;
+    s += dsdx;
+    t += dtdx;
+    ++pp;
+    ++pz;
+    --n;
+  }
+}
+
+static void
+FNAME(white_textured) (ZBuffer *zb,
+                       ZBufferPoint *p0,ZBufferPoint *p1,ZBufferPoint *p2)
+{
+  ZTextureDef *texture_def;
+
+#define INTERP_Z
+#define INTERP_ST
+
+#define EARLY_OUT()                             \
+  {                                             \
+  }
+
+#define DRAW_INIT()                             \
+  {                                             \
+    texture_def = &zb->current_textures[0];     \
+  }
+
+#define DRAW_LINE()                                                     \
+  {                                                                     \
+    unsigned int z = z1, s = s1, t = t1;                                \
+    FNAME(textured_span)(pp1 + x1, pz1 + x1, (x2 >> 16) - x1 + 1,       \
+                         z, dzdx, s, dsdx, t, dtdx, texture_def,        \
+                         mipmap_level, mipmap_dx, nullptr);             \
+  }
+
+#define PIXEL_COUNT pixel_count_white_textured
+
+#include "ztriangle.h"
+}
+
+static void
+FNAME(flat_textured) (ZBuffer *zb,
+                      ZBufferPoint *p0,ZBufferPoint *p1,ZBufferPoint *p2)
+{
+  ZTextureDef *texture_def;
+  int rgba[4];
+
+#define INTERP_Z
+#define INTERP_ST
+
+#define EARLY_OUT()                             \
+  {                                             \
+  }
+
+#define DRAW_INIT()                             \
+  {                                             \
+    texture_def = &zb->current_textures[0];     \
+    rgba[0] = p2->r;                            \
+    rgba[1] = p2->g;                            \
+    rgba[2] = p2->b;                            \
+    rgba[3] = p2->a;                            \
+  }
+
+#define DRAW_LINE()                                                     \
+  {                                                                     \
+    unsigned int z = z1, s = s1, t = t1;                                \
+    FNAME(textured_span)(pp1 + x1, pz1 + x1, (x2 >> 16) - x1 + 1,       \
+                         z, dzdx, s, dsdx, t, dtdx, texture_def,        \
+                         mipmap_level, mipmap_dx, rgba);                \
+  }
+
+#define PIXEL_COUNT pixel_count_flat_textured
+
+#include "ztriangle.h"
+}
+
+/*
+ * The perspective-correct versions compute the texture coordinates exactly
+ * as ztriangle_two.h does, once every NB_INTERP pixels, and draw the pixels
+ * in between with textured_span().
+ */
+#define DRAW_PERSPECTIVE_LINE(rgba)                                     \
+  {                                                                     \
+    PIXEL *pp;                                                          \
+    ZPOINT *pz;                                                         \
+    unsigned int s,t,z;                                                 \
+    int n,dsdx,dtdx;                                                    \
+    PN_stdfloat sz,tz,fz,zinv;                                          \
+    n=(x2>>16)-x1;                                                      \
+    fz=(PN_stdfloat)z1;                                                 \
+    zinv=1.0f / fz;                                                     \
+    pp=pp1+x1;                                                          \
+    pz=pz1+x1;                                                          \
+    z=z1;                                                               \
+    sz=sz1;                                                             \
+    tz=tz1;                                                             \
+    while (n>=(NB_INTERP-1)) {                                          \
+      {                                                                 \
+        PN_stdfloat ss,tt;                                              \
+        ss=(sz * zinv);                                                 \
+        tt=(tz * zinv);                                                 \
+        s=(unsigned int)(int) ss;                                       \
+        t=(unsigned int)(int) tt;                                       \
+        dsdx= (int)( (dszdx - ss*fdzdx)*zinv );                         \
+        dtdx= (int)( (dtzdx - tt*fdzdx)*zinv );                         \
+        CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx);         \
+        fz+=fndzdx;                                                     \
+        zinv=1.0f / fz;                                                 \
+      }                                                                 \
+      FNAME(textured_span)(pp, pz, NB_INTERP, z, dzdx, s, dsdx, t, dtdx, \
+                           texture_def, mipmap_level, mipmap_dx, rgba); \
+      pz+=NB_INTERP;                                                    \
+      pp+=NB_INTERP;                                                    \
+      n-=NB_INTERP;                                                     \
+      sz+=ndszdx;                                                       \
+      tz+=ndtzdx;                                                       \
+    }                                                                   \
+    {                                                                   \
+      PN_stdfloat ss,tt;                                                \
+      ss=(sz * zinv);                                                   \
+      tt=(tz * zinv);                                                   \
+      s=(unsigned int)(int) ss;                                         \
+      t=(unsigned int)(int) tt;                                         \
+      dsdx= (int)( (dszdx - ss*fdzdx)*zinv );                           \
+      dtdx= (int)( (dtzdx - tt*fdzdx)*zinv );                           \
+      CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx);           \
+    }                                                                   \
+    FNAME(textured_span)(pp, pz, n + 1, z, dzdx, s, dsdx, t, dtdx,      \
+                         texture_def, mipmap_level, mipmap_dx, rgba);   \
+  }
+
+static void
+FNAME(white_perspective) (ZBuffer *zb,
+                          ZBufferPoint *p0,ZBufferPoint *p1,ZBufferPoint *p2)
+{
+  ZTextureDef *texture_def;
+  PN_stdfloat fdzdx,fndzdx,ndszdx,ndtzdx;
+
+#define INTERP_Z
+#define INTERP_STZ
+
+#define EARLY_OUT()                             \
+  {                                             \
+  }
+
+#define DRAW_INIT()                             \
+  {                                             \
+    texture_def = &zb->current_textures[0];     \
+    fdzdx=(PN_stdfloat)dzdx;                    \
+    fndzdx=NB_INTERP * fdzdx;                   \
+    ndszdx=NB_INTERP * dszdx;                   \
+    ndtzdx=NB_INTERP * dtzdx;                   \
+  }
+
+#define DRAW_LINE() DRAW_PERSPECTIVE_LINE(nullptr)
+
+#define PIXEL_COUNT pixel_count_white_perspective
+
+#include "ztriangle.h"
+}
+
+static void
+FNAME(flat_perspective) (ZBuffer *zb,
+                         ZBufferPoint *p0,ZBufferPoint *p1,ZBufferPoint *p2)
+{
+  ZTextureDef *texture_def;
+  PN_stdfloat fdzdx,fndzdx,ndszdx,ndtzdx;
+  int rgba[4];
+
+#define INTERP_Z
+#define INTERP_STZ
+
+#define EARLY_OUT()                             \
+  {                                             \
+  }
+
+#define DRAW_INIT()                             \
+  {                                             \
+    texture_def = &zb->current_textures[0];     \
+    fdzdx=(PN_stdfloat)dzdx;                    \
+    fndzdx=NB_INTERP * fdzdx;                   \
+    ndszdx=NB_INTERP * dszdx;                   \
+    ndtzdx=NB_INTERP * dtzdx;                   \
+    rgba[0] = p2->r;                            \
+    rgba[1] = p2->g;                            \
+    rgba[2] = p2->b;                            \
+    rgba[3] = p2->a;                            \
+  }
+
+#define DRAW_LINE() DRAW_PERSPECTIVE_LINE(rgba)
+
+#define PIXEL_COUNT pixel_count_flat_perspective
+
+#include "ztriangle.h"
+}
+
+#undef DRAW_PERSPECTIVE_LINE
+#undef DEPTH_WRITE
+#undef DEPTH_TEST
+#undef FNAME
+#undef INTERP_MIPMAP
+#undef CALC_MIPMAP_LEVEL
+#undef ZB_LOOKUP_TEXTURE
+#undef LOOKUP_TEXELS
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,72 @@
+/*
+ * SSE2 versions of the white and flat untextured triangle fillers in
+ * ztriangle_two.h.  These are included once for each combination of
+ * DEPTH_WRITE and DEPTH_TEST, by ztriangle_sse2.cxx.
+ */
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wunused-but-set-variable"
+#endif
+
+static void
+FNAME(white_untextured) (ZBuffer *zb,
+                         ZBufferPoint *p0,ZBufferPoint *p1,ZBufferPoint *p2)
+{
+#define INTERP_Z
+
+#define EARLY_OUT()                             \
+  {                                             \
+  }
+
+#define DRAW_INIT()                             \
+  {                                             \
+  }
+
+#define DRAW_LINE()                                                     \
+  {                                                                     \
+    fill_span_sse2<DEPTH_WRITE, DEPTH_TEST>                             \
+      (pp1 + x1, pz1 + x1, (x2 >> 16) - x1 + 1, z1, dzdx, 0xffffffffU); \
+  }
+
+#define PIXEL_COUNT pixel_count_white_untextured
+
+#include "ztriangle.h"
+}
+
+static void
+FNAME(flat_untextured) (ZBuffer *zb,
+                        ZBufferPoint *p0,ZBufferPoint *p1,ZBufferPoint *p2)
+{
+  PIXEL color;
+
+#define INTERP_Z
+
+#define EARLY_OUT()                             \
+  {                                             \
+  }
+
+#define DRAW_INIT()                                             \
+  {                                                             \
+    color=RGBA_TO_PIXEL(p2->r, p2->g, p2->b, p2->a);            \
+  }
+
+#define DRAW_LINE()                                                     \
+  {                                                                     \
+    fill_span_sse2<DEPTH_WRITE, DEPTH_TEST>                             \
+      (pp1 + x1, pz1 + x1, (x2 >> 16) - x1 + 1, z1, dzdx, color);      \
+  }
+
+#define PIXEL_COUNT pixel_count_flat_untextured
+
+#include "ztriangle.h"
+}
+
+#undef DEPTH_WRITE
+#undef DEPTH_TEST
+#undef FNAME
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
@@ -21,6 +21,10 @@
 #include "config_chan.h"
 #include "pandaNode.h"
 #include "geomNode.h"
+#include "sceneGraphReducer.h"
+#include "lodNode.h"
+#include "nodePath.h"
+#include "nodePathCollection.h"
 #include "renderState.h"
 #include "textureAttrib.h"
 #include "dcast.h"
@@ -31,6 +35,7 @@
 #include "load_prc_file.h"
 #include "windowProperties.h"
 #include "frameBufferProperties.h"
+#include "trueClock.h"
 
 /**
  *
@@ -88,6 +93,38 @@ EggToBam() :
      "file has been loaded, showing the nodes that will be written out.",
      &EggToBam::dispatch_none, &_ls);
 
+  add_option
+    ("optimize-vertex-cache", "", 0,
+     "Reorders the triangles and vertices of the geometry to make better use "
+     "of the post-transform vertex cache of the graphics hardware.  The "
+     "average cache miss ratio (the number of vertices transformed per "
+     "triangle) is reported before and after the optimization.  The assumed "
+     "cache size comes from the vertex-cache-size Config.prc variable.",
+     &EggToBam::dispatch_none, &_optimize_vertex_cache);
+
+  add_option
+    ("lods", "count", 0,
+     "Generates the indicated number of lower levels of detail for each "
+     "GeomNode in the model, by simplifying the geometry.  Each GeomNode "
+     "is replaced with an LODNode that switches between the original "
+     "geometry and the simplified versions.",
+     &EggToBam::dispatch_int, nullptr, &_lod_levels);
+
+  add_option
+    ("lod-ratio", "ratio", 0,
+     "Specifies the fraction of the triangles of each level of detail that "
+     "are kept in the next lower level, when -lods is specified.  The "
+     "default is 0.5.",
+     &EggToBam::dispatch_double, nullptr, &_lod_ratio);
+
+  add_option
+    ("lod-distance", "distance", 0,
+     "Specifies the distance at which the original geometry switches to the "
+     "first lower level of detail, when -lods is specified.  Each subsequent "
+     "level switches at twice the distance of the previous one.  The default "
+     "is ten times the radius of each GeomNode.",
+     &EggToBam::dispatch_double, nullptr, &_lod_distance);
+
   add_option
     ("C", "quality", 0,
      "Specify the quality level for lossy channel compression.  If this "
@@ -199,6 +236,15 @@ EggToBam() :
      ,
      &EggToBam::dispatch_string, nullptr, &_load_display);
 
+  add_option
+    ("timing", "", 0,
+     "Reports the time taken by each step of the conversion: reading the "
+     "egg file, building the scene graph, any optional processing, and "
+     "writing the bam file.  This is useful for finding the bottleneck "
+     "when converting very large egg files.  The scene graph is built "
+     "on multiple threads unless egg-parallel-load is turned off.",
+     &EggToBam::dispatch_none, &_timing);
+
   redescribe_option
     ("cs",
      "Specify the coordinate system of the resulting " + _format_name +
@@ -210,8 +256,14 @@ EggToBam() :
   _egg_flatten = 0;
   _egg_combine_geoms = 0;
   _egg_suppress_hidden = 1;
+  _optimize_vertex_cache = false;
+  _lod_levels = 0;
+  _lod_ratio = 0.5;
+  _lod_distance = 0.0;
   _tex_txopz = false;
   _ctex_quality = "best";
+  _timing = false;
+  _read_time = 0.0;
 }
 
 /**
@@ -256,11 +308,42 @@ run() {
     _data->set_coordinate_system(CS_zup_right);
   }
 
+  if (_timing) {
+    nout << "Timing:\n"
+         << "  read egg file: " << _read_time << " s\n";
+  }
+  double start = TrueClock::get_global_ptr()->get_short_time();
+  double total_start = start;
+
   PT(PandaNode) root = load_egg_data(_data);
   if (root == nullptr) {
     nout << "Unable to build scene graph from egg file.\n";
     exit(1);
   }
+  report_time(egg_parallel_load ? "build scene graph (parallel)" : "build scene graph", start);
+
+  if (_lod_levels > 0) {
+    if (_lod_ratio <= 0.0 || _lod_ratio >= 1.0) {
+      nout << "-lod-ratio must be between 0 and 1.\n";
+      exit(1);
+    }
+    NodePathCollection geom_nodes = NodePath(root).find_all_matches("**/+GeomNode");
+    for (int i = 0; i < geom_nodes.get_num_paths(); ++i) {
+      LODNode::generate_lods(geom_nodes.get_path(i), _lod_levels,
+                             _lod_ratio, _lod_distance);
+    }
+    report_time("generate lods", start);
+  }
+
+  if (_optimize_vertex_cache) {
+    SceneGraphReducer gr;
+    double before = gr.calc_acmr(root);
+    gr.optimize_vertex_cache(root);
+    double after = gr.calc_acmr(root);
+    nout << "Average cache miss ratio: " << before << " before, "
+         << after << " after vertex cache optimization.\n";
+    report_time("optimize vertex cache", start);
+  }
 
   if (_tex_ctex) {
 #ifndef HAVE_SQUISH
@@ -308,6 +391,7 @@ run() {
         convert_txo(tex);
       }
     }
+    report_time("process textures", start);
   }
 
   if (_ls) {
@@ -331,6 +415,12 @@ run() {
     nout << "Error in writing.\n";
     exit(1);
   }
+  bam_file.close();
+  report_time("write bam file", start);
+
+  if (_timing) {
+    nout << "  total: " << _read_time + (start - total_start) << " s\n";
+  }
 }
 
 /**
@@ -355,7 +445,11 @@ handle_args(ProgramBase::Args &args) {
     _path_replace->_path_store = PS_absolute;
   }
 
-  return EggToSomething::handle_args(args);
+  // The egg file is read by our base class.
+  double start = TrueClock::get_global_ptr()->get_short_time();
+  bool result = EggToSomething::handle_args(args);
+  _read_time = TrueClock::get_global_ptr()->get_short_time() - start;
+  return result;
 }
 
 /**
@@ -435,6 +529,20 @@ convert_txo(Texture *tex) {
   }
 }
 
+/**
+ * If -timing was specified, reports the time elapsed since start for the
+ * indicated step of the conversion.  In any case, resets start to the
+ * current time.
+ */
+void EggToBam::
+report_time(const std::string &step, double &start) {
+  double now = TrueClock::get_global_ptr()->get_short_time();
+  if (_timing) {
+    nout << "  " << step << ": " << now - start << " s\n";
+  }
+  start = now;
+}
+
 /**
  * Creates a GraphicsBuffer for communicating with the graphics card.
  */
@@ -45,6 +45,7 @@ private:
   void convert_txo(Texture *tex);
 
   bool make_buffer();
+  void report_time(const std::string &step, double &start);
 
 private:
   typedef pset<Texture *> Textures;
@@ -56,6 +57,10 @@ private:
   int _egg_combine_geoms;
   bool _egg_suppress_hidden;
   bool _ls;
+  bool _optimize_vertex_cache;
+  int _lod_levels;
+  double _lod_ratio;
+  double _lod_distance;
   bool _has_compression_quality;
   int _compression_quality;
   bool _compression_off;
@@ -66,6 +71,8 @@ private:
   bool _tex_mipmap;
   std::string _ctex_quality;
   std::string _load_display;
+  bool _timing;
+  double _read_time;
 
   // The rest of this is required to support -ctex.
   PT(GraphicsPipe) _pipe;
@@ -0,0 +1,118 @@
+from panda3d import core
+import pytest
+
+
+@pytest.fixture
+def quantize_tables():
+    share = core.ConfigVariableBool('share-anim-tables')
+    quantize = core.ConfigVariableBool('quantize-anim-tables')
+    share.set_value(True)
+    quantize.set_value(False)
+    yield quantize
+    share.clear_local_value()
+    quantize.clear_local_value()
+
+
+def make_channel(num_frames=4):
+    anim = core.AnimBundle("anim", 24, num_frames)
+    channel = core.AnimChannelMatrixXfmTable(anim, "joint")
+    return anim, channel
+
+
+def test_anim_table_pool_share(quantize_tables):
+    num_tables = core.AnimTablePool.get_num_tables()
+
+    anim1, channel1 = make_channel()
+    channel1.set_table('x', core.CPTA_stdfloat([1.5, 2.5, 3.5, 4.5]))
+    assert core.AnimTablePool.get_num_tables() == num_tables + 1
+
+    # The table is held by the pool, the channel, and the one we got back.
+    assert channel1.get_table('x').get_ref_count() == 3
+
+    anim2, channel2 = make_channel()
+    channel2.set_table('x', core.CPTA_stdfloat([1.5, 2.5, 3.5, 4.5]))
+    assert core.AnimTablePool.get_num_tables() == num_tables + 1
+    assert channel1.get_table('x').get_ref_count() == 4
+    assert list(channel2.get_table('x')) == [1.5, 2.5, 3.5, 4.5]
+
+    # A different table is not shared.
+    anim3, channel3 = make_channel()
+    channel3.set_table('x', core.CPTA_stdfloat([1.5, 2.5, 3.5, 5.5]))
+    assert core.AnimTablePool.get_num_tables() == num_tables + 2
+    assert channel3.get_table('x').get_ref_count() == 3
+
+
+def test_anim_table_pool_copy(quantize_tables):
+    # The pool must not be affected by changes to the array that was passed
+    # in to set_table().
+    table = core.PTA_stdfloat([6.5, 7.5, 8.5, 9.5])
+    anim1, channel1 = make_channel()
+    channel1.set_table('y', table)
+
+    table[0] = 0.0
+    assert list(channel1.get_table('y')) == [6.5, 7.5, 8.5, 9.5]
+
+    anim2, channel2 = make_channel()
+    channel2.set_table('y', core.CPTA_stdfloat([6.5, 7.5, 8.5, 9.5]))
+    assert channel2.get_table('y').get_ref_count() == 4
+
+    anim3, channel3 = make_channel()
+    channel3.set_table('y', core.CPTA_stdfloat([0.0, 7.5, 8.5, 9.5]))
+    assert list(channel3.get_table('y')) == [0.0, 7.5, 8.5, 9.5]
+    assert channel3.get_table('y').get_ref_count() == 3
+
+
+def test_anim_table_pool_garbage_collect(quantize_tables):
+    core.AnimTablePool.garbage_collect()
+    num_tables = core.AnimTablePool.get_num_tables()
+
+    anim, channel = make_channel()
+    channel.set_table('z', core.CPTA_stdfloat([11.5, 12.5, 13.5, 14.5]))
+    channel.set_table('h', core.CPTA_stdfloat([15.5, 16.5, 17.5, 18.5]))
+    assert core.AnimTablePool.get_num_tables() == num_tables + 2
+
+    # Nothing is released while the channel still uses the tables.
+    assert core.AnimTablePool.garbage_collect() == 0
+    assert core.AnimTablePool.get_num_tables() == num_tables + 2
+
+    del channel
+    del anim
+    assert core.AnimTablePool.garbage_collect() == 2
+    assert core.AnimTablePool.get_num_tables() == num_tables
+
+
+def test_anim_table_pool_quantized(quantize_tables):
+    quantize_tables.set_value(True)
+    num_tables = core.AnimTablePool.get_num_tables()
+
+    values = [0.0, 0.25, 2.0, 10.0]
+    anim1, channel1 = make_channel()
+    channel1.set_table('x', core.CPTA_stdfloat(values))
+    assert channel1.is_table_quantized('x')
+
+    decoded = list(channel1.get_table('x'))
+    assert decoded == pytest.approx(values, abs=10.0 / 65535)
+
+    # An identical table is quantized the same way, and shared.
+    anim2, channel2 = make_channel()
+    channel2.set_table('x', core.CPTA_stdfloat(values))
+    assert core.AnimTablePool.get_num_tables() == num_tables + 1
+    assert list(channel2.get_table('x')) == decoded
+
+    # Storing the decoded values again reproduces the same table.
+    channel2.set_table('x', channel1.get_table('x'))
+    assert core.AnimTablePool.get_num_tables() == num_tables + 1
+    assert list(channel2.get_table('x')) == pytest.approx(decoded)
+
+    # A constant table needs only a single value, which isn't quantized.
+    channel2.set_table('y', core.CPTA_stdfloat([3.0, 3.0, 3.0, 3.0]))
+    assert not channel2.is_table_quantized('y')
+    assert list(channel2.get_table('y')) == [3.0]
+    assert core.AnimTablePool.get_num_tables() == num_tables + 2
+
+    # So does the round trip through a bam stream.
+    anim3 = core.AnimBundle.decode_from_bam_stream(anim1.encode_to_bam_stream())
+    channel3 = anim3.find_child("joint")
+    assert channel3.is_table_quantized('x')
+    assert list(channel3.get_table('x')) == pytest.approx(decoded)
+    assert core.AnimTablePool.get_num_tables() == num_tables + 2
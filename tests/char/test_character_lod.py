@@ -0,0 +1,160 @@
+from panda3d import core
+import pytest
+
+
+def make_character(num_joints):
+    """Returns a Character with a single chain of joints, each of which is a
+    child of the one before."""
+
+    char = core.Character("char")
+    bundle = char.get_bundle(0)
+    parent = core.PartGroup(bundle, "<skeleton>")
+
+    joints = []
+    for i in range(num_joints):
+        joint = core.CharacterJoint(char, bundle, parent, "joint%d" % (i),
+                                    core.LMatrix4.ident_mat())
+        joints.append(joint)
+        parent = joint
+
+    return char, joints
+
+
+def make_anim(num_joints, num_frames):
+    """Returns an AnimBundle for make_character(), in which every joint is
+    moved along the X axis by the frame number."""
+
+    anim = core.AnimBundle("char", 24, num_frames)
+    parent = core.AnimGroup(anim, "<skeleton>")
+
+    table = core.CPTA_stdfloat([float(i) for i in range(num_frames)])
+    for i in range(num_joints):
+        channel = core.AnimChannelMatrixXfmTable(parent, "joint%d" % (i))
+        channel.set_table('x', table)
+        parent = channel
+
+    return anim
+
+
+def local_x(joint):
+    return joint.get_transform().get_row3(3).x
+
+
+def net_x(joint):
+    mat = core.LMatrix4()
+    joint.get_net_transform(mat)
+    return mat.get_row3(3).x
+
+
+def test_part_bundle_lod_joint_depth():
+    char, joints = make_character(3)
+    bundle = char.get_bundle(0)
+    control = bundle.bind_anim(make_anim(3, 10))
+    assert control is not None
+
+    control.pose(2)
+    bundle.force_update()
+    assert [local_x(joint) for joint in joints] == [2, 2, 2]
+
+    # Only the root joint is animated now, but the others still follow it.
+    bundle.set_lod_joint_depth(0)
+    assert bundle.get_lod_joint_depth() == 0
+
+    control.pose(5)
+    bundle.force_update()
+    assert [local_x(joint) for joint in joints] == [5, 2, 2]
+    assert [net_x(joint) for joint in joints] == [5, 7, 9]
+
+    bundle.set_lod_joint_depth(1)
+    control.pose(6)
+    bundle.force_update()
+    assert [local_x(joint) for joint in joints] == [6, 6, 2]
+
+    bundle.update()
+    assert [local_x(joint) for joint in joints] == [6, 6, 2]
+
+    # Raising the limit again catches up the joints that were skipped, even
+    # though the animation hasn't changed since the last update.
+    bundle.set_lod_joint_depth(-1)
+    assert bundle.get_lod_joint_depth() == -1
+    bundle.update()
+    assert [local_x(joint) for joint in joints] == [6, 6, 6]
+
+
+def test_part_bundle_lod_joint_depth_forced():
+    # A joint that is explicitly controlled is updated at any depth.
+    char, joints = make_character(3)
+    bundle = char.get_bundle(0)
+    bundle.bind_anim(make_anim(3, 10)).pose(0)
+    bundle.force_update()
+
+    bundle.set_lod_joint_depth(0)
+    bundle.freeze_joint("joint2", core.TransformState.make_pos((3, 0, 0)))
+    bundle.force_update()
+    assert local_x(joints[2]) == 3
+
+
+@pytest.fixture(scope='module')
+def tiny_pipe():
+    selection = core.GraphicsPipeSelection.get_global_ptr()
+    pipe = selection.make_pipe('TinyOffscreenGraphicsPipe', 'p3tinydisplay')
+
+    if pipe is None or not pipe.is_valid():
+        pytest.skip("TinyOffscreenGraphicsPipe is not available")
+
+    yield pipe
+
+
+def test_character_lod_joint_depth(tiny_pipe):
+    # The joint depth is chosen by the cull traversal, and applied by the
+    # update that follows it.
+    engine = core.GraphicsEngine()
+    engine.set_threading_model("")
+
+    buffer = engine.make_output(
+        tiny_pipe,
+        'buffer',
+        0,
+        core.FrameBufferProperties(),
+        core.WindowProperties.size(16, 16),
+        core.GraphicsPipe.BF_refuse_window,
+    )
+    engine.open_windows()
+
+    if buffer is None:
+        pytest.skip("Cannot make tinydisplay buffer")
+
+    scene = core.NodePath("root")
+    camera = scene.attach_new_node(core.Camera("camera"))
+    region = buffer.make_display_region()
+    region.camera = camera
+
+    char, joints = make_character(3)
+    char.set_bounds(core.OmniBoundingVolume())
+    char.set_lod_animation((0, 0, 0), 10, 1, 0)
+    char.set_lod_joint_depth(0)
+    assert char.get_lod_joint_depth() == 0
+    path = scene.attach_new_node(char)
+
+    control = char.get_bundle(0).bind_anim(make_anim(3, 10))
+    control.pose(2)
+
+    try:
+        # Close by, all of the joints are animated.
+        path.set_pos(0, 5, 0)
+        engine.render_frame()
+        assert [local_x(joint) for joint in joints] == [2, 2, 2]
+
+        # Past the far distance, only the root joint is.
+        path.set_pos(0, 20, 0)
+        control.pose(5)
+        engine.render_frame()
+        assert [local_x(joint) for joint in joints] == [5, 2, 2]
+
+        # Coming closer again brings the other joints up to date, even though
+        # the animation has not changed.
+        path.set_pos(0, 5, 0)
+        engine.render_frame()
+        assert [local_x(joint) for joint in joints] == [5, 5, 5]
+    finally:
+        engine.remove_all_windows()
@@ -0,0 +1,131 @@
+from panda3d import core
+import pytest
+
+
+NUM_JOINTS = 4
+
+
+@pytest.fixture
+def parallel_pose_batch():
+    var = core.ConfigVariableBool('parallel-pose-batch')
+    var.set_value(True)
+    yield var
+    var.clear_local_value()
+
+
+def make_character():
+    """Returns a Character with a small tree of joints."""
+
+    char = core.Character("char")
+    bundle = char.get_bundle(0)
+    skeleton = core.PartGroup(bundle, "<skeleton>")
+
+    root = core.CharacterJoint(char, bundle, skeleton, "joint0", core.LMatrix4.ident_mat())
+    arm = core.CharacterJoint(char, bundle, root, "joint1", core.LMatrix4.translate_mat(1, 0, 0))
+    core.CharacterJoint(char, bundle, arm, "joint2", core.LMatrix4.translate_mat(0, 1, 0))
+    core.CharacterJoint(char, bundle, root, "joint3", core.LMatrix4.translate_mat(0, 0, 1))
+    return char
+
+
+def make_anim(num_frames=10):
+    """Returns an AnimBundle for make_character(), which rotates and moves
+    each of the joints by a different amount on each frame."""
+
+    anim = core.AnimBundle("char", 24, num_frames)
+    skeleton = core.AnimGroup(anim, "<skeleton>")
+
+    def add_channel(parent, i):
+        channel = core.AnimChannelMatrixXfmTable(parent, "joint%d" % (i))
+        channel.set_table('h', core.CPTA_stdfloat([f * 10.0 + i for f in range(num_frames)]))
+        channel.set_table('x', core.CPTA_stdfloat([f * 0.5 + i for f in range(num_frames)]))
+        return channel
+
+    root = add_channel(skeleton, 0)
+    arm = add_channel(root, 1)
+    add_channel(arm, 2)
+    add_channel(root, 3)
+    return anim
+
+
+def make_scene(num_characters):
+    """Returns a scene with the indicated number of separate characters, each
+    in a different pose, and a pair of characters that share the same bundle,
+    as happens when an instanced character is flattened."""
+
+    root = core.NodePath("root")
+    for i in range(num_characters):
+        path = root.attach_new_node(make_character())
+        path.set_pos(i, 0, 0)
+
+    char = make_character()
+    for i in range(2):
+        parent = root.attach_new_node("instance")
+        parent.set_pos(0, 5, 0)
+        parent.node().add_child(char)
+
+    # Flattening replaces the bundles, so we bind the animations afterwards.
+    root.flatten_light()
+
+    chars = [path.node() for path in root.find_all_matches("**/+Character")]
+    assert len(chars) == num_characters + 2
+    assert chars[-1].get_bundle(0) == chars[-2].get_bundle(0)
+
+    anim = make_anim()
+    for i, char in enumerate(chars[:-1]):
+        char.get_bundle(0).bind_anim(anim).pose(i % 10)
+
+    return root, chars
+
+
+def get_joint_transforms(chars):
+    result = []
+    for char in chars:
+        for i in range(NUM_JOINTS):
+            mat = core.LMatrix4()
+            char.find_joint("joint%d" % (i)).get_net_transform(mat)
+            result.append(mat)
+    return result
+
+
+def test_character_pose_batch(parallel_pose_batch):
+    root1, chars1 = make_scene(6)
+    for char in chars1:
+        char.force_update()
+    expected = get_joint_transforms(chars1)
+
+    root2, chars2 = make_scene(6)
+    batch = core.CharacterPoseBatch()
+    for char in chars2:
+        batch.add_character(char)
+
+    # The shared bundle is only posed once.
+    assert batch.get_num_characters() == len(chars2)
+    assert batch.get_num_joints() == NUM_JOINTS * (len(chars2) - 1)
+
+    batch.force_update()
+    result = get_joint_transforms(chars2)
+
+    assert len(result) == len(expected)
+    for mat1, mat2 in zip(result, expected):
+        assert mat1.almost_equal(mat2)
+
+    # A character that is removed from the batch no longer counts.
+    assert batch.remove_character(chars2[0])
+    assert batch.get_num_joints() == NUM_JOINTS * (len(chars2) - 2)
+
+
+def test_character_pose_batch_serial(parallel_pose_batch):
+    parallel_pose_batch.set_value(False)
+    root1, chars1 = make_scene(3)
+    for char in chars1:
+        char.force_update()
+    expected = get_joint_transforms(chars1)
+
+    root2, chars2 = make_scene(3)
+    batch = core.CharacterPoseBatch()
+    for char in chars2:
+        batch.add_character(char)
+    batch.force_update()
+
+    for mat1, mat2 in zip(get_joint_transforms(chars2), expected):
+        assert mat1.almost_equal(mat2)
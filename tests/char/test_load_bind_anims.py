@@ -0,0 +1,103 @@
+from panda3d import core
+import pytest
+
+
+@pytest.fixture
+def bam_extension():
+    # The preload table lists the animations without an extension.
+    var = core.ConfigVariableString('default-model-extension')
+    var.set_value('.bam')
+    yield var
+    var.clear_local_value()
+
+
+def make_character(num_joints):
+    """Returns a Character with a single chain of joints, each of which is
+    moved by 0.5 along the X axis in the bind pose."""
+
+    char = core.Character("char")
+    bundle = char.get_bundle(0)
+    parent = core.PartGroup(bundle, "<skeleton>")
+
+    joints = []
+    for i in range(num_joints):
+        joint = core.CharacterJoint(char, bundle, parent, "joint%d" % (i),
+                                    core.LMatrix4.translate_mat(0.5, 0, 0))
+        joints.append(joint)
+        parent = joint
+
+    return char, joints
+
+
+def write_anim(path, num_joints, num_frames, offset):
+    """Writes an animation for make_character() to a bam file, in which every
+    joint is moved along the X axis by the frame number plus the offset."""
+
+    anim = core.AnimBundle("char", 24, num_frames)
+    parent = core.AnimGroup(anim, "<skeleton>")
+
+    table = core.CPTA_stdfloat([float(i + offset) for i in range(num_frames)])
+    for i in range(num_joints):
+        channel = core.AnimChannelMatrixXfmTable(parent, "joint%d" % (i))
+        channel.set_table('x', table)
+        parent = channel
+
+    node = core.AnimBundleNode(anim.name, anim)
+    assert core.NodePath(node).write_bam_file(core.Filename.from_os_specific(str(path)))
+
+
+def local_x(joint):
+    return joint.get_transform().get_row3(3).x
+
+
+@pytest.mark.skipif(not core.Thread.is_threading_supported(),
+                    reason="Threading support disabled")
+def test_part_bundle_load_bind_anims(tmp_path, bam_extension):
+    char, joints = make_character(2)
+    bundle = char.get_bundle(0)
+
+    table = core.AnimPreloadTable()
+    for name, offset in (("walk", 1), ("run", 10)):
+        write_anim(tmp_path / (name + ".bam"), 2, 10, offset)
+        table.add_anim(name, 24, 10)
+    bundle.set_anim_preload(table)
+
+    # The animations are loaded by a task manager that only runs when it is
+    # polled, so that we can see what happens while they are still pending.
+    task_mgr = core.AsyncTaskManager("load_bind_anims")
+    loader = core.Loader("load_bind_anims")
+    loader.set_task_manager(task_mgr)
+    loader.set_task_chain("default")
+
+    controls = core.AnimControlCollection()
+    directory = core.Filename.from_os_specific(str(tmp_path))
+    assert bundle.load_bind_anims(loader, directory, controls) == 2
+    assert controls.get_num_anims() == 2
+
+    walk = controls.find_anim("walk")
+    run = controls.find_anim("run")
+    assert walk.is_pending()
+    assert run.is_pending()
+
+    # The bundle holds its bind pose while the animation is pending.
+    walk.pose(5)
+    bundle.force_update()
+    assert [local_x(joint) for joint in joints] == [0.5, 0.5]
+
+    for i in range(100):
+        if not walk.is_pending() and not run.is_pending():
+            break
+        task_mgr.poll()
+
+    assert not walk.is_pending()
+    assert not run.is_pending()
+    assert walk.has_anim()
+
+    # Now the control that was posed takes effect, without having to pose it
+    # again.
+    bundle.update()
+    assert [local_x(joint) for joint in joints] == [6, 6]
+
+    run.pose(2)
+    bundle.update()
+    assert [local_x(joint) for joint in joints] == [12, 12]
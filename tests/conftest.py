@@ -4,6 +4,27 @@ from panda3d import core
 from direct.showbase.ShowBase import ShowBase
 
 
+def pytest_addoption(parser):
+    parser.addoption("--run-benchmarks", action="store_true", default=False,
+                     help="run the tests marked as benchmarks")
+
+
+def pytest_configure(config):
+    config.addinivalue_line(
+        "markers", "benchmark: slow test that only reports timings; "
+                   "skipped unless --run-benchmarks is given")
+
+
+def pytest_collection_modifyitems(config, items):
+    if config.getoption("--run-benchmarks"):
+        return
+
+    skip = pytest.mark.skip(reason="benchmark; run with --run-benchmarks")
+    for item in items:
+        if item.get_closest_marker("benchmark") is not None:
+            item.add_marker(skip)
+
+
 @pytest.fixture
 def base():
     base = ShowBase(windowType='none')
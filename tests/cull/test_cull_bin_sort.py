@@ -0,0 +1,153 @@
+from panda3d import core
+import itertools
+import pytest
+import random
+
+
+# Distances that are far enough apart that they stay distinct as floats, and
+# include values of either sign near zero and near the limits of the range.
+# Both zeroes end up as the same distance.
+DEPTHS = [-3e38, -1e30, -50, -1, -1e-3, -0.0, 0.0, 1e-3, 0.5, 3, 50, 1e30, 3e38]
+
+BIN_TYPES = [
+    core.CullBinManager.BT_state_sorted,
+    core.CullBinManager.BT_back_to_front,
+    core.CullBinManager.BT_front_to_back,
+]
+
+
+@pytest.fixture(scope='module')
+def tiny_pipe():
+    selection = core.GraphicsPipeSelection.get_global_ptr()
+    pipe = selection.make_pipe('TinyOffscreenGraphicsPipe', 'p3tinydisplay')
+
+    if pipe is None or not pipe.is_valid():
+        pytest.skip("TinyOffscreenGraphicsPipe is not available")
+
+    yield pipe
+
+
+@pytest.fixture
+def radix_threshold():
+    var = core.ConfigVariableInt('cull-bin-radix-sort-threshold')
+    yield var
+    var.clear_local_value()
+
+
+def get_bin_name(bin_type):
+    # Bins can't be removed again, so each type of bin is only added once.
+    name = "test_sort_%d" % (bin_type)
+    manager = core.CullBinManager.get_global_ptr()
+    if manager.find_bin(name) < 0:
+        manager.add_bin(name, bin_type, 100)
+    return name
+
+
+def make_scene(bin_name, num_objects, seed=1):
+    """Returns a scene with the indicated number of cards in the given bin,
+    along with the depth and state of each card.  Each card has a different
+    size, by which it can be recognized."""
+
+    rand = random.Random(seed)
+
+    # A few distinct states, so that many cards share the same one.
+    states = [core.RenderState.make(core.DepthOffsetAttrib.make(i)) for i in range(5)]
+
+    root = core.NodePath("root")
+    cards = {}
+    for i in range(num_objects):
+        size = 0.001 * (i + 1)
+        maker = core.CardMaker("card")
+        maker.set_frame(-size, size, -size, size)
+
+        depth = rand.choice(DEPTHS)
+        state = rand.randrange(len(states))
+
+        card = root.attach_new_node(maker.generate())
+        card.set_y(depth)
+        card.set_state(states[state])
+        card.set_bin(bin_name, 0)
+
+        # Make sure the card is not culled, however far away it is.
+        card.node().set_bounds(core.OmniBoundingVolume())
+        cards[round(size, 6)] = (depth, state)
+
+    return root, cards
+
+
+def get_draw_order(region, bin_name):
+    """Returns the sizes of the cards in the given bin, in the order in which
+    they were drawn in the last frame."""
+
+    order = []
+    result = core.NodePath(region.make_cull_result_graph())
+    for node in result.find(bin_name).get_children():
+        for geom in node.node().get_geoms():
+            reader = core.GeomVertexReader(geom.get_vertex_data(), "vertex")
+            order.append(round(abs(reader.get_data3()[0]), 6))
+    return order
+
+
+def group_by_key(order, key):
+    # Returns the objects grouped by sort key, in the order of the groups.
+    # Within each group, the order is unspecified, since std::sort is not
+    # stable and the radix sort doesn't order by pointer.
+    return [(k, sorted(group)) for k, group in itertools.groupby(order, key)]
+
+
+@pytest.mark.parametrize("bin_type", BIN_TYPES, ids=["state_sorted", "back_to_front", "front_to_back"])
+@pytest.mark.parametrize("num_objects", [20, 300])
+def test_cull_bin_radix_sort(tiny_pipe, radix_threshold, bin_type, num_objects):
+    engine = core.GraphicsEngine()
+    engine.set_threading_model("")
+
+    buffer = engine.make_output(
+        tiny_pipe,
+        'buffer',
+        0,
+        core.FrameBufferProperties(),
+        core.WindowProperties.size(16, 16),
+        core.GraphicsPipe.BF_refuse_window,
+    )
+    engine.open_windows()
+
+    if buffer is None:
+        pytest.skip("Cannot make tinydisplay buffer")
+
+    bin_name = get_bin_name(bin_type)
+    root, cards = make_scene(bin_name, num_objects)
+
+    lens = core.OrthographicLens()
+    lens.set_film_size(2, 2)
+    lens.set_near_far(-100, 100)
+    camera = root.attach_new_node(core.Camera("camera", lens))
+
+    region = buffer.make_display_region()
+    region.camera = camera
+
+    if bin_type == core.CullBinManager.BT_state_sorted:
+        key = lambda size: cards[size][1]
+    else:
+        key = lambda size: cards[size][0]
+
+    # Draw with std::sort first, then with the radix sort for any number of
+    # objects, then with the default threshold, which is between the two
+    # numbers of objects we test with.
+    orders = []
+    for threshold in (-1, 0, 256):
+        radix_threshold.set_value(threshold)
+        engine.render_frame()
+        order = get_draw_order(region, bin_name)
+        assert sorted(order) == sorted(cards)
+        orders.append(group_by_key(order, key))
+
+    engine.remove_all_windows()
+
+    assert orders[1] == orders[0]
+    assert orders[2] == orders[0]
+
+    if bin_type != core.CullBinManager.BT_state_sorted:
+        depths = [depth for depth, group in orders[0]]
+        if bin_type == core.CullBinManager.BT_back_to_front:
+            depths.reverse()
+        assert depths == sorted(depths)
@@ -0,0 +1,281 @@
+from panda3d import core
+import pytest
+import random
+import time
+
+
+@pytest.fixture(scope='module')
+def tiny_pipe():
+    selection = core.GraphicsPipeSelection.get_global_ptr()
+    pipe = selection.make_pipe('TinyOffscreenGraphicsPipe', 'p3tinydisplay')
+
+    if pipe is None or not pipe.is_valid():
+        pytest.skip("TinyOffscreenGraphicsPipe is not available")
+
+    yield pipe
+
+
+@pytest.fixture
+def parallel_raster():
+    var = core.ConfigVariableBool('td-parallel-raster', False)
+    rows = core.ConfigVariableInt('td-parallel-raster-rows', 32)
+    min_triangles = core.ConfigVariableInt('td-parallel-raster-min-triangles', 64)
+
+    # Use small bands, so that many triangles span several of them.
+    rows.set_value(8)
+    min_triangles.set_value(1)
+    yield var
+    var.clear_local_value()
+    rows.clear_local_value()
+    min_triangles.clear_local_value()
+
+
+@pytest.fixture
+def hierarchical_z():
+    var = core.ConfigVariableBool('td-hierarchical-z', False)
+    yield var
+    var.clear_local_value()
+
+
+@pytest.fixture
+def sse2():
+    var = core.ConfigVariableBool('td-sse2', True)
+    perspective = core.ConfigVariableBool('td-perspective-textures', True)
+    yield var
+    var.clear_local_value()
+    perspective.clear_local_value()
+
+
+def make_triangles(num_triangles, seed=1):
+    """Returns a GeomNode with a number of randomly placed, overlapping,
+    vertex-colored triangles."""
+
+    rand = random.Random(seed)
+
+    format = core.GeomVertexFormat.get_v3c4()
+    vdata = core.GeomVertexData("triangles", format, core.Geom.UH_static)
+    vdata.unclean_set_num_rows(num_triangles * 3)
+
+    vertex = core.GeomVertexWriter(vdata, "vertex")
+    color = core.GeomVertexWriter(vdata, "color")
+    for i in range(num_triangles * 3):
+        vertex.set_data3(rand.uniform(-1.2, 1.2), rand.uniform(1, 9), rand.uniform(-1.2, 1.2))
+        color.set_data4(rand.random(), rand.random(), rand.random(), 1)
+
+    tris = core.GeomTriangles(core.Geom.UH_static)
+    tris.add_next_vertices(num_triangles * 3)
+
+    geom = core.Geom(vdata)
+    geom.add_primitive(tris)
+
+    gnode = core.GeomNode("triangles")
+    gnode.add_geom(geom)
+    return gnode
+
+
+def make_textured_triangles(num_triangles, seed=1):
+    """Like make_triangles, but the triangles have texture coordinates
+    instead of vertex colors."""
+
+    rand = random.Random(seed)
+
+    format = core.GeomVertexFormat.get_v3t2()
+    vdata = core.GeomVertexData("triangles", format, core.Geom.UH_static)
+    vdata.unclean_set_num_rows(num_triangles * 3)
+
+    vertex = core.GeomVertexWriter(vdata, "vertex")
+    texcoord = core.GeomVertexWriter(vdata, "texcoord")
+    for i in range(num_triangles * 3):
+        vertex.set_data3(rand.uniform(-1.2, 1.2), rand.uniform(1, 9), rand.uniform(-1.2, 1.2))
+        texcoord.set_data2(rand.uniform(-2, 2), rand.uniform(-2, 2))
+
+    tris = core.GeomTriangles(core.Geom.UH_static)
+    tris.add_next_vertices(num_triangles * 3)
+
+    geom = core.Geom(vdata)
+    geom.add_primitive(tris)
+
+    gnode = core.GeomNode("triangles")
+    gnode.add_geom(geom)
+    return gnode
+
+
+def make_noise_texture(size, seed=1):
+    """Returns an RGBA texture filled with random texels."""
+
+    rand = random.Random(seed)
+
+    texture = core.Texture("noise")
+    texture.setup_2d_texture(size, size, core.Texture.T_unsigned_byte, core.Texture.F_rgba)
+    texture.set_ram_image(bytes(rand.randrange(256) for i in range(size * size * 4)))
+
+    # Otherwise, tinydisplay downgrades the filter to nearest.
+    texture.set_quality_level(core.Texture.QL_best)
+    return texture
+
+
+def render_triangles(pipe, size, num_triangles, num_frames=1):
+    """Renders the triangles into an offscreen buffer of the given size, and
+    returns the contents of the color buffer and the time taken."""
+
+    lens = core.OrthographicLens()
+    lens.set_film_size(2, 2)
+    lens.set_near_far(0, 10)
+    return render_scene(pipe, size, make_triangles(num_triangles), lens, num_frames)
+
+
+def render_scene(pipe, size, node, lens, num_frames=1):
+    """Renders the given node into an offscreen buffer of the given size, and
+    returns the contents of the color buffer and the time taken."""
+
+    engine = core.GraphicsEngine()
+    engine.set_threading_model("")
+
+    fbprops = core.FrameBufferProperties()
+    fbprops.set_rgba_bits(8, 8, 8, 8)
+    fbprops.depth_bits = 16
+
+    buffer = engine.make_output(
+        pipe,
+        'buffer',
+        0,
+        fbprops,
+        core.WindowProperties.size(size, size),
+        core.GraphicsPipe.BF_refuse_window,
+    )
+    engine.open_windows()
+
+    if buffer is None:
+        pytest.skip("Cannot make tinydisplay buffer")
+
+    buffer.set_clear_color_active(True)
+    buffer.set_clear_color((0, 0, 0, 1))
+
+    scene = core.NodePath("root")
+    scene.attach_new_node(node)
+    camera = scene.attach_new_node(core.Camera("camera", lens))
+
+    region = buffer.make_display_region()
+    region.camera = camera
+
+    color_texture = core.Texture("color")
+    buffer.add_render_texture(color_texture,
+                              core.GraphicsOutput.RTM_copy_ram,
+                              core.GraphicsOutput.RTP_color)
+
+    start = time.perf_counter()
+    for i in range(num_frames):
+        engine.render_frame()
+    elapsed = time.perf_counter() - start
+
+    buffer.clear_render_textures()
+    engine.remove_all_windows()
+
+    return bytes(color_texture.get_ram_image()), elapsed
+
+
+def test_tinydisplay_parallel_raster_identical(tiny_pipe, parallel_raster):
+    parallel_raster.set_value(False)
+    serial, _ = render_triangles(tiny_pipe, 128, 500)
+
+    parallel_raster.set_value(True)
+    parallel, _ = render_triangles(tiny_pipe, 128, 500)
+
+    # Something should actually have been drawn.
+    assert serial.count(0) < len(serial) // 2
+    assert serial == parallel
+
+
+@pytest.mark.parametrize("color", [(1, 1, 1, 1), (0.25, 0.5, 0.75, 1)],
+                         ids=["white", "flat"])
+@pytest.mark.parametrize("filter", [
+    None,
+    core.SamplerState.FT_nearest,
+    core.SamplerState.FT_linear,
+    core.SamplerState.FT_nearest_mipmap_nearest,
+    core.SamplerState.FT_linear_mipmap_nearest,
+    core.SamplerState.FT_nearest_mipmap_linear,
+    core.SamplerState.FT_linear_mipmap_linear,
+], ids=["untextured", "nearest", "linear", "nearest_mipmap_nearest",
+        "linear_mipmap_nearest", "nearest_mipmap_linear",
+        "linear_mipmap_linear"])
+def test_tinydisplay_sse2_identical(tiny_pipe, sse2, color, filter):
+    # The SSE2 fillers and texture filters should produce exactly the same
+    # pixels as the plain versions.  If the CPU doesn't support SSE2, both
+    # renders use the plain versions.
+    if filter is None:
+        node = make_triangles(300)
+        perspective_modes = [True]
+    else:
+        node = make_textured_triangles(300)
+        texture = make_noise_texture(32)
+        texture.set_minfilter(filter)
+        texture.set_magfilter(filter)
+        node.set_attrib(core.TextureAttrib.make(texture))
+        perspective_modes = [True, False]
+    node.set_attrib(core.ColorAttrib.make_flat(color))
+
+    lens = core.PerspectiveLens()
+    lens.set_fov(90)
+    lens.set_near_far(0.5, 10)
+
+    depth_write_modes = [core.DepthWriteAttrib.M_on, core.DepthWriteAttrib.M_off]
+    depth_test_modes = [core.RenderAttrib.M_less, core.RenderAttrib.M_none]
+
+    perspective = core.ConfigVariableBool('td-perspective-textures')
+    for perspective_mode in perspective_modes:
+        perspective.set_value(perspective_mode)
+        for depth_write in depth_write_modes:
+            for depth_test in depth_test_modes:
+                node.set_attrib(core.DepthWriteAttrib.make(depth_write))
+                node.set_attrib(core.DepthTestAttrib.make(depth_test))
+
+                sse2.set_value(False)
+                expected, _ = render_scene(tiny_pipe, 64, node, lens)
+
+                sse2.set_value(True)
+                result, _ = render_scene(tiny_pipe, 64, node, lens)
+
+                # Something should actually have been drawn; the clear color
+                # alone is three zero bytes out of every four.
+                assert expected.count(0) < len(expected) * 2 // 3
+                assert expected == result, \
+                    "perspective=%s, depth_write=%s, depth_test=%s" % (
+                        perspective_mode, depth_write, depth_test)
+
+
+@pytest.mark.benchmark
+def test_tinydisplay_parallel_raster_benchmark(tiny_pipe, parallel_raster):
+    # Renders a larger scene both ways, and reports the time taken; run with
+    # pytest --run-benchmarks -s to see the results.
+    parallel_raster.set_value(False)
+    serial, serial_time = render_triangles(tiny_pipe, 1024, 20000, num_frames=5)
+
+    parallel_raster.set_value(True)
+    parallel, parallel_time = render_triangles(tiny_pipe, 1024, 20000, num_frames=5)
+
+    print("tinydisplay: serial %.3f s, parallel %.3f s" % (serial_time, parallel_time))
+    assert serial == parallel
+
+
+def test_tinydisplay_hierarchical_z_identical(tiny_pipe, hierarchical_z):
+    hierarchical_z.set_value(False)
+    expected, _ = render_triangles(tiny_pipe, 128, 2000)
+
+    hierarchical_z.set_value(True)
+    result, _ = render_triangles(tiny_pipe, 128, 2000)
+
+    assert expected.count(0) < len(expected) // 2
+    assert expected == result
+
+
+def test_tinydisplay_hierarchical_z_parallel(tiny_pipe, hierarchical_z, parallel_raster):
+    hierarchical_z.set_value(False)
+    parallel_raster.set_value(False)
+    expected, _ = render_triangles(tiny_pipe, 128, 2000)
+
+    hierarchical_z.set_value(True)
+    parallel_raster.set_value(True)
+    result, _ = render_triangles(tiny_pipe, 128, 2000)
+
+    assert expected == result
@@ -0,0 +1,67 @@
+import pytest
+from panda3d import core
+
+# Skip these tests if we can't import egg.
+egg = pytest.importorskip("panda3d.egg")
+
+
+def make_egg_data(num_groups, num_quads):
+    # Makes a grid of quads for each of a number of groups, with a different
+    # color for each group, and some of them hidden.
+    data = egg.EggData()
+    pool = egg.EggVertexPool("pool")
+    data.add_child(pool)
+
+    for g in range(num_groups):
+        group = egg.EggGroup("group%d" % (g))
+        data.add_child(group)
+        for q in range(num_quads):
+            poly = egg.EggPolygon()
+            poly.set_color((g / num_groups, q / num_quads, 0.5, 1))
+            if g % 5 == 3:
+                poly.set_hidden()
+            for dx, dy in ((0, 0), (1, 0), (1, 1), (0, 1)):
+                vertex = egg.EggVertex()
+                vertex.set_pos(core.Point3D(q + dx, g + dy, 0))
+                poly.add_vertex(pool.add_vertex(vertex))
+            group.add_child(poly)
+
+    return data
+
+
+def describe(node):
+    # Returns a list describing the scene graph, including the vertices of
+    # each Geom, in order.
+    result = [(node.get_type().name, node.name, node.get_num_stashed())]
+    if isinstance(node, core.GeomNode):
+        for geom in node.get_geoms():
+            vdata = geom.get_vertex_data()
+            result.append(bytes(vdata.get_array(0).get_handle().get_data()))
+    for child in node.get_stashed():
+        result += describe(child)
+    for child in node.get_children():
+        result += describe(child)
+    return result
+
+
+@pytest.fixture
+def parallel_load():
+    var = core.ConfigVariableBool("egg-parallel-load")
+    suppress = core.ConfigVariableBool("egg-suppress-hidden")
+    suppress.set_value(False)
+    yield var
+    var.clear_local_value()
+    suppress.clear_local_value()
+
+
+def test_egg2pg_parallel_load(parallel_load):
+    results = []
+    for parallel in (False, True):
+        parallel_load.set_value(parallel)
+        root = egg.load_egg_data(make_egg_data(40, 50))
+        assert root
+        results.append(describe(root))
+
+    # The scene graph should come out exactly the same either way.
+    assert len(results[0]) > 40
+    assert results[0] == results[1]
@@ -1,4 +1,9 @@
-from panda3d.core import Multifile, StringStream, IStreamWrapper
+from panda3d.core import Multifile, StringStream, IStreamWrapper, Filename
+from panda3d.core import ConfigVariableBool
+from panda3d import core
+import pytest
+import random
+import time
 
 
 def test_multifile_read_empty():
@@ -23,3 +28,274 @@ def test_multifile_password():
 
     m.set_encryption_password(b'\xc4\x97\xa1\x01\x85\xb6')
     assert m.get_encryption_password() == b'\xc4\x97\xa1\x01\x85\xb6'
+
+
+@pytest.fixture
+def multifile_mmap():
+    var = ConfigVariableBool('multifile-mmap', False)
+    var.set_value(True)
+    yield var
+    var.clear_local_value()
+
+
+def test_multifile_mmap(tmp_path, multifile_mmap):
+    plain = bytes(range(256)) * 40
+    compressed = b'Panda3D rocks! ' * 1000
+
+    fn = Filename.from_os_specific(str(tmp_path / "test.mf"))
+    m = Multifile()
+    assert m.open_write(fn)
+    m.add_subfile("plain.bin", StringStream(plain), 0)
+    m.add_subfile("compressed.bin", StringStream(compressed), 6)
+    m.close()
+
+    m = Multifile()
+    assert m.open_read(fn)
+    assert m.is_mapped()
+
+    plain_index = m.find_subfile("plain.bin")
+    compressed_index = m.find_subfile("compressed.bin")
+    assert m.read_subfile(plain_index) == plain
+    assert m.read_subfile(compressed_index) == compressed
+
+    # Read it through the stream interface, including a seek.
+    stream = m.open_read_subfile(plain_index)
+    stream.seekg(1000)
+    assert stream.read(24) == plain[1000:1024]
+    Multifile.close_read_subfile(stream)
+    m.close()
+
+    multifile_mmap.set_value(False)
+    m = Multifile()
+    assert m.open_read(fn)
+    assert not m.is_mapped()
+    assert m.read_subfile(plain_index) == plain
+    m.close()
+
+
+def write_multifile(fn, contents, num_threads, codec=core.CC_zlib):
+    m = Multifile()
+    m.set_num_threads(num_threads)
+    m.set_compression_codec(codec)
+    m.set_record_timestamp(False)
+    assert m.open_write(fn)
+    for name, data in contents:
+        m.add_subfile(name, StringStream(data), 6)
+    assert m.flush()
+    m.close()
+
+
+def make_contents(num_subfiles, size, seed=1):
+    rand = random.Random(seed)
+    words = [bytes(rand.choice(b'abcdefghij') for i in range(rand.randint(2, 8))) for i in range(500)]
+    contents = []
+    for i in range(num_subfiles):
+        data = b' '.join(rand.choice(words) for i in range(size // 5))
+        contents.append(("asset%04d.egg" % (i), data))
+    return contents
+
+
+def test_multifile_parallel_write(tmp_path):
+    contents = make_contents(50, 20000)
+
+    serial_fn = Filename.from_os_specific(str(tmp_path / "serial.mf"))
+    parallel_fn = Filename.from_os_specific(str(tmp_path / "parallel.mf"))
+    write_multifile(serial_fn, contents, 1)
+    write_multifile(parallel_fn, contents, 4)
+
+    # The subfiles are written in the same order, so the files are identical.
+    with open(serial_fn.to_os_specific(), 'rb') as serial:
+        with open(parallel_fn.to_os_specific(), 'rb') as parallel:
+            assert serial.read() == parallel.read()
+
+    m = Multifile()
+    assert m.open_read(parallel_fn)
+    for name, data in contents:
+        index = m.find_subfile(name)
+        assert index >= 0
+        assert m.is_subfile_compressed(index)
+        assert m.read_subfile(index) == data
+    m.close()
+
+
+@pytest.mark.benchmark
+def test_multifile_parallel_write_benchmark(tmp_path):
+    # Writes a larger set of assets both ways, and reports the time taken; run
+    # with pytest --run-benchmarks -s to see the results.
+    contents = make_contents(200, 200000)
+    fn = Filename.from_os_specific(str(tmp_path / "bench.mf"))
+
+    times = []
+    for num_threads in (1, 0):
+        start = time.perf_counter()
+        write_multifile(fn, contents, num_threads)
+        times.append(time.perf_counter() - start)
+
+    print("multifile write: serial %.3f s, parallel %.3f s" % (times[0], times[1]))
+
+
+@pytest.mark.skipif(not core.is_compression_codec_available(core.CC_zstd),
+                    reason="requires zstd")
+def test_multifile_zstd(tmp_path):
+    contents = make_contents(10, 20000)
+    fn = Filename.from_os_specific(str(tmp_path / "zstd.mf"))
+    write_multifile(fn, contents, 1, core.CC_zstd)
+
+    m = Multifile()
+    assert m.open_read(fn)
+    for name, data in contents:
+        index = m.find_subfile(name)
+        assert index >= 0
+        assert m.is_subfile_compressed(index)
+        assert m.get_subfile_compression_codec(index) == core.CC_zstd
+        assert m.read_subfile(index) == data
+    m.close()
+
+    # Adding zlib-compressed subfiles to the same Multifile is fine.
+    m = Multifile()
+    assert m.open_read_write(fn)
+    m.add_subfile("zlib.egg", StringStream(contents[0][1]), 6)
+    assert m.flush()
+    m.close()
+
+    m = Multifile()
+    assert m.open_read(fn)
+    index = m.find_subfile("zlib.egg")
+    assert m.get_subfile_compression_codec(index) == core.CC_zlib
+    assert m.read_subfile(index) == contents[0][1]
+    index = m.find_subfile(contents[1][0])
+    assert m.get_subfile_compression_codec(index) == core.CC_zstd
+    assert m.read_subfile(index) == contents[1][1]
+    m.close()
+
+
+@pytest.mark.benchmark
+@pytest.mark.skipif(not core.is_compression_codec_available(core.CC_zstd),
+                    reason="requires zstd")
+def test_multifile_codec_benchmark(tmp_path):
+    # Compares the size and read time of the same assets compressed with zlib
+    # and with zstd; run with pytest --run-benchmarks -s to see the results.
+    contents = make_contents(100, 200000)
+
+    for codec in (core.CC_zlib, core.CC_zstd):
+        fn = Filename.from_os_specific(str(tmp_path / "bench.mf"))
+        write_multifile(fn, contents, 0, codec)
+        size = (tmp_path / "bench.mf").stat().st_size
+
+        m = Multifile()
+        assert m.open_read(fn)
+        start = time.perf_counter()
+        for i in range(m.get_num_subfiles()):
+            m.read_subfile(i)
+        elapsed = time.perf_counter() - start
+        m.close()
+
+        print("multifile %s: %d bytes, read %.3f s" % (codec, size, elapsed))
+
+
+def test_multifile_find_subfile(tmp_path):
+    contents = [("dir%d/file%04d.txt" % (i % 7, i), b"%d" % (i)) for i in range(2000)]
+    fn = Filename.from_os_specific(str(tmp_path / "find.mf"))
+
+    m = Multifile()
+    assert m.open_read_write(fn)
+    for name, data in contents:
+        m.add_subfile(name, StringStream(data), 0)
+
+    # Lookups work before the index is written.
+    assert m.find_subfile("dir3/file0003.txt") >= 0
+    assert m.flush()
+
+    for name, data in contents:
+        index = m.find_subfile(name)
+        assert m.get_subfile_name(index) == name
+    assert m.find_subfile("dir0/missing.txt") == -1
+    assert m.find_subfile("dir0") == -1
+
+    # Removing a subfile shifts the indices of the following ones.
+    m.remove_subfile(m.find_subfile(contents[0][0]))
+    assert m.find_subfile(contents[0][0]) == -1
+    assert m.get_subfile_name(m.find_subfile(contents[1][0])) == contents[1][0]
+    assert m.repack()
+    m.close()
+
+    m = Multifile()
+    assert m.open_read(fn)
+    assert m.find_subfile(contents[0][0]) == -1
+    for name, data in contents[1:]:
+        index = m.find_subfile(name)
+        assert m.read_subfile(index) == data
+    m.close()
+
+
+def test_multifile_vfs_path_cache(tmp_path):
+    vfs = core.VirtualFileSystem.get_global_ptr()
+    mount_point = Filename.from_os_specific(str(tmp_path / "mnt"))
+
+    fn1 = Filename.from_os_specific(str(tmp_path / "one.mf"))
+    write_multifile(fn1, [("a.txt", b"one"), ("b.txt", b"one")], 1)
+    fn2 = Filename.from_os_specific(str(tmp_path / "two.mf"))
+    write_multifile(fn2, [("a.txt", b"two")], 1)
+
+    m1 = Multifile()
+    assert m1.open_read(fn1)
+    m2 = Multifile()
+    assert m2.open_read(fn2)
+
+    assert vfs.mount(m1, mount_point, 0)
+    try:
+        assert vfs.read_file(Filename(mount_point, "a.txt"), True) == b"one"
+        assert vfs.read_file(Filename(mount_point, "a.txt"), True) == b"one"
+
+        # A later mount overrides the earlier one, even though the path has
+        # already been looked up.
+        assert vfs.mount(m2, mount_point, 0)
+        assert vfs.read_file(Filename(mount_point, "a.txt"), True) == b"two"
+        assert vfs.read_file(Filename(mount_point, "b.txt"), True) == b"one"
+
+        vfs.unmount(m2)
+        assert vfs.read_file(Filename(mount_point, "a.txt"), True) == b"one"
+
+        vfs.unmount(m1)
+        assert not vfs.exists(Filename(mount_point, "a.txt"))
+    finally:
+        vfs.unmount(m1)
+        vfs.unmount(m2)
+
+
+@pytest.mark.benchmark
+def test_multifile_vfs_lookup_benchmark(tmp_path):
+    # Looks up every file in a large Multifile mounted among several others,
+    # and reports the time taken; run with pytest --run-benchmarks -s to see
+    # the results.
+    vfs = core.VirtualFileSystem.get_global_ptr()
+    mount_point = Filename.from_os_specific(str(tmp_path / "mnt"))
+    names = ["phase_%d/models/file%05d.bam" % (i % 5, i) for i in range(20000)]
+
+    fn = Filename.from_os_specific(str(tmp_path / "phase.mf"))
+    write_multifile(fn, [(name, b"") for name in names], 1)
+
+    multifiles = []
+    for i in range(10):
+        m = Multifile()
+        assert m.open_read(fn)
+        multifiles.append(m)
+        assert vfs.mount(m, Filename(mount_point, "other%d" % (i)), 0)
+    m = Multifile()
+    assert m.open_read(fn)
+    multifiles.append(m)
+    assert vfs.mount(m, mount_point, 0)
+
+    cache = core.ConfigVariableBool("vfs-path-cache")
+    try:
+        for value in (False, True):
+            cache.set_value(value)
+            start = time.perf_counter()
+            for i in range(2):
+                for name in names:
+                    assert vfs.exists(Filename(mount_point, name))
+            print("vfs lookup (path cache %s): %.3f s" % (value, time.perf_counter() - start))
+    finally:
+        cache.clear_local_value()
+        for m in multifiles:
+            vfs.unmount(m)
@@ -0,0 +1,152 @@
+from panda3d.core import VirtualFileSystem, Filename, Multifile, StringStream
+from panda3d.core import ConfigVariableInt64
+import pytest
+import time
+
+
+@pytest.fixture
+def vfs():
+    vfs = VirtualFileSystem.get_global_ptr()
+    vfs.clear_prefetch_cache()
+    vfs.reset_prefetch_stats()
+    yield vfs
+    vfs.clear_prefetch_cache()
+    vfs.reset_prefetch_stats()
+
+
+def wait_for_prefetch(vfs, size):
+    # Waits for the background threads to finish reading the given number of
+    # bytes.
+    deadline = time.time() + 10
+    while vfs.get_prefetch_cache_size() < size and time.time() < deadline:
+        time.sleep(0.01)
+    assert vfs.get_prefetch_cache_size() == size
+
+
+def make_files(tmp_path, num_files, size):
+    filenames = []
+    for i in range(num_files):
+        path = tmp_path / ("file%04d.txt" % (i))
+        path.write_bytes(b"%04d" % (i) * (size // 4))
+        filenames.append(Filename.from_os_specific(str(path)))
+    return filenames
+
+
+def test_vfs_prefetch(vfs, tmp_path):
+    filenames = make_files(tmp_path, 10, 1000)
+    for fn in filenames[:5]:
+        vfs.prefetch(fn)
+    wait_for_prefetch(vfs, 5000)
+
+    for i, fn in enumerate(filenames):
+        assert vfs.read_file(fn, True) == b"%04d" % (i) * 250
+
+    assert vfs.get_prefetch_hits() == 5
+    assert vfs.get_prefetch_misses() == 0
+    assert vfs.get_prefetch_cache_size() == 0
+
+    # Each prefetched file is only handed out once.
+    assert vfs.read_file(filenames[0], True) == b"0000" * 250
+    assert vfs.get_prefetch_hits() == 5
+
+
+def test_vfs_prefetch_list(vfs, tmp_path):
+    filenames = make_files(tmp_path, 3, 1000)
+    vfs.prefetch([fn.get_fullpath() for fn in filenames])
+    wait_for_prefetch(vfs, 3000)
+
+    for i, fn in enumerate(filenames):
+        assert vfs.read_file(fn, True) == b"%04d" % (i) * 250
+
+    assert vfs.get_prefetch_hits() == 3
+    assert vfs.get_prefetch_misses() == 0
+
+
+def test_vfs_prefetch_stream(vfs, tmp_path):
+    filenames = make_files(tmp_path, 2, 1000)
+    vfs.prefetch(filenames[0])
+    vfs.prefetch(Filename.from_os_specific(str(tmp_path / "nonexistent.txt")))
+    wait_for_prefetch(vfs, 1000)
+
+    # A file that wasn't prefetched is a miss, as long as something was.
+    assert vfs.read_file(filenames[1], True) == b"0001" * 250
+    assert vfs.get_prefetch_misses() == 1
+
+    stream = vfs.open_read_file(filenames[0], True)
+    assert stream.read() == b"0000" * 250
+    vfs.close_read_file(stream)
+    assert vfs.get_prefetch_hits() == 1
+
+
+def test_vfs_prefetch_multifile(vfs, tmp_path):
+    mf_fn = Filename.from_os_specific(str(tmp_path / "test.mf"))
+    mount_point = Filename.from_os_specific(str(tmp_path / "mnt"))
+
+    m = Multifile()
+    assert m.open_write(mf_fn)
+    m.add_subfile("a.txt", StringStream(b"a" * 10000), 6)
+    m.add_subfile("b.txt", StringStream(b"b" * 10000), 6)
+    assert m.flush()
+    m.close()
+
+    m = Multifile()
+    assert m.open_read(mf_fn)
+    assert vfs.mount(m, mount_point, 0)
+    try:
+        vfs.prefetch(Filename(mount_point, "a.txt"))
+        vfs.prefetch(Filename(mount_point, "b.txt"))
+        wait_for_prefetch(vfs, 20000)
+        assert vfs.read_file(Filename(mount_point, "a.txt"), True) == b"a" * 10000
+        assert vfs.get_prefetch_hits() == 1
+
+        # Unmounting throws away the rest.
+        vfs.unmount(m)
+        assert vfs.get_prefetch_cache_size() == 0
+    finally:
+        vfs.unmount(m)
+
+
+def test_vfs_prefetch_cache_size(vfs, tmp_path):
+    filenames = make_files(tmp_path, 10, 1000)
+    cache_size = ConfigVariableInt64("vfs-prefetch-cache-size")
+    cache_size.set_value(5000)
+    try:
+        for fn in filenames:
+            vfs.prefetch(fn)
+
+        # No more than five files fit at once; older ones are discarded as
+        # the rest come in.
+        wait_for_prefetch(vfs, 5000)
+        for i in range(20):
+            assert vfs.get_prefetch_cache_size() <= 5000
+            time.sleep(0.01)
+
+        for i, fn in enumerate(filenames):
+            assert vfs.read_file(fn, True) == b"%04d" % (i) * 250
+        assert vfs.get_prefetch_cache_size() == 0
+    finally:
+        cache_size.clear_local_value()
+
+
+@pytest.mark.benchmark
+def test_vfs_prefetch_benchmark(vfs, tmp_path):
+    # Reads a few hundred small files, with and without prefetching them first,
+    # and reports the time taken; run with pytest --run-benchmarks -s to see
+    # the results.  Since the files are probably in the OS cache, this mostly
+    # measures the overhead rather than the benefit of hiding disk latency.
+    filenames = make_files(tmp_path, 500, 20000)
+
+    start = time.perf_counter()
+    for fn in filenames:
+        vfs.read_file(fn, True)
+    serial = time.perf_counter() - start
+
+    start = time.perf_counter()
+    for fn in filenames:
+        vfs.prefetch(fn)
+    for fn in filenames:
+        vfs.read_file(fn, True)
+    prefetched = time.perf_counter() - start
+
+    print("vfs read: direct %.3f s, prefetched %.3f s (%d hits, %d misses)" % (
+        serial, prefetched, vfs.get_prefetch_hits(), vfs.get_prefetch_misses()))
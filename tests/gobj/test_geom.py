@@ -82,3 +82,97 @@ def test_geom_calc_box_bounds():
     assert isinstance(bounds, core.BoundingBox)
     assert bounds.get_min() == (1, 1, 1)
     assert bounds.get_max() == (1, 1, 2)
+
+
+def make_grid_geom(size):
+    vdata = core.GeomVertexData("grid", core.GeomVertexFormat.get_v3t2(), core.GeomEnums.UH_static)
+    vertex = core.GeomVertexWriter(vdata, "vertex")
+    texcoord = core.GeomVertexWriter(vdata, "texcoord")
+    for y in range(size + 1):
+        for x in range(size + 1):
+            vertex.add_data3(x, y, 0)
+            texcoord.add_data2(x, y)
+
+    prim = core.GeomTriangles(core.GeomEnums.UH_static)
+    for y in range(size):
+        for x in range(size):
+            i = y * (size + 1) + x
+            prim.add_vertices(i, i + 1, i + size + 2)
+            prim.add_vertices(i, i + size + 2, i + size + 1)
+
+    geom = core.Geom(vdata)
+    geom.add_primitive(prim)
+    return geom
+
+
+def test_geom_simplify():
+    geom = make_grid_geom(20)
+    assert geom.get_primitive(0).get_num_faces() == 800
+
+    simple = geom.simplify(0.25)
+    assert geom.get_primitive(0).get_num_faces() == 800
+    assert 0 < simple.get_primitive(0).get_num_faces() <= 200
+
+    # The corners of the grid should be preserved.
+    verts = set(simple.get_primitive(0).get_vertex_list())
+    assert {0, 20, 420, 440} <= verts
+
+
+def test_geom_simplify_seam():
+    # A grid that is split down the middle by a UV seam: the vertices of the
+    # middle column appear twice, with different texcoords on either side.
+    size = 20
+    mid = size // 2
+    vdata = core.GeomVertexData("grid", core.GeomVertexFormat.get_v3t2(), core.GeomEnums.UH_static)
+    vertex = core.GeomVertexWriter(vdata, "vertex")
+    texcoord = core.GeomVertexWriter(vdata, "texcoord")
+    for y in range(size + 1):
+        for x in range(size + 1):
+            vertex.add_data3(x, y, 0)
+            texcoord.add_data2(x, y)
+
+    # The rows for the right side of the seam come after the grid.
+    seam_rows = {}
+    for y in range(size + 1):
+        seam_rows[y * (size + 1) + mid] = vdata.get_num_rows()
+        vertex.add_data3(mid, y, 0)
+        texcoord.add_data2(mid + 100, y)
+
+    prim = core.GeomTriangles(core.GeomEnums.UH_static)
+    for y in range(size):
+        for x in range(size):
+            i = y * (size + 1) + x
+            quad = [i, i + 1, i + size + 2, i + size + 1]
+            if x >= mid:
+                quad = [seam_rows.get(v, v) for v in quad]
+            prim.add_vertices(quad[0], quad[1], quad[2])
+            prim.add_vertices(quad[0], quad[2], quad[3])
+
+    geom = core.Geom(vdata)
+    geom.add_primitive(prim)
+
+    simple = geom.simplify(0.25)
+    prim = simple.get_primitive(0)
+    assert 0 < prim.get_num_faces() <= 200
+
+    def is_right(row):
+        return row >= (size + 1) ** 2 or row % (size + 1) > mid
+
+    left_seam = set()
+    right_seam = set()
+    for i in range(prim.get_num_faces()):
+        rows = [prim.get_vertex(prim.get_primitive_start(i) + k) for k in range(3)]
+
+        # No triangle may mix the rows of both sides of the seam.
+        sides = [is_right(row) for row in rows]
+        assert all(sides) or not any(sides)
+
+        for row in rows:
+            if row in seam_rows:
+                left_seam.add(row // (size + 1))
+            elif row >= (size + 1) ** 2:
+                right_seam.add(row - (size + 1) ** 2)
+
+    # Vertices were removed along the seam, on both sides at once.
+    assert 2 <= len(left_seam) < size + 1
+    assert left_seam == right_seam
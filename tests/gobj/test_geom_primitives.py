@@ -163,3 +163,41 @@ def test_geom_linestrips_offset_indexed():
         cut,
         100103, 100104, 100005, 100006,
     )
+
+
+def test_geom_triangles_optimize_vertex_cache():
+    import random
+
+    # Make a regular grid of triangles, and shuffle the triangles.
+    size = 20
+    tris = []
+    for y in range(size):
+        for x in range(size):
+            v = y * (size + 1) + x
+            tris.append((v, v + 1, v + size + 2))
+            tris.append((v, v + size + 2, v + size + 1))
+    random.Random(1).shuffle(tris)
+
+    prim = core.GeomTriangles(core.GeomEnums.UH_static)
+    for tri in tris:
+        prim.add_vertices(*tri)
+        prim.close_primitive()
+
+    before = prim.calc_acmr(32)
+    assert before > 2.0
+
+    opt = prim.optimize_vertex_cache(32)
+    after = opt.calc_acmr(32)
+    assert after < 1.0
+
+    # The same triangles should still be drawn, with the same winding order.
+    def normalize(verts):
+        result = []
+        for i in range(0, len(verts), 3):
+            a, b, c = verts[i:i + 3]
+            while a != min(a, b, c):
+                a, b, c = b, c, a
+            result.append((a, b, c))
+        return sorted(result)
+
+    assert normalize(opt.get_vertex_list()) == normalize(prim.get_vertex_list())
@@ -0,0 +1,146 @@
+from panda3d import core
+import pytest
+import time
+
+
+@pytest.fixture
+def bam_deferred():
+    version = core.ConfigVariableInt('bam-version')
+    size = core.ConfigVariableInt('bam-deferred-vertex-data-size')
+    lazy = core.ConfigVariableBool('bam-lazy-vertex-data')
+
+    version.set_string_value('6 47')
+    size.set_value(1024)
+    yield lazy
+    version.clear_local_value()
+    size.clear_local_value()
+    lazy.clear_local_value()
+
+
+def make_array(num_rows):
+    array = core.GeomVertexArrayData(core.GeomVertexFormat.get_v3().arrays[0], core.Geom.UH_static)
+    data = bytes(i % 251 for i in range(num_rows * 12))
+    array.modify_handle().set_data(data)
+    return array, data
+
+
+def write_bam(filename, objects):
+    bam = core.BamFile()
+    assert bam.open_write(filename)
+    for obj in objects:
+        assert bam.write_object(obj)
+    bam.close()
+
+
+def read_bam(filename, count):
+    bam = core.BamFile()
+    assert bam.open_read(filename)
+    assert bam.get_file_minor_ver() == 47
+    objects = [bam.read_object() for i in range(count)]
+    assert bam.resolve()
+    bam.close()
+    return objects
+
+
+@pytest.mark.parametrize("lazy", [False, True])
+@pytest.mark.parametrize("extension", [".bam", ".bam.pz"])
+def test_geom_vertex_array_data_bam_deferred(bam_deferred, tmp_path, lazy, extension):
+    bam_deferred.set_value(lazy)
+    small, small_data = make_array(10)
+    large, large_data = make_array(1000)
+
+    filename = core.Filename.from_os_specific(str(tmp_path / ("arrays" + extension)))
+    write_bam(filename, [small, large])
+
+    small, large = read_bam(filename, 2)
+    assert large.get_num_rows() == 1000
+    assert small.get_handle().get_data() == small_data
+    assert large.get_handle().get_data() == large_data
+
+
+def test_geom_vertex_array_data_bam_mapped(bam_deferred, tmp_path):
+    map_data = core.ConfigVariableBool('bam-map-file-data')
+    map_data.set_value(True)
+    try:
+        small, small_data = make_array(10)
+        large, large_data = make_array(1000)
+
+        filename = core.Filename.from_os_specific(str(tmp_path / "arrays.bam"))
+        write_bam(filename, [small, large])
+        small, large = read_bam(filename, 2)
+    finally:
+        map_data.clear_local_value()
+
+    assert small.get_handle().get_data() == small_data
+    assert large.get_handle().get_data() == large_data
+
+    # Modifying the array should make a private copy, and leave the file
+    # alone.
+    large.modify_handle().set_subdata(0, 4, b"abcd")
+    assert large.get_handle().get_data() == b"abcd" + large_data[4:]
+    assert read_bam(filename, 2)[1].get_handle().get_data() == large_data
+
+
+def test_texture_bam_deferred_ram_image(bam_deferred, tmp_path):
+    tex = core.Texture("test")
+    tex.setup_2d_texture(128, 128, core.Texture.T_unsigned_byte, core.Texture.F_rgba)
+    image = bytes(i % 251 for i in range(128 * 128 * 4))
+    tex.set_ram_image(image)
+
+    filename = core.Filename.from_os_specific(str(tmp_path / "texture.bam"))
+    write_bam(filename, [tex])
+
+    tex, = read_bam(filename, 1)
+    assert tex.get_x_size() == 128
+    assert bytes(tex.get_ram_image()) == image
+
+
+def test_geom_vertex_array_data_bam_deferred_stream(bam_deferred, tmp_path):
+    array, data = make_array(1000)
+    filename = core.Filename.from_os_specific(str(tmp_path / "arrays.bam"))
+    write_bam(filename, [array])
+
+    # A BamReader on a generator that doesn't come from a file should still
+    # be able to read the separate record.  Skip the file header.
+    buffer = core.DatagramBuffer(open(str(tmp_path / "arrays.bam"), 'rb').read()[6:])
+    reader = core.BamReader(buffer)
+    assert reader.init()
+    array = reader.read_object()
+    assert reader.resolve()
+    assert array.get_handle().get_data() == data
+
+    # When not writing to a file, the data is always written inline.
+    buffer = core.DatagramBuffer()
+    writer = core.BamWriter(buffer)
+    assert writer.get_file_minor_ver() == 47
+    assert writer.init()
+    assert writer.write_object(array)
+    writer.flush()
+
+    reader = core.BamReader(core.DatagramBuffer(buffer.data))
+    assert reader.init()
+    array = reader.read_object()
+    assert reader.resolve()
+    assert array.get_handle().get_data() == data
+
+
+@pytest.mark.benchmark
+def test_geom_vertex_array_data_bam_deferred_benchmark(bam_deferred, tmp_path):
+    # Loads a file full of large vertex arrays, with and without deferring the
+    # vertex data, and reports the time taken; run with
+    # pytest --run-benchmarks -s to see the results.
+    arrays = [make_array(20000)[0] for i in range(50)]
+    filename = core.Filename.from_os_specific(str(tmp_path / "arrays.bam"))
+    write_bam(filename, arrays)
+
+    times = []
+    for lazy in (False, True):
+        bam_deferred.set_value(lazy)
+        start = time.perf_counter()
+        result = read_bam(filename, len(arrays))
+        times.append(time.perf_counter() - start)
+
+    # The lazily loaded data should still be there when we ask for it.
+    assert result[-1].get_handle().get_data() == arrays[-1].get_handle().get_data()
+
+    print("bam load with %d vertex arrays: eager %.3f s, lazy %.3f s" % (len(arrays), times[0], times[1]))
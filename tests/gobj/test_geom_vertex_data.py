@@ -0,0 +1,146 @@
+from panda3d import core
+import pytest
+import random
+import time
+
+
+@pytest.fixture
+def parallel_skinning():
+    var = core.ConfigVariableBool('parallel-skinning', False)
+    min_vertices = core.ConfigVariableInt('parallel-skinning-min-vertices', 4096)
+
+    # Make sure that even the small test meshes are split between threads.
+    min_vertices.set_value(1)
+    yield var
+    var.clear_local_value()
+    min_vertices.clear_local_value()
+
+
+def make_skinned_vdata(num_rows, num_joints, seed=1):
+    """Returns a GeomVertexData with random vertices and normals, each of which
+    is assigned to a blend of up to four of the given number of joints, along
+    with the list of joint transforms."""
+
+    rand = random.Random(seed)
+
+    array = core.GeomVertexArrayFormat()
+    array.add_column("vertex", 3, core.Geom.NT_float32, core.Geom.C_point)
+    array.add_column("normal", 3, core.Geom.NT_float32, core.Geom.C_normal)
+    blend_array = core.GeomVertexArrayFormat()
+    blend_array.add_column("transform_blend", 1, core.Geom.NT_uint16, core.Geom.C_index)
+
+    format = core.GeomVertexFormat()
+    format.add_array(array)
+    format.add_array(blend_array)
+    spec = core.GeomVertexAnimationSpec()
+    spec.set_panda()
+    format.set_animation(spec)
+    format = core.GeomVertexFormat.register_format(format)
+
+    joints = [core.UserVertexTransform("joint%d" % (i)) for i in range(num_joints)]
+
+    table = core.TransformBlendTable()
+    for i in range(num_rows // 4 + 1):
+        blend = core.TransformBlend()
+        for joint in rand.sample(joints, rand.randint(1, min(4, num_joints))):
+            blend.add_transform(joint, rand.random() + 0.1)
+        blend.normalize_weights()
+        table.add_blend(blend)
+    table.set_rows(core.SparseArray.lower_on(num_rows))
+
+    vdata = core.GeomVertexData("skinned", format, core.Geom.UH_static)
+    vdata.set_transform_blend_table(table)
+    vdata.unclean_set_num_rows(num_rows)
+
+    vertex = core.GeomVertexWriter(vdata, "vertex")
+    normal = core.GeomVertexWriter(vdata, "normal")
+    blend_index = core.GeomVertexWriter(vdata, "transform_blend")
+    for i in range(num_rows):
+        vertex.set_data3(rand.uniform(-1, 1), rand.uniform(-1, 1), rand.uniform(-1, 1))
+        normal.set_data3(core.LVector3(rand.uniform(-1, 1), rand.uniform(-1, 1), 1).normalized())
+        blend_index.set_data1i(rand.randrange(table.get_num_blends()))
+
+    return vdata, joints
+
+
+def pose_joints(joints, seed=2, uniform_scale=False):
+    rand = random.Random(seed)
+    for joint in joints:
+        if uniform_scale:
+            scale = (rand.uniform(0.5, 2),) * 3
+        else:
+            scale = (rand.uniform(0.5, 2), rand.uniform(0.5, 2), rand.uniform(0.5, 2))
+        mat = core.LMatrix4()
+        core.compose_matrix(mat, scale, (0, 0, 0),
+                            (rand.uniform(-180, 180), rand.uniform(-90, 90), rand.uniform(-180, 180)),
+                            (rand.uniform(-5, 5), rand.uniform(-5, 5), rand.uniform(-5, 5)))
+        joint.set_matrix(mat)
+
+
+def expected_vertices(vdata):
+    """Computes the animated vertices the slow way, in Python."""
+
+    table = vdata.get_transform_blend_table()
+    vertex = core.GeomVertexReader(vdata, "vertex")
+    normal = core.GeomVertexReader(vdata, "normal")
+    blend_index = core.GeomVertexReader(vdata, "transform_blend")
+
+    result = []
+    while not vertex.is_at_end():
+        blend = table.get_blend(blend_index.get_data1i())
+        mat = core.LMatrix4()
+        blend.get_blend(mat, core.Thread.get_current_thread())
+        nmat = core.LMatrix4()
+        nmat.invert_from(mat)
+        nmat.transpose_in_place()
+        result.append((mat.xform_point(vertex.get_data3()),
+                       nmat.xform_vec(normal.get_data3()).normalized()))
+    return result
+
+
+def check_vertices(animated, expected):
+    vertex = core.GeomVertexReader(animated, "vertex")
+    normal = core.GeomVertexReader(animated, "normal")
+    for pos, norm in expected:
+        assert vertex.get_data3().almost_equal(pos, 1e-3)
+        assert normal.get_data3().almost_equal(norm, 1e-3)
+    assert vertex.is_at_end()
+
+
+@pytest.mark.parametrize("uniform_scale", [False, True])
+def test_geom_vertex_data_animate_vertices(parallel_skinning, uniform_scale):
+    vdata, joints = make_skinned_vdata(1000, 8)
+    pose_joints(joints, uniform_scale=uniform_scale)
+    expected = expected_vertices(vdata)
+
+    thread = core.Thread.get_current_thread()
+    parallel_skinning.set_value(False)
+    check_vertices(vdata.animate_vertices(True, thread), expected)
+
+    # Pose the joints differently, to make sure the vertices are recomputed.
+    pose_joints(joints, seed=3, uniform_scale=uniform_scale)
+    expected = expected_vertices(vdata)
+
+    parallel_skinning.set_value(True)
+    check_vertices(vdata.animate_vertices(True, thread), expected)
+
+
+@pytest.mark.benchmark
+def test_geom_vertex_data_skinning_benchmark(parallel_skinning):
+    # Animates a number of characters both ways, and reports the time taken;
+    # run with pytest --run-benchmarks -s to see the results.
+    characters = [make_skinned_vdata(6000, 50, seed=i) for i in range(80)]
+    thread = core.Thread.get_current_thread()
+
+    for num_characters in (1, 10, 80):
+        times = []
+        for parallel in (False, True):
+            parallel_skinning.set_value(parallel)
+            start = time.perf_counter()
+            for frame in range(5):
+                for vdata, joints in characters[:num_characters]:
+                    pose_joints(joints, seed=frame)
+                    vdata.animate_vertices(True, thread)
+            times.append(time.perf_counter() - start)
+
+        print("skinning %d characters: serial %.3f s, parallel %.3f s" % (num_characters, times[0], times[1]))
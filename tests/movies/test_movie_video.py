@@ -1,3 +1,4 @@
+from panda3d import core
 from panda3d.core import MovieVideo
 from panda3d.core import Filename
 from panda3d.core import PandaSystem
@@ -37,3 +38,47 @@ class Test_Video_Movie():
         cursor = reference_file.open()
         assert cursor.size_x() == 640 #found the height and width using mkvinfo
         assert cursor.size_y() == 360
+
+
+@pytest.mark.skipif(not check_ffmpeg(), reason="skip when ffmpeg is not available")
+def test_video_bam_file_data(tmp_path):
+    # The movie data is written with the older write_file_data overloads,
+    # which must produce the same record layout as the aligned vertex data
+    # that is written alongside it.
+    version = core.ConfigVariableInt('bam-version')
+    size = core.ConfigVariableInt('bam-deferred-vertex-data-size')
+    version.set_string_value('6 47')
+    size.set_value(1024)
+
+    try:
+        movie_path = os.path.join(os.path.dirname(__file__), "small.mp4")
+        movie_path = Filename.from_os_specific(movie_path)
+        video = MovieVideo.get(movie_path)
+
+        fmt = core.GeomVertexFormat.get_v3().arrays[0]
+        array = core.GeomVertexArrayData(fmt, core.Geom.UH_static)
+        data = bytes(i % 251 for i in range(1000 * 12))
+        array.modify_handle().set_data(data)
+
+        filename = Filename.from_os_specific(str(tmp_path / "video.bam"))
+        bam = core.BamFile()
+        assert bam.open_write(filename)
+        assert bam.write_object(array)
+        assert bam.write_object(video)
+        bam.close()
+
+        bam = core.BamFile()
+        assert bam.open_read(filename)
+        assert bam.get_file_minor_ver() == 47
+        objects = [bam.read_object() for i in range(2)]
+        assert bam.resolve()
+        bam.close()
+    finally:
+        version.clear_local_value()
+        size.clear_local_value()
+
+    array, video = objects
+    assert array.get_handle().get_data() == data
+    assert not video.get_subfile_info().is_empty()
+    assert video.get_subfile_info().get_size() == os.path.getsize(movie_path.to_os_specific())
+    assert video.open() is not None
@@ -0,0 +1,188 @@
+from panda3d import core
+import pytest
+
+
+@pytest.fixture
+def persistent_cull():
+    var = core.ConfigVariableBool('persistent-cull')
+    var.set_value(True)
+    yield var
+    var.clear_local_value()
+
+
+@pytest.fixture(scope='module')
+def tiny_pipe():
+    selection = core.GraphicsPipeSelection.get_global_ptr()
+    pipe = selection.make_pipe('TinyOffscreenGraphicsPipe', 'p3tinydisplay')
+
+    if pipe is None or not pipe.is_valid():
+        pytest.skip("TinyOffscreenGraphicsPipe is not available")
+
+    yield pipe
+
+
+@pytest.fixture
+def scene(tiny_pipe):
+    """Yields a scene with a red card filling the view, the DisplayRegion
+    looking at it, and a function that renders a frame and returns the color
+    in the middle of the buffer."""
+
+    engine = core.GraphicsEngine()
+    engine.set_threading_model("")
+
+    buffer = engine.make_output(
+        tiny_pipe,
+        'buffer',
+        0,
+        core.FrameBufferProperties(),
+        core.WindowProperties.size(16, 16),
+        core.GraphicsPipe.BF_refuse_window,
+    )
+    engine.open_windows()
+
+    if buffer is None:
+        pytest.skip("Cannot make tinydisplay buffer")
+
+    root = core.NodePath("root")
+    lens = core.OrthographicLens()
+    lens.set_film_size(2, 2)
+    lens.set_near_far(1, 10)
+    camera = root.attach_new_node(core.Camera("camera", lens))
+
+    region = buffer.make_display_region()
+    region.camera = camera
+
+    maker = core.CardMaker("card")
+    maker.set_frame(-2, 2, -2, 2)
+    card = root.attach_new_node("parent").attach_new_node(maker.generate())
+    card.set_y(5)
+    card.node().set_geom_state(0, core.RenderState.make(core.ColorAttrib.make_flat((1, 0, 0, 1))))
+
+    texture = core.Texture("color")
+    buffer.add_render_texture(texture,
+                              core.GraphicsOutput.RTM_copy_ram,
+                              core.GraphicsOutput.RTP_color)
+
+    def render():
+        engine.render_frame()
+        color = core.LColor()
+        texture.peek().lookup(color, 0.5, 0.5)
+        return color
+
+    try:
+        yield root, card, region, render
+    finally:
+        buffer.clear_render_textures()
+        engine.remove_all_windows()
+
+
+def test_persistent_cull_reuse(persistent_cull, scene):
+    root, card, region, render = scene
+    trav = region.get_cull_traverser()
+
+    assert render().almost_equal((1, 0, 0, 1))
+    assert trav.get_num_nodes_reused() == 0
+    assert trav.get_num_nodes_recomputed() > 0
+
+    # Nothing has changed, so the whole scene is reused.
+    assert render().almost_equal((1, 0, 0, 1))
+    assert trav.get_num_nodes_reused() > 0
+    assert trav.get_num_nodes_recomputed() == 0
+
+
+def test_persistent_cull_disabled(persistent_cull, scene):
+    persistent_cull.set_value(False)
+    root, card, region, render = scene
+    trav = region.get_cull_traverser()
+
+    render()
+    render()
+    assert trav.get_num_nodes_reused() == 0
+    assert trav.get_num_nodes_recomputed() == 0
+
+
+def test_persistent_cull_geom_state(persistent_cull, scene):
+    root, card, region, render = scene
+    trav = region.get_cull_traverser()
+    render()
+    render()
+
+    card.node().set_geom_state(0, core.RenderState.make(core.ColorAttrib.make_flat((0, 0, 1, 1))))
+    assert render().almost_equal((0, 0, 1, 1))
+    assert trav.get_num_nodes_reused() == 0
+    assert trav.get_num_nodes_recomputed() > 0
+
+    assert render().almost_equal((0, 0, 1, 1))
+    assert trav.get_num_nodes_reused() > 0
+
+
+def test_persistent_cull_node_change(persistent_cull, scene):
+    root, card, region, render = scene
+    trav = region.get_cull_traverser()
+    render()
+    render()
+
+    # A state change on the node is noticed through its update sequence.
+    card.set_color_scale((0, 1, 1, 1))
+    assert render().almost_equal((0, 0, 0, 1))
+    assert trav.get_num_nodes_reused() == 0
+    assert trav.get_num_nodes_recomputed() > 0
+
+    # So is a change to its transform.
+    card.set_x(1)
+    assert render().almost_equal((0, 0, 0, 1))
+    assert trav.get_num_nodes_reused() == 0
+    assert trav.get_num_nodes_recomputed() > 0
+
+    render()
+    assert trav.get_num_nodes_reused() > 0
+
+
+def test_persistent_cull_effects(persistent_cull, scene):
+    root, card, region, render = scene
+    trav = region.get_cull_traverser()
+    render()
+    render()
+
+    card.set_effect(core.DecalEffect.make())
+    render()
+    assert trav.get_num_nodes_reused() == 0
+    assert trav.get_num_nodes_recomputed() > 0
+
+    render()
+    assert trav.get_num_nodes_reused() > 0
+
+    card.clear_effect(core.DecalEffect)
+    render()
+    assert trav.get_num_nodes_reused() == 0
+
+    render()
+    card.node().set_effects(core.RenderEffects.make_empty())
+    render()
+    assert trav.get_num_nodes_reused() == 0
+
+
+@pytest.mark.skipif(not hasattr(core, 'MovieTexture'),
+                    reason="Panda was built without audio support")
+@pytest.mark.parametrize("where", ["node", "parent", "geom"])
+def test_persistent_cull_state_cull_callback(persistent_cull, scene, where):
+    # A MovieTexture needs to be updated by the cull traversal every frame,
+    # so nothing rendered with it may be reused.
+    root, card, region, render = scene
+    trav = region.get_cull_traverser()
+
+    texture = core.MovieTexture("movie")
+    if where == "node":
+        card.set_texture(texture)
+    elif where == "parent":
+        card.get_parent().set_texture(texture)
+    else:
+        state = card.node().get_geom_state(0)
+        card.node().set_geom_state(0, state.add_attrib(core.TextureAttrib.make(texture)))
+
+    assert card.get_net_state().compose(card.node().get_geom_state(0)).has_cull_callback()
+
+    for i in range(3):
+        render()
+        assert trav.get_num_nodes_reused() == 0
+        assert trav.get_num_nodes_recomputed() > 0
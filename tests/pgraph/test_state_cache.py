@@ -0,0 +1,216 @@
+from panda3d.core import TransformState, RenderState, ColorScaleAttrib
+from panda3d.core import DepthWriteAttrib, CullFaceAttrib
+from panda3d.core import Thread, Randomizer, ConfigVariableInt
+import pytest
+import time
+
+
+def make_transforms(count):
+    return [TransformState.make_pos((i, i * 2, 0)) for i in range(count)]
+
+
+def test_transform_cache_compose_repeat():
+    a, b = make_transforms(2)
+
+    # The second composition may be answered by the per-thread cache.
+    ab = a.compose(b)
+    assert a.compose(b) == ab
+    assert ab.pos == (1, 2, 0)
+
+    inv = a.invert_compose(ab)
+    assert a.invert_compose(ab) == inv
+    assert inv.pos == b.pos
+
+
+def test_state_cache_compose_repeat():
+    a = RenderState.make(ColorScaleAttrib.make((0.5, 1, 1, 1)))
+    b = RenderState.make(ColorScaleAttrib.make((0.5, 0.5, 1, 1)))
+
+    ab = a.compose(b)
+    assert a.compose(b) == ab
+    assert ab.get_attrib(ColorScaleAttrib).scale == (0.25, 0.5, 1, 1)
+
+    assert a.invert_compose(ab) == a.invert_compose(ab)
+
+
+def test_transform_cache_states():
+    transforms = make_transforms(100)
+
+    # All of the transforms should be findable, regardless of the shard of
+    # the table they were stored in.
+    states = TransformState.get_states()
+    assert TransformState.get_num_states() >= len(transforms)
+    for transform in transforms:
+        assert transform in states
+
+    assert TransformState.validate_states()
+
+
+def test_state_cache_clear():
+    a = RenderState.make(ColorScaleAttrib.make((0.5, 1, 1, 1)))
+    b = RenderState.make(ColorScaleAttrib.make((1, 0.5, 1, 1)))
+    ab = a.compose(b)
+    assert a.get_composition_cache_num_entries() > 0
+
+    RenderState.clear_cache()
+    RenderState.garbage_collect()
+    assert a.get_composition_cache_num_entries() == 0
+
+    # The result must still be computed correctly afterwards.
+    assert a.compose(b) == ab
+    assert RenderState.validate_states()
+
+
+@pytest.mark.skipif(not Thread.is_threading_supported(),
+                    reason="Threading support disabled")
+def test_transform_cache_threads():
+    threading = pytest.importorskip("direct.stdpy.threading")
+
+    transforms = make_transforms(32)
+    expected = [[a.compose(b) for b in transforms] for a in transforms]
+    errors = []
+
+    def compose_all():
+        for i, a in enumerate(transforms):
+            for j, b in enumerate(transforms):
+                if a.compose(b) != expected[i][j]:
+                    errors.append((i, j))
+
+    threads = [threading.Thread(target=compose_all) for i in range(4)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+    assert not errors
+    TransformState.garbage_collect()
+    assert TransformState.validate_states()
+
+
+@pytest.mark.skipif(not Thread.is_threading_supported(),
+                    reason="Threading support disabled")
+def test_state_cache_threads_garbage_collect():
+    # Several threads compose random pairs of transforms and states, the way
+    # the app and cull threads do in pipelined mode, while the main thread
+    # collects garbage at the end of every "frame".
+    threading = pytest.importorskip("direct.stdpy.threading")
+
+    random = Randomizer(1)
+    transforms = []
+    states = []
+    for i in range(64):
+        transforms.append(TransformState.make_pos_hpr(
+            (random.random_real(100), random.random_real(100), 0),
+            (random.random_int(8) * 45, 0, 0)))
+
+        state = RenderState.make(ColorScaleAttrib.make((random.random_int(4) / 4.0, 1, 1, 1)))
+        if random.random_int(2):
+            state = state.add_attrib(DepthWriteAttrib.make(DepthWriteAttrib.M_off))
+        if random.random_int(2):
+            state = state.add_attrib(CullFaceAttrib.make_reverse())
+        states.append(state)
+
+    errors = []
+    done = []
+
+    def compose_random(seed):
+        random = Randomizer(seed)
+        while not done:
+            for i in range(100):
+                a = transforms[random.random_int(len(transforms))]
+                b = transforms[random.random_int(len(transforms))]
+                ts = a.invert_compose(a.compose(b))
+                if not ts.get_mat().almost_equal(b.get_mat(), 0.01):
+                    errors.append((a, b))
+
+                c = states[random.random_int(len(states))]
+                d = states[random.random_int(len(states))]
+                rs = c.compose(d)
+                scale = c.get_attrib(ColorScaleAttrib).compose(d.get_attrib(ColorScaleAttrib))
+                if rs.get_attrib(ColorScaleAttrib) != scale:
+                    errors.append((c, d))
+
+    threads = [threading.Thread(target=compose_random, args=(i + 1,)) for i in range(4)]
+    for thread in threads:
+        thread.start()
+
+    try:
+        for frame in range(20):
+            Thread.sleep(1.0 / 60.0)
+            TransformState.garbage_collect()
+            RenderState.garbage_collect()
+    finally:
+        done.append(True)
+        for thread in threads:
+            thread.join()
+
+    assert not errors
+    assert TransformState.validate_states()
+    assert RenderState.validate_states()
+
+
+@pytest.mark.benchmark
+@pytest.mark.skipif(not Thread.is_threading_supported(),
+                    reason="Threading support disabled")
+@pytest.mark.parametrize("local_cache_size", [0, 256])
+def test_state_cache_compose_benchmark(local_cache_size):
+    # Reports the number of compose() calls per second made by 1, 2, 4 and 8
+    # threads together, with and without the per-thread composition cache;
+    # run with pytest --run-benchmarks -s to see the results.  Since every
+    # call is made from Python, this also measures contention for the Python
+    # interpreter lock.
+    threading = pytest.importorskip("direct.stdpy.threading")
+
+    transforms = make_transforms(16)
+    states = [RenderState.make(ColorScaleAttrib.make((i / 16.0, 1, 1, 1)))
+              for i in range(16)]
+
+    def compose_all(counts):
+        count = 0
+        deadline = time.perf_counter() + 0.5
+        while time.perf_counter() < deadline:
+            for a in transforms:
+                for b in transforms:
+                    a.compose(b)
+            for a in states:
+                for b in states:
+                    a.compose(b)
+            count += len(transforms) ** 2 + len(states) ** 2
+        counts.append(count)
+
+    # The cache size is read by each thread when it first composes a state,
+    # so it only applies to threads that are started afterwards.
+    cache_size = ConfigVariableInt("local-composition-cache-size")
+    cache_size.set_value(local_cache_size)
+    try:
+        for num_threads in (1, 2, 4, 8):
+            counts = []
+            threads = [threading.Thread(target=compose_all, args=(counts,))
+                       for i in range(num_threads)]
+            start = time.perf_counter()
+            for thread in threads:
+                thread.start()
+            for thread in threads:
+                thread.join()
+            elapsed = time.perf_counter() - start
+
+            print("compose, local cache %d, %d threads: %.0f calls/s" % (
+                local_cache_size, num_threads, sum(counts) / elapsed))
+    finally:
+        cache_size.clear_local_value()
+
+    assert TransformState.validate_states()
+    assert RenderState.validate_states()
+
+
+def test_transform_cache_collect_young():
+    transforms = [TransformState.make_pos((0.5, i, -7)) for i in range(100)]
+    TransformState.garbage_collect()
+    num_states = TransformState.get_num_states()
+
+    # Newly made transforms are checked on every garbage collection cycle,
+    # so these should all go away on the very next one.
+    del transforms
+    TransformState.garbage_collect()
+    assert TransformState.get_num_states() <= num_states - 100
+    assert TransformState.validate_states()
@@ -1,5 +1,8 @@
 from panda3d.core import PNMImage, PNMImageHeader
-from random import randint
+from panda3d.core import ConfigVariableBool, ConfigVariableInt
+from random import randint, Random
+import time
+import pytest
 
 
 def test_pixelspec_ctor():
@@ -107,3 +110,116 @@ def test_pnmimage_mult_sub_image():
     assert final_color[0][1] == dst_color[0][1]
     assert final_color[1][0] == dst_color[1][0]
     assert final_color[1][1][0] == dst_color[1][1][0] * src_color[0] and final_color[1][1][1] == dst_color[1][1][1] * src_color[1] and final_color[1][1][2] == dst_color[1][1][2] * src_color[2]
+
+
+@pytest.fixture
+def parallel_filter():
+    var = ConfigVariableBool("pnmimage-parallel-filter")
+    min_pixels = ConfigVariableInt("pnmimage-parallel-filter-min-pixels")
+    min_pixels.set_value(0)
+    yield var
+    var.clear_local_value()
+    min_pixels.clear_local_value()
+
+
+def make_noise_image(x_size, y_size, seed=0):
+    rand = Random(seed)
+    image = PNMImage(x_size, y_size, 4)
+    for y in range(y_size):
+        for x in range(x_size):
+            image.set_xel_val(x, y, rand.randint(0, 255), rand.randint(0, 255), rand.randint(0, 255))
+            image.set_alpha_val(x, y, rand.randint(0, 255))
+    return image
+
+
+def filter_image(method, source, x_size, y_size):
+    dest = PNMImage(x_size, y_size, source.get_num_channels())
+    if method == "quick":
+        dest.quick_filter_from(source)
+    else:
+        getattr(dest, method + "_filter_from")(1.0 if method != "lanczos" else 3.0, source)
+    return dest
+
+
+def get_pixels(image):
+    return [(tuple(image.get_xel_val(x, y)), image.get_alpha_val(x, y))
+            for y in range(image.get_y_size())
+            for x in range(image.get_x_size())]
+
+
+@pytest.mark.parametrize("method", ["box", "gaussian", "lanczos", "quick"])
+@pytest.mark.parametrize("size", [(7, 5), (40, 30), (150, 90)])
+def test_pnmimage_filter_constant(method, size):
+    # Filtering an image of a single color should not change the color.
+    source = PNMImage(40, 30, 4)
+    source.fill(0.25, 0.5, 0.75)
+    source.alpha_fill(0.5)
+
+    dest = filter_image(method, source, *size)
+    for xel, alpha in set(get_pixels(dest)):
+        assert abs(xel[0] - 64) <= 1
+        assert abs(xel[1] - 128) <= 1
+        assert abs(xel[2] - 191) <= 1
+        assert abs(alpha - 128) <= 1
+
+
+@pytest.mark.parametrize("method", ["box", "gaussian", "lanczos", "quick"])
+def test_pnmimage_filter_parallel(method, parallel_filter):
+    # The result should not depend on whether the rows were divided among
+    # threads.
+    source = make_noise_image(60, 45)
+    results = []
+    for parallel in (False, True):
+        parallel_filter.set_value(parallel)
+        down = filter_image(method, source, 37, 29)
+        up = filter_image(method, source, 97, 71)
+        results.append((get_pixels(down), get_pixels(up)))
+
+    assert results[0] == results[1]
+
+
+def test_pnmimage_filter_in_place():
+    image = make_noise_image(30, 20)
+    copy = PNMImage(image)
+    image.gaussian_filter(1.0)
+
+    expected = PNMImage(30, 20, 4)
+    expected.gaussian_filter_from(1.0, copy)
+    assert get_pixels(image) == get_pixels(expected)
+
+
+def test_pnmimage_lanczos_filter_grayscale():
+    # A sharp edge should stay within range, even though the Lanczos filter
+    # overshoots.
+    source = PNMImage(16, 16, 1)
+    source.fill(0)
+    for y in range(16):
+        for x in range(8, 16):
+            source.set_gray(x, y, 1)
+
+    dest = PNMImage(64, 64, 1)
+    dest.lanczos_filter_from(3.0, source)
+    assert dest.get_gray_val(0, 32) == 0
+    assert dest.get_gray_val(63, 32) == 255
+    assert 0 < dest.get_gray_val(32, 32) < 255
+
+
+@pytest.mark.benchmark
+@pytest.mark.parametrize("method", ["box", "gaussian", "lanczos", "quick"])
+def test_pnmimage_filter_benchmark(method, parallel_filter):
+    # Resizes a large image both ways, and reports the time taken; run with
+    # pytest --run-benchmarks -s to see the results.
+    source = PNMImage(1024, 1024, 4)
+    source.fill(0.2, 0.4, 0.6)
+    source.alpha_fill(1)
+    source.perlin_noise_fill(4, 4)
+
+    for size in (256, 1536):
+        times = []
+        for parallel in (False, True):
+            parallel_filter.set_value(parallel)
+            start = time.perf_counter()
+            filter_image(method, source, size, size)
+            times.append(time.perf_counter() - start)
+
+        print("%s filter 1024 to %d: serial %.3f s, parallel %.3f s" % (method, size, times[0], times[1]))
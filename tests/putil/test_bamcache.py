@@ -1,4 +1,7 @@
 from panda3d import core
+import pytest
+import subprocess
+import sys
 
 
 def test_bamcache_flush_index():
@@ -6,3 +9,116 @@ def test_bamcache_flush_index():
     # consistently, and not intermittently, to avoid a noisy coverage report.
     cache = core.BamCache()
     cache.flush_index()
+
+
+@pytest.mark.parametrize("codec", [core.CC_none, core.CC_zlib, core.CC_zstd])
+def test_bamcache_compression(tmp_path, codec):
+    if not core.is_compression_codec_available(codec):
+        pytest.skip("requires %s" % (codec))
+
+    source = tmp_path / "source.egg"
+    source.write_text("<CoordinateSystem> { Z-up }")
+    source_fn = core.Filename.from_os_specific(str(source))
+
+    cache = core.BamCache()
+    cache.set_root(core.Filename.from_os_specific(str(tmp_path / "cache")))
+    cache.set_compression_codec(codec)
+
+    record = cache.lookup(source_fn, "bam")
+    assert record is not None
+    assert not record.has_data()
+    record.set_data(core.ModelRoot("model"))
+    assert cache.store(record)
+
+    # A new cache should find the record on disk, regardless of the codec it
+    # was written with.
+    cache = core.BamCache()
+    cache.set_root(core.Filename.from_os_specific(str(tmp_path / "cache")))
+    record = cache.lookup(source_fn, "bam")
+    assert record is not None
+    assert record.has_data()
+    assert record.get_data().name == "model"
+
+
+def make_cache(tmp_path):
+    cache = core.BamCache()
+    cache.set_root(core.Filename.from_os_specific(str(tmp_path / "cache")))
+    return cache
+
+
+def store_model(cache, tmp_path, name):
+    source = tmp_path / (name + ".egg")
+    source.write_text("<CoordinateSystem> { Z-up }")
+    source_fn = core.Filename.from_os_specific(str(source))
+
+    record = cache.lookup(source_fn, "bam")
+    assert record is not None
+    record.set_data(core.ModelRoot(name))
+    assert cache.store(record)
+    return source_fn
+
+
+@pytest.mark.parametrize("async_store", [False, True])
+def test_bamcache_async_store(tmp_path, async_store):
+    cache = make_cache(tmp_path)
+    cache.set_async_store(async_store)
+    source_fns = [store_model(cache, tmp_path, "model%d" % (i)) for i in range(20)]
+
+    # A lookup right after the store should wait for it to be written.
+    record = cache.lookup(source_fns[0], "bam")
+    assert record.has_data()
+    assert record.get_data().name == "model0"
+
+    cache.flush_index()
+
+    # The index is split into shards, each with its own reference file.
+    names = set(p.name for p in (tmp_path / "cache").iterdir())
+    for digit in "0123456789abcdef":
+        assert ("index_name_%s.txt" % (digit)) in names
+
+    # A new cache should find all of the records through the index.
+    cache = make_cache(tmp_path)
+    for i, source_fn in enumerate(source_fns):
+        record = cache.lookup(source_fn, "bam")
+        assert record.has_data()
+        assert record.get_data().name == "model%d" % (i)
+
+
+def test_bamcache_max_kbytes(tmp_path):
+    cache = make_cache(tmp_path)
+    source_fns = [store_model(cache, tmp_path, "model%d" % (i)) for i in range(10)]
+    cache.wait_for_stores()
+
+    # Shrinking the cache should remove the least-recently-used files.
+    cache.cache_max_kbytes = 0
+    cache.wait_for_stores()
+    files = [p for p in (tmp_path / "cache").iterdir() if p.suffix == ".bam"]
+    assert len(files) < 10
+
+    record = cache.lookup(source_fns[0], "bam")
+    assert not record.has_data()
+
+
+def test_bamcache_global_store_at_exit(tmp_path):
+    # The global cache is never destructed, but a record that is still
+    # waiting for the store thread must be written before the process exits.
+    source = tmp_path / "source.egg"
+    source.write_text("<CoordinateSystem> { Z-up }")
+    source_fn = core.Filename.from_os_specific(str(source))
+    cache_dir = core.Filename.from_os_specific(str(tmp_path / "cache"))
+
+    script = """if True:
+        from panda3d import core
+        core.load_prc_file_data("", "model-cache-dir %s\\nmodel-cache-async-store true")
+        cache = core.BamCache.get_global_ptr()
+        record = cache.lookup(core.Filename(%r), "bam")
+        record.set_data(core.ModelRoot("model"))
+        assert cache.store(record)
+    """ % (cache_dir.get_fullpath(), source_fn.get_fullpath())
+    subprocess.check_call([sys.executable, "-c", script])
+
+    cache = make_cache(tmp_path)
+    record = cache.lookup(source_fn, "bam")
+    assert record is not None
+    assert record.has_data()
+    assert record.get_data().name == "model"